@@ -0,0 +1,78 @@
+#include "benchmarks/bench.h"
+
+namespace sedfer::bench {
+
+static constexpr usize SIZES[] = {64, 1500, 64 * 1024, usize(16) << 20};
+
+void bench_base64() {
+    for(const usize size : SIZES) {
+        std::vector<u8> bytes(size);
+        for(u8 & byte : bytes) {
+            byte = u8(rand());
+        }
+        std::vector<u8> encoded(base64_encoded_size(size));
+        std::vector<u8> decoded(size);
+        const ConstBuffer input(bytes.data(), size);
+        const ConstBuffer text(encoded.data(), encoded.size());
+        char name[64];
+
+        std::snprintf(name, sizeof(name), "scalar::base64_encode %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(input);
+                kernels::scalar::base64_encode(input.data, input.size, encoded.data(), kernels::BASE64_STANDARD);
+                keep(encoded.data());
+            }
+        });
+        std::snprintf(name, sizeof(name), "base64_encode %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(input);
+                MutableBuffer output(encoded.data(), encoded.size());
+                keep(base64_encode(input, output));
+            }
+        });
+
+        // Byte-wise decoder: 6 bits per character into a bit accumulator.
+        std::snprintf(name, sizeof(name), "loop base64_decode %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(text);
+                u32 bits = 0;
+                u32 count = 0;
+                u8 * out = decoded.data();
+                for(usize j = 0; j < text.size && text.data[j] != '='; ++j) {
+                    const u8 value = kernels::BASE64_STANDARD.values[text.data[j]];
+                    if(value == 0xff) {
+                        break;
+                    }
+                    bits = (bits << 6) | value;
+                    count += 6;
+                    if(count >= 8) {
+                        count -= 8;
+                        *out++ = u8(bits >> count);
+                    }
+                }
+                keep(out);
+            }
+        });
+        std::snprintf(name, sizeof(name), "scalar::base64_decode %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            const usize padding = kernels::base64_padding(text);
+            for(usize i = 0; i < iterations; ++i) {
+                keep(text);
+                keep(kernels::scalar::base64_decode(text.data, text.size - padding, decoded.data(), kernels::BASE64_STANDARD));
+            }
+        });
+        std::snprintf(name, sizeof(name), "base64_decode %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(text);
+                MutableBuffer output(decoded.data(), decoded.size());
+                keep(base64_decode(text, output));
+            }
+        });
+    }
+}
+
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "helpers/all.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include <sys/resource.h>
+
+namespace sedfer::bench {
+
+[[gnu::always_inline]] inline u64 now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/// \brief Prevent the compiler from optimizing away a computed value.
+template<typename T>
+[[gnu::always_inline]] inline void keep(const T & value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/// \brief Minor + major page faults of this process so far.
+inline u64 page_faults() {
+    rusage usage = {};
+    getrusage(RUSAGE_SELF, &usage);
+    return u64(usage.ru_minflt) + u64(usage.ru_majflt);
+}
+
+/// \brief Per-iteration latency samples.
+struct Latency {
+    std::vector<u64> samples;
+
+    void add(u64 ns) {
+        samples.push_back(ns);
+    }
+
+    [[nodiscard]] u64 percentile(double p) {
+        if(samples.empty()) {
+            return 0;
+        }
+        std::sort(samples.begin(), samples.end());
+        const usize index = std::min(samples.size() - 1, usize(p / 100.0 * double(samples.size())));
+        return samples[index];
+    }
+};
+
+/**
+ * \brief Run f(iterations) with growing iteration count until it takes at least ~100ms, print GB/s.
+ * \note f must process bytes_per_iteration bytes per iteration.
+ */
+template<typename F>
+inline void throughput(const char * name, usize bytes_per_iteration, F && f) {
+    usize iterations = 1;
+    u64 elapsed = 0;
+    while(true) {
+        const u64 start = now_ns();
+        f(iterations);
+        elapsed = now_ns() - start;
+        if(elapsed >= 100'000'000 || iterations >= (usize(1) << 40)) {
+            break;
+        }
+        iterations *= 2;
+    }
+
+    const double bytes = double(bytes_per_iteration) * double(iterations);
+    std::printf("  %-48s %9.3f GB/s %10.2f ns/op\n", name, bytes / double(elapsed), double(elapsed) / double(iterations));
+}
+
+}
@@ -0,0 +1,85 @@
+#include "benchmarks/bench.h"
+
+namespace sedfer::bench {
+
+static constexpr usize SIZES[] = {64, 1500, 64 * 1024, usize(16) << 20};
+
+void bench_bitwise() {
+    static const u8 KEY[] = {0x37, 0xfa, 0x21, 0x3d};
+    u32 key;
+    std::memcpy(&key, KEY, 4);
+
+    for(const usize size : SIZES) {
+        std::vector<u8> left(size, 0x5a);
+        std::vector<u8> right(size, 0xa5);
+        const MutableBuffer buffer(left.data(), size);
+        const ConstBuffer other(right.data(), size);
+        char name[64];
+
+        std::snprintf(name, sizeof(name), "loop xor %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(buffer);
+                for(usize j = 0; j < buffer.size; ++j) {
+                    buffer.data[j] ^= other.data[j];
+                }
+                keep(buffer.data);
+            }
+        });
+        std::snprintf(name, sizeof(name), "xor_with %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(buffer);
+                (void)buffer.xor_with(other);
+            }
+        });
+#if defined(__x86_64__) || defined(__i386__)
+        std::snprintf(name, sizeof(name), "sse2::bitwise<xor_> %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(buffer);
+                kernels::sse2::bitwise<BitOp::xor_>(buffer.data, buffer.data, other.data, size);
+            }
+        });
+        if(cpu_tier() >= CpuTier::avx2) {
+            std::snprintf(name, sizeof(name), "avx2::bitwise<xor_> %lu", size);
+            throughput(name, size, [&](usize iterations) {
+                for(usize i = 0; i < iterations; ++i) {
+                    keep(buffer);
+                    kernels::avx2::bitwise<BitOp::xor_>(buffer.data, buffer.data, other.data, size);
+                }
+            });
+        }
+        if(cpu_tier() >= CpuTier::avx512) {
+            std::snprintf(name, sizeof(name), "avx512::bitwise<xor_> %lu", size);
+            throughput(name, size, [&](usize iterations) {
+                for(usize i = 0; i < iterations; ++i) {
+                    keep(buffer);
+                    kernels::avx512::bitwise<BitOp::xor_>(buffer.data, buffer.data, other.data, size);
+                }
+            });
+        }
+#endif
+
+        // WebSocket-style unmasking: byte loop with index modulo 4.
+        std::snprintf(name, sizeof(name), "loop mask %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(buffer);
+                for(usize j = 0; j < buffer.size; ++j) {
+                    buffer.data[j] ^= KEY[j % 4];
+                }
+                keep(buffer.data);
+            }
+        });
+        std::snprintf(name, sizeof(name), "xor_mask %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(buffer);
+                buffer.xor_mask(key, i);
+            }
+        });
+    }
+}
+
+}
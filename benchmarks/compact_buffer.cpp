@@ -0,0 +1,73 @@
+#include "benchmarks/bench.h"
+
+#include <cstdlib>
+#include <memory>
+
+namespace sedfer::bench {
+
+static usize entries() {
+    const char * const value = std::getenv("SEDFER_BENCH_ENTRIES");
+    return value ? std::strtoull(value, nullptr, 10) : 50'000'000;
+}
+
+template<typename Handle, typename Resolve>
+static void scan(const char * name, const std::vector<Handle> & table, Resolve && resolve) {
+    u64 size_sum = 0;
+    u64 start = now_ns();
+    for(const Handle & handle : table) {
+        size_sum += resolve(handle).size;
+    }
+    const u64 sizes_elapsed = now_ns() - start;
+    keep(size_sum);
+
+    u64 byte_sum = 0;
+    start = now_ns();
+    for(const Handle & handle : table) {
+        const ConstBuffer buffer = resolve(handle);
+        byte_sum += buffer.data[buffer.size - 1];
+    }
+    const u64 bytes_elapsed = now_ns() - start;
+    keep(byte_sum);
+
+    std::printf("  %-44s table %7.1f MB   sizes %6.2f ns/entry   last byte %6.2f ns/entry\n",
+                name,
+                double(table.size() * sizeof(Handle)) / 1e6,
+                double(sizes_elapsed) / double(table.size()),
+                double(bytes_elapsed) / double(table.size()));
+}
+
+void bench_compact_buffer() {
+    const usize count = entries();
+
+    // Arena of short keys (8..23 bytes), like identifiers or URL path segments.
+    std::vector<u8> arena_storage;
+    std::vector<CompactBuffer> compact;
+    compact.reserve(count);
+    u64 state = 0x9E3779B97F4A7C15;
+    for(usize i = 0; i < count; ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        const usize size = 8 + state % 16;
+        compact.push_back({u32(arena_storage.size()), u32(size)});
+        for(usize j = 0; j < size; ++j) {
+            arena_storage.push_back(u8('a' + (state >> (j * 2)) % 26));
+        }
+    }
+    const ConstBuffer arena(arena_storage.data(), arena_storage.size());
+
+    std::printf("  %lu entries, arena %.1f MB\n", count, double(arena.size) / 1e6);
+
+    {
+        std::vector<ConstBuffer> plain;
+        plain.reserve(count);
+        for(const CompactBuffer handle : compact) {
+            plain.push_back(handle.resolve(arena));
+        }
+        scan("ConstBuffer", plain, [](ConstBuffer buffer) { return buffer; });
+    }
+
+    scan("CompactBuffer", compact, [arena](CompactBuffer handle) { return handle.resolve(arena); });
+}
+
+}
@@ -0,0 +1,98 @@
+#include "benchmarks/bench.h"
+
+#include <cstring>
+#include <random>
+#include <string>
+
+namespace sedfer::bench {
+
+static constexpr usize SIZES[] = {4, 8, 16, 32, 64, 256, 4096};
+static constexpr usize KEYS = 2'000'000;
+
+/// Keys with a shared prefix of random length (0-40 bytes), like sorted paths or URLs.
+static std::vector<u8> make_keys(std::vector<ConstBuffer> & keys) {
+    std::mt19937_64 random(42);
+    static const std::string PREFIX = "https://static.example.com/assets/images/";
+    std::vector<u8> arena;
+    std::vector<usize> sizes;
+    for(usize i = 0; i < KEYS; ++i) {
+        std::string key = PREFIX.substr(0, random() % PREFIX.size());
+        key += std::to_string(random() % 10'000'000);
+        arena.insert(arena.end(), key.begin(), key.end());
+        sizes.push_back(key.size());
+    }
+    usize offset = 0;
+    for(const usize size : sizes) {
+        keys.emplace_back(arena.data() + offset, size);
+        offset += size;
+    }
+    return arena;
+}
+
+template<typename Less>
+static void sort(const char * name, const std::vector<ConstBuffer> & keys, Less less) {
+    std::vector<ConstBuffer> copy = keys;
+    const u64 start = now_ns();
+    std::sort(copy.begin(), copy.end(), less);
+    std::printf("  %-48s %9.0f ms\n", name, double(now_ns() - start) / 1e6);
+}
+
+void bench_compare() {
+    for(const usize size : SIZES) {
+        // Equal buffers: the whole size is compared.
+        std::vector<u8> left(size, 'x');
+        std::vector<u8> right(size, 'x');
+        const ConstBuffer l(left.data(), size);
+        const ConstBuffer r(right.data(), size);
+        char name[64];
+
+        std::snprintf(name, sizeof(name), "lexicographical_compare %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(l);
+                keep(std::lexicographical_compare(l.data, l.data + l.size, r.data, r.data + r.size));
+            }
+        });
+        std::snprintf(name, sizeof(name), "memcmp %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(l);
+                keep(std::memcmp(l.data, r.data, size));
+            }
+        });
+        std::snprintf(name, sizeof(name), "compare %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(l);
+                keep(compare(l, r) < 0);
+            }
+        });
+        std::snprintf(name, sizeof(name), "std::equal %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(l);
+                keep(std::equal(l.data, l.data + l.size, r.data, r.data + r.size));
+            }
+        });
+        std::snprintf(name, sizeof(name), "equal %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(l);
+                keep(equal(l, r));
+            }
+        });
+    }
+
+    std::vector<ConstBuffer> keys;
+    const std::vector<u8> arena = make_keys(keys);
+    sort("sort 2M keys lexicographical_compare", keys, [](ConstBuffer left, ConstBuffer right) {
+        return std::lexicographical_compare(left.data, left.data + left.size, right.data, right.data + right.size);
+    });
+    sort("sort 2M keys memcmp", keys, [](ConstBuffer left, ConstBuffer right) {
+        const int ret = std::memcmp(left.data, right.data, std::min(left.size, right.size));
+        return ret != 0 ? ret < 0 : left.size < right.size;
+    });
+    sort("sort 2M keys BufferLess", keys, BufferLess());
+}
+
+}
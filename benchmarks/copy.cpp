@@ -0,0 +1,90 @@
+#include "benchmarks/bench.h"
+
+#include <cstring>
+
+namespace sedfer::bench {
+
+static constexpr usize SIZES[] = {1, 2, 3, 4, 7, 8, 12, 16, 24, 32, 48, 64, 128};
+static constexpr usize OUTPUT_SIZE = 256 * 1024;
+static constexpr usize RECORDS = 4096; // at most 256 KiB of random 1-64 byte records
+
+/// \brief Hide a value from the optimizer so copy sizes stay runtime values.
+[[gnu::always_inline]] inline usize opaque(usize value) {
+    asm volatile("" : "+r"(value));
+    return value;
+}
+
+void bench_copy() {
+    std::vector<u8> source(256, 'x');
+    std::vector<u8> output(OUTPUT_SIZE);
+
+    for(const usize fixed_size : SIZES) {
+        const usize size = opaque(fixed_size);
+        const usize records = OUTPUT_SIZE / fixed_size;
+        char name[64];
+
+        std::snprintf(name, sizeof(name), "std::copy_n %lu", fixed_size);
+        throughput(name, records * size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                u8 * out = output.data();
+                for(usize j = 0; j < records; ++j) {
+                    out = std::copy_n(source.data(), size, out);
+                }
+                keep(out);
+            }
+        });
+        std::snprintf(name, sizeof(name), "push %lu", fixed_size);
+        throughput(name, records * size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                MutableBuffer out(output.data(), output.size());
+                for(usize j = 0; j < records; ++j) {
+                    (void)out.push({source.data(), size});
+                }
+                keep(out);
+            }
+        });
+    }
+
+    // TLV-like traffic: random sizes 1-64, size-class branches are not predictable.
+    std::vector<usize> sizes(RECORDS);
+    u64 state = 0x9E3779B97F4A7C15;
+    usize bytes = 0;
+    for(usize & size : sizes) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        size = 1 + state % 64;
+        bytes += size;
+    }
+
+    throughput("std::copy_n random 1-64", bytes, [&](usize iterations) {
+        for(usize i = 0; i < iterations; ++i) {
+            u8 * out = output.data();
+            for(const usize size : sizes) {
+                out = std::copy_n(source.data(), size, out);
+            }
+            keep(out);
+        }
+    });
+    throughput("memcpy random 1-64", bytes, [&](usize iterations) {
+        for(usize i = 0; i < iterations; ++i) {
+            u8 * out = output.data();
+            for(const usize size : sizes) {
+                std::memcpy(out, source.data(), size);
+                out += size;
+            }
+            keep(out);
+        }
+    });
+    throughput("push random 1-64", bytes, [&](usize iterations) {
+        for(usize i = 0; i < iterations; ++i) {
+            MutableBuffer out(output.data(), output.size());
+            for(const usize size : sizes) {
+                (void)out.push({source.data(), size});
+            }
+            keep(out);
+        }
+    });
+}
+
+}
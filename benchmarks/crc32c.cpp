@@ -0,0 +1,45 @@
+#include "benchmarks/bench.h"
+
+namespace sedfer::bench {
+
+static constexpr usize SIZES[] = {64, 1500, 64 * 1024, usize(16) << 20};
+
+void bench_crc32c() {
+    for(const usize size : SIZES) {
+        std::vector<u8> bytes(size);
+        for(u8 & byte : bytes) {
+            byte = u8(rand());
+        }
+        const ConstBuffer buffer(bytes.data(), size);
+        char name[64];
+
+        // Byte-at-a-time table lookup.
+        std::snprintf(name, sizeof(name), "table crc32c %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(buffer);
+                u32 crc = ~u32(0);
+                for(usize j = 0; j < buffer.size; ++j) {
+                    crc = (crc >> 8) ^ kernels::CRC32C_TABLES[0][(crc ^ buffer.data[j]) & 0xff];
+                }
+                keep(crc);
+            }
+        });
+        std::snprintf(name, sizeof(name), "scalar::crc32c %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(buffer);
+                keep(kernels::scalar::crc32c(~u32(0), buffer.data, buffer.size));
+            }
+        });
+        std::snprintf(name, sizeof(name), "crc32c %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(buffer);
+                keep(crc32c(buffer));
+            }
+        });
+    }
+}
+
+}
@@ -0,0 +1,158 @@
+#include "benchmarks/bench.h"
+
+namespace sedfer::bench {
+
+/// Numbers separated by ' ', parsed one by one: strtoull / strtod on a std::string copy, std::from_chars, pop_*.
+template<typename T>
+static void parse(const char * type, const std::string & text, usize count) {
+    char name[64];
+    const ConstBuffer input(reinterpret_cast<const u8 *>(text.data()), text.size());
+
+    std::snprintf(name, sizeof(name), "std::string + strto %s", type);
+    throughput(name, text.size(), [&](usize iterations) {
+        for(usize i = 0; i < iterations; ++i) {
+            keep(input);
+            ConstBuffer rest = input;
+            T sum = 0;
+            for(usize j = 0; j < count; ++j) {
+                const ConstBuffer field = rest.pop_until(' ');
+                const std::string copy(reinterpret_cast<const char *>(field.data), field.size);
+                if constexpr(std::is_floating_point_v<T>) {
+                    sum += T(std::strtod(copy.c_str(), nullptr));
+                } else {
+                    sum += T(std::strtoull(copy.c_str(), nullptr, 10));
+                }
+            }
+            keep(sum);
+        }
+    });
+    std::snprintf(name, sizeof(name), "std::from_chars %s", type);
+    throughput(name, text.size(), [&](usize iterations) {
+        for(usize i = 0; i < iterations; ++i) {
+            keep(input);
+            const char * p = text.data();
+            const char * const end = p + text.size();
+            T sum = 0;
+            for(usize j = 0; j < count; ++j) {
+                T value = 0;
+                p = std::from_chars(p, end, value).ptr + 1;
+                sum += value;
+            }
+            keep(sum);
+        }
+    });
+    std::snprintf(name, sizeof(name), "pop_%s %s", std::is_floating_point_v<T> ? "float" : "decimal", type);
+    throughput(name, text.size(), [&](usize iterations) {
+        for(usize i = 0; i < iterations; ++i) {
+            keep(input);
+            ConstBuffer rest = input;
+            T sum = 0;
+            for(usize j = 0; j < count; ++j) {
+                T value = 0;
+                if constexpr(std::is_floating_point_v<T>) {
+                    (void)rest.pop_float(value);
+                } else {
+                    (void)rest.pop_decimal(value);
+                }
+                (void)rest.skip(1);
+                sum += value;
+            }
+            keep(sum);
+        }
+    });
+}
+
+/// Numbers written separated by ' ': snprintf into a temporary + push, std::to_chars, push_*.
+template<typename T>
+static void format(const char * type, const std::vector<T> & values) {
+    char name[64];
+    std::vector<u8> text(32 * values.size());
+    const char * const format = std::is_floating_point_v<T> ? "%.17g" : "%llu";
+
+    std::snprintf(name, sizeof(name), "snprintf + push %s", type);
+    throughput(name, 8 * values.size(), [&](usize iterations) {
+        for(usize i = 0; i < iterations; ++i) {
+            keep(values.data());
+            MutableBuffer output(text.data(), text.size());
+            for(const T value : values) {
+                char temporary[32];
+                int length;
+                if constexpr(std::is_floating_point_v<T>) {
+                    length = std::snprintf(temporary, sizeof(temporary), format, value);
+                } else {
+                    length = std::snprintf(temporary, sizeof(temporary), format, static_cast<unsigned long long>(value));
+                }
+                (void)output.push(ConstBuffer(reinterpret_cast<const u8 *>(temporary), usize(length)));
+                (void)output.push(u8(' '));
+            }
+            keep(text.data());
+        }
+    });
+    std::snprintf(name, sizeof(name), "std::to_chars %s", type);
+    throughput(name, 8 * values.size(), [&](usize iterations) {
+        for(usize i = 0; i < iterations; ++i) {
+            keep(values.data());
+            char * p = reinterpret_cast<char *>(text.data());
+            char * const end = p + text.size();
+            for(const T value : values) {
+                p = std::to_chars(p, end, value).ptr;
+                *p++ = ' ';
+            }
+            keep(text.data());
+        }
+    });
+    std::snprintf(name, sizeof(name), "push_%s %s", std::is_floating_point_v<T> ? "float" : "decimal", type);
+    throughput(name, 8 * values.size(), [&](usize iterations) {
+        for(usize i = 0; i < iterations; ++i) {
+            keep(values.data());
+            MutableBuffer output(text.data(), text.size());
+            for(const T value : values) {
+                if constexpr(std::is_floating_point_v<T>) {
+                    (void)output.push_float(value);
+                } else {
+                    (void)output.push_decimal(value);
+                }
+                (void)output.push(u8(' '));
+            }
+            keep(text.data());
+        }
+    });
+}
+
+void bench_decimal() {
+    constexpr usize COUNT = 10000;
+    std::string small;
+    std::string large;
+    std::string prices;
+    std::string doubles;
+    char text[64];
+    for(usize i = 0; i < COUNT; ++i) {
+        small += std::to_string(u64(rand()) % 1000) + ' ';
+        large += std::to_string(((u64(rand()) << 40) ^ (u64(rand()) << 20) ^ u64(rand())) >> (rand() % 40)) + ' ';
+        std::snprintf(text, sizeof(text), "%.2f ", double(rand() % 1000000) / 100);
+        prices += text;
+        std::snprintf(text, sizeof(text), "%.17g ", std::bit_cast<double>((((u64(rand()) << 40) ^ (u64(rand()) << 20) ^ u64(rand())) >> 2) | (u64(1) << 61)));
+        doubles += text;
+    }
+    parse<u64>("u64 0-999", small, COUNT);
+    parse<u64>("u64 random", large, COUNT);
+    parse<double>("double 0.00-9999.99", prices, COUNT);
+    parse<double>("double %.17g", doubles, COUNT);
+
+    std::vector<u64> small_values(COUNT);
+    std::vector<u64> large_values(COUNT);
+    std::vector<double> price_values(COUNT);
+    std::vector<double> double_values(COUNT);
+    for(usize i = 0; i < COUNT; ++i) {
+        small_values[i] = u64(rand()) % 1000;
+        large_values[i] = ((u64(rand()) << 40) ^ (u64(rand()) << 20) ^ u64(rand())) >> (rand() % 40);
+        price_values[i] = double(rand() % 1000000) / 100;
+        double_values[i] = std::bit_cast<double>((((u64(rand()) << 40) ^ (u64(rand()) << 20) ^ u64(rand())) >> 2) | (u64(1) << 61));
+    }
+    format<u64>("u64 0-999", small_values);
+    format<u64>("u64 random", large_values);
+    format<double>("double 0.00-9999.99", price_values);
+    format<double>("double random", double_values);
+}
+
+}
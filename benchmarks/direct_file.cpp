@@ -0,0 +1,81 @@
+#include "benchmarks/bench.h"
+
+#include <cstdlib>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace sedfer::bench {
+
+static constexpr usize FILE_SIZE = usize(256) << 20;
+static constexpr usize CHUNK_SIZE = usize(1) << 20;
+
+static void report(const char * name, u64 elapsed) {
+    std::printf("  %-44s %9.3f GB/s\n", name, double(FILE_SIZE) / double(elapsed));
+}
+
+static void buffered_write(const char * path, ConstBuffer chunk) {
+    const int fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    const u64 start = now_ns();
+    for(usize offset = 0; offset < FILE_SIZE; offset += chunk.size) {
+        keep(::pwrite(fd, chunk.data, chunk.size, off_t(offset)));
+    }
+    ::fdatasync(fd);
+    report("buffered write (+fdatasync)", now_ns() - start);
+    ::close(fd);
+}
+
+static void direct_write(const char * path, DirectFile::Buffer chunk) {
+    DirectFile file(path, O_WRONLY | O_CREAT | O_TRUNC);
+    const u64 start = now_ns();
+    for(usize offset = 0; offset < FILE_SIZE; offset += chunk.size) {
+        keep(file.write(chunk, offset));
+    }
+    ::fdatasync(file.native_handle());
+    report(file.direct() ? "direct write (+fdatasync)" : "direct write (O_DIRECT rejected)", now_ns() - start);
+}
+
+static void buffered_read(const char * path, MutableBuffer chunk, bool cold) {
+    const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if(cold) {
+        ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    }
+    const u64 start = now_ns();
+    for(usize offset = 0; offset < FILE_SIZE; offset += chunk.size) {
+        keep(::pread(fd, chunk.data, chunk.size, off_t(offset)));
+    }
+    report(cold ? "buffered read (cold cache)" : "buffered read (warm cache)", now_ns() - start);
+    ::close(fd);
+}
+
+static void direct_read(const char * path, DirectFile::Buffer chunk) {
+    DirectFile file(path, O_RDONLY);
+    const u64 start = now_ns();
+    for(usize offset = 0; offset < FILE_SIZE; offset += chunk.size) {
+        keep(file.read(chunk, offset));
+    }
+    report(file.direct() ? "direct read" : "direct read (O_DIRECT rejected)", now_ns() - start);
+}
+
+void bench_direct_file() {
+    const char * const directory = std::getenv("TMPDIR") ? std::getenv("TMPDIR") : "/tmp";
+    char path[4096];
+    std::snprintf(path, sizeof(path), "%s/sedfer_bench_direct_file", directory);
+
+    AlignedStorage<DirectFile::ALIGNMENT> storage(CHUNK_SIZE);
+    const DirectFile::Buffer chunk = storage.buffer();
+    for(usize i = 0; i < chunk.size; ++i) {
+        chunk.data[i] = u8(i * 31);
+    }
+
+    buffered_write(path, chunk);
+    direct_write(path, chunk);
+
+    buffered_read(path, chunk, true);
+    buffered_read(path, chunk, false);
+    direct_read(path, chunk);
+
+    ::unlink(path);
+}
+
+}
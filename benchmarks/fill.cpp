@@ -0,0 +1,66 @@
+#include "benchmarks/bench.h"
+
+#include <cstring>
+
+namespace sedfer::bench {
+
+static constexpr usize SIZES[] = {16, 64, 256, 4096, usize(1) << 20, usize(64) << 20};
+static constexpr usize PATTERN_SIZES[] = {3, 8, 13, 64};
+
+void bench_fill() {
+    static const u8 PATTERN[64] = {0xde, 0xad, 0xbe, 0xef, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09};
+
+    for(const usize size : SIZES) {
+        std::vector<u8> bytes(size);
+        MutableBuffer buffer(bytes.data(), size);
+        char name[64];
+
+        std::snprintf(name, sizeof(name), "std::fill %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(buffer);
+                std::fill(buffer.data, buffer.data + buffer.size, u8(0));
+                keep(buffer.data);
+            }
+        });
+        std::snprintf(name, sizeof(name), "fill %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(buffer);
+                buffer.fill(0);
+                keep(buffer.data);
+            }
+        });
+        std::snprintf(name, sizeof(name), "secure_zero %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(buffer);
+                buffer.secure_zero();
+            }
+        });
+
+        for(const usize pattern_size : PATTERN_SIZES) {
+            // Ad hoc pattern fill: index modulo pattern size.
+            std::snprintf(name, sizeof(name), "loop pattern %lu %lu", pattern_size, size);
+            throughput(name, size, [&](usize iterations) {
+                for(usize i = 0; i < iterations; ++i) {
+                    keep(buffer);
+                    for(usize j = 0; j < buffer.size; ++j) {
+                        buffer.data[j] = PATTERN[j % pattern_size];
+                    }
+                    keep(buffer.data);
+                }
+            });
+            std::snprintf(name, sizeof(name), "fill_pattern %lu %lu", pattern_size, size);
+            throughput(name, size, [&](usize iterations) {
+                for(usize i = 0; i < iterations; ++i) {
+                    keep(buffer);
+                    (void)buffer.fill_pattern({PATTERN, pattern_size});
+                    keep(buffer.data);
+                }
+            });
+        }
+    }
+}
+
+}
@@ -0,0 +1,67 @@
+#include "benchmarks/bench.h"
+
+#include <string_view>
+
+namespace sedfer::bench {
+
+static constexpr usize SIZES[] = {8, 16, 32, 64, 200, 1500, 64 * 1024, usize(16) << 20};
+
+void bench_hash() {
+    for(const usize size : SIZES) {
+        std::vector<u8> bytes(size);
+        for(u8 & byte : bytes) {
+            byte = u8(rand());
+        }
+        const ConstBuffer buffer(bytes.data(), size);
+        char name[64];
+
+        std::snprintf(name, sizeof(name), "loop fnv1a %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(buffer);
+                u64 hash = 0xcbf29ce484222325ull;
+                for(usize j = 0; j < buffer.size; ++j) {
+                    hash = (hash ^ buffer.data[j]) * 0x100000001b3ull;
+                }
+                keep(hash);
+            }
+        });
+        std::snprintf(name, sizeof(name), "std::hash %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(buffer);
+                keep(std::hash<std::string_view>()({reinterpret_cast<const char *>(buffer.data), buffer.size}));
+            }
+        });
+        std::snprintf(name, sizeof(name), "hash64 %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(buffer);
+                keep(hash64(buffer));
+            }
+        });
+        std::snprintf(name, sizeof(name), "hash128 %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(buffer);
+                const Hash128 hash = hash128(buffer, i);
+                keep(hash.low);
+                keep(hash.high);
+            }
+        });
+        std::snprintf(name, sizeof(name), "Hasher 1500-byte pieces %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(buffer);
+                Hasher hasher;
+                ConstBuffer rest = buffer;
+                while(rest.size != 0) {
+                    hasher.update(rest.pop_buffer(std::min(rest.size, usize(1500))));
+                }
+                keep(hasher.digest64());
+            }
+        });
+    }
+}
+
+}
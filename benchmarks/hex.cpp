@@ -0,0 +1,144 @@
+#include "benchmarks/bench.h"
+
+namespace sedfer::bench {
+
+static constexpr usize SIZES[] = {16, 1500, 64 * 1024, usize(16) << 20};
+
+void bench_hex() {
+    for(const usize size : SIZES) {
+        std::vector<u8> bytes(size);
+        for(u8 & byte : bytes) {
+            byte = u8(rand());
+        }
+        std::vector<u8> encoded(2 * size);
+        std::vector<u8> decoded(size);
+        const ConstBuffer input(bytes.data(), size);
+        const ConstBuffer text(encoded.data(), encoded.size());
+        char name[64];
+
+        // Per-nibble loop with a digit string.
+        std::snprintf(name, sizeof(name), "loop hex_encode %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            static const char DIGITS[] = "0123456789abcdef";
+            for(usize i = 0; i < iterations; ++i) {
+                keep(input);
+                for(usize j = 0; j < input.size; ++j) {
+                    encoded[2 * j] = u8(DIGITS[input.data[j] >> 4]);
+                    encoded[2 * j + 1] = u8(DIGITS[input.data[j] & 15]);
+                }
+                keep(encoded.data());
+            }
+        });
+        std::snprintf(name, sizeof(name), "scalar::hex_encode %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(input);
+                kernels::scalar::hex_encode(input.data, input.size, encoded.data(), HexCase::lower);
+                keep(encoded.data());
+            }
+        });
+        std::snprintf(name, sizeof(name), "hex_encode %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(input);
+                MutableBuffer output(encoded.data(), encoded.size());
+                keep(hex_encode(input, output));
+            }
+        });
+
+        // Per-digit branches.
+        std::snprintf(name, sizeof(name), "loop hex_decode %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            const auto nibble = [](u8 c) -> int {
+                if(c >= '0' && c <= '9') {
+                    return c - '0';
+                }
+                c |= 0x20;
+                return (c >= 'a' && c <= 'f') ? c - 'a' + 10 : -1;
+            };
+            for(usize i = 0; i < iterations; ++i) {
+                keep(text);
+                usize j = 0;
+                for(; j < size; ++j) {
+                    const int high = nibble(text.data[2 * j]);
+                    const int low = nibble(text.data[2 * j + 1]);
+                    if((high | low) < 0) {
+                        break;
+                    }
+                    decoded[j] = u8((high << 4) | low);
+                }
+                keep(j);
+                keep(decoded.data());
+            }
+        });
+        std::snprintf(name, sizeof(name), "scalar::hex_decode %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(text);
+                keep(kernels::scalar::hex_decode(text.data, size, decoded.data()));
+            }
+        });
+        std::snprintf(name, sizeof(name), "hex_decode %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(text);
+                MutableBuffer output(decoded.data(), decoded.size());
+                keep(hex_decode(text, output));
+            }
+        });
+    }
+
+    // Fixed-width integers: snprintf / strtoull against SWAR push_hex / pop_hex.
+    std::vector<u64> values(1024);
+    for(u64 & value : values) {
+        value = (u64(rand()) << 40) ^ (u64(rand()) << 20) ^ u64(rand());
+    }
+    std::vector<u8> text(16 * values.size());
+    throughput("snprintf u64 hex", 8 * values.size(), [&](usize iterations) {
+        for(usize i = 0; i < iterations; ++i) {
+            keep(values.data());
+            char digits[17];
+            for(usize j = 0; j < values.size(); ++j) {
+                std::snprintf(digits, sizeof(digits), "%016llx", static_cast<unsigned long long>(values[j]));
+                std::memcpy(text.data() + 16 * j, digits, 16);
+            }
+            keep(text.data());
+        }
+    });
+    throughput("push_hex u64", 8 * values.size(), [&](usize iterations) {
+        for(usize i = 0; i < iterations; ++i) {
+            keep(values.data());
+            MutableBuffer output(text.data(), text.size());
+            for(const u64 value : values) {
+                (void)output.push_hex(value);
+            }
+            keep(text.data());
+        }
+    });
+    throughput("strtoull u64 hex", 8 * values.size(), [&](usize iterations) {
+        for(usize i = 0; i < iterations; ++i) {
+            keep(text.data());
+            u64 sum = 0;
+            char digits[17] = {};
+            for(usize j = 0; j < values.size(); ++j) {
+                std::memcpy(digits, text.data() + 16 * j, 16);
+                sum += std::strtoull(digits, nullptr, 16);
+            }
+            keep(sum);
+        }
+    });
+    throughput("pop_hex u64", 8 * values.size(), [&](usize iterations) {
+        for(usize i = 0; i < iterations; ++i) {
+            keep(text.data());
+            ConstBuffer input(text.data(), text.size());
+            u64 sum = 0;
+            u64 value = 0;
+            while(input.pop_hex(value)) {
+                sum += value;
+            }
+            keep(sum);
+        }
+    });
+}
+
+}
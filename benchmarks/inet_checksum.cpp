@@ -0,0 +1,51 @@
+#include "benchmarks/bench.h"
+
+namespace sedfer::bench {
+
+static constexpr usize SIZES[] = {20, 64, 1500, 64 * 1024};
+
+void bench_inet_checksum() {
+    for(const usize size : SIZES) {
+        std::vector<u8> bytes(size);
+        for(u8 & byte : bytes) {
+            byte = u8(rand());
+        }
+        const ConstBuffer buffer(bytes.data(), size);
+        char name[64];
+
+        // RFC 1071 reference loop: 16-bit big-endian words into a 32-bit sum.
+        std::snprintf(name, sizeof(name), "loop checksum %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(buffer);
+                u32 sum = 0;
+                usize j = 0;
+                for(; j + 1 < buffer.size; j += 2) {
+                    sum += (u32(buffer.data[j]) << 8) | buffer.data[j + 1];
+                }
+                if(j < buffer.size) {
+                    sum += u32(buffer.data[j]) << 8;
+                }
+                sum = (sum & 0xffff) + (sum >> 16);
+                sum = (sum & 0xffff) + (sum >> 16);
+                keep(u16(~sum));
+            }
+        });
+        std::snprintf(name, sizeof(name), "scalar::inet_sum %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(buffer);
+                keep(kernels::inet_fold(kernels::scalar::inet_sum(buffer.data, buffer.size)));
+            }
+        });
+        std::snprintf(name, sizeof(name), "inet_checksum %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(buffer);
+                keep(inet_checksum(buffer));
+            }
+        });
+    }
+}
+
+}
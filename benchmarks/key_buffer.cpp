@@ -0,0 +1,94 @@
+#include "benchmarks/bench.h"
+
+#include <cstdlib>
+#include <string>
+
+namespace sedfer::bench {
+
+static constexpr usize KEYS = 10'000'000;
+
+static const char * const HOSTS[] = {"example.com", "cdn.example.net", "api.service.io", "static.files.org",
+                                     "www.shop.example", "mail.provider.com", "news.site.co.uk", "m.social.app"};
+
+static const char * const SEGMENTS[] = {"api", "v1", "v2", "users", "items", "images", "search", "static",
+                                        "assets", "profile", "orders", "thumbnails", "data", "feed", "page", "id"};
+
+enum class Shape { url, url_without_scheme, path_tail };
+
+/// "https://host/segment/segment/123456", without the scheme, or only "segment/123456" (fits inline).
+static std::vector<u8> make_urls(Shape shape, std::vector<ConstBuffer> & keys) {
+    std::vector<u8> arena;
+    std::vector<usize> sizes;
+    u64 state = 0x9E3779B97F4A7C15;
+    for(usize i = 0; i < KEYS; ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+
+        std::string url;
+        if(shape == Shape::path_tail) {
+            url = std::string(SEGMENTS[(state >> 8) % 16]).substr(0, 5);
+        } else {
+            url = (shape == Shape::url) ? "https://" : "";
+            url += HOSTS[state % 8];
+            for(usize j = 0; j < 1 + (state >> 3) % 3; ++j) {
+                url += '/';
+                url += SEGMENTS[(state >> (8 + j * 4)) % 16];
+            }
+        }
+        url += '/';
+        url += std::to_string((state >> 24) % 1'000'000);
+
+        arena.insert(arena.end(), url.begin(), url.end());
+        sizes.push_back(url.size());
+    }
+
+    keys.clear();
+    usize offset = 0;
+    for(const usize size : sizes) {
+        keys.emplace_back(arena.data() + offset, size);
+        offset += size;
+    }
+    return arena;
+}
+
+static void sort(const char * name, const std::vector<ConstBuffer> & keys) {
+    std::vector<ConstBuffer> plain = keys;
+    u64 start = now_ns();
+    std::sort(plain.begin(), plain.end(), [](ConstBuffer left, ConstBuffer right) {
+        return std::lexicographical_compare(left.data, left.data + left.size, right.data, right.data + right.size);
+    });
+    const u64 plain_elapsed = now_ns() - start;
+
+    std::vector<KeyBuffer> german;
+    german.reserve(keys.size());
+    for(const ConstBuffer key : keys) {
+        german.emplace_back(key);
+    }
+    start = now_ns();
+    std::sort(german.begin(), german.end());
+    const u64 german_elapsed = now_ns() - start;
+
+    for(usize i = 0; i < keys.size(); i += keys.size() / 16) {
+        if(not equal(plain[i], german[i])) {
+            std::printf("  MISMATCH at %lu\n", i);
+        }
+    }
+
+    std::printf("  %-44s ConstBuffer %7.0f ms   KeyBuffer %7.0f ms\n", name, double(plain_elapsed) / 1e6, double(german_elapsed) / 1e6);
+}
+
+void bench_key_buffer() {
+    std::vector<ConstBuffer> keys;
+
+    const std::vector<u8> urls = make_urls(Shape::url, keys);
+    sort("sort 10M urls", keys);
+
+    const std::vector<u8> hosts = make_urls(Shape::url_without_scheme, keys);
+    sort("sort 10M urls without scheme", keys);
+
+    const std::vector<u8> tails = make_urls(Shape::path_tail, keys);
+    sort("sort 10M path tails (<= 12 bytes)", keys);
+}
+
+}
@@ -0,0 +1,96 @@
+#include "benchmarks/bench.h"
+
+#include <cstring>
+#include <thread>
+
+namespace sedfer::bench {
+
+static constexpr usize SIZES[] = {usize(8) << 20, usize(64) << 20, usize(256) << 20};
+static constexpr usize HOT_SIZE = usize(1) << 20;
+static constexpr usize LOOKUPS = 1 << 20;
+
+/// \brief Cache-sensitive workload: dependent random reads in a 1 MiB table, ns per lookup.
+static double hot_lookups(const std::vector<u32> & table) {
+    const u64 start = now_ns();
+    u32 index = 0;
+    for(usize i = 0; i < LOOKUPS; ++i) {
+        index = table[index];
+    }
+    keep(index);
+    return double(now_ns() - start) / double(LOOKUPS);
+}
+
+/// \brief Alternate a copy with the hot workload, report the workload's latency right after the copy.
+template<typename F>
+static void co_run(const char * name, const std::vector<u32> & table, F copy) {
+    double total = 0;
+    static constexpr usize ROUNDS = 16;
+    for(usize round = 0; round < ROUNDS; ++round) {
+        copy();
+        total += hot_lookups(table);
+    }
+    std::printf("  %-48s %9.2f ns/lookup\n", name, total / ROUNDS);
+}
+
+void bench_large_copy() {
+    const usize threads = std::max(1u, std::thread::hardware_concurrency());
+    CopyPool pool(threads);
+
+    for(const usize size : SIZES) {
+        std::vector<u8> source(size, 'x');
+        std::vector<u8> destination(size, 'y');
+        char name[64];
+
+        std::snprintf(name, sizeof(name), "memcpy %lu MiB", size >> 20);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                std::memcpy(destination.data(), source.data(), size);
+                keep(destination.data());
+            }
+        });
+        std::snprintf(name, sizeof(name), "copy_streaming %lu MiB", size >> 20);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                kernels::copy_streaming(destination.data(), source.data(), size);
+                keep(destination.data());
+            }
+        });
+        std::snprintf(name, sizeof(name), "CopyPool (%lu threads) %lu MiB", threads, size >> 20);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                pool.copy(destination.data(), source.data(), size);
+                keep(destination.data());
+            }
+        });
+    }
+
+    // Random cycle through the hot table: every lookup depends on the previous one.
+    std::vector<u32> table(HOT_SIZE / sizeof(u32));
+    std::vector<u32> order(table.size());
+    for(usize i = 0; i < order.size(); ++i) {
+        order[i] = u32(i);
+    }
+    u64 state = 0x9E3779B97F4A7C15;
+    for(usize i = order.size() - 1; i > 0; --i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        std::swap(order[i], order[state % (i + 1)]);
+    }
+    for(usize i = 0; i < order.size(); ++i) {
+        table[order[i]] = order[(i + 1) % order.size()];
+    }
+
+    const usize size = usize(64) << 20;
+    std::vector<u8> source(size, 'x');
+    std::vector<u8> destination(size, 'y');
+    co_run("hot lookups alone", table, [] {});
+    co_run("hot lookups after memcpy 64 MiB", table, [&] {
+        std::memcpy(destination.data(), source.data(), size);
+    });
+    co_run("hot lookups after copy_streaming 64 MiB", table, [&] {
+        kernels::copy_streaming(destination.data(), source.data(), size);
+    });
+}
+
+}
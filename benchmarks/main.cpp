@@ -0,0 +1,77 @@
+#include "benchmarks/bench.h"
+
+#include <cstring>
+
+namespace sedfer::bench {
+
+void bench_base64();
+void bench_bitwise();
+void bench_compact_buffer();
+void bench_compare();
+void bench_copy();
+void bench_crc32c();
+void bench_decimal();
+void bench_direct_file();
+void bench_fill();
+void bench_hash();
+void bench_hex();
+void bench_inet_checksum();
+void bench_key_buffer();
+void bench_large_copy();
+void bench_pattern_set();
+void bench_region();
+void bench_search();
+void bench_split();
+void bench_statistics();
+void bench_substring();
+void bench_translate();
+void bench_utf8();
+
+struct Entry {
+    const char * name;
+    void (* run)();
+};
+
+static constexpr Entry ENTRIES[] = {
+    {"base64", bench_base64},
+    {"bitwise", bench_bitwise},
+    {"compact_buffer", bench_compact_buffer},
+    {"compare", bench_compare},
+    {"copy", bench_copy},
+    {"crc32c", bench_crc32c},
+    {"decimal", bench_decimal},
+    {"direct_file", bench_direct_file},
+    {"fill", bench_fill},
+    {"hash", bench_hash},
+    {"hex", bench_hex},
+    {"inet_checksum", bench_inet_checksum},
+    {"key_buffer", bench_key_buffer},
+    {"large_copy", bench_large_copy},
+    {"pattern_set", bench_pattern_set},
+    {"region", bench_region},
+    {"search", bench_search},
+    {"split", bench_split},
+    {"statistics", bench_statistics},
+    {"substring", bench_substring},
+    {"translate", bench_translate},
+    {"utf8", bench_utf8},
+};
+
+}
+
+/// Usage: [SEDFER_CPU_TIER=sse2] benchmarks [name...] (all benchmarks if no names given)
+int main(int argc, char ** argv) {
+    std::printf("cpu tier: %s\n", sedfer::cpu_tier_name(sedfer::cpu_tier()));
+    for(const sedfer::bench::Entry & entry : sedfer::bench::ENTRIES) {
+        bool selected = (argc == 1);
+        for(int i = 1; i < argc; ++i) {
+            selected = selected || std::strcmp(argv[i], entry.name) == 0;
+        }
+        if(selected) {
+            std::printf("%s\n", entry.name);
+            entry.run();
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,80 @@
+#include "benchmarks/bench.h"
+
+#include <random>
+#include <string>
+
+namespace sedfer::bench {
+
+static constexpr usize PAYLOAD_SIZE = usize(4) << 20;
+static constexpr usize PATTERN_COUNTS[] = {10, 30, 100, 300, 1000};
+
+/// Payload: printable text with some binary bytes. Signatures: 6-16 random printable bytes (rarely occur).
+void bench_pattern_set() {
+    std::mt19937_64 random(42);
+    std::string payload(PAYLOAD_SIZE, '\0');
+    for(char & c : payload) {
+        c = (random() % 16 == 0) ? char(random() % 256) : char(' ' + random() % 95);
+    }
+    const ConstBuffer buffer(reinterpret_cast<const u8 *>(payload.data()), payload.size());
+
+    for(const usize count : PATTERN_COUNTS) {
+        std::vector<std::string> signatures(count);
+        std::vector<ConstBuffer> patterns;
+        for(std::string & signature : signatures) {
+            const usize size = 6 + random() % 11;
+            for(usize i = 0; i < size; ++i) {
+                signature.push_back(char(' ' + random() % 95));
+            }
+            // A few signatures occur in the payload.
+            if(random() % 8 == 0) {
+                payload.replace(random() % (payload.size() - size), size, signature);
+            }
+            patterns.emplace_back(reinterpret_cast<const u8 *>(signature.data()), signature.size());
+        }
+        char name[64];
+
+        std::snprintf(name, sizeof(name), "find per pattern, %lu patterns", count);
+        throughput(name, buffer.size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                for(const ConstBuffer pattern : patterns) {
+                    for(ConstBuffer rest = buffer; (rest = rest.find(pattern)).data != nullptr; (void)rest.skip(1)) {
+                        keep(rest.data);
+                    }
+                }
+            }
+        });
+
+        for(const PatternEngine engine : {PatternEngine::teddy, PatternEngine::automaton}) {
+            const PatternSet set(patterns, engine);
+            if(set.engine() != engine) {
+                continue;
+            }
+            std::snprintf(name, sizeof(name), "PatternSet %s, %lu patterns", engine == PatternEngine::teddy ? "teddy" : "automaton", count);
+            throughput(name, buffer.size, [&](usize iterations) {
+                for(usize i = 0; i < iterations; ++i) {
+                    (void)set.scan(buffer, [](PatternMatch match) {
+                        keep(match.offset);
+                        return true;
+                    });
+                }
+            });
+        }
+
+        const PatternSet set(patterns);
+        PatternSet::Stream stream = set.stream();
+        std::snprintf(name, sizeof(name), "PatternSet stream (1500 B pieces), %lu patterns", count);
+        throughput(name, buffer.size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                for(ConstBuffer rest = buffer; rest.size != 0;) {
+                    const ConstBuffer piece = rest.pop_buffer(std::min<usize>(rest.size, 1500));
+                    (void)stream.scan(piece, [](PatternMatch match) {
+                        keep(match.offset);
+                        return true;
+                    });
+                }
+            }
+        });
+    }
+}
+
+}
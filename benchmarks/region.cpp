@@ -0,0 +1,110 @@
+#include "benchmarks/bench.h"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace sedfer::bench {
+
+static constexpr usize BUFFER_SIZE = usize(1) << 20;
+static constexpr usize ITERATIONS = 2000;
+
+static const char * backing_name(RegionBacking backing) {
+    switch(backing) {
+        case RegionBacking::none: return "none";
+        case RegionBacking::normal: return "normal";
+        case RegionBacking::transparent_huge: return "transparent_huge";
+        case RegionBacking::huge_tlb: return "huge_tlb";
+    }
+    return "?";
+}
+
+static void report(const char * name, Latency & latency, u64 faults) {
+    std::printf("  %-44s faults/iter %8.1f   p50 %8lu ns   p99 %8lu ns   p99.9 %8lu ns   max %8lu ns\n",
+                name,
+                double(faults) / double(ITERATIONS),
+                latency.percentile(50),
+                latency.percentile(99),
+                latency.percentile(99.9),
+                latency.percentile(100));
+}
+
+/// Fresh receive buffer per message, filled completely (first touch of every page).
+static void malloc_buffers() {
+    Latency latency;
+    const u64 faults_before = page_faults();
+
+    for(usize i = 0; i < ITERATIONS; ++i) {
+        const u64 start = now_ns();
+        u8 * const data = static_cast<u8 *>(std::malloc(BUFFER_SIZE));
+        std::memset(data, int(i), BUFFER_SIZE);
+        keep(data[BUFFER_SIZE / 2]);
+        std::free(data);
+        latency.add(now_ns() - start);
+    }
+
+    report("malloc", latency, page_faults() - faults_before);
+}
+
+static void region_buffers(const char * name, RegionOptions options) {
+    Region region(BUFFER_SIZE, options);
+    if(region.backing() == RegionBacking::none) {
+        std::printf("  %-44s mapping failed\n", name);
+        return;
+    }
+
+    Latency latency;
+    const u64 faults_before = page_faults();
+
+    for(usize i = 0; i < ITERATIONS; ++i) {
+        const u64 start = now_ns();
+        region.reset();
+        const MutableBuffer buffer = region.allocate(BUFFER_SIZE);
+        std::memset(buffer.data, int(i), buffer.size);
+        keep(buffer.data[BUFFER_SIZE / 2]);
+        latency.add(now_ns() - start);
+    }
+
+    char full_name[128];
+    std::snprintf(full_name, sizeof(full_name), "%s (%s%s)", name, backing_name(region.backing()), region.locked() ? ", locked" : "");
+    report(full_name, latency, page_faults() - faults_before);
+}
+
+/// Random 8-byte reads over a large buffer, sensitive to TLB reach.
+static void random_reads(const char * name, RegionOptions options) {
+    static constexpr usize SIZE = usize(256) << 20;
+    static constexpr usize READS = usize(1) << 24;
+
+    Region region(SIZE, options);
+    if(region.backing() == RegionBacking::none) {
+        std::printf("  %-44s mapping failed\n", name);
+        return;
+    }
+
+    const MutableBuffer buffer = region.buffer();
+    u64 state = 0x9E3779B97F4A7C15;
+    u64 sum = 0;
+
+    const u64 start = now_ns();
+    for(usize i = 0; i < READS; ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        sum += buffer.data[state % SIZE];
+    }
+    const u64 elapsed = now_ns() - start;
+    keep(sum);
+
+    std::printf("  %-44s %8.2f ns/read (%s)\n", name, double(elapsed) / double(READS), backing_name(region.backing()));
+}
+
+void bench_region() {
+    malloc_buffers();
+    region_buffers("region 4k", {.huge_pages = false, .populate = true, .lock = false});
+    region_buffers("region 2M", {.huge_pages = true, .populate = true, .lock = false});
+    region_buffers("region 2M locked", {.huge_pages = true, .populate = true, .lock = true});
+
+    random_reads("random reads 4k", {.huge_pages = false, .populate = true, .lock = false});
+    random_reads("random reads 2M", {.huge_pages = true, .populate = true, .lock = false});
+}
+
+}
@@ -0,0 +1,82 @@
+#include "benchmarks/bench.h"
+
+#include <cstring>
+
+namespace sedfer::bench {
+
+static constexpr usize SIZES[] = {16, 64, 256, 4096, usize(1) << 20};
+
+/// Text without the searched bytes, terminated with '\0' for strpbrk/strspn.
+static std::vector<u8> make_text(usize size) {
+    std::vector<u8> text(size + 1);
+    for(usize i = 0; i < size; ++i) {
+        text[i] = u8('a' + i % 26);
+    }
+    text[size] = 0;
+    return text;
+}
+
+void bench_search() {
+    static constexpr ByteSet DELIMITERS(",;:|\n");
+    static constexpr ByteSet LETTERS("abcdefghijklmnopqrstuvwxyz");
+
+    for(const usize size : SIZES) {
+        std::vector<u8> text = make_text(size);
+        const ConstBuffer buffer(text.data(), size);
+        char name[64];
+
+        std::snprintf(name, sizeof(name), "memchr %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(std::memchr(buffer.data, '\n', buffer.size));
+            }
+        });
+        std::snprintf(name, sizeof(name), "find %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(buffer.find('\n').data);
+            }
+        });
+
+        std::snprintf(name, sizeof(name), "memrchr %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(memrchr(buffer.data, '\n', buffer.size));
+            }
+        });
+        std::snprintf(name, sizeof(name), "find_last %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(buffer.find_last('\n').data);
+            }
+        });
+
+        std::snprintf(name, sizeof(name), "strpbrk (5 bytes) %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(std::strpbrk(reinterpret_cast<const char *>(buffer.data), ",;:|\n"));
+            }
+        });
+        std::snprintf(name, sizeof(name), "find_first_of (5 bytes) %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(buffer.find_first_of(DELIMITERS).data);
+            }
+        });
+
+        std::snprintf(name, sizeof(name), "strspn (26 bytes) %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(std::strspn(reinterpret_cast<const char *>(buffer.data), "abcdefghijklmnopqrstuvwxyz"));
+            }
+        });
+        std::snprintf(name, sizeof(name), "find_first_not_of (26 bytes) %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(buffer.find_first_not_of(LETTERS).data);
+            }
+        });
+    }
+}
+
+}
@@ -0,0 +1,99 @@
+#include "benchmarks/bench.h"
+
+#include <ranges>
+#include <string_view>
+
+namespace sedfer::bench {
+
+/// Random printable text of size bytes with a delimiter every average_piece bytes on average.
+static std::vector<u8> random_text(usize size, usize average_piece, u8 delimiter) {
+    std::vector<u8> ret(size);
+    for(u8 & byte : ret) {
+        byte = (usize(rand()) % average_piece == 0) ? delimiter : u8('!' + rand() % 94);
+    }
+    return ret;
+}
+
+void bench_split() {
+    static constexpr usize SIZE = usize(16) << 20;
+    for(const usize average_piece : {8, 80, 1000}) {
+        const std::vector<u8> text = random_text(SIZE, average_piece, '\n');
+        const ConstBuffer input(text.data(), text.size());
+        char name[64];
+
+        // Find each delimiter from scratch, collect pieces.
+        std::snprintf(name, sizeof(name), "pop_until + vector %lu", average_piece);
+        throughput(name, SIZE, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(input);
+                std::vector<ConstBuffer> pieces;
+                ConstBuffer rest = input;
+                for(ConstBuffer piece = rest.pop_until('\n'); piece.data != nullptr; piece = rest.pop_until('\n')) {
+                    pieces.push_back(piece);
+                }
+                pieces.push_back(rest);
+                keep(pieces.data());
+            }
+        });
+        std::snprintf(name, sizeof(name), "pop_until %lu", average_piece);
+        throughput(name, SIZE, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(input);
+                ConstBuffer rest = input;
+                usize total = 0;
+                for(ConstBuffer piece = rest.pop_until('\n'); piece.data != nullptr; piece = rest.pop_until('\n')) {
+                    total += piece.size;
+                }
+                keep(total);
+            }
+        });
+        std::snprintf(name, sizeof(name), "std::views::split %lu", average_piece);
+        throughput(name, SIZE, [&](usize iterations) {
+            const std::string_view view(reinterpret_cast<const char *>(text.data()), text.size());
+            for(usize i = 0; i < iterations; ++i) {
+                keep(input);
+                usize total = 0;
+                for(const auto piece : std::views::split(view, '\n')) {
+                    total += usize(std::ranges::distance(piece));
+                }
+                keep(total);
+            }
+        });
+        std::snprintf(name, sizeof(name), "split %lu", average_piece);
+        throughput(name, SIZE, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(input);
+                usize total = 0;
+                for(const ConstBuffer piece : split(input, '\n')) {
+                    total += piece.size;
+                }
+                keep(total);
+            }
+        });
+        std::snprintf(name, sizeof(name), "lines %lu", average_piece);
+        throughput(name, SIZE, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(input);
+                usize total = 0;
+                for(const ConstBuffer piece : lines(input)) {
+                    total += piece.size;
+                }
+                keep(total);
+            }
+        });
+        static constexpr ByteSet SEPARATORS("\n,;");
+        std::snprintf(name, sizeof(name), "split_any %lu", average_piece);
+        throughput(name, SIZE, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(input);
+                usize total = 0;
+                for(const ConstBuffer piece : split_any(input, SEPARATORS)) {
+                    total += piece.size;
+                }
+                keep(total);
+            }
+        });
+    }
+}
+
+}
@@ -0,0 +1,92 @@
+#include "benchmarks/bench.h"
+
+namespace sedfer::bench {
+
+static constexpr usize SIZES[] = {64, 1500, 64 * 1024, usize(16) << 20};
+
+void bench_statistics() {
+    for(const usize size : SIZES) {
+        std::vector<u8> bytes(size);
+        for(usize i = 0; i < size; ++i) {
+            // Text-like input: a small alphabet with long runs is the worst case for a single table.
+            bytes[i] = (i % 64 < 48) ? ' ' : u8('a' + rand() % 26);
+        }
+        const ConstBuffer buffer(bytes.data(), size);
+        char name[64];
+
+        std::snprintf(name, sizeof(name), "loop histogram %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(buffer);
+                ByteHistogram table = {};
+                for(usize j = 0; j < buffer.size; ++j) {
+                    ++table[buffer.data[j]];
+                }
+                keep(table);
+            }
+        });
+        std::snprintf(name, sizeof(name), "histogram %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(buffer);
+                const ByteHistogram table = histogram(buffer);
+                keep(table);
+            }
+        });
+        std::snprintf(name, sizeof(name), "byte_stats %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(buffer);
+                const ByteStats stats = byte_stats(buffer);
+                keep(stats.entropy);
+            }
+        });
+
+        std::snprintf(name, sizeof(name), "std::count %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(buffer);
+                keep(std::count(buffer.data, buffer.data + buffer.size, u8(' ')));
+            }
+        });
+        std::snprintf(name, sizeof(name), "count %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(buffer);
+                keep(buffer.count(u8(' ')));
+            }
+        });
+
+        std::snprintf(name, sizeof(name), "loop popcount %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(buffer);
+                usize ret = 0;
+                for(usize j = 0; j < buffer.size; ++j) {
+                    ret += std::popcount(buffer.data[j]);
+                }
+                keep(ret);
+            }
+        });
+#if defined(__x86_64__) || defined(__i386__)
+        if(cpu_tier() >= CpuTier::sse42) {
+            std::snprintf(name, sizeof(name), "sse42::popcount %lu", size);
+            throughput(name, size, [&](usize iterations) {
+                for(usize i = 0; i < iterations; ++i) {
+                    keep(buffer);
+                    keep(kernels::sse42::popcount(buffer.data, buffer.size));
+                }
+            });
+        }
+#endif
+        std::snprintf(name, sizeof(name), "popcount %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(buffer);
+                keep(popcount(buffer));
+            }
+        });
+    }
+}
+
+}
@@ -0,0 +1,104 @@
+#include "benchmarks/bench.h"
+
+#include <cstring>
+#include <random>
+#include <string>
+
+namespace sedfer::bench {
+
+static constexpr usize TEXT_SIZE = usize(16) << 20;
+static constexpr usize NEEDLE_SIZES[] = {2, 4, 8, 16, 32, 64, 256};
+
+/// Log-like text: random lowercase words and spaces, lines end with '\n'.
+static std::string make_text(usize size, std::mt19937_64 & random) {
+    std::string text;
+    text.reserve(size);
+    while(text.size() < size) {
+        const usize word = 2 + random() % 8;
+        for(usize i = 0; i < word && text.size() < size; ++i) {
+            text.push_back(char('a' + random() % 26));
+        }
+        if(text.size() < size) {
+            text.push_back(random() % 10 == 0 ? '\n' : ' ');
+        }
+    }
+    return text;
+}
+
+/// Needle that is not in the text but shares its first and last byte with many text positions (worst case).
+static std::string make_needle(usize size, std::mt19937_64 & random) {
+    std::string needle;
+    for(usize i = 0; i < size; ++i) {
+        needle.push_back(char('a' + random() % 26));
+    }
+    needle[size / 2] = '#';
+    return needle;
+}
+
+void bench_substring() {
+    std::mt19937_64 random(42);
+    const std::string text = make_text(TEXT_SIZE, random);
+    const ConstBuffer buffer(reinterpret_cast<const u8 *>(text.data()), text.size());
+
+    for(const usize needle_size : NEEDLE_SIZES) {
+        const std::string needle = make_needle(needle_size, random);
+        const ConstBuffer needle_buffer(reinterpret_cast<const u8 *>(needle.data()), needle.size());
+        char name[64];
+
+        std::snprintf(name, sizeof(name), "memmem needle %lu", needle_size);
+        throughput(name, buffer.size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(memmem(buffer.data, buffer.size, needle_buffer.data, needle_buffer.size));
+            }
+        });
+        std::snprintf(name, sizeof(name), "find needle %lu", needle_size);
+        throughput(name, buffer.size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(buffer.find(needle_buffer).data);
+            }
+        });
+        std::snprintf(name, sizeof(name), "find_last needle %lu", needle_size);
+        throughput(name, buffer.size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(buffer.find_last(needle_buffer).data);
+            }
+        });
+    }
+
+    // Many small haystacks (records), same needle: preprocessing is amortized by Finder.
+    static constexpr usize RECORD_SIZE = 256;
+    for(const usize needle_size : {usize(8), usize(64)}) {
+        const std::string needle = make_needle(needle_size, random);
+        const ConstBuffer needle_buffer(reinterpret_cast<const u8 *>(needle.data()), needle.size());
+        const Finder finder(needle_buffer);
+        const usize records = buffer.size / RECORD_SIZE;
+        char name[64];
+
+        std::snprintf(name, sizeof(name), "memmem %lu B records, needle %lu", RECORD_SIZE, needle_size);
+        throughput(name, records * RECORD_SIZE, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                for(usize r = 0; r < records; ++r) {
+                    keep(memmem(buffer.data + r * RECORD_SIZE, RECORD_SIZE, needle_buffer.data, needle_buffer.size));
+                }
+            }
+        });
+        std::snprintf(name, sizeof(name), "find %lu B records, needle %lu", RECORD_SIZE, needle_size);
+        throughput(name, records * RECORD_SIZE, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                for(usize r = 0; r < records; ++r) {
+                    keep(ConstBuffer(buffer.data + r * RECORD_SIZE, RECORD_SIZE).find(needle_buffer).data);
+                }
+            }
+        });
+        std::snprintf(name, sizeof(name), "Finder %lu B records, needle %lu", RECORD_SIZE, needle_size);
+        throughput(name, records * RECORD_SIZE, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                for(usize r = 0; r < records; ++r) {
+                    keep(finder.find({buffer.data + r * RECORD_SIZE, RECORD_SIZE}).data);
+                }
+            }
+        });
+    }
+}
+
+}
@@ -0,0 +1,84 @@
+#include "benchmarks/bench.h"
+
+#include <cctype>
+
+namespace sedfer::bench {
+
+static constexpr usize SIZES[] = {16, 1500, 64 * 1024, usize(16) << 20};
+
+void bench_translate() {
+    ByteMap map;
+    for(usize i = 0; i < 256; ++i) {
+        map.set(u8(i), u8(255 - i));
+    }
+    for(const usize size : SIZES) {
+        std::vector<u8> text(size);
+        for(u8 & byte : text) {
+            byte = u8(' ' + rand() % 95);
+        }
+        std::vector<u8> copy(size);
+        const ConstBuffer input(text.data(), size);
+        const MutableBuffer output(copy.data(), size);
+        char name[64];
+
+        // Byte at a time through the C library.
+        std::snprintf(name, sizeof(name), "std::tolower %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(input);
+                for(usize j = 0; j < size; ++j) {
+                    copy[j] = u8(std::tolower(text[j]));
+                }
+                keep(copy.data());
+            }
+        });
+        std::snprintf(name, sizeof(name), "scalar::change_case %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(input);
+                kernels::scalar::change_case<false>(copy.data(), text.data(), size);
+                keep(copy.data());
+            }
+        });
+        std::snprintf(name, sizeof(name), "to_lower %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(input);
+                keep(to_lower(output, input));
+            }
+        });
+
+        std::snprintf(name, sizeof(name), "strncasecmp %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(input);
+                keep(strncasecmp(reinterpret_cast<const char *>(text.data()), reinterpret_cast<const char *>(copy.data()), size));
+            }
+        });
+        std::snprintf(name, sizeof(name), "equal_icase %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(input);
+                keep(equal_icase(input, output));
+            }
+        });
+
+        std::snprintf(name, sizeof(name), "scalar::translate %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(input);
+                kernels::scalar::translate(copy.data(), text.data(), size, map);
+                keep(copy.data());
+            }
+        });
+        std::snprintf(name, sizeof(name), "translate %lu", size);
+        throughput(name, size, [&](usize iterations) {
+            for(usize i = 0; i < iterations; ++i) {
+                keep(input);
+                keep(translate(output, input, map));
+            }
+        });
+    }
+}
+
+}
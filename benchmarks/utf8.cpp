@@ -0,0 +1,83 @@
+#include "benchmarks/bench.h"
+
+namespace sedfer::bench {
+
+static constexpr usize SIZES[] = {64, 1500, 64 * 1024, usize(16) << 20};
+
+/// Random valid UTF-8 of at least size bytes, ascii_percent % ASCII code points, the rest 2- and 3-byte.
+static std::vector<u8> random_utf8(usize size, u32 ascii_percent) {
+    std::vector<u8> ret(size + 4);
+    u8 * out = ret.data();
+    while(out < ret.data() + size) {
+        u32 code_point = u32(rand()) % 0x80;
+        if(u32(rand()) % 100 >= ascii_percent) {
+            code_point = (rand() & 1) ? 0x80 + u32(rand()) % 0x780 : 0x800 + u32(rand()) % 0xd000;
+        }
+        out = kernels::utf8_encode(out, code_point);
+    }
+    ret.resize(usize(out - ret.data()));
+    return ret;
+}
+
+void bench_utf8() {
+    for(const u32 ascii_percent : {100u, 90u, 0u}) {
+        for(const usize size : SIZES) {
+            const std::vector<u8> text = random_utf8(size, ascii_percent);
+            const ConstBuffer input(text.data(), text.size());
+            std::vector<u8> utf16(2 * text.size());
+            char name[64];
+
+            std::snprintf(name, sizeof(name), "scalar::utf8_validate %u%% %lu", ascii_percent, size);
+            throughput(name, input.size, [&](usize iterations) {
+                for(usize i = 0; i < iterations; ++i) {
+                    keep(input);
+                    keep(kernels::scalar::utf8_validate(input.data, input.size));
+                }
+            });
+            std::snprintf(name, sizeof(name), "utf8_validate %u%% %lu", ascii_percent, size);
+            throughput(name, input.size, [&](usize iterations) {
+                for(usize i = 0; i < iterations; ++i) {
+                    keep(input);
+                    keep(utf8_validate(input));
+                }
+            });
+            // Validate, size and transcode with the scalar kernels.
+            std::snprintf(name, sizeof(name), "scalar::utf8_to_utf16 %u%% %lu", ascii_percent, size);
+            throughput(name, input.size, [&](usize iterations) {
+                for(usize i = 0; i < iterations; ++i) {
+                    keep(input);
+                    if(kernels::scalar::utf8_validate(input.data, input.size) &&
+                       2 * kernels::scalar::utf8_utf16_units(input.data, input.size) <= utf16.size()) {
+                        keep(kernels::scalar::utf8_to_utf16(input.data, input.size, utf16.data()));
+                    }
+                }
+            });
+            std::snprintf(name, sizeof(name), "utf8_to_utf16 %u%% %lu", ascii_percent, size);
+            throughput(name, input.size, [&](usize iterations) {
+                for(usize i = 0; i < iterations; ++i) {
+                    keep(input);
+                    MutableBuffer output(utf16.data(), utf16.size());
+                    keep(utf8_to_utf16(input, output));
+                }
+            });
+            if(ascii_percent == 100) {
+                std::snprintf(name, sizeof(name), "scalar::is_ascii %lu", size);
+                throughput(name, input.size, [&](usize iterations) {
+                    for(usize i = 0; i < iterations; ++i) {
+                        keep(input);
+                        keep(kernels::scalar::is_ascii(input.data, input.size));
+                    }
+                });
+                std::snprintf(name, sizeof(name), "is_ascii %lu", size);
+                throughput(name, input.size, [&](usize iterations) {
+                    for(usize i = 0; i < iterations; ++i) {
+                        keep(input);
+                        keep(is_ascii(input));
+                    }
+                });
+            }
+        }
+    }
+}
+
+}
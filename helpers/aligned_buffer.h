@@ -0,0 +1,174 @@
+#pragma once
+
+#include "helpers/buffer.h"
+#include "helpers/types.h"
+
+#include <bit>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+
+namespace sedfer {
+
+/**
+ * \brief AlignedBuffer is a MutableBuffer whose address and size are multiples of A.
+ *
+ * Useful for O_DIRECT I/O (4 KiB) and SIMD kernels (32/64 bytes). All sub-buffer operations accept
+ * only multiples of A, so alignment is preserved by construction and never has to be re-checked by the user.
+ * \code
+ * AlignedStorage<4096> storage(1 << 20);
+ * AlignedBuffer<4096> buffer = storage.buffer();
+ *
+ * AlignedBuffer<4096> header = buffer.pop_buffer(4096);  // OK
+ * AlignedBuffer<4096> bad = buffer.pop_buffer(100);      // {nullptr, 0}, buffer is unaffected
+ * AlignedBuffer<512> weaker = header;                    // OK, 4096-aligned is also 512-aligned
+ * MutableBuffer plain = header;                          // OK
+ * \endcode
+ * \note Create from unchecked memory with from(). Setting data/size directly bypasses the check.
+ */
+template<usize A>
+struct AlignedBuffer {
+    static_assert(std::has_single_bit(A), "alignment must be a power of 2");
+
+    static constexpr usize ALIGNMENT = A;
+
+    u8 * data = nullptr;
+    usize size = 0;
+
+    /// \brief true if both _data and _size are multiples of A.
+    [[nodiscard, gnu::always_inline]] static inline bool is_aligned(const void * _data, usize _size) {
+        return ((reinterpret_cast<uintptr_t>(_data) | _size) & (A - 1)) == 0;
+    }
+
+    /**
+     * \brief Check alignment of mutable_buffer.
+     * \return Valid buffer if OK, {nullptr, 0} if mutable_buffer.data or mutable_buffer.size is not a multiple of A.
+     */
+    [[nodiscard, gnu::always_inline]] static inline AlignedBuffer from(MutableBuffer mutable_buffer) {
+        if(not is_aligned(mutable_buffer.data, mutable_buffer.size)) {
+            return {};
+        }
+        return {mutable_buffer.data, mutable_buffer.size};
+    }
+
+    // NOLINTNEXTLINE(google-explicit-constructor)
+    [[gnu::always_inline]] inline operator MutableBuffer() const {
+        return {data, size};
+    }
+
+    // NOLINTNEXTLINE(google-explicit-constructor)
+    [[gnu::always_inline]] inline operator ConstBuffer() const {
+        return {data, size};
+    }
+
+    /// \brief Weaken alignment (A is a multiple of B).
+    template<usize B>
+        requires (B < A)
+    // NOLINTNEXTLINE(google-explicit-constructor)
+    [[gnu::always_inline]] inline operator AlignedBuffer<B>() const {
+        return {data, size};
+    }
+
+    /**
+     * \brief Get first _size bytes as sub-buffer. Current buffer is unaffected.
+     * \return Valid buffer if OK, {nullptr, 0} if _size > this.size or _size is not a multiple of A.
+     */
+    [[nodiscard, gnu::always_inline]] inline AlignedBuffer peek_buffer(usize _size) const {
+        if(size < _size || (_size & (A - 1)) != 0) {
+            return {};
+        }
+        return {data, _size};
+    }
+
+    /**
+     * \brief Get last _size bytes as sub-buffer. Current buffer is unaffected.
+     * \return Valid buffer if OK, {nullptr, 0} if _size > this.size or _size is not a multiple of A.
+     */
+    [[nodiscard, gnu::always_inline]] inline AlignedBuffer peek_buffer_back(usize _size) const {
+        if(size < _size || (_size & (A - 1)) != 0) {
+            return {};
+        }
+        return {data + size - _size, _size};
+    }
+
+    /**
+     * \brief Skip first _size bytes (.data and .size are adjusted).
+     * \return true if OK, false if _size > this.size or _size is not a multiple of A.
+     */
+    [[nodiscard, gnu::always_inline]] inline bool skip(usize _size) {
+        if(size < _size || (_size & (A - 1)) != 0) {
+            return false;
+        }
+        data += _size;
+        size -= _size;
+        return true;
+    }
+
+    /**
+     * \brief Skip last _size bytes (.data and .size are adjusted).
+     * \return true if OK, false if _size > this.size or _size is not a multiple of A.
+     */
+    [[nodiscard, gnu::always_inline]] inline bool skip_back(usize _size) {
+        if(size < _size || (_size & (A - 1)) != 0) {
+            return false;
+        }
+        size -= _size;
+        return true;
+    }
+
+    /**
+     * \brief Get first _size bytes as sub-buffer. Read bytes are consumed (.data and .size are adjusted).
+     * \return Valid buffer if OK, {nullptr, 0} if _size > this.size or _size is not a multiple of A.
+     */
+    [[nodiscard, gnu::always_inline]] inline AlignedBuffer pop_buffer(usize _size) {
+        const AlignedBuffer ret = peek_buffer(_size);
+        (void)skip(_size);
+        return ret;
+    }
+
+    /**
+     * \brief Get last _size bytes as sub-buffer. Read bytes are consumed (.data and .size are adjusted).
+     * \return Valid buffer if OK, {nullptr, 0} if _size > this.size or _size is not a multiple of A.
+     */
+    [[nodiscard, gnu::always_inline]] inline AlignedBuffer pop_buffer_back(usize _size) {
+        const AlignedBuffer ret = peek_buffer_back(_size);
+        (void)skip_back(_size);
+        return ret;
+    }
+};
+
+/**
+ * \brief AlignedStorage owns A-aligned memory, size is rounded up to a multiple of A.
+ * \note Check buffer().data for allocation failure.
+ */
+template<usize A>
+class AlignedStorage {
+public:
+    AlignedStorage() = default;
+
+    explicit AlignedStorage(usize _size)
+        : owner(static_cast<u8 *>(std::aligned_alloc(A, round_up(_size)))),
+          storage_size(owner ? round_up(_size) : 0)
+    { }
+
+    [[nodiscard, gnu::always_inline]] inline AlignedBuffer<A> buffer() const {
+        return {owner.get(), storage_size};
+    }
+
+    /// \brief Round _size up to a multiple of A.
+    [[nodiscard, gnu::always_inline]] static inline usize round_up(usize _size) {
+        return (_size + A - 1) & ~(A - 1);
+    }
+
+private:
+    struct Free {
+        void operator()(u8 * ptr) const {
+            std::free(ptr);
+        }
+    };
+
+    std::unique_ptr<u8, Free> owner;
+    usize storage_size = 0;
+};
+
+}
@@ -1,5 +1,31 @@
 #pragma once
 
+#include "helpers/aligned_buffer.h"
+#include "helpers/base64.h"
+#include "helpers/bitwise.h"
 #include "helpers/buffer.h"
+#include "helpers/compact_buffer.h"
+#include "helpers/compare.h"
+#include "helpers/copy.h"
+#include "helpers/copy_pool.h"
+#include "helpers/cpu.h"
+#include "helpers/crc32c.h"
+#include "helpers/decimal.h"
+#include "helpers/direct_file.h"
+#include "helpers/dynamic_buffer.h"
+#include "helpers/fill.h"
+#include "helpers/finder.h"
+#include "helpers/hash.h"
+#include "helpers/hex.h"
+#include "helpers/inet_checksum.h"
+#include "helpers/key_buffer.h"
 #include "helpers/packed.h"
+#include "helpers/pattern_set.h"
+#include "helpers/region.h"
+#include "helpers/search.h"
+#include "helpers/shared_buffer.h"
+#include "helpers/split.h"
+#include "helpers/statistics.h"
+#include "helpers/translate.h"
 #include "helpers/types.h"
+#include "helpers/utf8.h"
@@ -0,0 +1,337 @@
+#pragma once
+
+#include "helpers/buffer.h"
+#include "helpers/cpu.h"
+#include "helpers/types.h"
+
+#include <array>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace sedfer {
+
+/**
+ * \brief Base64 alphabets (RFC 4648).
+ *
+ * 1. standard: A-Z a-z 0-9 + /, padded with '=' to a multiple of 4 characters.
+ * 2. url: A-Z a-z 0-9 - _ (URL and file name safe), without padding.
+ */
+enum class Base64 : u8 {
+    standard,
+    url,
+};
+
+/**
+ * \brief Base64 encode / decode loops over raw pointers, for any Base64Alphabet.
+ *
+ * The AVX2 kernels follow Muła and Lemire ("Faster Base64 Encoding and Decoding Using AVX2 Instructions"):
+ * 24 input bytes are spread to 32 6-bit values with a byte shuffle and two multiplies, then mapped to characters
+ * by range (pshufb offset table). Decoding classifies characters by range, adds per-range offsets and packs
+ * 4 x 6 bits back into 3 bytes with two multiply-adds. The alphabet only changes the two characters 62 and 63.
+ */
+namespace kernels {
+
+struct Base64Alphabet {
+    /// \brief Value -> character.
+    std::array<u8, 64> chars = {};
+    /// \brief Character -> value, 0xff for characters outside the alphabet (including '=').
+    std::array<u8, 256> values = {};
+    bool padding = false;
+
+    [[nodiscard]] constexpr u8 char62() const {
+        return chars[62];
+    }
+
+    [[nodiscard]] constexpr u8 char63() const {
+        return chars[63];
+    }
+};
+
+[[nodiscard]] constexpr inline Base64Alphabet base64_alphabet(u8 char62, u8 char63, bool padding) {
+    Base64Alphabet ret;
+    for(usize i = 0; i < 26; ++i) {
+        ret.chars[i] = u8('A' + i);
+        ret.chars[26 + i] = u8('a' + i);
+    }
+    for(usize i = 0; i < 10; ++i) {
+        ret.chars[52 + i] = u8('0' + i);
+    }
+    ret.chars[62] = char62;
+    ret.chars[63] = char63;
+    ret.values.fill(0xff);
+    for(usize i = 0; i < 64; ++i) {
+        ret.values[ret.chars[i]] = u8(i);
+    }
+    ret.padding = padding;
+    return ret;
+}
+
+inline constexpr Base64Alphabet BASE64_STANDARD = base64_alphabet('+', '/', true);
+inline constexpr Base64Alphabet BASE64_URL = base64_alphabet('-', '_', false);
+
+[[nodiscard, gnu::always_inline]] constexpr inline const Base64Alphabet & base64_alphabet(Base64 variant) {
+    return (variant == Base64::url) ? BASE64_URL : BASE64_STANDARD;
+}
+
+/// \brief Characters of size encoded bytes.
+[[nodiscard, gnu::always_inline]] constexpr inline usize base64_encoded_size(usize size, bool padding) {
+    return padding ? (size + 2) / 3 * 4 : size / 3 * 4 + (size % 3 == 0 ? 0 : size % 3 + 1);
+}
+
+/// \brief Decoded bytes of size characters (valid input), padding is the number of trailing '=' characters.
+[[nodiscard, gnu::always_inline]] constexpr inline usize base64_decoded_size(usize size, usize padding) {
+    size -= padding;
+    return size / 4 * 3 + (size % 4 == 0 ? 0 : size % 4 - 1);
+}
+
+namespace scalar {
+
+/// \brief Encode size bytes into base64_encoded_size(size) characters at out.
+inline void base64_encode(const u8 * data, usize size, u8 * out, const Base64Alphabet & alphabet) {
+    const u8 * const chars = alphabet.chars.data();
+    for(; size >= 3; size -= 3, data += 3, out += 4) {
+        const u32 bits = (u32(data[0]) << 16) | (u32(data[1]) << 8) | data[2];
+        out[0] = chars[bits >> 18];
+        out[1] = chars[(bits >> 12) & 63];
+        out[2] = chars[(bits >> 6) & 63];
+        out[3] = chars[bits & 63];
+    }
+    if(size == 0) {
+        return;
+    }
+    const u32 bits = (u32(data[0]) << 16) | (size == 2 ? u32(data[1]) << 8 : 0);
+    out[0] = chars[bits >> 18];
+    out[1] = chars[(bits >> 12) & 63];
+    if(size == 2) {
+        out[2] = chars[(bits >> 6) & 63];
+    }
+    if(alphabet.padding) {
+        out[2] = (size == 2) ? out[2] : '=';
+        out[3] = '=';
+    }
+}
+
+/**
+ * \brief Decode size characters without padding (size % 4 != 1) into base64_decoded_size(size, 0) bytes at out.
+ * \return true if OK, false if a character is outside the alphabet or the unused bits of the last character are not 0.
+ */
+inline bool base64_decode(const u8 * data, usize size, u8 * out, const Base64Alphabet & alphabet) {
+    const u8 * const values = alphabet.values.data();
+    for(; size >= 4; size -= 4, data += 4, out += 3) {
+        const u32 a = values[data[0]];
+        const u32 b = values[data[1]];
+        const u32 c = values[data[2]];
+        const u32 d = values[data[3]];
+        if((a | b | c | d) & 0x80) {
+            return false;
+        }
+        const u32 bits = (a << 18) | (b << 12) | (c << 6) | d;
+        out[0] = u8(bits >> 16);
+        out[1] = u8(bits >> 8);
+        out[2] = u8(bits);
+    }
+    if(size == 0) {
+        return true;
+    }
+    if(size == 1) {
+        return false;
+    }
+    const u32 a = values[data[0]];
+    const u32 b = values[data[1]];
+    const u32 c = (size == 3) ? values[data[2]] : 0;
+    if((a | b | c) & 0x80) {
+        return false;
+    }
+    const u32 bits = (a << 18) | (b << 12) | (c << 6);
+    out[0] = u8(bits >> 16);
+    if(size == 3) {
+        out[1] = u8(bits >> 8);
+    }
+    // Canonical encoding only: bits below the last decoded byte must be 0.
+    return (bits & (size == 3 ? 0xff : 0xffff)) == 0;
+}
+
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+namespace avx2 {
+
+/// \brief 24 bytes (12 per 128-bit lane) to 32 6-bit values, one per byte.
+[[gnu::target("avx2"), gnu::always_inline]] inline __m256i base64_split(__m256i input) {
+    // Each 32-bit word gets the 3 source bytes b, a, c, b (big-endian bit order after the multiplies).
+    const __m256i in = _mm256_shuffle_epi8(input, _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+                                                                   1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+    const __m256i high = _mm256_mulhi_epu16(_mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00)), _mm256_set1_epi32(0x04000040));
+    const __m256i low = _mm256_mullo_epi16(_mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0)), _mm256_set1_epi32(0x01000010));
+    return _mm256_or_si256(high, low);
+}
+
+/// \brief 6-bit values to characters: offset per range (A-Z, a-z, 0-9, char62, char63) from a 16-entry table.
+[[gnu::target("avx2"), gnu::always_inline]] inline __m256i base64_translate(__m256i values, __m256i offsets) {
+    // Index 0 for 0 - 25, 1 for 26 - 51, 2 - 11 for 52 - 61, 12 for 62, 13 for 63.
+    __m256i indices = _mm256_subs_epu8(values, _mm256_set1_epi8(51));
+    indices = _mm256_sub_epi8(indices, _mm256_cmpgt_epi8(values, _mm256_set1_epi8(25)));
+    return _mm256_add_epi8(values, _mm256_shuffle_epi8(offsets, indices));
+}
+
+/// \brief Encode 24 bytes per iteration into 32 characters, scalar::base64_encode for the rest.
+[[gnu::target("avx2")]] inline void base64_encode(const u8 * data, usize size, u8 * out, const Base64Alphabet & alphabet) {
+    const i8 char62 = i8(alphabet.char62() - 62);
+    const i8 char63 = i8(alphabet.char63() - 63);
+    const __m256i offsets = _mm256_setr_epi8(65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, char62, char63, 0, 0,
+                                             65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, char62, char63, 0, 0);
+    // Lanes load bytes [0, 16) and [12, 28): 28 bytes must be readable.
+    for(; size >= 28; size -= 24, data += 24, out += 32) {
+        const __m256i input = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data))),
+                                                      _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 12)), 1);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), base64_translate(base64_split(input), offsets));
+    }
+    scalar::base64_encode(data, size, out, alphabet);
+}
+
+/// \brief Bytes of each 128-bit lane within [low, high] (signed compare, characters are < 0x80 after the range check).
+[[gnu::target("avx2"), gnu::always_inline]] inline __m256i base64_in_range(__m256i input, char low, char high) {
+    return _mm256_and_si256(_mm256_cmpgt_epi8(input, _mm256_set1_epi8(char(low - 1))),
+                            _mm256_cmpgt_epi8(_mm256_set1_epi8(char(high + 1)), input));
+}
+
+/// \brief 4 x 6-bit values per 32-bit word packed to 3 bytes, 24 bytes in the low 3/4 of the register.
+[[gnu::target("avx2"), gnu::always_inline]] inline __m256i base64_pack(__m256i values) {
+    const __m256i pairs = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+    const __m256i words = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+    const __m256i bytes = _mm256_shuffle_epi8(words, _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                                                      2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+    return _mm256_permutevar8x32_epi32(bytes, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7));
+}
+
+/// \brief Decode 32 characters per iteration into 24 bytes (32-byte stores), scalar::base64_decode for the rest.
+[[gnu::target("avx2")]] inline bool base64_decode(const u8 * data, usize size, u8 * out, const Base64Alphabet & alphabet) {
+    const __m256i char62 = _mm256_set1_epi8(char(alphabet.char62()));
+    const __m256i char63 = _mm256_set1_epi8(char(alphabet.char63()));
+    const __m256i offset62 = _mm256_set1_epi8(char(62 - alphabet.char62()));
+    const __m256i offset63 = _mm256_set1_epi8(char(63 - alphabet.char63()));
+    // The 32-byte store writes 8 bytes past the 24 decoded ones: they are overwritten by the next block or the tail.
+    for(; size >= 44; size -= 32, data += 32, out += 24) {
+        const __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data));
+        const __m256i upper = base64_in_range(input, 'A', 'Z');
+        const __m256i lower = base64_in_range(input, 'a', 'z');
+        const __m256i digit = base64_in_range(input, '0', '9');
+        const __m256i is62 = _mm256_cmpeq_epi8(input, char62);
+        const __m256i is63 = _mm256_cmpeq_epi8(input, char63);
+        const __m256i valid = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(upper, lower), _mm256_or_si256(digit, is62)), is63);
+        if(_mm256_movemask_epi8(valid) != -1) {
+            return false;
+        }
+        __m256i offset = _mm256_and_si256(upper, _mm256_set1_epi8(-65));
+        offset = _mm256_or_si256(offset, _mm256_and_si256(lower, _mm256_set1_epi8(-71)));
+        offset = _mm256_or_si256(offset, _mm256_and_si256(digit, _mm256_set1_epi8(4)));
+        offset = _mm256_or_si256(offset, _mm256_and_si256(is62, offset62));
+        offset = _mm256_or_si256(offset, _mm256_and_si256(is63, offset63));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), base64_pack(_mm256_add_epi8(input, offset)));
+    }
+    return scalar::base64_decode(data, size, out, alphabet);
+}
+
+}
+
+#endif
+
+/// \brief Encode size bytes into base64_encoded_size(size, alphabet.padding) characters at out.
+inline void base64_encode(const u8 * data, usize size, u8 * out, const Base64Alphabet & alphabet) {
+#if defined(__x86_64__) || defined(__i386__)
+    switch(cpu_tier()) {
+        case CpuTier::avx512:
+        case CpuTier::avx2: return avx2::base64_encode(data, size, out, alphabet);
+        case CpuTier::sse42:
+        case CpuTier::sse2:
+        case CpuTier::scalar: break;
+    }
+#endif
+    scalar::base64_encode(data, size, out, alphabet);
+}
+
+/// \brief Decode size characters without padding into base64_decoded_size(size, 0) bytes at out.
+inline bool base64_decode(const u8 * data, usize size, u8 * out, const Base64Alphabet & alphabet) {
+#if defined(__x86_64__) || defined(__i386__)
+    switch(cpu_tier()) {
+        case CpuTier::avx512:
+        case CpuTier::avx2: return avx2::base64_decode(data, size, out, alphabet);
+        case CpuTier::sse42:
+        case CpuTier::sse2:
+        case CpuTier::scalar: break;
+    }
+#endif
+    return scalar::base64_decode(data, size, out, alphabet);
+}
+
+/// \brief Number of '=' padding characters at the end of encoded, 0 - 2.
+[[nodiscard, gnu::always_inline]] inline usize base64_padding(ConstBuffer encoded) {
+    usize ret = 0;
+    while(ret < 2 && ret < encoded.size && encoded.data[encoded.size - 1 - ret] == '=') {
+        ++ret;
+    }
+    return ret;
+}
+
+}
+
+/// \brief Exact number of characters base64_encode writes for size bytes.
+[[nodiscard, gnu::always_inline]] constexpr inline usize base64_encoded_size(usize size, Base64 variant = Base64::standard) {
+    return kernels::base64_encoded_size(size, variant == Base64::standard);
+}
+
+/// \brief Exact number of bytes base64_decode writes for valid encoded input (counts trailing padding).
+[[nodiscard, gnu::always_inline]] inline usize base64_decoded_size(ConstBuffer encoded, Base64 variant = Base64::standard) {
+    return kernels::base64_decoded_size(encoded.size, variant == Base64::standard ? kernels::base64_padding(encoded) : 0);
+}
+
+/**
+ * \brief Encode input as Base64 into the first base64_encoded_size(input.size) bytes of output, which are consumed.
+ * \code
+ * MutableBuffer output = ...;
+ * if(not base64_encode(blob, output, Base64::url)) {
+ *     // Not enough space in output
+ * }
+ * \endcode
+ * \return true if OK, false if output is too small (output is unchanged).
+ */
+[[nodiscard, gnu::always_inline]] inline bool base64_encode(ConstBuffer input, MutableBuffer & output, Base64 variant = Base64::standard) {
+    const usize size = base64_encoded_size(input.size, variant);
+    if(output.size < size) {
+        return false;
+    }
+    kernels::base64_encode(input.data, input.size, output.data, kernels::base64_alphabet(variant));
+    return output.skip(size);
+}
+
+/**
+ * \brief Decode Base64 input into the first base64_decoded_size(input) bytes of output, which are consumed.
+ *
+ * Strict: no whitespace or line breaks, standard input must be padded to a multiple of 4 characters, url input must
+ * not be padded, and unused bits of the last character must be 0 (every byte string has exactly one valid encoding).
+ * \return true if OK, false if input is invalid or output is too small (output.data / .size are unchanged,
+ *         bytes in output may be overwritten).
+ */
+[[nodiscard, gnu::always_inline]] inline bool base64_decode(ConstBuffer input, MutableBuffer & output, Base64 variant = Base64::standard) {
+    const kernels::Base64Alphabet & alphabet = kernels::base64_alphabet(variant);
+    usize padding = 0;
+    if(alphabet.padding) {
+        if(input.size % 4 != 0) {
+            return false;
+        }
+        padding = kernels::base64_padding(input);
+    }
+    const usize size = kernels::base64_decoded_size(input.size, padding);
+    if(output.size < size || (input.size - padding) % 4 == 1) {
+        return false;
+    }
+    if(not kernels::base64_decode(input.data, input.size - padding, output.data, alphabet)) {
+        return false;
+    }
+    return output.skip(size);
+}
+
+}
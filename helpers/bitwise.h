@@ -0,0 +1,366 @@
+#pragma once
+
+#include "helpers/cpu.h"
+#include "helpers/types.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace sedfer {
+
+/// \brief Bitwise operation of bitwise kernels: destination = left op right.
+enum class BitOp : u8 {
+    xor_,
+    and_,
+    or_,
+    andnot, ///< left & ~right: clear bits set in right.
+};
+
+/**
+ * \brief AND / OR / XOR / ANDNOT of two byte arrays, and XOR with a repeating 4-byte key (WebSocket masking).
+ *
+ * destination may be equal to left or right (in place), partial overlap is not supported.
+ * The last (overlapping) vector is loaded before the main loop stores anything, so the tail is done with one
+ * unaligned vector even in place. AVX-512 uses masked loads and stores for the tail instead.
+ */
+namespace kernels {
+
+/// \brief Pattern for xor_pattern that continues a 4-byte mask key (bytes in memory order) at stream position offset.
+[[nodiscard, gnu::always_inline]] inline u32 mask_pattern(u32 key, usize offset) {
+    // Byte (offset % 4) of key moves to the lowest address.
+    const int shift = int(8 * (offset % 4));
+    if constexpr(std::endian::native == std::endian::little) {
+        return std::rotr(key, shift);
+    } else {
+        return std::rotl(key, shift);
+    }
+}
+
+namespace scalar {
+
+template<BitOp op, typename T>
+[[gnu::always_inline]] inline T apply_bitwise(T left, T right) {
+    if constexpr(op == BitOp::xor_) {
+        return left ^ right;
+    } else if constexpr(op == BitOp::and_) {
+        return left & right;
+    } else if constexpr(op == BitOp::or_) {
+        return left | right;
+    } else {
+        return left & ~right;
+    }
+}
+
+template<BitOp op>
+inline void bitwise(u8 * destination, const u8 * left, const u8 * right, usize size) {
+    usize i = 0;
+    for(; i + 8 <= size; i += 8) {
+        u64 l;
+        u64 r;
+        std::memcpy(&l, left + i, 8);
+        std::memcpy(&r, right + i, 8);
+        const u64 ret = apply_bitwise<op>(l, r);
+        std::memcpy(destination + i, &ret, 8);
+    }
+    for(; i < size; ++i) {
+        destination[i] = apply_bitwise<op>(left[i], right[i]);
+    }
+}
+
+/// \brief destination[i] = source[i] ^ pattern byte (i % 4), pattern bytes in memory order.
+inline void xor_pattern(u8 * destination, const u8 * source, usize size, u32 pattern) {
+    const u64 wide = u64(pattern) | (u64(pattern) << 32);
+    usize i = 0;
+    for(; i + 8 <= size; i += 8) {
+        u64 value;
+        std::memcpy(&value, source + i, 8);
+        value ^= wide;
+        std::memcpy(destination + i, &value, 8);
+    }
+    u8 bytes[4];
+    std::memcpy(bytes, &pattern, 4);
+    for(; i < size; ++i) {
+        destination[i] = source[i] ^ bytes[i % 4];
+    }
+}
+
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+namespace sse2 {
+
+template<BitOp op>
+[[gnu::target("sse2"), gnu::always_inline]] inline __m128i apply_bitwise(__m128i left, __m128i right) {
+    if constexpr(op == BitOp::xor_) {
+        return _mm_xor_si128(left, right);
+    } else if constexpr(op == BitOp::and_) {
+        return _mm_and_si128(left, right);
+    } else if constexpr(op == BitOp::or_) {
+        return _mm_or_si128(left, right);
+    } else {
+        return _mm_andnot_si128(right, left);
+    }
+}
+
+[[gnu::target("sse2"), gnu::always_inline]] inline __m128i load_vector(const u8 * data) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+}
+
+[[gnu::target("sse2"), gnu::always_inline]] inline void store_vector(u8 * data, __m128i value) {
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(data), value);
+}
+
+template<BitOp op>
+[[gnu::target("sse2")]] inline void bitwise(u8 * destination, const u8 * left, const u8 * right, usize size) {
+    if(size < 16) {
+        scalar::bitwise<op>(destination, left, right, size);
+        return;
+    }
+    const __m128i tail = apply_bitwise<op>(load_vector(left + size - 16), load_vector(right + size - 16));
+
+    usize i = 0;
+    for(; i + 64 <= size; i += 64) {
+        const __m128i a = apply_bitwise<op>(load_vector(left + i), load_vector(right + i));
+        const __m128i b = apply_bitwise<op>(load_vector(left + i + 16), load_vector(right + i + 16));
+        const __m128i c = apply_bitwise<op>(load_vector(left + i + 32), load_vector(right + i + 32));
+        const __m128i d = apply_bitwise<op>(load_vector(left + i + 48), load_vector(right + i + 48));
+        store_vector(destination + i, a);
+        store_vector(destination + i + 16, b);
+        store_vector(destination + i + 32, c);
+        store_vector(destination + i + 48, d);
+    }
+    for(; i + 16 <= size; i += 16) {
+        store_vector(destination + i, apply_bitwise<op>(load_vector(left + i), load_vector(right + i)));
+    }
+    store_vector(destination + size - 16, tail);
+}
+
+[[gnu::target("sse2")]] inline void xor_pattern(u8 * destination, const u8 * source, usize size, u32 pattern) {
+    if(size < 16) {
+        scalar::xor_pattern(destination, source, size, pattern);
+        return;
+    }
+    const __m128i mask = _mm_set1_epi32(int(pattern));
+    const __m128i tail = _mm_xor_si128(load_vector(source + size - 16), _mm_set1_epi32(int(mask_pattern(pattern, size - 16))));
+
+    usize i = 0;
+    for(; i + 64 <= size; i += 64) {
+        const __m128i a = _mm_xor_si128(load_vector(source + i), mask);
+        const __m128i b = _mm_xor_si128(load_vector(source + i + 16), mask);
+        const __m128i c = _mm_xor_si128(load_vector(source + i + 32), mask);
+        const __m128i d = _mm_xor_si128(load_vector(source + i + 48), mask);
+        store_vector(destination + i, a);
+        store_vector(destination + i + 16, b);
+        store_vector(destination + i + 32, c);
+        store_vector(destination + i + 48, d);
+    }
+    for(; i + 16 <= size; i += 16) {
+        store_vector(destination + i, _mm_xor_si128(load_vector(source + i), mask));
+    }
+    store_vector(destination + size - 16, tail);
+}
+
+}
+
+namespace avx2 {
+
+template<BitOp op>
+[[gnu::target("avx2"), gnu::always_inline]] inline __m256i apply_bitwise(__m256i left, __m256i right) {
+    if constexpr(op == BitOp::xor_) {
+        return _mm256_xor_si256(left, right);
+    } else if constexpr(op == BitOp::and_) {
+        return _mm256_and_si256(left, right);
+    } else if constexpr(op == BitOp::or_) {
+        return _mm256_or_si256(left, right);
+    } else {
+        return _mm256_andnot_si256(right, left);
+    }
+}
+
+[[gnu::target("avx2"), gnu::always_inline]] inline __m256i load_vector(const u8 * data) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data));
+}
+
+[[gnu::target("avx2"), gnu::always_inline]] inline void store_vector(u8 * data, __m256i value) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(data), value);
+}
+
+template<BitOp op>
+[[gnu::target("avx2")]] inline void bitwise(u8 * destination, const u8 * left, const u8 * right, usize size) {
+    if(size < 32) {
+        sse2::bitwise<op>(destination, left, right, size);
+        return;
+    }
+    const __m256i tail = apply_bitwise<op>(load_vector(left + size - 32), load_vector(right + size - 32));
+
+    usize i = 0;
+    for(; i + 128 <= size; i += 128) {
+        const __m256i a = apply_bitwise<op>(load_vector(left + i), load_vector(right + i));
+        const __m256i b = apply_bitwise<op>(load_vector(left + i + 32), load_vector(right + i + 32));
+        const __m256i c = apply_bitwise<op>(load_vector(left + i + 64), load_vector(right + i + 64));
+        const __m256i d = apply_bitwise<op>(load_vector(left + i + 96), load_vector(right + i + 96));
+        store_vector(destination + i, a);
+        store_vector(destination + i + 32, b);
+        store_vector(destination + i + 64, c);
+        store_vector(destination + i + 96, d);
+    }
+    for(; i + 32 <= size; i += 32) {
+        store_vector(destination + i, apply_bitwise<op>(load_vector(left + i), load_vector(right + i)));
+    }
+    store_vector(destination + size - 32, tail);
+}
+
+[[gnu::target("avx2")]] inline void xor_pattern(u8 * destination, const u8 * source, usize size, u32 pattern) {
+    if(size < 32) {
+        sse2::xor_pattern(destination, source, size, pattern);
+        return;
+    }
+    const __m256i mask = _mm256_set1_epi32(int(pattern));
+    const __m256i tail = _mm256_xor_si256(load_vector(source + size - 32), _mm256_set1_epi32(int(mask_pattern(pattern, size - 32))));
+
+    usize i = 0;
+    for(; i + 128 <= size; i += 128) {
+        const __m256i a = _mm256_xor_si256(load_vector(source + i), mask);
+        const __m256i b = _mm256_xor_si256(load_vector(source + i + 32), mask);
+        const __m256i c = _mm256_xor_si256(load_vector(source + i + 64), mask);
+        const __m256i d = _mm256_xor_si256(load_vector(source + i + 96), mask);
+        store_vector(destination + i, a);
+        store_vector(destination + i + 32, b);
+        store_vector(destination + i + 64, c);
+        store_vector(destination + i + 96, d);
+    }
+    for(; i + 32 <= size; i += 32) {
+        store_vector(destination + i, _mm256_xor_si256(load_vector(source + i), mask));
+    }
+    store_vector(destination + size - 32, tail);
+}
+
+}
+
+namespace avx512 {
+
+template<BitOp op>
+[[gnu::target("avx512f,avx512bw"), gnu::always_inline]] inline __m512i apply_bitwise(__m512i left, __m512i right) {
+    if constexpr(op == BitOp::xor_) {
+        return _mm512_xor_si512(left, right);
+    } else if constexpr(op == BitOp::and_) {
+        return _mm512_and_si512(left, right);
+    } else if constexpr(op == BitOp::or_) {
+        return _mm512_or_si512(left, right);
+    } else {
+        return _mm512_andnot_si512(right, left);
+    }
+}
+
+[[gnu::target("avx512f,avx512bw"), gnu::always_inline]] inline __m512i load_vector(const u8 * data) {
+    return _mm512_loadu_si512(data);
+}
+
+[[gnu::target("avx512f,avx512bw"), gnu::always_inline]] inline void store_vector(u8 * data, __m512i value) {
+    _mm512_storeu_si512(data, value);
+}
+
+/// \brief Bytes below size (< 64) are set.
+[[gnu::target("avx512f,avx512bw"), gnu::always_inline]] inline __mmask64 tail_mask(usize size) {
+    return _cvtu64_mask64((u64(1) << size) - 1);
+}
+
+template<BitOp op>
+[[gnu::target("avx512f,avx512bw")]] inline void bitwise(u8 * destination, const u8 * left, const u8 * right, usize size) {
+    // Masked head up to a 64-byte aligned destination: full-width stores must not split cache lines.
+    usize i = std::min(size, (0 - reinterpret_cast<uintptr_t>(destination)) & 63);
+    if(i != 0) {
+        const __mmask64 mask = tail_mask(i);
+        const __m512i ret = apply_bitwise<op>(_mm512_maskz_loadu_epi8(mask, left), _mm512_maskz_loadu_epi8(mask, right));
+        _mm512_mask_storeu_epi8(destination, mask, ret);
+    }
+    for(; i + 256 <= size; i += 256) {
+        const __m512i a = apply_bitwise<op>(load_vector(left + i), load_vector(right + i));
+        const __m512i b = apply_bitwise<op>(load_vector(left + i + 64), load_vector(right + i + 64));
+        const __m512i c = apply_bitwise<op>(load_vector(left + i + 128), load_vector(right + i + 128));
+        const __m512i d = apply_bitwise<op>(load_vector(left + i + 192), load_vector(right + i + 192));
+        store_vector(destination + i, a);
+        store_vector(destination + i + 64, b);
+        store_vector(destination + i + 128, c);
+        store_vector(destination + i + 192, d);
+    }
+    for(; i + 64 <= size; i += 64) {
+        store_vector(destination + i, apply_bitwise<op>(load_vector(left + i), load_vector(right + i)));
+    }
+    if(i != size) {
+        const __mmask64 mask = tail_mask(size - i);
+        const __m512i ret = apply_bitwise<op>(_mm512_maskz_loadu_epi8(mask, left + i), _mm512_maskz_loadu_epi8(mask, right + i));
+        _mm512_mask_storeu_epi8(destination + i, mask, ret);
+    }
+}
+
+/// \brief Vectors are multiples of 4 bytes: after the head the same pattern applies at every vector start.
+[[gnu::target("avx512f,avx512bw")]] inline void xor_pattern(u8 * destination, const u8 * source, usize size, u32 pattern) {
+    usize i = std::min(size, (0 - reinterpret_cast<uintptr_t>(destination)) & 63);
+    if(i != 0) {
+        const __mmask64 bytes = tail_mask(i);
+        _mm512_mask_storeu_epi8(destination, bytes, _mm512_xor_si512(_mm512_maskz_loadu_epi8(bytes, source), _mm512_set1_epi32(int(pattern))));
+    }
+    // The pattern continues at the first aligned position.
+    const __m512i mask = _mm512_set1_epi32(int(mask_pattern(pattern, i)));
+    for(; i + 256 <= size; i += 256) {
+        const __m512i a = _mm512_xor_si512(load_vector(source + i), mask);
+        const __m512i b = _mm512_xor_si512(load_vector(source + i + 64), mask);
+        const __m512i c = _mm512_xor_si512(load_vector(source + i + 128), mask);
+        const __m512i d = _mm512_xor_si512(load_vector(source + i + 192), mask);
+        store_vector(destination + i, a);
+        store_vector(destination + i + 64, b);
+        store_vector(destination + i + 128, c);
+        store_vector(destination + i + 192, d);
+    }
+    for(; i + 64 <= size; i += 64) {
+        store_vector(destination + i, _mm512_xor_si512(load_vector(source + i), mask));
+    }
+    if(i != size) {
+        const __mmask64 bytes = tail_mask(size - i);
+        _mm512_mask_storeu_epi8(destination + i, bytes, _mm512_xor_si512(_mm512_maskz_loadu_epi8(bytes, source + i), mask));
+    }
+}
+
+}
+
+#endif
+
+/// \brief destination = left op right for size bytes (destination may be left or right).
+template<BitOp op>
+inline void bitwise(u8 * destination, const u8 * left, const u8 * right, usize size) {
+#if defined(__x86_64__) || defined(__i386__)
+    switch(cpu_tier()) {
+        case CpuTier::avx512: return avx512::bitwise<op>(destination, left, right, size);
+        case CpuTier::avx2: return avx2::bitwise<op>(destination, left, right, size);
+        case CpuTier::sse42:
+        case CpuTier::sse2: return sse2::bitwise<op>(destination, left, right, size);
+        case CpuTier::scalar: break;
+    }
+#endif
+    scalar::bitwise<op>(destination, left, right, size);
+}
+
+/// \brief destination[i] = source[i] ^ pattern byte (i % 4), pattern bytes in memory order (destination may be source).
+inline void xor_pattern(u8 * destination, const u8 * source, usize size, u32 pattern) {
+#if defined(__x86_64__) || defined(__i386__)
+    switch(cpu_tier()) {
+        case CpuTier::avx512: return avx512::xor_pattern(destination, source, size, pattern);
+        case CpuTier::avx2: return avx2::xor_pattern(destination, source, size, pattern);
+        case CpuTier::sse42:
+        case CpuTier::sse2: return sse2::xor_pattern(destination, source, size, pattern);
+        case CpuTier::scalar: break;
+    }
+#endif
+    scalar::xor_pattern(destination, source, size, pattern);
+}
+
+}
+
+}
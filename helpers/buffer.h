@@ -1,7 +1,17 @@
 #pragma once
 
+#include "helpers/bitwise.h"
+#include "helpers/compare.h"
+#include "helpers/copy.h"
+#include "helpers/decimal.h"
+#include "helpers/fill.h"
+#include "helpers/hex.h"
+#include "helpers/search.h"
+#include "helpers/statistics.h"
+#include "helpers/translate.h"
 #include "helpers/types.h"
 #include <algorithm>
+#include <compare>
 
 namespace sedfer {
 
@@ -42,6 +52,17 @@ concept implicit_cast_to_buffer = (not is_buffer_v<T>) &&
 template<typename T>
 concept interpretable_from_unaligned = (alignof(T) == 1);
 
+/**
+ * \brief Concept checks if a type is a single byte value (u8, i8, char).
+ * \note Byte search functions accept only these, so find(u32) does not silently truncate to a byte.
+ */
+template<typename T>
+concept byte_value = std::is_integral_v<T> && (sizeof(T) == 1) && (not std::is_same_v<T, bool>);
+
+/// \brief Concept checks if a type is an integer but not a byte value (such arguments must not become multi-byte needles).
+template<typename T>
+concept non_byte_integral = std::is_integral_v<T> && (not byte_value<T>);
+
 /**
  * \brief ConstBuffer is a light-weight, non-owning view of immutable bytes, similar to span\<u8, dynamic_extent\>.
  *
@@ -302,6 +323,179 @@ struct ConstBuffer {
         (void)skip_back(sizeof(T));
         return ret;
     }
+
+    /**
+     * \brief Parse first 2 * sizeof(T) bytes as hex digits (either case, no prefix). Read bytes are consumed.
+     * \code
+     * u32 color = 0;
+     * if(not input.pop_hex(color)) return false; // "ff8000aa"
+     * \endcode
+     * \return true if OK, false if 2 * sizeof(T) > this.size or any byte is not a hex digit (buffer and value are unchanged).
+     */
+    template<hex_integer T>
+    [[nodiscard, gnu::always_inline]] inline bool pop_hex(T & value) {
+        return size >= 2 * sizeof(T) && kernels::hex_read(data, value) && skip(2 * sizeof(T));
+    }
+
+    /**
+     * \brief Parse a decimal integer at the start (optional '-' for signed T, then digits, as std::from_chars).
+     * Read bytes are consumed, parsing stops at the first non-digit.
+     * \code
+     * u32 length = 0;
+     * if(not field.pop_decimal(length)) return false; // "1024;chunk" -> 1024, field is ";chunk"
+     * \endcode
+     * \return true if OK, false if there are no digits or the value does not fit T (buffer and value are unchanged).
+     */
+    template<decimal_integer T>
+    [[nodiscard, gnu::always_inline]] inline bool pop_decimal(T & value) {
+        const usize used = kernels::parse_decimal(data, size, value);
+        return used != 0 && skip(used);
+    }
+
+    /**
+     * \brief Parse a float at the start (std::from_chars general format: "-1.5e3", ".5", "inf", "nan"), correctly rounded.
+     * Read bytes are consumed, parsing stops at the first byte that does not continue the number.
+     * \return true if OK, false if there is no number or it overflows / underflows T (buffer and value are unchanged).
+     */
+    template<decimal_float T>
+    [[nodiscard, gnu::always_inline]] inline bool pop_float(T & value) {
+        const usize used = kernels::parse_float(data, size, value);
+        return used != 0 && skip(used);
+    }
+
+    /**
+     * \brief Find first byte equal to value. Current buffer is unaffected.
+     * \return Sub-buffer from the found byte to the end if OK, {nullptr, 0} if not found.
+     */
+    template<byte_value T>
+    [[nodiscard, gnu::always_inline]] inline ConstBuffer find(T value) const {
+        return tail_from(kernels::find_byte(data, size, u8(value)));
+    }
+
+    /**
+     * \brief Find last byte equal to value. Current buffer is unaffected.
+     * \return Sub-buffer from the found byte to the end if OK, {nullptr, 0} if not found.
+     */
+    template<byte_value T>
+    [[nodiscard, gnu::always_inline]] inline ConstBuffer find_last(T value) const {
+        return tail_from(kernels::find_last_byte(data, size, u8(value)));
+    }
+
+    /// \brief Number of bytes equal to value.
+    template<byte_value T>
+    [[nodiscard, gnu::always_inline]] inline usize count(T value) const {
+        return kernels::count(data, size, u8(value));
+    }
+
+    /**
+     * \brief Find first occurrence of needle bytes. Current buffer is unaffected.
+     * \return Sub-buffer from the found occurrence to the end if OK, {nullptr, 0} if not found.
+     * \note find("abc") searches for 4 bytes {'a', 'b', 'c', '\0'}, pass {pointer, size} to search for text.
+     * \note Use Finder to search for the same needle in many buffers (preprocessing is done once).
+     */
+    [[nodiscard, gnu::always_inline]] inline ConstBuffer find(ConstBuffer needle) const {
+        return tail_from(kernels::find_substring(data, size, needle.data, needle.size));
+    }
+
+    /**
+     * \brief Find last occurrence of needle bytes. Current buffer is unaffected.
+     * \return Sub-buffer from the found occurrence to the end if OK, {nullptr, 0} if not found.
+     */
+    [[nodiscard, gnu::always_inline]] inline ConstBuffer find_last(ConstBuffer needle) const {
+        return tail_from(kernels::find_last_substring(data, size, needle.data, needle.size));
+    }
+
+    /**
+     * \brief Find first byte that is in set. Current buffer is unaffected.
+     * \return Sub-buffer from the found byte to the end if OK, {nullptr, 0} if not found.
+     */
+    [[nodiscard, gnu::always_inline]] inline ConstBuffer find_first_of(const ByteSet & set) const {
+        return tail_from(kernels::find_in_set<true>(data, size, set));
+    }
+
+    /**
+     * \brief Find first byte that is NOT in set. Current buffer is unaffected.
+     * \return Sub-buffer from the found byte to the end if OK, {nullptr, 0} if not found.
+     */
+    [[nodiscard, gnu::always_inline]] inline ConstBuffer find_first_not_of(const ByteSet & set) const {
+        return tail_from(kernels::find_in_set<false>(data, size, set));
+    }
+
+    /**
+     * \brief Get bytes before first delimiter as sub-buffer. Read bytes and the delimiter are consumed (.data and .size are adjusted).
+     * \return Valid (possibly empty) buffer if OK, {nullptr, 0} if delimiter is not found (current buffer is unaffected).
+     */
+    template<byte_value T>
+    [[nodiscard, gnu::always_inline]] inline ConstBuffer pop_until(T delimiter) {
+        return pop_before(kernels::find_byte(data, size, u8(delimiter)), 1);
+    }
+
+    /**
+     * \brief Get bytes before first occurrence of delimiter as sub-buffer.
+     *        Read bytes and the delimiter are consumed (.data and .size are adjusted).
+     * \return Valid (possibly empty) buffer if OK, {nullptr, 0} if delimiter is not found (current buffer is unaffected).
+     */
+    [[nodiscard, gnu::always_inline]] inline ConstBuffer pop_until(ConstBuffer delimiter) {
+        return pop_before(kernels::find_substring(data, size, delimiter.data, delimiter.size), delimiter.size);
+    }
+
+    // find(10) would search for the sizeof(int) bytes of 10: cast to u8 / char to search for a byte.
+    template<non_byte_integral T>
+    ConstBuffer find(T) const = delete;
+    template<non_byte_integral T>
+    ConstBuffer find_last(T) const = delete;
+    template<non_byte_integral T>
+    ConstBuffer pop_until(T) = delete;
+
+    /**
+     * \brief Get bytes after last delimiter as sub-buffer. Read bytes and the delimiter are consumed (.size is adjusted).
+     * \return Valid (possibly empty) buffer if OK, {nullptr, 0} if delimiter is not found (current buffer is unaffected).
+     */
+    template<byte_value T>
+    [[nodiscard, gnu::always_inline]] inline ConstBuffer pop_back_until(T delimiter) {
+        const u8 * const found = kernels::find_last_byte(data, size, u8(delimiter));
+        if(found == nullptr) {
+            return {};
+        }
+        const ConstBuffer ret(found + 1, data + size - found - 1);
+        size = usize(found - data);
+        return ret;
+    }
+
+    /**
+     * \brief Get bytes before first byte in set as sub-buffer. Read bytes and the delimiter are consumed (.data and .size are adjusted).
+     * \return Valid (possibly empty) buffer if OK, {nullptr, 0} if no byte is in set (current buffer is unaffected).
+     */
+    [[nodiscard, gnu::always_inline]] inline ConstBuffer pop_until_first_of(const ByteSet & set) {
+        return pop_before(kernels::find_in_set<true>(data, size, set), 1);
+    }
+
+    /**
+     * \brief Get leading bytes that are in set as sub-buffer. Read bytes are consumed (.data and .size are adjusted),
+     *        the first byte NOT in set is kept.
+     * \return Valid (possibly empty) buffer if OK, {nullptr, 0} if all bytes are in set (current buffer is unaffected).
+     */
+    [[nodiscard, gnu::always_inline]] inline ConstBuffer pop_until_first_not_of(const ByteSet & set) {
+        return pop_before(kernels::find_in_set<false>(data, size, set), 0);
+    }
+
+private:
+    [[nodiscard, gnu::always_inline]] inline ConstBuffer tail_from(const u8 * found) const {
+        if(found == nullptr) {
+            return {};
+        }
+        return {found, usize(data + size - found)};
+    }
+
+    [[nodiscard, gnu::always_inline]] inline ConstBuffer pop_before(const u8 * found, usize delimiter_size) {
+        if(found == nullptr) {
+            return {};
+        }
+        const ConstBuffer ret(data, usize(found - data));
+        data = found + delimiter_size;
+        size -= ret.size + delimiter_size;
+        return ret;
+    }
 };
 
 /**
@@ -438,7 +632,7 @@ struct MutableBuffer {
         if(size < mutable_buffer.size) {
             return false;
         }
-        std::copy_n(data, mutable_buffer.size, mutable_buffer.data);
+        kernels::copy(mutable_buffer.data, data, mutable_buffer.size);
         return true;
     }
 
@@ -450,7 +644,7 @@ struct MutableBuffer {
         if(size < mutable_buffer.size) {
             return false;
         }
-        std::copy_n(data + size - mutable_buffer.size, mutable_buffer.size, mutable_buffer.data);
+        kernels::copy(mutable_buffer.data, data + size - mutable_buffer.size, mutable_buffer.size);
         return true;
     }
 
@@ -593,6 +787,53 @@ struct MutableBuffer {
         return ret;
     }
 
+    /**
+     * \brief Write value as 2 * sizeof(T) hex digits (zero-padded, no prefix) into first bytes. Written bytes are consumed.
+     * \return true if OK, false if 2 * sizeof(T) > this.size.
+     */
+    template<hex_integer T>
+    [[nodiscard, gnu::always_inline]] inline bool push_hex(T value, HexCase letters = HexCase::lower) {
+        if(size < 2 * sizeof(T)) {
+            return false;
+        }
+        kernels::hex_write(data, value, letters);
+        return skip(2 * sizeof(T));
+    }
+
+    /**
+     * \brief Write value as decimal text ('-' if negative, then digits, as std::to_chars) into first bytes.
+     * Written bytes are consumed.
+     * \return true if OK, false if the text is longer than this.size (buffer is unchanged).
+     */
+    template<decimal_integer_or_128 T>
+    [[nodiscard, gnu::always_inline]] inline bool push_decimal(T value) {
+        const kernels::DecimalInteger<T> text(value);
+        if(size < text.length) {
+            return false;
+        }
+        text.write(data);
+        return skip(text.length);
+    }
+
+    /**
+     * \brief Write value as the shortest decimal text that reads back as the same value (as std::to_chars(value):
+     * "0.1", "100", "1e+21", "1.5e-07", "inf", "nan") into first bytes. Written bytes are consumed.
+     * \code
+     * if(not output.push_float(0.1 + 0.2)) return false; // "0.30000000000000004"
+     * \endcode
+     * \return true if OK, false if the text is longer than this.size (buffer is unchanged).
+     * \note At most 24 bytes for double, 15 for float.
+     */
+    template<decimal_float T>
+    [[nodiscard, gnu::always_inline]] inline bool push_float(T value) {
+        const kernels::DecimalFloat<T> text(value);
+        if(size < text.length) {
+            return false;
+        }
+        text.write(data);
+        return skip(text.length);
+    }
+
     /**
      * \brief Copy mutable_buffer.size bytes from mutable_buffer.data into first (this) bytes. Read bytes are consumed (.data and .size are adjusted).
      * \return true if OK, false if mutable_buffer.size > this.size.
@@ -601,7 +842,7 @@ struct MutableBuffer {
         if(size < const_buffer.size) {
             return false;
         }
-        std::copy_n(const_buffer.data, const_buffer.size, data);
+        kernels::copy(data, const_buffer.data, const_buffer.size);
         return skip(const_buffer.size);
     }
 
@@ -613,16 +854,127 @@ struct MutableBuffer {
         if(size < const_buffer.size) {
             return false;
         }
-        std::copy_n(const_buffer.data, const_buffer.size, data + size - const_buffer.size);
+        kernels::copy(data + size - const_buffer.size, const_buffer.data, const_buffer.size);
         return skip_back(const_buffer.size);
     }
+
+    /// \brief Set all bytes to value. Streaming (non-temporal) stores are used for large buffers.
+    [[gnu::always_inline]] inline void fill(u8 value) const {
+        kernels::fill(data, size, value);
+    }
+
+    /**
+     * \brief Repeat pattern over all bytes, the last repetition may be partial. Streaming stores are used for large buffers.
+     * \code
+     * MutableBuffer padding = ...;
+     * static const u8 PAD[] = {0xde, 0xad, 0xbe, 0xef};
+     * (void)padding.fill_pattern(PAD);
+     * \endcode
+     * \return true if OK, false if pattern is empty or longer than kernels::MAX_FILL_PATTERN_SIZE (64) bytes.
+     */
+    [[nodiscard, gnu::always_inline]] inline bool fill_pattern(ConstBuffer pattern) const {
+        if(pattern.size == 0 || pattern.size > kernels::MAX_FILL_PATTERN_SIZE) {
+            return false;
+        }
+        kernels::fill_pattern(data, size, pattern.data, pattern.size);
+        return true;
+    }
+
+    /// \brief Set all bytes to zero, unlike fill(0) the stores are never elided by the optimizer (for secrets).
+    [[gnu::always_inline]] inline void secure_zero() const {
+        kernels::secure_zero(data, size);
+    }
+
+    /**
+     * \brief In-place this ^= other (e.g. XOR delta between snapshots).
+     * \return true if OK, false if other.size != this.size.
+     */
+    [[nodiscard, gnu::always_inline]] inline bool xor_with(ConstBuffer other) const {
+        return apply<BitOp::xor_>(other);
+    }
+
+    /**
+     * \brief In-place this &= other (e.g. bitmap intersection).
+     * \return true if OK, false if other.size != this.size.
+     */
+    [[nodiscard, gnu::always_inline]] inline bool and_with(ConstBuffer other) const {
+        return apply<BitOp::and_>(other);
+    }
+
+    /**
+     * \brief In-place this |= other (e.g. bitmap union).
+     * \return true if OK, false if other.size != this.size.
+     */
+    [[nodiscard, gnu::always_inline]] inline bool or_with(ConstBuffer other) const {
+        return apply<BitOp::or_>(other);
+    }
+
+    /**
+     * \brief In-place this &= ~other: clear bits set in other (e.g. bitmap difference).
+     * \return true if OK, false if other.size != this.size.
+     */
+    [[nodiscard, gnu::always_inline]] inline bool andnot_with(ConstBuffer other) const {
+        return apply<BitOp::andnot>(other);
+    }
+
+    /// \brief In-place this = ~this.
+    [[gnu::always_inline]] inline void invert() const {
+        kernels::xor_pattern(data, data, size, u32(-1));
+    }
+
+    /// \brief In-place ASCII lower case: 'A' - 'Z' -> 'a' - 'z', all other bytes (including UTF-8) are kept.
+    [[gnu::always_inline]] inline void to_lower() const {
+        kernels::change_case<false>(data, data, size);
+    }
+
+    /// \brief In-place ASCII upper case: 'a' - 'z' -> 'A' - 'Z', all other bytes (including UTF-8) are kept.
+    [[gnu::always_inline]] inline void to_upper() const {
+        kernels::change_case<true>(data, data, size);
+    }
+
+    /**
+     * \brief In-place this[i] = map[this[i]] for any byte -> byte table.
+     * \code
+     * static constexpr ByteMap SAFE_NAME("/\\:*?", "_____");
+     * file_name.translate(SAFE_NAME);
+     * \endcode
+     */
+    [[gnu::always_inline]] inline void translate(const ByteMap & map) const {
+        kernels::translate(data, data, size, map);
+    }
+
+    /**
+     * \brief In-place XOR with a repeating 4-byte key (WebSocket payload masking / unmasking).
+     *
+     * key holds the 4 mask bytes in memory (wire) order, e.g. read with pop(key).
+     * offset is the position of data in the masked stream, so a payload can be unmasked in chunks.
+     * \code
+     * u32 key;
+     * if(not frame.pop(key)) return false;
+     * MutableBuffer payload = ...;
+     * payload.xor_mask(key);
+     * \endcode
+     */
+    [[gnu::always_inline]] inline void xor_mask(u32 key, usize offset = 0) const {
+        kernels::xor_pattern(data, data, size, kernels::mask_pattern(key, offset));
+    }
+
+private:
+    template<BitOp op>
+    [[nodiscard, gnu::always_inline]] inline bool apply(ConstBuffer other) const {
+        if(other.size != size) {
+            return false;
+        }
+        kernels::bitwise<op>(data, data, other.data, size);
+        return true;
+    }
 };
 
 [[nodiscard, gnu::always_inline]] inline bool ConstBuffer::peek(MutableBuffer mutable_buffer) const {
     if(size < mutable_buffer.size) {
         return false;
     }
-    std::copy_n(data, mutable_buffer.size, mutable_buffer.data);
+    kernels::copy(mutable_buffer.data, data, mutable_buffer.size);
     return true;
 }
 
@@ -630,7 +982,7 @@ struct MutableBuffer {
     if(size < mutable_buffer.size) {
         return false;
     }
-    std::copy_n(data + size - mutable_buffer.size, mutable_buffer.size, mutable_buffer.data);
+    kernels::copy(mutable_buffer.data, data + size - mutable_buffer.size, mutable_buffer.size);
     return true;
 }
 
@@ -653,9 +1005,188 @@ struct MutableBuffer {
  * \return true if left == right, false otherwise.
  */
 [[nodiscard, gnu::always_inline]] inline bool equal(ConstBuffer left, ConstBuffer right) {
-    return std::equal(left.data, left.data + left.size, right.data, right.data + right.size);
+    return left.size == right.size && kernels::equal(left.data, right.data, left.size);
+}
+
+/**
+ * \brief Compare two buffers ignoring ASCII case (e.g. HTTP header names), without lower case copies.
+ * \return true if left and right have the same size and equal bytes after MutableBuffer::to_lower.
+ */
+[[nodiscard, gnu::always_inline]] inline bool equal_icase(ConstBuffer left, ConstBuffer right) {
+    return left.size == right.size && kernels::equal_icase(left.data, right.data, left.size);
+}
+
+/**
+ * \brief Compare two buffers lexicographically (like std::lexicographical_compare on bytes, shorter prefix orders first).
+ * \code
+ * std::sort(keys.begin(), keys.end(), [](ConstBuffer l, ConstBuffer r) { return compare(l, r) < 0; });
+ * \endcode
+ */
+[[nodiscard, gnu::always_inline]] inline std::strong_ordering compare(ConstBuffer left, ConstBuffer right) {
+    const int ret = kernels::compare(left.data, right.data, std::min(left.size, right.size));
+    return (ret != 0) ? ret <=> 0 : left.size <=> right.size;
+}
+
+/**
+ * \brief Find first offset where buffers differ.
+ * \return Offset of the first differing byte, min(left.size, right.size) if one is a prefix of the other (or equal).
+ */
+[[nodiscard, gnu::always_inline]] inline usize mismatch(ConstBuffer left, ConstBuffer right) {
+    return kernels::mismatch(left.data, right.data, std::min(left.size, right.size));
+}
+
+/// \brief true if buffer begins with prefix bytes.
+[[nodiscard, gnu::always_inline]] inline bool starts_with(ConstBuffer buffer, ConstBuffer prefix) {
+    return buffer.size >= prefix.size && kernels::equal(buffer.data, prefix.data, prefix.size);
+}
+
+/// \brief true if buffer ends with suffix bytes.
+[[nodiscard, gnu::always_inline]] inline bool ends_with(ConstBuffer buffer, ConstBuffer suffix) {
+    return buffer.size >= suffix.size && kernels::equal(buffer.data + buffer.size - suffix.size, suffix.data, suffix.size);
+}
+
+/// \brief Number of occurrences of each byte value in buffer (counts wrap above 4 GiB of one value).
+[[nodiscard, gnu::always_inline]] inline ByteHistogram histogram(ConstBuffer buffer) {
+    ByteHistogram ret;
+    kernels::histogram(buffer.data, buffer.size, ret);
+    return ret;
+}
+
+/// \brief Number of set bits in buffer.
+[[nodiscard, gnu::always_inline]] inline usize popcount(ConstBuffer buffer) {
+    return kernels::popcount(buffer.data, buffer.size);
+}
+
+/**
+ * \brief Byte statistics of buffer in a single pass (histogram): zero / ASCII bytes, set bits, entropy.
+ * \code
+ * const ByteStats stats = byte_stats(payload);
+ * if(stats.entropy > 7.5) {
+ *     // Already compressed or encrypted, store as is
+ * }
+ * \endcode
+ */
+[[nodiscard, gnu::always_inline]] inline ByteStats byte_stats(ConstBuffer buffer) {
+    return ByteStats::from(histogram(buffer), buffer.size);
+}
+
+/**
+ * \brief destination = left op right for BitOp::xor_, and_, or_, andnot. destination may be left or right (in place).
+ * \code
+ * if(not bitwise<BitOp::xor_>(delta, current_snapshot, previous_snapshot)) return false;
+ * \endcode
+ * \return true if OK, false if sizes differ.
+ */
+template<BitOp op>
+[[nodiscard, gnu::always_inline]] inline bool bitwise(MutableBuffer destination, ConstBuffer left, ConstBuffer right) {
+    if(left.size != destination.size || right.size != destination.size) {
+        return false;
+    }
+    kernels::bitwise<op>(destination.data, left.data, right.data, destination.size);
+    return true;
+}
+
+/**
+ * \brief destination = ~source.
+ * \return true if OK, false if sizes differ.
+ */
+[[nodiscard, gnu::always_inline]] inline bool invert(MutableBuffer destination, ConstBuffer source) {
+    if(source.size != destination.size) {
+        return false;
+    }
+    kernels::xor_pattern(destination.data, source.data, destination.size, u32(-1));
+    return true;
+}
+
+/**
+ * \brief destination = source masked with a repeating 4-byte key, see MutableBuffer::xor_mask.
+ * \return true if OK, false if sizes differ.
+ */
+[[nodiscard, gnu::always_inline]] inline bool xor_mask(MutableBuffer destination, ConstBuffer source, u32 key, usize offset = 0) {
+    if(source.size != destination.size) {
+        return false;
+    }
+    kernels::xor_pattern(destination.data, source.data, destination.size, kernels::mask_pattern(key, offset));
+    return true;
+}
+
+/**
+ * \brief destination = source in ASCII lower case, see MutableBuffer::to_lower.
+ * \return true if OK, false if sizes differ.
+ */
+[[nodiscard, gnu::always_inline]] inline bool to_lower(MutableBuffer destination, ConstBuffer source) {
+    if(source.size != destination.size) {
+        return false;
+    }
+    kernels::change_case<false>(destination.data, source.data, destination.size);
+    return true;
+}
+
+/**
+ * \brief destination = source in ASCII upper case, see MutableBuffer::to_upper.
+ * \return true if OK, false if sizes differ.
+ */
+[[nodiscard, gnu::always_inline]] inline bool to_upper(MutableBuffer destination, ConstBuffer source) {
+    if(source.size != destination.size) {
+        return false;
+    }
+    kernels::change_case<true>(destination.data, source.data, destination.size);
+    return true;
 }
 
+/**
+ * \brief destination[i] = map[source[i]], see MutableBuffer::translate.
+ * \return true if OK, false if sizes differ.
+ */
+[[nodiscard, gnu::always_inline]] inline bool translate(MutableBuffer destination, ConstBuffer source, const ByteMap & map) {
+    if(source.size != destination.size) {
+        return false;
+    }
+    kernels::translate(destination.data, source.data, destination.size, map);
+    return true;
+}
+
+/**
+ * \brief Write input as hex digits (2 per byte) into output. Written bytes are consumed.
+ * \return true if OK, false if 2 * input.size > output.size (output is unchanged).
+ */
+[[nodiscard, gnu::always_inline]] inline bool hex_encode(ConstBuffer input, MutableBuffer & output, HexCase letters = HexCase::lower) {
+    if(output.size / 2 < input.size) {
+        return false;
+    }
+    kernels::hex_encode(input.data, input.size, output.data, letters);
+    return output.skip(2 * input.size);
+}
+
+/**
+ * \brief Decode hex digits (either case, no prefix or separators) of input into output. Written bytes are consumed.
+ * \return true if OK, false if input.size is odd, input.size / 2 > output.size or any byte is not a hex digit
+ *         (output is unchanged, its bytes may be overwritten).
+ */
+[[nodiscard, gnu::always_inline]] inline bool hex_decode(ConstBuffer input, MutableBuffer & output) {
+    if((input.size & 1) != 0 || output.size < input.size / 2) {
+        return false;
+    }
+    return kernels::hex_decode(input.data, input.size / 2, output.data) && output.skip(input.size / 2);
+}
+
+/**
+ * \brief Lexicographic less-than for buffers, for std::sort, std::map, std::lower_bound etc.
+ * \note The byte comparison is kept out of line: inlined into std::sort it bloats the partition loop
+ * and measured slower than a call (benchmarks/compare.cpp).
+ */
+struct BufferLess {
+    [[nodiscard, gnu::always_inline]] inline bool operator()(ConstBuffer left, ConstBuffer right) const {
+        const int ret = compare_bytes(left.data, right.data, std::min(left.size, right.size));
+        return (ret != 0) ? ret < 0 : left.size < right.size;
+    }
+
+private:
+    [[gnu::noinline]] static int compare_bytes(const u8 * left, const u8 * right, usize size) {
+        return kernels::compare(left, right, size);
+    }
+};
+
 }
 
 /**
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "helpers/buffer.h"
+#include "helpers/types.h"
+
+#include <algorithm>
+#include <compare>
+#include <functional>
+#include <string_view>
+
+namespace sedfer {
+
+/**
+ * \brief CompactBuffer is an 8-byte handle of bytes inside an arena: u32 offset + u32 size relative to the arena start.
+ *
+ * Half the size of ConstBuffer, useful for tables with millions of buffers pointing into a few large arenas.
+ * Resolve to ConstBuffer on demand with resolve(arena), which is range-checked against the arena.
+ * \code
+ * ConstBuffer arena = load_strings();
+ * std::vector<CompactBuffer> keys;
+ *
+ * ConstBuffer key = find_key(arena);
+ * const CompactBuffer compact = CompactBuffer::from(arena, key);
+ * if(not compact.valid()) return false; // key is outside arena or arena is too large
+ * keys.push_back(compact);
+ *
+ * std::sort(keys.begin(), keys.end(), CompactBuffer::Less{arena}); // sort by content
+ * ConstBuffer first = keys[0].resolve(arena);
+ * \endcode
+ * \note Comparison operators and std::hash compare handles (offset, size), NOT the content.
+ *       This is what you want for de-duplicated (interned) arenas. Use Less / Equal / Hash with arena for content.
+ */
+struct CompactBuffer {
+    u32 offset = 0;
+    u32 size = 0;
+
+    /// \brief Handle that fails to resolve against any arena.
+    [[nodiscard, gnu::always_inline]] static constexpr inline CompactBuffer invalid() {
+        return {u32(-1), u32(-1)};
+    }
+
+    /**
+     * \brief Make handle of buffer relative to arena.
+     * \return Valid handle if OK, invalid() if buffer is not inside arena or offset/size do not fit u32.
+     */
+    [[nodiscard, gnu::always_inline]] static inline CompactBuffer from(ConstBuffer arena, ConstBuffer buffer) {
+        // Compare as integers: pointers into different objects can not be compared in C++.
+        const uintptr_t begin = reinterpret_cast<uintptr_t>(arena.data);
+        const uintptr_t position = reinterpret_cast<uintptr_t>(buffer.data);
+        if(position < begin || position - begin > arena.size || arena.size - (position - begin) < buffer.size) {
+            return invalid();
+        }
+        const usize _offset = position - begin;
+        if(_offset >= u32(-1) || buffer.size >= u32(-1)) {
+            return invalid();
+        }
+        return {u32(_offset), u32(buffer.size)};
+    }
+
+    /// \brief false for invalid().
+    [[nodiscard, gnu::always_inline]] inline bool valid() const {
+        return *this != invalid();
+    }
+
+    /**
+     * \brief Get the bytes inside arena.
+     * \return Valid buffer if OK, {nullptr, 0} if handle is outside arena (or invalid()).
+     */
+    [[nodiscard, gnu::always_inline]] inline ConstBuffer resolve(ConstBuffer arena) const {
+        if(arena.size < offset || arena.size - offset < size || not valid()) {
+            return {};
+        }
+        return {arena.data + offset, size};
+    }
+
+    /// \brief Handle as one integer (offset in the high half), ordered the same way as operator<=>.
+    [[nodiscard, gnu::always_inline]] inline u64 as_u64() const {
+        return (u64(offset) << 32) | size;
+    }
+
+    friend constexpr bool operator==(CompactBuffer, CompactBuffer) = default;
+    friend constexpr auto operator<=>(CompactBuffer, CompactBuffer) = default;
+
+    /// \brief Compare content of handles in arena (lexicographically), for sorting.
+    struct Less {
+        ConstBuffer arena;
+
+        [[nodiscard, gnu::always_inline]] inline bool operator()(CompactBuffer left, CompactBuffer right) const {
+            return compare(left.resolve(arena), right.resolve(arena)) < 0;
+        }
+    };
+
+    /// \brief Compare content of handles in arena, for hash tables.
+    struct Equal {
+        ConstBuffer arena;
+
+        [[nodiscard, gnu::always_inline]] inline bool operator()(CompactBuffer left, CompactBuffer right) const {
+            return left == right || equal(left.resolve(arena), right.resolve(arena));
+        }
+    };
+
+    /// \brief Hash content of handles in arena, for hash tables.
+    struct Hash {
+        ConstBuffer arena;
+
+        [[nodiscard, gnu::always_inline]] inline usize operator()(CompactBuffer handle) const {
+            const ConstBuffer buffer = handle.resolve(arena);
+            return std::hash<std::string_view>()({reinterpret_cast<const char *>(buffer.data), buffer.size});
+        }
+    };
+};
+
+static_assert(sizeof(CompactBuffer) == 8);
+
+}
+
+template<>
+struct std::hash<sedfer::CompactBuffer> {
+    [[nodiscard, gnu::always_inline]] inline sedfer::usize operator()(sedfer::CompactBuffer handle) const {
+        // Fibonacci hashing of the 8 handle bytes, good spread for sequential offsets.
+        const sedfer::u64 value = handle.as_u64() * 0x9E3779B97F4A7C15;
+        return sedfer::usize(value ^ (value >> 32));
+    }
+};
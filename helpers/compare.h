@@ -0,0 +1,256 @@
+#pragma once
+
+#include "helpers/cpu.h"
+#include "helpers/types.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace sedfer {
+
+/**
+ * \brief memcmp-like ordering, first mismatch and equality of two byte arrays of the same size.
+ *
+ * Inputs up to 16 bytes are compared with two overlapping word loads (no loop, no call),
+ * ordering is taken from the byte-swapped first differing word. Up to 32 bytes two overlapping SSE2 loads
+ * are compared (sse2 tier and above). Longer inputs use 16/32-byte SIMD loops (128 bytes per iteration) with an
+ * overlapping final load, the first differing byte is found from the compare mask.
+ */
+namespace kernels {
+
+namespace scalar {
+
+[[gnu::always_inline]] inline u64 load_u64(const u8 * data) {
+    u64 ret;
+    std::memcpy(&ret, data, sizeof(ret));
+    return ret;
+}
+
+[[gnu::always_inline]] inline u32 load_u32(const u8 * data) {
+    u32 ret;
+    std::memcpy(&ret, data, sizeof(ret));
+    return ret;
+}
+
+/// \brief Offset of the first byte where left and right differ, size if equal.
+inline usize mismatch(const u8 * left, const u8 * right, usize size) {
+    usize i = 0;
+    for(; i + 8 <= size; i += 8) {
+        const u64 diff = load_u64(left + i) ^ load_u64(right + i);
+        if(diff != 0) {
+            return i + __builtin_ctzll(diff) / 8;
+        }
+    }
+    for(; i < size; ++i) {
+        if(left[i] != right[i]) {
+            return i;
+        }
+    }
+    return size;
+}
+
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+namespace sse2 {
+
+[[gnu::target("sse2")]] inline usize mismatch(const u8 * left, const u8 * right, usize size) {
+    if(size < 16) {
+        return scalar::mismatch(left, right, size);
+    }
+
+    usize i = 0;
+    for(; i + 16 <= size; i += 16) {
+        const __m128i l = _mm_loadu_si128(reinterpret_cast<const __m128i *>(left + i));
+        const __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i *>(right + i));
+        const u32 mask = _mm_movemask_epi8(_mm_cmpeq_epi8(l, r)) ^ 0xffff;
+        if(mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+
+    if(i != size) {
+        i = size - 16;
+        const __m128i l = _mm_loadu_si128(reinterpret_cast<const __m128i *>(left + i));
+        const __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i *>(right + i));
+        const u32 mask = _mm_movemask_epi8(_mm_cmpeq_epi8(l, r)) ^ 0xffff;
+        if(mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return size;
+}
+
+/// \brief Offset of the first differing byte of 17-32 bytes, size - 1 if equal.
+[[gnu::target("sse2")]] inline usize compare_index(const u8 * left, const u8 * right, usize size) {
+    // Two overlapping loads, bit j of mask is set if byte j differs (overlapping bits agree).
+    const u32 head = u32(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(left)),
+                                                          _mm_loadu_si128(reinterpret_cast<const __m128i *>(right)))));
+    const u32 tail = u32(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(left + size - 16)),
+                                                          _mm_loadu_si128(reinterpret_cast<const __m128i *>(right + size - 16)))));
+    const u64 mask = u64(head ^ 0xffff) | (u64(tail ^ 0xffff) << (size - 16));
+    return (mask != 0) ? usize(__builtin_ctzll(mask)) : size - 1;
+}
+
+}
+
+namespace avx2 {
+
+/// \brief Bit i is set if left[i] == right[i], for 64 bytes.
+[[gnu::target("avx2")]] inline u64 equal_mask_64(const u8 * left, const u8 * right) {
+    const __m256i a = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(left)),
+                                        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(right)));
+    const __m256i b = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(left + 32)),
+                                        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(right + 32)));
+    return u64(u32(_mm256_movemask_epi8(a))) | (u64(u32(_mm256_movemask_epi8(b))) << 32);
+}
+
+[[gnu::target("avx2,bmi")]] inline usize mismatch(const u8 * left, const u8 * right, usize size) {
+    if(size < 32) {
+        return sse2::mismatch(left, right, size);
+    }
+
+    if(size <= 64) {
+        const u32 head = ~u32(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(left)),
+                                                                     _mm256_loadu_si256(reinterpret_cast<const __m256i *>(right)))));
+        if(head != 0) {
+            return _tzcnt_u32(head);
+        }
+        const u32 tail = ~u32(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(left + size - 32)),
+                                                                     _mm256_loadu_si256(reinterpret_cast<const __m256i *>(right + size - 32)))));
+        return (tail != 0) ? size - 32 + _tzcnt_u32(tail) : size;
+    }
+
+    if(size <= 128) {
+        const u64 head = ~equal_mask_64(left, right);
+        if(head != 0) {
+            return _tzcnt_u64(head);
+        }
+        const u64 tail = ~equal_mask_64(left + size - 64, right + size - 64);
+        return (tail != 0) ? size - 64 + _tzcnt_u64(tail) : size;
+    }
+
+    // 128 bytes per iteration: OR of XORs is tested once, the differing 64-byte half is located on exit.
+    usize i = 0;
+    for(;; i += 128) {
+        if(i + 128 > size) {
+            i = size - 128;
+        }
+        const __m256i * const l = reinterpret_cast<const __m256i *>(left + i);
+        const __m256i * const r = reinterpret_cast<const __m256i *>(right + i);
+        const __m256i diff_0 = _mm256_xor_si256(_mm256_loadu_si256(l), _mm256_loadu_si256(r));
+        const __m256i diff_1 = _mm256_xor_si256(_mm256_loadu_si256(l + 1), _mm256_loadu_si256(r + 1));
+        const __m256i diff_2 = _mm256_xor_si256(_mm256_loadu_si256(l + 2), _mm256_loadu_si256(r + 2));
+        const __m256i diff_3 = _mm256_xor_si256(_mm256_loadu_si256(l + 3), _mm256_loadu_si256(r + 3));
+        const __m256i diff = _mm256_or_si256(_mm256_or_si256(diff_0, diff_1), _mm256_or_si256(diff_2, diff_3));
+        if(not _mm256_testz_si256(diff, diff)) {
+            const u64 head = ~equal_mask_64(left + i, right + i);
+            if(head != 0) {
+                return i + _tzcnt_u64(head);
+            }
+            return i + 64 + _tzcnt_u64(~equal_mask_64(left + i + 64, right + i + 64));
+        }
+        if(i + 128 == size) {
+            break;
+        }
+    }
+    return size;
+}
+
+}
+
+#endif
+
+/// \brief Offset of the first byte where left and right differ, size if equal.
+inline usize mismatch(const u8 * left, const u8 * right, usize size) {
+#if defined(__x86_64__) || defined(__i386__)
+    switch(cpu_tier()) {
+        case CpuTier::avx512:
+        case CpuTier::avx2: return avx2::mismatch(left, right, size);
+        case CpuTier::sse42:
+        case CpuTier::sse2: return sse2::mismatch(left, right, size);
+        case CpuTier::scalar: break;
+    }
+#endif
+    return scalar::mismatch(left, right, size);
+}
+
+/// \brief Sign of (left - right) for big-endian words, without branches.
+template<typename T>
+[[gnu::always_inline]] inline int sign(T left, T right) {
+    return int(left > right) - int(left < right);
+}
+
+/**
+ * \brief Lexicographic order of size bytes at left and right, like memcmp: < 0, 0 or > 0.
+ *
+ * The result is computed without data-dependent branches up to 32 bytes (sorting compares are unpredictable):
+ * the first differing word is selected with conditional moves and compared as a big-endian integer.
+ */
+[[gnu::always_inline]] inline int compare(const u8 * left, const u8 * right, usize size) {
+    if(size <= 16) {
+        if(size >= 8) {
+            const u64 l_head = __builtin_bswap64(scalar::load_u64(left));
+            const u64 r_head = __builtin_bswap64(scalar::load_u64(right));
+            const u64 l_tail = __builtin_bswap64(scalar::load_u64(left + size - 8));
+            const u64 r_tail = __builtin_bswap64(scalar::load_u64(right + size - 8));
+            return (l_head != r_head) ? sign(l_head, r_head) : sign(l_tail, r_tail);
+        }
+        if(size >= 4) {
+            const u32 l_head = __builtin_bswap32(scalar::load_u32(left));
+            const u32 r_head = __builtin_bswap32(scalar::load_u32(right));
+            const u32 l_tail = __builtin_bswap32(scalar::load_u32(left + size - 4));
+            const u32 r_tail = __builtin_bswap32(scalar::load_u32(right + size - 4));
+            return (l_head != r_head) ? sign(l_head, r_head) : sign(l_tail, r_tail);
+        }
+        if(size == 0) {
+            return 0;
+        }
+        // 1-3 bytes: first, middle and last byte as one big-endian integer.
+        const u32 l = (u32(left[0]) << 16) | (u32(left[size / 2]) << 8) | left[size - 1];
+        const u32 r = (u32(right[0]) << 16) | (u32(right[size / 2]) << 8) | right[size - 1];
+        return sign(l, r);
+    }
+
+    usize i;
+#if defined(__x86_64__) || defined(__i386__)
+    if(size <= 32 && cpu_tier() >= CpuTier::sse2) {
+        i = sse2::compare_index(left, right, size);
+    } else
+#endif
+    {
+        i = std::min(mismatch(left, right, size), size - 1);
+    }
+    // If all bytes are equal i is size - 1 and the difference is 0.
+    return int(left[i]) - int(right[i]);
+}
+
+/// \brief true if size bytes at left and right are equal.
+[[gnu::always_inline]] inline bool equal(const u8 * left, const u8 * right, usize size) {
+    if(size >= 8) {
+        if(size <= 16) {
+            return ((scalar::load_u64(left) ^ scalar::load_u64(right)) |
+                    (scalar::load_u64(left + size - 8) ^ scalar::load_u64(right + size - 8))) == 0;
+        }
+        return mismatch(left, right, size) == size;
+    }
+    if(size >= 4) {
+        return ((scalar::load_u32(left) ^ scalar::load_u32(right)) |
+                (scalar::load_u32(left + size - 4) ^ scalar::load_u32(right + size - 4))) == 0;
+    }
+    for(usize i = 0; i < size; ++i) {
+        if(left[i] != right[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+}
@@ -0,0 +1,183 @@
+#pragma once
+
+#include "helpers/cpu.h"
+#include "helpers/types.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace sedfer {
+
+namespace kernels {
+
+/// \brief Copies up to this size are done inline, larger ones call copy_large.
+inline constexpr usize SMALL_COPY_SIZE = 64;
+
+/// \brief Bytes ahead of the current source position to prefetch in the streaming copy loop.
+inline constexpr usize STREAMING_PREFETCH_DISTANCE = 1024;
+
+/**
+ * \brief Copies and fills of at least this many bytes use non-temporal (streaming) stores, which do not allocate
+ * destination lines in the cache: a multi-MB copy does not evict the caller's hot data.
+ *
+ * The destination is not in the cache after a streaming copy, so keep the threshold above the size of data
+ * that is read back right after the copy. Tunable at runtime (set once at startup, it is not synchronized).
+ */
+inline usize streaming_copy_threshold = usize(4) << 20;
+
+/**
+ * \brief Copy size bytes (N <= size <= 2 * N) with two overlapping N-byte blocks: head and tail.
+ *
+ * Both blocks are loaded before anything is stored, so a single unaligned load/store pair per block is emitted
+ * and destination may overlap source.
+ */
+// GCC warns when this is inlined into a call with a smaller source array: the size class is only known at runtime.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Warray-bounds"
+template<usize N>
+[[gnu::always_inline]] inline void copy_overlapping(u8 * destination, const u8 * source, usize size) {
+    struct Block {
+        u8 bytes[N];
+    };
+    Block head;
+    Block tail;
+    std::memcpy(&head, source, N);
+    std::memcpy(&tail, source + size - N, N);
+    std::memcpy(destination, &head, N);
+    std::memcpy(destination + size - N, &tail, N);
+}
+#pragma GCC diagnostic pop
+
+#if defined(__x86_64__) || defined(__i386__)
+
+namespace sse2 {
+
+/// \brief Copy with 16-byte non-temporal stores and software prefetch of the source, size >= 64.
+[[gnu::target("sse2")]] inline void copy_streaming(u8 * destination, const u8 * source, usize size) {
+    // Unaligned head, then continue from the first 16-byte aligned destination address.
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(destination), _mm_loadu_si128(reinterpret_cast<const __m128i *>(source)));
+    const usize head = 16 - (reinterpret_cast<uintptr_t>(destination) & 15);
+    destination += head;
+    source += head;
+    size -= head;
+
+    for(; size >= 64; size -= 64, destination += 64, source += 64) {
+        _mm_prefetch(reinterpret_cast<const char *>(source + STREAMING_PREFETCH_DISTANCE), _MM_HINT_T0);
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + 16));
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + 32));
+        const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + 48));
+        _mm_stream_si128(reinterpret_cast<__m128i *>(destination), a);
+        _mm_stream_si128(reinterpret_cast<__m128i *>(destination + 16), b);
+        _mm_stream_si128(reinterpret_cast<__m128i *>(destination + 32), c);
+        _mm_stream_si128(reinterpret_cast<__m128i *>(destination + 48), d);
+    }
+    // Streaming stores are weakly ordered: make them visible before the copy is reported done.
+    _mm_sfence();
+
+    for(; size >= 16; size -= 16, destination += 16, source += 16) {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(destination), _mm_loadu_si128(reinterpret_cast<const __m128i *>(source)));
+    }
+    std::memcpy(destination, source, size);
+}
+
+}
+
+namespace avx2 {
+
+/// \brief Copy with 32-byte non-temporal stores (128 bytes per iteration) and software prefetch, size >= 64.
+[[gnu::target("avx2")]] inline void copy_streaming(u8 * destination, const u8 * source, usize size) {
+    // Unaligned head, then continue from the first 32-byte aligned destination address.
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(destination), _mm256_loadu_si256(reinterpret_cast<const __m256i *>(source)));
+    const usize head = 32 - (reinterpret_cast<uintptr_t>(destination) & 31);
+    destination += head;
+    source += head;
+    size -= head;
+
+    for(; size >= 128; size -= 128, destination += 128, source += 128) {
+        _mm_prefetch(reinterpret_cast<const char *>(source + STREAMING_PREFETCH_DISTANCE), _MM_HINT_T0);
+        _mm_prefetch(reinterpret_cast<const char *>(source + STREAMING_PREFETCH_DISTANCE + 64), _MM_HINT_T0);
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(source));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(source + 32));
+        const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(source + 64));
+        const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(source + 96));
+        _mm256_stream_si256(reinterpret_cast<__m256i *>(destination), a);
+        _mm256_stream_si256(reinterpret_cast<__m256i *>(destination + 32), b);
+        _mm256_stream_si256(reinterpret_cast<__m256i *>(destination + 64), c);
+        _mm256_stream_si256(reinterpret_cast<__m256i *>(destination + 96), d);
+    }
+    _mm_sfence();
+
+    for(; size >= 32; size -= 32, destination += 32, source += 32) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(destination), _mm256_loadu_si256(reinterpret_cast<const __m256i *>(source)));
+    }
+    std::memcpy(destination, source, size);
+}
+
+}
+
+#endif
+
+/// \brief Copy with non-temporal stores where available (memmove otherwise), size >= SMALL_COPY_SIZE.
+inline void copy_streaming(u8 * destination, const u8 * source, usize size) {
+#if defined(__x86_64__) || defined(__i386__)
+    switch(cpu_tier()) {
+        case CpuTier::avx512:
+        case CpuTier::avx2: avx2::copy_streaming(destination, source, size); return;
+        case CpuTier::sse42:
+        case CpuTier::sse2: sse2::copy_streaming(destination, source, size); return;
+        case CpuTier::scalar: break;
+    }
+#endif
+    // Same path as copy_large for overlapping buffers: once inlined there, GCC does not see its overlap check (-Wrestrict).
+    std::memmove(destination, source, size);
+}
+
+/// \brief Out-of-line part of copy: memmove, or streaming stores from streaming_copy_threshold if buffers do not overlap.
+inline void copy_large(u8 * destination, const u8 * source, usize size) {
+    const uintptr_t to = reinterpret_cast<uintptr_t>(destination);
+    const uintptr_t from = reinterpret_cast<uintptr_t>(source);
+    if(size >= streaming_copy_threshold && (to + size <= from || from + size <= to)) {
+        copy_streaming(destination, source, size);
+        return;
+    }
+    std::memmove(destination, source, size);
+}
+
+/**
+ * \brief Copy size bytes from source to destination (like memmove, buffers may overlap).
+ *
+ * Runtime sizes up to SMALL_COPY_SIZE are copied inline by size class (1, 2-3, 4-7, 8-15, 16-31, 32-64 bytes),
+ * each class with two overlapping unaligned loads and stores: no loop and no call.
+ * Larger sizes are forwarded to copy_large: memmove, or non-temporal stores from streaming_copy_threshold.
+ */
+[[gnu::always_inline]] inline void copy(u8 * destination, const u8 * source, usize size) {
+    if(size <= 16) {
+        if(size >= 8) {
+            copy_overlapping<8>(destination, source, size);
+        } else if(size >= 4) {
+            copy_overlapping<4>(destination, source, size);
+        } else if(size >= 2) {
+            copy_overlapping<2>(destination, source, size);
+        } else if(size == 1) {
+            *destination = *source;
+        }
+        return;
+    }
+    if(size <= 32) {
+        copy_overlapping<16>(destination, source, size);
+        return;
+    }
+    if(size <= SMALL_COPY_SIZE) {
+        copy_overlapping<32>(destination, source, size);
+        return;
+    }
+    copy_large(destination, source, size);
+}
+
+}
+
+}
@@ -0,0 +1,173 @@
+#pragma once
+
+#include "helpers/buffer.h"
+#include "helpers/copy.h"
+#include "helpers/types.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sedfer {
+
+/**
+ * \brief CopyPool splits very large copies across worker threads (each chunk uses streaming stores).
+ *
+ * A single core rarely saturates memory bandwidth on server CPUs, several cores copying disjoint chunks do.
+ * Copies below parallel_threshold are done by the calling thread with kernels::copy.
+ * The calling thread always copies one chunk itself and returns when all chunks are done.
+ * \code
+ * CopyPool pool(4);
+ *
+ * MutableBuffer output = ...;
+ * if(not pool.push(output, blob)) {
+ *     // Not enough space in output
+ * }
+ * \endcode
+ * \note One copy at a time: copy / push must not be called concurrently on the same pool.
+ */
+class CopyPool {
+public:
+    /// \brief Default minimal size of a parallel copy.
+    static constexpr usize PARALLEL_THRESHOLD = usize(32) << 20;
+
+    /// \brief Chunks are cache line multiples of at least this size.
+    static constexpr usize MIN_CHUNK_SIZE = usize(1) << 20;
+
+    /// \brief Start threads - 1 workers (the caller is the last thread).
+    inline explicit CopyPool(usize threads, usize _parallel_threshold = PARALLEL_THRESHOLD)
+        : parallel_threshold(_parallel_threshold)
+    {
+        for(usize i = 1; i < threads; ++i) {
+            workers.emplace_back([this] { work(); });
+        }
+    }
+
+    CopyPool(const CopyPool &) = delete;
+    CopyPool & operator=(const CopyPool &) = delete;
+
+    inline ~CopyPool() {
+        {
+            std::lock_guard lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for(std::thread & worker : workers) {
+            worker.join();
+        }
+    }
+
+    /// \brief Number of threads taking part in a parallel copy (workers + caller).
+    [[nodiscard, gnu::always_inline]] inline usize threads() const {
+        return workers.size() + 1;
+    }
+
+    /// \brief Copy size bytes from source to destination (buffers must not overlap).
+    inline void copy(u8 * destination, const u8 * source, usize size) {
+        if(size < parallel_threshold || workers.empty()) {
+            kernels::copy(destination, source, size);
+            return;
+        }
+
+        const usize chunk = std::max(MIN_CHUNK_SIZE, (size / threads() + 63) & ~usize(63));
+        Job current;
+        {
+            std::lock_guard lock(mutex);
+            ++generation;
+            job = {destination, source, size, chunk, u32(generation)};
+            claims.store(u64(job.generation) << 32, std::memory_order_relaxed);
+            pending = (size + chunk - 1) / chunk;
+            current = job;
+        }
+        wake.notify_all();
+
+        run_chunks(current);
+
+        // Every chunk is claimed with this generation: a late worker sees a newer one and touches nothing.
+        std::unique_lock lock(mutex);
+        done.wait(lock, [this] { return pending == 0; });
+    }
+
+    /**
+     * \brief Copy const_buffer into the first bytes of mutable_buffer, which are consumed (like MutableBuffer::push).
+     * \return true if OK, false if const_buffer.size > mutable_buffer.size.
+     */
+    [[nodiscard]] inline bool push(MutableBuffer & mutable_buffer, ConstBuffer const_buffer) {
+        if(mutable_buffer.size < const_buffer.size) {
+            return false;
+        }
+        copy(mutable_buffer.data, const_buffer.data, const_buffer.size);
+        return mutable_buffer.skip(const_buffer.size);
+    }
+
+private:
+    struct Job {
+        u8 * destination = nullptr;
+        const u8 * source = nullptr;
+        usize size = 0;
+        usize chunk = 0;
+        u32 generation = 0;
+    };
+
+    usize parallel_threshold;
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    Job job;
+    std::atomic<u64> claims = 0; ///< Generation of the current copy (high 32 bits), index of the next chunk (low 32 bits).
+    usize pending = 0;
+    u64 generation = 0;
+    bool stopping = false;
+
+    /// \brief Take chunks of current until none are left, streaming stores regardless of streaming_copy_threshold.
+    inline void run_chunks(const Job & current) {
+        usize finished = 0;
+        u64 claim = claims.load(std::memory_order_relaxed);
+        while((claim >> 32) == current.generation) {
+            const usize offset = usize(u32(claim)) * current.chunk;
+            if(offset >= current.size) {
+                break;
+            }
+            // The generation and the index change together: a chunk is never claimed for a stale job.
+            if(not claims.compare_exchange_weak(claim, claim + 1, std::memory_order_relaxed)) {
+                continue;
+            }
+            const usize size = std::min(current.chunk, current.size - offset);
+            if(size > kernels::SMALL_COPY_SIZE) {
+                kernels::copy_streaming(current.destination + offset, current.source + offset, size);
+            } else {
+                kernels::copy(current.destination + offset, current.source + offset, size);
+            }
+            ++finished;
+            claim = claims.load(std::memory_order_relaxed);
+        }
+        if(finished != 0) {
+            std::lock_guard lock(mutex);
+            pending -= finished;
+        }
+    }
+
+    inline void work() {
+        u64 seen = 0;
+        while(true) {
+            Job current;
+            {
+                std::unique_lock lock(mutex);
+                wake.wait(lock, [&] { return stopping || generation != seen; });
+                if(stopping) {
+                    return;
+                }
+                seen = generation;
+                current = job;
+            }
+            run_chunks(current);
+            done.notify_one();
+        }
+    }
+};
+
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "helpers/types.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace sedfer {
+
+/**
+ * \brief Instruction set tiers used to select SIMD kernels. Every tier includes all lower tiers.
+ *
+ * 1. scalar: portable C++.
+ * 2. sse2: baseline x86-64.
+ * 3. sse42: + SSSE3, SSE4.1, SSE4.2, POPCNT, PCLMUL.
+ * 4. avx2: + AVX, AVX2, BMI1, BMI2.
+ * 5. avx512: + AVX-512 F, BW, VL.
+ */
+enum class CpuTier : u8 {
+    scalar,
+    sse2,
+    sse42,
+    avx2,
+    avx512,
+};
+
+/// \brief Detect the highest tier supported by this CPU.
+inline CpuTier detect_cpu_tier() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+
+    if(not __builtin_cpu_supports("sse2")) {
+        return CpuTier::scalar;
+    }
+    if(not (__builtin_cpu_supports("ssse3") && __builtin_cpu_supports("sse4.1") && __builtin_cpu_supports("sse4.2") &&
+            __builtin_cpu_supports("popcnt") && __builtin_cpu_supports("pclmul"))) {
+        return CpuTier::sse2;
+    }
+    if(not (__builtin_cpu_supports("avx") && __builtin_cpu_supports("avx2") &&
+            __builtin_cpu_supports("bmi") && __builtin_cpu_supports("bmi2"))) {
+        return CpuTier::sse42;
+    }
+    if(not (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512vl"))) {
+        return CpuTier::avx2;
+    }
+    return CpuTier::avx512;
+#else
+    return CpuTier::scalar;
+#endif
+}
+
+/// \brief Tier names as accepted in SEDFER_CPU_TIER: "scalar", "sse2", "sse42", "avx2", "avx512".
+inline const char * cpu_tier_name(CpuTier tier) {
+    switch(tier) {
+        case CpuTier::scalar: return "scalar";
+        case CpuTier::sse2: return "sse2";
+        case CpuTier::sse42: return "sse42";
+        case CpuTier::avx2: return "avx2";
+        case CpuTier::avx512: return "avx512";
+    }
+    return "unknown";
+}
+
+/**
+ * \brief Parse a tier name (see cpu_tier_name).
+ * \return true if OK, false if name is not a tier name.
+ */
+[[nodiscard]] inline bool parse_cpu_tier(const char * name, CpuTier & ret) {
+    for(const CpuTier tier : {CpuTier::scalar, CpuTier::sse2, CpuTier::sse42, CpuTier::avx2, CpuTier::avx512}) {
+        if(std::strcmp(name, cpu_tier_name(tier)) == 0) {
+            ret = tier;
+            return true;
+        }
+    }
+    return false;
+}
+
+/// \brief Highest tier supported by this CPU (detected once). Kernels of higher tiers must not be called.
+[[gnu::always_inline]] inline CpuTier detected_cpu_tier() {
+    static const CpuTier tier = detect_cpu_tier();
+    return tier;
+}
+
+/// \brief Tier selected at startup: detected_cpu_tier(), lowered by the SEDFER_CPU_TIER environment variable if set.
+inline CpuTier initial_cpu_tier() {
+    CpuTier tier = detected_cpu_tier();
+    const char * name = std::getenv("SEDFER_CPU_TIER");
+    CpuTier forced;
+    if(name != nullptr && parse_cpu_tier(name, forced) && forced < tier) {
+        tier = forced;
+    }
+    return tier;
+}
+
+/// \brief Storage of the tier used by all kernel dispatchers, see cpu_tier() / set_cpu_tier().
+[[gnu::always_inline]] inline CpuTier & active_cpu_tier() {
+    static CpuTier tier = initial_cpu_tier();
+    return tier;
+}
+
+/**
+ * \brief Tier used by all kernel dispatchers (resolved once, then a single load per call).
+ *
+ * Every buffer operation with SIMD kernels switches on this value, so forcing a lower tier
+ * (SEDFER_CPU_TIER=sse2 ./app, or set_cpu_tier) runs the whole program on that tier's kernels.
+ */
+[[gnu::always_inline]] inline CpuTier cpu_tier() {
+    return active_cpu_tier();
+}
+
+/**
+ * \brief Force the tier used by kernel dispatchers, clamped to detected_cpu_tier().
+ * \return The tier now in use.
+ * \note Not synchronized: set it at startup or between tests, not while other threads run kernels.
+ * Objects that pick a kernel on construction (PatternSet) keep the tier active at that time.
+ */
+inline CpuTier set_cpu_tier(CpuTier tier) {
+    active_cpu_tier() = std::min(tier, detected_cpu_tier());
+    return active_cpu_tier();
+}
+
+}
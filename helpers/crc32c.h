@@ -0,0 +1,270 @@
+#pragma once
+
+#include "helpers/buffer.h"
+#include "helpers/cpu.h"
+#include "helpers/types.h"
+
+#include <array>
+#include <bit>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace sedfer {
+
+/**
+ * \brief CRC32C (Castagnoli): slicing-by-8 tables, the SSE4.2 crc32 instruction, and GF(2) helpers to combine CRCs.
+ *
+ * Kernels update the raw CRC register (no initial / final inversion), so chunks can be chained directly.
+ * Polynomials are in reflected bit order: bit 31 is the coefficient of x^0.
+ */
+namespace kernels {
+
+/// \brief Reflected CRC32C polynomial.
+inline constexpr u32 CRC32C_POLY = 0x82f63b78;
+
+/// \brief a * b modulo the CRC32C polynomial (reflected).
+[[nodiscard]] constexpr inline u32 crc32c_multiply(u32 a, u32 b) {
+    u32 ret = 0;
+    for(u32 mask = u32(1) << 31; mask != 0; mask >>= 1) {
+        if(a & mask) {
+            ret ^= b;
+        }
+        b = (b & 1) ? (b >> 1) ^ CRC32C_POLY : b >> 1;
+    }
+    return ret;
+}
+
+/// \brief x^(2^k) modulo the CRC32C polynomial for k = 0..63.
+inline constexpr std::array<u32, 64> CRC32C_X_POW_2N = [] {
+    std::array<u32, 64> ret = {};
+    ret[0] = u32(1) << 30; // x^1
+    for(usize k = 1; k < 64; ++k) {
+        ret[k] = crc32c_multiply(ret[k - 1], ret[k - 1]);
+    }
+    return ret;
+}();
+
+/// \brief x^n modulo the CRC32C polynomial.
+[[nodiscard]] constexpr inline u32 crc32c_x_pow(u64 n) {
+    u32 ret = u32(1) << 31; // x^0
+    for(usize k = 0; n != 0; n >>= 1, ++k) {
+        if(n & 1) {
+            ret = crc32c_multiply(CRC32C_X_POW_2N[k], ret);
+        }
+    }
+    return ret;
+}
+
+/// \brief Raw CRC register after size zero bytes are appended.
+[[nodiscard]] constexpr inline u32 crc32c_shift(u32 crc, u64 size) {
+    return crc32c_multiply(crc32c_x_pow(size * 8), crc);
+}
+
+/// \brief Slicing-by-8 tables: TABLES[k][byte] is the CRC of byte followed by k zero bytes.
+inline constexpr std::array<std::array<u32, 256>, 8> CRC32C_TABLES = [] {
+    std::array<std::array<u32, 256>, 8> ret = {};
+    for(u32 byte = 0; byte < 256; ++byte) {
+        u32 crc = byte;
+        for(usize bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1) ? (crc >> 1) ^ CRC32C_POLY : crc >> 1;
+        }
+        ret[0][byte] = crc;
+    }
+    for(usize k = 1; k < 8; ++k) {
+        for(usize byte = 0; byte < 256; ++byte) {
+            ret[k][byte] = (ret[k - 1][byte] >> 8) ^ ret[0][ret[k - 1][byte] & 0xff];
+        }
+    }
+    return ret;
+}();
+
+namespace scalar {
+
+/// \brief Slicing-by-8: one 8-byte word per iteration, 8 independent table lookups.
+inline u32 crc32c(u32 crc, const u8 * data, usize size) {
+    const auto & t = CRC32C_TABLES;
+    for(; size >= 8; size -= 8, data += 8) {
+        u64 word;
+        std::memcpy(&word, data, 8);
+        if constexpr(std::endian::native == std::endian::big) {
+            word = std::byteswap(word);
+        }
+        word ^= crc;
+        crc = t[7][word & 0xff] ^ t[6][(word >> 8) & 0xff] ^ t[5][(word >> 16) & 0xff] ^ t[4][(word >> 24) & 0xff] ^
+              t[3][(word >> 32) & 0xff] ^ t[2][(word >> 40) & 0xff] ^ t[1][(word >> 48) & 0xff] ^ t[0][word >> 56];
+    }
+    for(; size != 0; --size, ++data) {
+        crc = (crc >> 8) ^ t[0][(crc ^ *data) & 0xff];
+    }
+    return crc;
+}
+
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+namespace sse42 {
+
+/**
+ * \brief Raw CRC register shifted over size bytes (size >= 5): one carry-less multiply by x^(8 * size - 33),
+ * reduced to 32 bits by the crc32 instruction (which multiplies by x^32, the product is already times x).
+ */
+template<usize size>
+[[gnu::target("sse4.2,pclmul"), gnu::always_inline]] inline u32 crc32c_shift(u32 crc) {
+    static constexpr u32 CONSTANT = crc32c_x_pow(size * 8 - 33);
+    const __m128i product = _mm_clmulepi64_si128(_mm_cvtsi32_si128(int(crc)), _mm_cvtsi32_si128(int(CONSTANT)), 0x00);
+    return u32(_mm_crc32_u64(0, u64(_mm_cvtsi128_si64(product))));
+}
+
+[[gnu::target("sse4.2"), gnu::always_inline]] inline u64 crc32c_word(u64 crc, const u8 * data) {
+    u64 word;
+    std::memcpy(&word, data, 8);
+    return _mm_crc32_u64(crc, word);
+}
+
+/**
+ * \brief crc32 instruction on 3 independent streams of stream bytes while size >= 3 * stream.
+ *
+ * The instruction has a latency of 3 cycles and a throughput of 1 per cycle: three interleaved chains keep it busy.
+ * Stream CRCs are merged with crc32c_shift (PCLMUL), which costs a few cycles per block.
+ */
+template<usize stream>
+[[gnu::target("sse4.2,pclmul"), gnu::always_inline]] inline u32 crc32c_3way(u32 crc, const u8 *& data, usize & size) {
+    for(; size >= 3 * stream; size -= 3 * stream, data += 3 * stream) {
+        u64 a = crc;
+        u64 b = 0;
+        u64 c = 0;
+        for(usize i = 0; i < stream; i += 8) {
+            a = crc32c_word(a, data + i);
+            b = crc32c_word(b, data + stream + i);
+            c = crc32c_word(c, data + 2 * stream + i);
+        }
+        crc = crc32c_shift<2 * stream>(u32(a)) ^ crc32c_shift<stream>(u32(b)) ^ u32(c);
+    }
+    return crc;
+}
+
+/// \brief 3-way interleaved crc32 on 3 x 4 KiB and 3 x 256 byte blocks, single chain for the tail.
+[[gnu::target("sse4.2,pclmul")]] inline u32 crc32c(u32 crc, const u8 * data, usize size) {
+    crc = crc32c_3way<4096>(crc, data, size);
+    crc = crc32c_3way<256>(crc, data, size);
+    u64 crc64 = crc;
+    for(; size >= 8; size -= 8, data += 8) {
+        crc64 = crc32c_word(crc64, data);
+    }
+    crc = u32(crc64);
+    for(; size != 0; --size, ++data) {
+        crc = _mm_crc32_u8(crc, *data);
+    }
+    return crc;
+}
+
+}
+
+#endif
+
+/// \brief Update the raw CRC32C register with size bytes at data.
+inline u32 crc32c(u32 crc, const u8 * data, usize size) {
+#if defined(__x86_64__) || defined(__i386__)
+    switch(cpu_tier()) {
+        case CpuTier::avx512:
+        case CpuTier::avx2:
+        case CpuTier::sse42: return sse42::crc32c(crc, data, size);
+        case CpuTier::sse2:
+        case CpuTier::scalar: break;
+    }
+#endif
+    return scalar::crc32c(crc, data, size);
+}
+
+}
+
+/**
+ * \brief CRC32C (Castagnoli, iSCSI / ext4 / SCTP) of buffer.
+ *
+ * seed is the CRC of preceding bytes, so crc32c(b, crc32c(a)) == crc32c(a + b).
+ * Uses the SSE4.2 crc32 instruction where available (3 interleaved streams for long inputs).
+ */
+[[nodiscard, gnu::always_inline]] inline u32 crc32c(ConstBuffer buffer, u32 seed = 0) {
+    return ~kernels::crc32c(~seed, buffer.data, buffer.size);
+}
+
+/**
+ * \brief CRC32C of a + b from crc1 = crc32c(a), crc2 = crc32c(b) and b.size (e.g. chunks checksummed in parallel).
+ * \note Costs O(log(size2)) polynomial multiplications, independent of the data.
+ */
+[[nodiscard]] constexpr inline u32 crc32c_combine(u32 crc1, u32 crc2, u64 size2) {
+    return kernels::crc32c_shift(crc1, size2) ^ crc2;
+}
+
+/**
+ * \brief Incremental CRC32C over data arriving in chunks.
+ * \code
+ * Crc32c crc;
+ * for(ConstBuffer chunk : chunks) {
+ *     crc.update(chunk);
+ * }
+ * const u32 checksum = crc.value();
+ * \endcode
+ */
+class Crc32c {
+public:
+    [[gnu::always_inline]] inline Crc32c() = default;
+
+    /// \brief Continue from the CRC of already processed bytes.
+    [[gnu::always_inline]] inline explicit Crc32c(u32 seed)
+        : state(~seed)
+    { }
+
+    [[gnu::always_inline]] inline void update(ConstBuffer buffer) {
+        state = kernels::crc32c(state, buffer.data, buffer.size);
+    }
+
+    /// \brief CRC32C of all bytes passed to update so far.
+    [[nodiscard, gnu::always_inline]] inline u32 value() const {
+        return ~state;
+    }
+
+private:
+    u32 state = ~u32(0);
+};
+
+/// \brief Size of the checksum appended by push_with_crc32c.
+inline constexpr usize CRC32C_SIZE = 4;
+
+/**
+ * \brief Push payload followed by its CRC32C (4 bytes, little-endian). Pushed bytes are consumed.
+ * \return true if OK, false if payload.size + CRC32C_SIZE > output.size (output is unchanged).
+ */
+[[nodiscard, gnu::always_inline]] inline bool push_with_crc32c(MutableBuffer & output, ConstBuffer payload) {
+    if(output.size < payload.size + CRC32C_SIZE) {
+        return false;
+    }
+    const u32 crc = crc32c(payload);
+    const u8 bytes[CRC32C_SIZE] = {u8(crc), u8(crc >> 8), u8(crc >> 16), u8(crc >> 24)};
+    return output.push(payload) && output.push(ConstBuffer(bytes, CRC32C_SIZE));
+}
+
+/**
+ * \brief Pop payload_size bytes followed by their CRC32C (as written by push_with_crc32c) and verify the checksum.
+ * \return Payload if OK (payload and checksum are consumed), {nullptr, 0} if input is too short or the checksum
+ *         does not match (input is unchanged).
+ */
+[[nodiscard, gnu::always_inline]] inline ConstBuffer pop_with_crc32c(ConstBuffer & input, usize payload_size) {
+    if(input.size < CRC32C_SIZE || input.size - CRC32C_SIZE < payload_size) {
+        return {};
+    }
+    const ConstBuffer payload(input.data, payload_size);
+    const u8 * const bytes = input.data + payload_size;
+    const u32 stored = u32(bytes[0]) | (u32(bytes[1]) << 8) | (u32(bytes[2]) << 16) | (u32(bytes[3]) << 24);
+    if(crc32c(payload) != stored) {
+        return {};
+    }
+    (void)input.skip(payload_size + CRC32C_SIZE);
+    return payload;
+}
+
+}
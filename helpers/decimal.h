@@ -0,0 +1,698 @@
+#pragma once
+
+#include "helpers/types.h"
+
+#include <array>
+#include <bit>
+#include <charconv>
+#include <concepts>
+#include <cstring>
+#include <limits>
+
+namespace sedfer {
+
+/// \brief Concept for integers read as decimal text by pop_decimal (any integral type except bool, up to 64 bits).
+template<typename T>
+concept decimal_integer = std::integral<T> && (not std::same_as<T, bool>) && (sizeof(T) <= 8);
+
+/// \brief Concept for integers written as decimal text by push_decimal: decimal_integer, u128 and i128.
+template<typename T>
+concept decimal_integer_or_128 = decimal_integer<T> || std::same_as<T, u128> || std::same_as<T, i128>;
+
+/// \brief Concept for IEEE 754 binary32 / binary64 values read / written as decimal text by pop_float / push_float.
+template<typename T>
+concept decimal_float = std::same_as<T, float> || std::same_as<T, double>;
+
+/**
+ * \brief Decimal parsing and formatting of integers and floats; callers check the text bounds.
+ *
+ * Parsing: digits are read 8 at a time with SWAR (one 64-bit load, 3 multiplies), single digits only at the ends.
+ * Floats with up to 19 significant digits are converted without big integers: exactly with one multiplication or
+ * division when both mantissa and power of ten are exact in T (Clinger), otherwise with a 64x128-bit product of the
+ * mantissa and a truncated power of five (Eisel-Lemire). The few inputs this cannot round correctly (more than 19
+ * digits, products too close to a halfway point, inf / nan) are handed to std::from_chars.
+ *
+ * Formatting: the length is known before writing (digit count from the bit width, one comparison), digits are written
+ * backwards two at a time from a "00" - "99" table. Floats are reduced to the shortest decimal that rounds back to the
+ * same value with Schubfach (three 64x128-bit products with the same powers of ten as parsing), then printed in fixed
+ * or scientific notation, whichever is shorter, as std::to_chars.
+ */
+namespace kernels {
+
+[[nodiscard, gnu::always_inline]] inline u64 decimal_load(const u8 * data) {
+    u64 ret;
+    std::memcpy(&ret, data, 8);
+    if constexpr(std::endian::native == std::endian::big) {
+        ret = std::byteswap(ret);
+    }
+    return ret;
+}
+
+inline constexpr u32 DECIMAL_POWERS_OF_TEN[9] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000};
+
+/**
+ * \brief Leading digits of 8 bytes loaded as a little-endian word: ret = ret * 10^count + their value.
+ * \return Number of leading digits (0 - 8).
+ */
+[[nodiscard, gnu::always_inline]] inline usize decimal_append_8(u64 word, u64 & ret) {
+    // Digits become 0 - 9, any other byte has a non-zero high nibble here (carries only move towards later bytes).
+    const u64 x = word ^ 0x3030303030303030ull;
+    const u64 non_digits = (x | (x + 0x0606060606060606ull)) & 0xf0f0f0f0f0f0f0f0ull;
+    const usize count = usize(std::countr_zero(non_digits)) / 8;
+    if(count == 0) {
+        return 0;
+    }
+    // Digits to the high bytes, zeros (leading zero digits) below; then pairs, quads and all 8: x * 10 + next.
+    u64 digits = x << (8 * (8 - count));
+    digits = (digits * 10) + (digits >> 8);
+    digits = (((digits & 0x000000ff000000ffull) * (100 + (1000000ull << 32))) +
+              (((digits >> 16) & 0x000000ff000000ffull) * (1 + (10000ull << 32)))) >> 32;
+    ret = ret * DECIMAL_POWERS_OF_TEN[count] + u32(digits);
+    return count;
+}
+
+[[nodiscard, gnu::always_inline]] inline bool decimal_is_digit(u8 byte) {
+    return u8(byte - '0') < 10;
+}
+
+/// \brief u32 limbs of the numbers used to build DECIMAL_POWERS_OF_FIVE: 2^1024 (5^342 < 2^795, plus 128 bits of quotient).
+inline constexpr usize DECIMAL_LIMBS = 1024 / 32 + 1;
+
+/// \brief Top 128 bits of a non-zero little-endian u32 limb number.
+[[nodiscard]] constexpr inline u128 decimal_top128(const std::array<u32, DECIMAL_LIMBS> & limbs) {
+    usize top = DECIMAL_LIMBS - 1;
+    while(limbs[top] == 0) {
+        --top;
+    }
+    const usize bits = 32 * top + std::bit_width(limbs[top]);
+    u128 ret = 0;
+    for(usize bit = bits; bit-- > 0 && bit + 128 >= bits;) {
+        ret = (ret << 1) | ((limbs[bit / 32] >> (bit % 32)) & 1);
+    }
+    return ret << (128 - std::min<usize>(bits, 128));
+}
+
+inline constexpr i32 DECIMAL_MIN_POWER = -342;
+inline constexpr i32 DECIMAL_MAX_POWER = 326;
+
+/**
+ * \brief 5^q for q = -342..326 normalized to [2^127, 2^128), as {high, low} pairs.
+ * Truncated, except for -27 <= q < 0, where 2^b / 5^-q (exactly 128 bits) is rounded up: halfway cases with these
+ * powers are exact and must not come out just below halfway.
+ */
+inline constexpr std::array<u64, 2 * (DECIMAL_MAX_POWER - DECIMAL_MIN_POWER + 1)> DECIMAL_POWERS_OF_FIVE = [] {
+    std::array<u64, 2 * (DECIMAL_MAX_POWER - DECIMAL_MIN_POWER + 1)> ret = {};
+    // 2^1024 / 5^k by repeated long division (floor(floor(x / 5) / 5) == floor(x / 25)).
+    std::array<u32, DECIMAL_LIMBS> number = {};
+    number[DECIMAL_LIMBS - 1] = 1;
+    for(i32 k = 1; k <= -DECIMAL_MIN_POWER; ++k) {
+        u64 remainder = 0;
+        for(usize i = DECIMAL_LIMBS; i-- > 0;) {
+            const u64 current = (remainder << 32) | number[i];
+            number[i] = u32(current / 5);
+            remainder = current % 5;
+        }
+        const u128 value = decimal_top128(number) + (k <= 27 ? 1 : 0);
+        ret[2 * usize(-k - DECIMAL_MIN_POWER)] = u64(value >> 64);
+        ret[2 * usize(-k - DECIMAL_MIN_POWER) + 1] = u64(value);
+    }
+    number = {};
+    number[0] = 1;
+    for(i32 k = 0; k <= DECIMAL_MAX_POWER; ++k) {
+        const u128 value = decimal_top128(number);
+        ret[2 * usize(k - DECIMAL_MIN_POWER)] = u64(value >> 64);
+        ret[2 * usize(k - DECIMAL_MIN_POWER) + 1] = u64(value);
+        u64 carry = 0;
+        for(u32 & limb : number) {
+            const u64 current = u64(limb) * 5 + carry;
+            limb = u32(current);
+            carry = current >> 32;
+        }
+    }
+    return ret;
+}();
+
+/// \brief IEEE 754 layout of T.
+template<decimal_float T>
+struct DecimalFormat {
+    static constexpr i32 MANTISSA_BITS = std::numeric_limits<T>::digits - 1;
+    static constexpr i32 MIN_EXPONENT = -std::numeric_limits<T>::max_exponent + 1;
+    static constexpr i32 INFINITE_POWER = 2 * std::numeric_limits<T>::max_exponent - 1;
+    /// Powers of ten outside this range are zero or infinity for any 19-digit mantissa.
+    static constexpr i32 MIN_POWER = std::same_as<T, double> ? DECIMAL_MIN_POWER : -65;
+    static constexpr i32 MAX_POWER = std::same_as<T, double> ? 308 : 38;
+    /// Exact halfway cases are only possible for these powers of ten.
+    static constexpr i32 MIN_ROUND_TO_EVEN = std::same_as<T, double> ? -4 : -17;
+    static constexpr i32 MAX_ROUND_TO_EVEN = std::same_as<T, double> ? 23 : 10;
+    /// Mantissa and power of ten are exact in T: one correctly rounded multiplication or division (Clinger).
+    static constexpr i32 MAX_EXACT_POWER = std::same_as<T, double> ? 22 : 10;
+    static constexpr u64 MAX_EXACT_MANTISSA = u64(1) << (MANTISSA_BITS + 1);
+};
+
+template<decimal_float T>
+inline constexpr std::array<T, DecimalFormat<T>::MAX_EXACT_POWER + 1> DECIMAL_EXACT_POWERS = [] {
+    std::array<T, DecimalFormat<T>::MAX_EXACT_POWER + 1> ret = {};
+    T power = 1;
+    for(T & value : ret) {
+        value = power;
+        power *= 10;
+    }
+    return ret;
+}();
+
+/**
+ * \brief Binary value of mantissa * 10^power (mantissa != 0), Eisel-Lemire.
+ * \return Biased exponent << MANTISSA_BITS | mantissa bits (INFINITE_POWER << MANTISSA_BITS on overflow, 0 on underflow),
+ *         or -1 if the truncated product cannot decide the rounding.
+ */
+template<decimal_float T>
+[[nodiscard]] inline i64 decimal_to_binary(u64 mantissa, i64 power) {
+    using F = DecimalFormat<T>;
+    if(power < F::MIN_POWER) {
+        return 0;
+    }
+    if(power > F::MAX_POWER) {
+        return i64(F::INFINITE_POWER) << F::MANTISSA_BITS;
+    }
+    const i32 q = i32(power);
+    const i32 zeros = std::countl_zero(mantissa);
+    mantissa <<= zeros;
+
+    // Product with the high half of 5^q, the low half only if the bits below the kept precision are all ones.
+    const usize index = 2 * usize(q - DECIMAL_MIN_POWER);
+    constexpr u64 PRECISION_MASK = ~u64(0) >> (F::MANTISSA_BITS + 3);
+    u128 product = u128(mantissa) * DECIMAL_POWERS_OF_FIVE[index];
+    u64 high = u64(product >> 64);
+    u64 low = u64(product);
+    if((high & PRECISION_MASK) == PRECISION_MASK) {
+        const u64 second = u64((u128(mantissa) * DECIMAL_POWERS_OF_FIVE[index + 1]) >> 64);
+        low += second;
+        high += (low < second);
+    }
+    // Outside these powers 5^q is truncated to 128 bits: the product may be just below a carry.
+    if(low == ~u64(0) && (q < -27 || q > 55)) {
+        return -1;
+    }
+
+    const i32 upper = i32(high >> 63);
+    const i32 shift = upper + 64 - F::MANTISSA_BITS - 3;
+    u64 bits = high >> shift;
+    // floor(log2(10^q)) + 63 - zeros + upper, biased.
+    i32 exponent = (((217706 * q) >> 16) + 63) + upper - zeros - F::MIN_EXPONENT;
+    if(exponent <= 0) {
+        // Subnormal: shift out the missing exponent, round half up (exact halfway cases are impossible here).
+        if(-exponent + 1 >= 64) {
+            return 0;
+        }
+        bits >>= -exponent + 1;
+        bits += (bits & 1);
+        bits >>= 1;
+        // Rounded up to the smallest normal.
+        exponent = (bits < (u64(1) << F::MANTISSA_BITS)) ? 0 : 1;
+        return (i64(exponent) << F::MANTISSA_BITS) | i64(bits & ~(u64(1) << F::MANTISSA_BITS));
+    }
+    // Exact halfway (all bits below the rounding bit are zero): round to even instead of up.
+    if(low <= 1 && q >= F::MIN_ROUND_TO_EVEN && q <= F::MAX_ROUND_TO_EVEN && (bits & 3) == 1 && (bits << shift) == high) {
+        bits &= ~u64(1);
+    }
+    bits += (bits & 1);
+    bits >>= 1;
+    if(bits >= (u64(2) << F::MANTISSA_BITS)) {
+        bits = u64(1) << F::MANTISSA_BITS;
+        ++exponent;
+    }
+    bits &= ~(u64(1) << F::MANTISSA_BITS);
+    if(exponent >= F::INFINITE_POWER) {
+        return i64(F::INFINITE_POWER) << F::MANTISSA_BITS;
+    }
+    return (i64(exponent) << F::MANTISSA_BITS) | i64(bits);
+}
+
+/**
+ * \brief Parse an integer (optional '-' for signed T, then digits) from [data, data + size).
+ * \return Number of bytes used, 0 if there are no digits or the value does not fit T (value is unchanged).
+ */
+template<decimal_integer T>
+[[nodiscard]] inline usize parse_decimal(const u8 * data, usize size, T & value) {
+    const u8 * const end = data + size;
+    const u8 * p = data;
+    bool negative = false;
+    if constexpr(std::is_signed_v<T>) {
+        if(p != end && *p == '-') {
+            negative = true;
+            ++p;
+        }
+    }
+    // Up to 16 digits with SWAR cannot overflow u64, later digits are checked.
+    const u8 * const digits = p;
+    u64 ret = 0;
+    usize count = 8;
+    for(usize words = 0; words < 2 && end - p >= 8; ++words) {
+        count = decimal_append_8(decimal_load(p), ret);
+        p += count;
+        if(count < 8) {
+            break;
+        }
+    }
+    // Near the end of the buffer or after 16 digits.
+    if(count == 8) {
+        for(; p != end && decimal_is_digit(*p); ++p) {
+            if(__builtin_mul_overflow(ret, 10, &ret) || __builtin_add_overflow(ret, u64(*p - '0'), &ret)) {
+                return 0;
+            }
+        }
+    }
+    if(p == digits) {
+        return 0;
+    }
+    using U = std::make_unsigned_t<T>;
+    if constexpr(std::is_signed_v<T>) {
+        if(ret > u64(std::numeric_limits<T>::max()) + negative) {
+            return 0;
+        }
+        value = T(negative ? U(0 - U(ret)) : U(ret));
+    } else {
+        if(ret > u64(std::numeric_limits<T>::max())) {
+            return 0;
+        }
+        value = T(ret);
+    }
+    return usize(p - data);
+}
+
+/// \brief std::from_chars on [data, data + size): number of bytes used, 0 if invalid or out of range.
+template<decimal_float T>
+[[nodiscard, gnu::noinline]] inline usize parse_float_fallback(const u8 * data, usize size, T & value) {
+    const char * const begin = reinterpret_cast<const char *>(data);
+    T ret;
+    const std::from_chars_result result = std::from_chars(begin, begin + size, ret);
+    if(result.ec != std::errc()) {
+        return 0;
+    }
+    value = ret;
+    return usize(result.ptr - begin);
+}
+
+/**
+ * \brief Parse a float (std::from_chars general format: optional '-', digits with optional '.', optional exponent,
+ * or inf / infinity / nan) from [data, data + size).
+ * \return Number of bytes used, 0 if there is no number or it is out of range of T (value is unchanged).
+ */
+template<decimal_float T>
+[[nodiscard]] inline usize parse_float(const u8 * data, usize size, T & value) {
+    using F = DecimalFormat<T>;
+    const u8 * const end = data + size;
+    const u8 * p = data;
+    const bool negative = (p != end && *p == '-');
+    p += negative;
+
+    // Mantissa digits, wrapping above 19 digits (recounted below).
+    u64 mantissa = 0;
+    const u8 * const integer = p;
+    while(end - p >= 8) {
+        const usize count = decimal_append_8(decimal_load(p), mantissa);
+        p += count;
+        if(count < 8) {
+            break;
+        }
+    }
+    while(p != end && decimal_is_digit(*p)) {
+        mantissa = mantissa * 10 + u8(*p - '0');
+        ++p;
+    }
+    i64 digit_count = p - integer;
+    i64 power = 0;
+    if(p != end && *p == '.') {
+        ++p;
+        const u8 * const fraction = p;
+        while(end - p >= 8) {
+            const usize count = decimal_append_8(decimal_load(p), mantissa);
+            p += count;
+            if(count < 8) {
+                break;
+            }
+        }
+        while(p != end && decimal_is_digit(*p)) {
+            mantissa = mantissa * 10 + u8(*p - '0');
+            ++p;
+        }
+        power = -(p - fraction);
+        digit_count -= power;
+    }
+    if(digit_count == 0) {
+        // ".", "-", "inf", "nan" or not a number.
+        return parse_float_fallback(data, size, value);
+    }
+    if(p != end && (*p | 0x20) == 'e') {
+        const u8 * e = p + 1;
+        const bool negative_exponent = (e != end && *e == '-');
+        e += (e != end && (*e == '-' || *e == '+'));
+        if(e != end && decimal_is_digit(*e)) {
+            i64 exponent = 0;
+            for(; e != end && decimal_is_digit(*e); ++e) {
+                // Any larger exponent is zero or infinity for any mantissa that fits a buffer.
+                if(exponent < 0x10000000) {
+                    exponent = exponent * 10 + (*e - '0');
+                }
+            }
+            power += negative_exponent ? -exponent : exponent;
+            p = e;
+        }
+    }
+    if(digit_count > 19) {
+        // Leading zeros do not count.
+        const u8 * q = integer;
+        while(q != p && (*q == '0' || *q == '.')) {
+            digit_count -= (*q == '0');
+            ++q;
+        }
+        if(digit_count > 19) {
+            return parse_float_fallback(data, size, value);
+        }
+    }
+
+    T ret;
+    if(mantissa == 0) {
+        ret = T(0);
+    } else if(power >= -F::MAX_EXACT_POWER && power <= F::MAX_EXACT_POWER && mantissa <= F::MAX_EXACT_MANTISSA) {
+        ret = T(mantissa);
+        ret = (power < 0) ? ret / DECIMAL_EXACT_POWERS<T>[-power] : ret * DECIMAL_EXACT_POWERS<T>[power];
+    } else {
+        const i64 bits = decimal_to_binary<T>(mantissa, power);
+        if(bits < 0) {
+            return parse_float_fallback(data, size, value);
+        }
+        // Overflow to infinity or underflow to zero.
+        if(bits == 0 || (bits >> F::MANTISSA_BITS) == F::INFINITE_POWER) {
+            return 0;
+        }
+        if constexpr(std::same_as<T, double>) {
+            ret = std::bit_cast<double>(u64(bits));
+        } else {
+            ret = std::bit_cast<float>(u32(bits));
+        }
+    }
+    value = negative ? -ret : ret;
+    return usize(p - data);
+}
+
+/// \brief "00" - "99".
+inline constexpr std::array<u8, 200> DECIMAL_PAIRS = [] {
+    std::array<u8, 200> ret = {};
+    for(usize i = 0; i < 100; ++i) {
+        ret[2 * i] = u8('0' + i / 10);
+        ret[2 * i + 1] = u8('0' + i % 10);
+    }
+    return ret;
+}();
+
+/// \brief 10^0 - 10^38.
+inline constexpr std::array<u128, 39> DECIMAL_POWERS_OF_TEN_128 = [] {
+    std::array<u128, 39> ret = {};
+    u128 power = 1;
+    for(u128 & value : ret) {
+        value = power;
+        power *= 10;
+    }
+    return ret;
+}();
+
+/// \brief Number of decimal digits of value (1 - 20).
+[[nodiscard, gnu::always_inline]] inline usize decimal_digits(u64 value) {
+    // floor(log10(2^bits)) from bits * 1233 / 4096, one too large at most.
+    const usize guess = (usize(std::bit_width(value | 1)) * 1233) >> 12;
+    return guess + 1 - ((value | 1) < u64(DECIMAL_POWERS_OF_TEN_128[guess]));
+}
+
+/// \brief Number of decimal digits of value (1 - 39).
+[[nodiscard, gnu::always_inline]] inline usize decimal_digits(u128 value) {
+    const u64 high = u64(value >> 64);
+    if(high == 0) {
+        return decimal_digits(u64(value));
+    }
+    const usize guess = (usize(128 - std::countl_zero(high)) * 1233) >> 12;
+    return guess + 1 - (value < DECIMAL_POWERS_OF_TEN_128[guess]);
+}
+
+/// \brief Write exactly 8 digits of value (< 10^8, with leading zeros) at out: 4 independent pairs.
+[[gnu::always_inline]] inline void decimal_write_8(u8 * out, u32 value) {
+    const u32 high = value / 10000;
+    const u32 low = value % 10000;
+    std::memcpy(out, DECIMAL_PAIRS.data() + 2 * (high / 100), 2);
+    std::memcpy(out + 2, DECIMAL_PAIRS.data() + 2 * (high % 100), 2);
+    std::memcpy(out + 4, DECIMAL_PAIRS.data() + 2 * (low / 100), 2);
+    std::memcpy(out + 6, DECIMAL_PAIRS.data() + 2 * (low % 100), 2);
+}
+
+/// \brief Write the digits of value (decimal_digits(value) bytes) ending at end, two at a time.
+[[gnu::always_inline]] inline void decimal_write(u8 * end, u64 value) {
+    // 8-digit chunks from the end keep the dependency chain of divisions short.
+    while(value >= 100000000) {
+        end -= 8;
+        decimal_write_8(end, u32(value % 100000000));
+        value /= 100000000;
+    }
+    u32 rest = u32(value);
+    while(rest >= 100) {
+        end -= 2;
+        std::memcpy(end, DECIMAL_PAIRS.data() + 2 * (rest % 100), 2);
+        rest /= 100;
+    }
+    if(rest >= 10) {
+        std::memcpy(end - 2, DECIMAL_PAIRS.data() + 2 * rest, 2);
+    } else {
+        end[-1] = u8('0' + rest);
+    }
+}
+
+inline void decimal_write(u8 * end, u128 value) {
+    // u64 chunks of 19 digits (with leading zeros) from the end.
+    constexpr u64 CHUNK = 10000000000000000000ull;
+    while(value > ~u64(0)) {
+        const u64 chunk = u64(value % CHUNK);
+        value /= CHUNK;
+        decimal_write_8(end - 8, u32(chunk % 100000000));
+        decimal_write_8(end - 16, u32((chunk / 100000000) % 100000000));
+        std::memcpy(end - 18, DECIMAL_PAIRS.data() + 2 * ((chunk / 10000000000000000ull) % 100), 2);
+        end[-19] = u8('0' + chunk / 1000000000000000000ull);
+        end -= 19;
+    }
+    decimal_write(end, u64(value));
+}
+
+/// \brief Decimal text of an integer: '-' for negative values, then digits.
+template<decimal_integer_or_128 T>
+struct DecimalInteger {
+    using Magnitude = std::conditional_t<(sizeof(T) > 8), u128, u64>;
+
+    Magnitude magnitude;
+    bool negative;
+    usize length;
+
+    [[gnu::always_inline]] inline explicit DecimalInteger(T value)
+        : magnitude(Magnitude(value)),
+          negative(false)
+    {
+        if constexpr(T(-1) < T(0)) {
+            if(value < 0) {
+                negative = true;
+                magnitude = Magnitude(0) - magnitude;
+            }
+        }
+        length = negative + decimal_digits(magnitude);
+    }
+
+    /// \brief Write length bytes at out.
+    [[gnu::always_inline]] inline void write(u8 * out) const {
+        // Overwritten by the first digit if not negative.
+        out[0] = '-';
+        decimal_write(out + length, magnitude);
+    }
+};
+
+/// \brief Shortest decimal digits * 10^exponent that reads back as the same float.
+struct DecimalShortest {
+    u64 digits;
+    i32 exponent;
+};
+
+/**
+ * \brief digits * 10^exponent for a positive finite T from its biased exponent and fraction bits (Schubfach).
+ *
+ * The rounding interval of the value, scaled by 10^-k so that it contains at most one multiple of 10 and at most two
+ * integers, is computed with round-to-odd products by 10^-k (truncated to 128 bits plus one). The shortest candidate
+ * inside the interval wins, the nearest one if there are two.
+ */
+template<decimal_float T>
+[[nodiscard]] inline DecimalShortest decimal_shortest(u64 fraction, u32 biased_exponent) {
+    using F = DecimalFormat<T>;
+    constexpr i32 BIAS = -F::MIN_EXPONENT + F::MANTISSA_BITS;
+    u64 c;
+    i32 q;
+    if(biased_exponent != 0) {
+        c = (u64(1) << F::MANTISSA_BITS) | fraction;
+        q = i32(biased_exponent) - BIAS;
+        // Small integers.
+        if(q <= 0 && -q <= F::MANTISSA_BITS && (c & ((u64(1) << -q) - 1)) == 0) {
+            return {c >> -q, 0};
+        }
+    } else {
+        c = fraction;
+        q = 1 - BIAS;
+    }
+    const bool even = (c & 1) == 0;
+    // Powers of two: the next value below is half as far as the next value above.
+    const bool closer = (fraction == 0 && biased_exponent > 1);
+    const u64 cbl = 4 * c - 2 + closer;
+    const u64 cb = 4 * c;
+    const u64 cbr = 4 * c + 2;
+
+    // k = floor(log10(2^q)) or floor(log10(3/4 * 2^q)), h = q + floor(log2(10^-k)) + 1 (1 - 4).
+    const i32 k = (q * 1262611 - (closer ? 524031 : 0)) >> 22;
+    const i32 h = q + ((-k * 1741647) >> 19) + 1;
+    const usize index = 2 * usize(-k - DECIMAL_MIN_POWER);
+    // 10^-k truncated to 128 bits, plus one (-27 <= -k < 0 is already rounded up).
+    const u128 g = ((u128(DECIMAL_POWERS_OF_FIVE[index]) << 64) | DECIMAL_POWERS_OF_FIVE[index + 1]) + (-k >= -27 && -k < 0 ? 0 : 1);
+    const auto round_to_odd = [g](u64 cp) {
+        const u128 x = u128(u64(g)) * cp;
+        const u128 y = u128(u64(g >> 64)) * cp + u64(x >> 64);
+        return u64(y >> 64) | (u64(y) > 1);
+    };
+    const u64 vbl = round_to_odd(cbl << h);
+    const u64 vb = round_to_odd(cb << h);
+    const u64 vbr = round_to_odd(cbr << h);
+    const u64 lower = vbl + not even;
+    const u64 upper = vbr - not even;
+
+    const u64 s = vb / 4;
+    if(s >= 10) {
+        // One digit less: at most one of the neighbouring multiples of 10 is inside.
+        const u64 sp = s / 10;
+        const bool up_inside = lower <= 40 * sp;
+        const bool wp_inside = 40 * sp + 40 <= upper;
+        if(up_inside != wp_inside) {
+            return {sp + wp_inside, k + 1};
+        }
+    }
+    const bool u_inside = lower <= 4 * s;
+    const bool w_inside = 4 * s + 4 <= upper;
+    if(u_inside != w_inside) {
+        return {s + w_inside, k};
+    }
+    // Both inside: the nearest, ties to even.
+    const u64 mid = 4 * s + 2;
+    const bool round_up = vb > mid || (vb == mid && (s & 1) != 0);
+    return {s + round_up, k};
+}
+
+/**
+ * \brief Decimal text of a float as std::to_chars(value): shortest round-trip digits in fixed ("0.001", "123.5", "100")
+ * or scientific ("1e-04", "1.5e+300") notation, whichever is shorter (fixed for ties), "inf", "nan", "-" if negative.
+ * Like printf("%.0f"), integers above 2^53 (2^24) in fixed notation are printed exactly: 2^60 is "1152921504606846976",
+ * not "1152921504606847000".
+ */
+template<decimal_float T>
+struct DecimalFloat {
+    /// Longest output: "-1.2345678901234567e-308".
+    static constexpr usize MAX_LENGTH = std::same_as<T, double> ? 24 : 15;
+
+    u64 digits = 0;
+    i32 exponent = 0;
+    u32 count = 1;
+    /// Exact value of integers printed in fixed notation with exponent > 0.
+    u128 integer = 0;
+    bool negative;
+    bool finite = true;
+    bool fixed = true;
+    usize length = 0;
+
+    [[gnu::always_inline]] inline explicit DecimalFloat(T value) {
+        using F = DecimalFormat<T>;
+        using Bits = std::conditional_t<std::same_as<T, double>, u64, u32>;
+        const Bits bits = std::bit_cast<Bits>(value);
+        const u64 fraction = bits & ((Bits(1) << F::MANTISSA_BITS) - 1);
+        const u32 biased_exponent = u32(bits >> F::MANTISSA_BITS) & u32(F::INFINITE_POWER);
+        negative = (bits >> (sizeof(T) * 8 - 1)) != 0;
+        if(biased_exponent == u32(F::INFINITE_POWER)) {
+            // "inf" / "nan"
+            finite = false;
+            digits = fraction;
+            length = negative + 3;
+            return;
+        }
+        if(biased_exponent != 0 || fraction != 0) {
+            const DecimalShortest shortest = decimal_shortest<T>(fraction, biased_exponent);
+            digits = shortest.digits;
+            exponent = shortest.exponent;
+            while(digits % 10 == 0) {
+                digits /= 10;
+                ++exponent;
+            }
+            count = u32(decimal_digits(digits));
+        }
+        // Scientific exponent and both lengths without the sign.
+        const i32 scientific_exponent = exponent + i32(count) - 1;
+        const usize scientific = count + (count > 1) + 2 + ((scientific_exponent >= 100 || scientific_exponent <= -100) ? 3 : 2);
+        usize fixed_length;
+        if(exponent >= 0) {
+            fixed_length = count + usize(exponent);
+        } else if(scientific_exponent >= 0) {
+            fixed_length = count + 1;
+        } else {
+            fixed_length = usize(2 - exponent);
+        }
+        fixed = fixed_length <= scientific;
+        length = negative + (fixed ? fixed_length : scientific);
+        // Above 2^(MANTISSA_BITS + 1) every value is an integer, the exact one has as many digits.
+        constexpr i32 BIAS = -F::MIN_EXPONENT + F::MANTISSA_BITS;
+        if(fixed && exponent > 0 && i32(biased_exponent) > BIAS) {
+            integer = u128((u64(1) << F::MANTISSA_BITS) | fraction) << (i32(biased_exponent) - BIAS);
+        }
+    }
+
+    /// \brief Write length bytes at out.
+    inline void write(u8 * out) const {
+        // Overwritten by the first character if not negative.
+        out[0] = '-';
+        out += negative;
+        if(not finite) {
+            std::memcpy(out, (digits == 0) ? "inf" : "nan", 3);
+            return;
+        }
+        const i32 scientific_exponent = exponent + i32(count) - 1;
+        if(not fixed) {
+            // Digits one byte to the right, then the first digit moves left over the '.'.
+            decimal_write(out + 1 + count, digits);
+            out[0] = out[1];
+            out[1] = '.';
+            out += count + (count > 1);
+            *out++ = 'e';
+            *out++ = (scientific_exponent < 0) ? '-' : '+';
+            const u32 magnitude = u32((scientific_exponent < 0) ? -scientific_exponent : scientific_exponent);
+            if(magnitude >= 100) {
+                *out++ = u8('0' + magnitude / 100);
+            }
+            std::memcpy(out, DECIMAL_PAIRS.data() + 2 * (magnitude % 100), 2);
+        } else if(integer != 0) {
+            decimal_write(out + count + exponent, integer);
+        } else if(exponent >= 0) {
+            decimal_write(out + count, digits);
+            std::memset(out + count, '0', usize(exponent));
+        } else if(scientific_exponent >= 0) {
+            // Integer digits move left over the '.'.
+            decimal_write(out + 1 + count, digits);
+            std::memmove(out, out + 1, usize(scientific_exponent + 1));
+            out[scientific_exponent + 1] = '.';
+        } else {
+            const usize zeros = usize(-scientific_exponent - 1);
+            out[0] = '0';
+            out[1] = '.';
+            std::memset(out + 2, '0', zeros);
+            decimal_write(out + 2 + zeros + count, digits);
+        }
+    }
+};
+
+}
+
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+#include "helpers/aligned_buffer.h"
+#include "helpers/types.h"
+
+#include <cerrno>
+#include <utility>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace sedfer {
+
+/**
+ * \brief DirectFile reads and writes a local file with O_DIRECT, bypassing the page cache.
+ *
+ * O_DIRECT requires aligned addresses, sizes and offsets, so the interface only accepts AlignedBuffer\<ALIGNMENT>.
+ * If the file system does not support O_DIRECT (tmpfs etc.), the file is opened buffered, see direct().
+ * \code
+ * DirectFile file("replay.log", O_RDONLY);
+ * if(not file.is_open()) return false;
+ *
+ * AlignedStorage<DirectFile::ALIGNMENT> storage(1 << 20);
+ * u64 offset = 0;
+ * while(true) {
+ *     const isize read = file.read(storage.buffer(), offset);
+ *     if(read <= 0) break;
+ *     replay({storage.buffer().data, usize(read)});
+ *     offset += read;
+ * }
+ * \endcode
+ */
+class DirectFile {
+public:
+    /// \brief Logical block size accepted by all common devices and file systems.
+    static constexpr usize ALIGNMENT = 4096;
+
+    using Buffer = AlignedBuffer<ALIGNMENT>;
+
+    DirectFile() = default;
+
+    /// \brief Open path with open(2) flags (O_DIRECT is added). Check is_open() for the result.
+    DirectFile(const char * path, int flags, mode_t mode = 0644) {
+        fd = ::open(path, flags | O_DIRECT | O_CLOEXEC, mode);
+        is_direct = (fd >= 0);
+        if(fd < 0 && errno == EINVAL) {
+            fd = ::open(path, flags | O_CLOEXEC, mode);
+        }
+    }
+
+    DirectFile(const DirectFile &) = delete;
+    DirectFile & operator=(const DirectFile &) = delete;
+
+    DirectFile(DirectFile && other) noexcept {
+        swap(other);
+    }
+
+    DirectFile & operator=(DirectFile && other) noexcept {
+        DirectFile(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    ~DirectFile() {
+        if(fd >= 0) {
+            ::close(fd);
+        }
+    }
+
+    void swap(DirectFile & other) noexcept {
+        std::swap(fd, other.fd);
+        std::swap(is_direct, other.is_direct);
+    }
+
+    [[nodiscard, gnu::always_inline]] inline bool is_open() const {
+        return fd >= 0;
+    }
+
+    /// \brief true if the page cache is bypassed, false if the file system rejected O_DIRECT.
+    [[nodiscard, gnu::always_inline]] inline bool direct() const {
+        return is_direct;
+    }
+
+    [[nodiscard, gnu::always_inline]] inline int native_handle() const {
+        return fd;
+    }
+
+    /**
+     * \brief Read up to buffer.size bytes at offset. Retries on EINTR and short reads until pread returns 0 (end of file).
+     * \return Number of bytes read (less than buffer.size only at end of file), -1 on error (see errno).
+     * \note With O_DIRECT a read that stops mid-block is taken as end of file: the next offset would be unaligned.
+     * \note offset must be a multiple of ALIGNMENT (EINVAL otherwise).
+     */
+    [[nodiscard]] isize read(Buffer buffer, u64 offset) const {
+        if((offset & (ALIGNMENT - 1)) != 0) {
+            errno = EINVAL;
+            return -1;
+        }
+
+        usize total = 0;
+        while(total < buffer.size) {
+            const isize ret = ::pread(fd, buffer.data + total, buffer.size - total, off_t(offset + total));
+            if(ret < 0) {
+                if(errno == EINTR) {
+                    continue;
+                }
+                return -1;
+            }
+            if(ret == 0) {
+                break;
+            }
+            total += usize(ret);
+            if(is_direct && (total & (ALIGNMENT - 1)) != 0) {
+                // Partial last block: end of file (O_DIRECT reads of regular files are only short there).
+                break;
+            }
+        }
+        return isize(total);
+    }
+
+    /**
+     * \brief Write buffer.size bytes at offset. Retries on EINTR and on short writes that end on an ALIGNMENT boundary.
+     * \return true if OK, false on error (see errno, EIO if nothing was written or O_DIRECT stopped mid-block).
+     * \note offset must be a multiple of ALIGNMENT (EINVAL otherwise).
+     * \note Use truncate() to cut the file to a size that is not a multiple of ALIGNMENT.
+     */
+    [[nodiscard]] bool write(Buffer buffer, u64 offset) const {
+        if((offset & (ALIGNMENT - 1)) != 0) {
+            errno = EINVAL;
+            return false;
+        }
+
+        usize total = 0;
+        while(total < buffer.size) {
+            const isize ret = ::pwrite(fd, buffer.data + total, buffer.size - total, off_t(offset + total));
+            if(ret < 0) {
+                if(errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            if(ret == 0) {
+                errno = EIO;
+                return false;
+            }
+            total += usize(ret);
+            if(is_direct && total < buffer.size && (total & (ALIGNMENT - 1)) != 0) {
+                // The rest is unaligned, O_DIRECT would reject it with EINVAL.
+                errno = EIO;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// \brief Set file size. \return true if OK, false on error (see errno).
+    [[nodiscard]] bool truncate(u64 _size) const {
+        return ::ftruncate(fd, off_t(_size)) == 0;
+    }
+
+private:
+    int fd = -1;
+    bool is_direct = false;
+};
+
+}
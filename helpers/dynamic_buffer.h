@@ -0,0 +1,390 @@
+#pragma once
+
+#include "helpers/buffer.h"
+#include "helpers/shared_buffer.h"
+#include "helpers/types.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace sedfer {
+
+/**
+ * \brief DynamicBuffer is an owning, growable output buffer with the MutableBuffer write interface.
+ *
+ * Bytes written with push() are placed at the front, bytes written with push_back() are placed at the back,
+ * exactly like consecutive writes into a MutableBuffer. Instead of failing when space runs out,
+ * DynamicBuffer grows geometrically (x2).
+ *
+ * Small storage lives in malloc() memory. Starting from MMAP_THRESHOLD storage is mmap()-ed
+ * and grown with mremap(), so large buffers are never copied on growth.
+ *
+ * \code
+ * // u8 version | u32 size | u16 type | <...> | u16 type | <...> | ...
+ * SharedBuffer make_message() {
+ *     DynamicBuffer buffer;
+ *
+ *     if(not buffer.push(VERSION_1)) return {};
+ *     if(not buffer.push(u32packed(0))) return {}; // reserve space (fill at the end)
+ *
+ *     for(const Item & item : items) {
+ *         if(not buffer.push(item.type)) return {};
+ *         if(not buffer.push(item.data)) return {};
+ *     }
+ *
+ *     u32packed * const size = buffer.at<u32packed>(1);
+ *     *size = buffer.size();
+ *
+ *     return buffer.release();
+ * }
+ * \endcode
+ * \note Growth moves the storage. Pointers returned by interpret() and buffers returned by written() / available()
+ *       are invalidated by any operation that may grow or shrink the buffer. Use at() with an offset for late patching.
+ * \note All write methods return false (or nullptr) only if memory allocation fails.
+ */
+class DynamicBuffer {
+public:
+    /// \brief Minimal capacity of non-empty storage.
+    static constexpr usize MIN_CAPACITY = 64;
+
+    /// \brief Storage of this size (or larger) is allocated with mmap() and grown with mremap().
+    static constexpr usize MMAP_THRESHOLD = usize(1) << 20;
+
+    DynamicBuffer() = default;
+
+    DynamicBuffer(const DynamicBuffer &) = delete;
+    DynamicBuffer & operator=(const DynamicBuffer &) = delete;
+
+    DynamicBuffer(DynamicBuffer && other) noexcept {
+        swap(other);
+    }
+
+    DynamicBuffer & operator=(DynamicBuffer && other) noexcept {
+        DynamicBuffer(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    ~DynamicBuffer() {
+        deallocate(storage, storage_size, mapped);
+    }
+
+    void swap(DynamicBuffer & other) noexcept {
+        std::swap(storage, other.storage);
+        std::swap(storage_size, other.storage_size);
+        std::swap(front_size, other.front_size);
+        std::swap(back_size, other.back_size);
+        std::swap(mapped, other.mapped);
+    }
+
+    /// \brief Total number of written bytes (front + back).
+    [[nodiscard, gnu::always_inline]] inline usize size() const {
+        return front_size + back_size;
+    }
+
+    /// \brief Number of allocated bytes.
+    [[nodiscard, gnu::always_inline]] inline usize capacity() const {
+        return storage_size;
+    }
+
+    /// \brief Bytes written with push() / interpret().
+    [[nodiscard, gnu::always_inline]] inline ConstBuffer written() const {
+        return {storage, front_size};
+    }
+
+    /// \brief Bytes written with push_back() / interpret_back().
+    [[nodiscard, gnu::always_inline]] inline ConstBuffer written_back() const {
+        return {storage + storage_size - back_size, back_size};
+    }
+
+    /// \brief Free space between front and back. Can be filled directly and committed with commit().
+    [[nodiscard, gnu::always_inline]] inline MutableBuffer available() const {
+        return {storage + front_size, storage_size - front_size - back_size};
+    }
+
+    /**
+     * \brief Interpret sizeof(T) bytes at offset (from the start of written()) as T*.
+     * \return Valid pointer if OK, nullptr if offset + sizeof(T) > written().size.
+     */
+    template<interpretable_from_unaligned T>
+    [[nodiscard, gnu::always_inline]] inline T * at(usize offset) {
+        if(front_size < offset || front_size - offset < sizeof(T)) {
+            return nullptr;
+        }
+        return reinterpret_cast<T *>(storage + offset);
+    }
+
+    /**
+     * \brief Make sure capacity() >= _capacity.
+     * \return true if OK, false if allocation failed.
+     */
+    [[nodiscard]] bool reserve(usize _capacity) {
+        if(_capacity <= storage_size) {
+            return true;
+        }
+        return reallocate(_capacity);
+    }
+
+    /**
+     * \brief Reduce capacity() to size() (rounded up to page size for mmap()-ed storage).
+     * \return true if OK, false if allocation failed (buffer is unaffected).
+     */
+    [[nodiscard]] bool shrink_to_fit() {
+        if(size() == 0) {
+            deallocate(storage, storage_size, mapped);
+            storage = nullptr;
+            storage_size = 0;
+            mapped = false;
+            return true;
+        }
+        if(storage_size == round_capacity(size())) {
+            return true;
+        }
+        return reallocate(size());
+    }
+
+    /// \brief Forget all written bytes. Capacity is unaffected.
+    void clear() {
+        front_size = 0;
+        back_size = 0;
+    }
+
+    /**
+     * \brief Make sure available().size >= _size.
+     * \return available() if OK, {nullptr, 0} if allocation failed.
+     */
+    [[nodiscard, gnu::always_inline]] inline MutableBuffer prepare(usize _size) {
+        if(not ensure_available(_size)) {
+            return {};
+        }
+        return available();
+    }
+
+    /**
+     * \brief Mark first _size bytes of available() as written (after filling them directly).
+     * \return true if OK, false if _size > available().size.
+     */
+    [[nodiscard, gnu::always_inline]] inline bool commit(usize _size) {
+        if(storage_size - front_size - back_size < _size) {
+            return false;
+        }
+        front_size += _size;
+        return true;
+    }
+
+    /**
+     * \brief Copy const_buffer.size bytes from const_buffer.data after previously pushed bytes.
+     * \return true if OK, false if allocation failed.
+     * \note const_buffer may point into this buffer (e.g. written()), it is followed to the grown storage.
+     */
+    [[nodiscard, gnu::always_inline]] inline bool push(ConstBuffer const_buffer) {
+        if(not ensure_available(const_buffer)) {
+            return false;
+        }
+        kernels::copy(storage + front_size, const_buffer.data, const_buffer.size);
+        front_size += const_buffer.size;
+        return true;
+    }
+
+    /**
+     * \brief Copy const_buffer.size bytes from const_buffer.data before previously back-pushed bytes.
+     * \return true if OK, false if allocation failed.
+     * \note const_buffer may point into this buffer (e.g. written_back()), it is followed to the grown storage.
+     */
+    [[nodiscard, gnu::always_inline]] inline bool push_back(ConstBuffer const_buffer) {
+        if(not ensure_available(const_buffer)) {
+            return false;
+        }
+        back_size += const_buffer.size;
+        kernels::copy(storage + storage_size - back_size, const_buffer.data, const_buffer.size);
+        return true;
+    }
+
+    /**
+     * \brief Reserve sizeof(T) bytes after previously pushed bytes and interpret them as T*.
+     * \return Valid pointer if OK, nullptr if allocation failed.
+     * \note alignof(T) must be 1. Use __attribute__((packed)) for structs, sedfer::packed\<T> for trivial types.
+     * \note Pointer is invalidated by the next growth, see at() for late patching.
+     */
+    template<interpretable_from_unaligned T>
+    [[nodiscard, gnu::always_inline]] inline T * interpret() {
+        if(not ensure_available(sizeof(T))) {
+            return nullptr;
+        }
+        T * const ret = reinterpret_cast<T *>(storage + front_size);
+        front_size += sizeof(T);
+        return ret;
+    }
+
+    /**
+     * \brief Reserve sizeof(T) bytes before previously back-pushed bytes and interpret them as T*.
+     * \return Valid pointer if OK, nullptr if allocation failed.
+     * \note alignof(T) must be 1. Use __attribute__((packed)) for structs, sedfer::packed\<T> for trivial types.
+     * \note Pointer is invalidated by the next growth.
+     */
+    template<interpretable_from_unaligned T>
+    [[nodiscard, gnu::always_inline]] inline T * interpret_back() {
+        if(not ensure_available(sizeof(T))) {
+            return nullptr;
+        }
+        back_size += sizeof(T);
+        return reinterpret_cast<T *>(storage + storage_size - back_size);
+    }
+
+    /**
+     * \brief Hand written bytes (front followed by back) over to SharedBuffer. DynamicBuffer becomes empty.
+     * \note No copy is made, back bytes are moved right after front bytes in-place.
+     */
+    [[nodiscard]] SharedBuffer release() {
+        if(storage == nullptr) {
+            return {};
+        }
+
+        if(back_size != 0) {
+            std::memmove(storage + front_size, storage + storage_size - back_size, back_size);
+        }
+
+        const usize total_size = size();
+        u8 * const released = storage;
+        const usize released_size = storage_size;
+        const bool released_mapped = mapped;
+
+        storage = nullptr;
+        storage_size = 0;
+        front_size = 0;
+        back_size = 0;
+        mapped = false;
+
+        return {std::shared_ptr<const u8>(released, [released_size, released_mapped](const u8 * ptr) {
+                    deallocate(const_cast<u8 *>(ptr), released_size, released_mapped);
+                }),
+                total_size};
+    }
+
+private:
+    u8 * storage = nullptr;
+    usize storage_size = 0;
+    usize front_size = 0;
+    usize back_size = 0;
+    bool mapped = false;
+
+    static usize page_size() {
+        static const usize value = usize(sysconf(_SC_PAGESIZE));
+        return value;
+    }
+
+    static usize round_capacity(usize _capacity) {
+        if(_capacity < MIN_CAPACITY) {
+            return MIN_CAPACITY;
+        }
+        if(_capacity < MMAP_THRESHOLD) {
+            return _capacity;
+        }
+        return (_capacity + page_size() - 1) & ~(page_size() - 1);
+    }
+
+    static void deallocate(u8 * ptr, usize _size, bool is_mapped) {
+        if(ptr == nullptr) {
+            return;
+        }
+        if(is_mapped) {
+            munmap(ptr, _size);
+        } else {
+            std::free(ptr);
+        }
+    }
+
+    [[gnu::always_inline]] inline bool ensure_available(usize _size) {
+        if(storage_size - front_size - back_size >= _size) [[likely]] {
+            return true;
+        }
+        return grow(_size);
+    }
+
+    [[gnu::always_inline]] inline bool ensure_available(ConstBuffer & source) {
+        if(storage_size - front_size - back_size >= source.size) [[likely]] {
+            return true;
+        }
+        return grow(source);
+    }
+
+    /// \brief grow() for source.size bytes. If source points into storage, it is moved along with the bytes.
+    [[gnu::noinline]] bool grow(ConstBuffer & source) {
+        const usize offset = usize(reinterpret_cast<uintptr_t>(source.data) - reinterpret_cast<uintptr_t>(storage));
+        if(storage == nullptr || offset >= storage_size) {
+            return grow(source.size);
+        }
+        const usize old_storage_size = storage_size;
+        if(not grow(source.size)) {
+            return false;
+        }
+        // Front bytes keep their offset, back bytes keep their distance from the end.
+        source.data = (offset < old_storage_size - back_size) ? storage + offset : storage + storage_size - (old_storage_size - offset);
+        return true;
+    }
+
+    [[gnu::noinline]] bool grow(usize _size) {
+        if(_size > usize(-1) / 2 - size()) {
+            return false;
+        }
+        return reallocate(std::max(size() + _size, storage_size * 2));
+    }
+
+    bool reallocate(usize _capacity) {
+        const usize new_size = round_capacity(_capacity);
+        const bool new_mapped = (new_size >= MMAP_THRESHOLD);
+
+        u8 * new_storage;
+        if(new_mapped == mapped && storage != nullptr) {
+            // Same kind of storage: resize in-place (or let the kernel/allocator move pages), then fix back bytes.
+            if(new_size < storage_size && back_size != 0) {
+                std::memmove(storage + new_size - back_size, storage + storage_size - back_size, back_size);
+            }
+
+            if(mapped) {
+                void * const remapped = mremap(storage, storage_size, new_size, MREMAP_MAYMOVE);
+                new_storage = (remapped == MAP_FAILED) ? nullptr : static_cast<u8 *>(remapped);
+            } else {
+                new_storage = static_cast<u8 *>(std::realloc(storage, new_size));
+            }
+
+            if(new_storage == nullptr) {
+                if(new_size < storage_size && back_size != 0) {
+                    std::memmove(storage + storage_size - back_size, storage + new_size - back_size, back_size);
+                }
+                return false;
+            }
+
+            if(new_size > storage_size && back_size != 0) {
+                std::memmove(new_storage + new_size - back_size, new_storage + storage_size - back_size, back_size);
+            }
+        } else {
+            if(new_mapped) {
+                void * const allocated = mmap(nullptr, new_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                new_storage = (allocated == MAP_FAILED) ? nullptr : static_cast<u8 *>(allocated);
+            } else {
+                new_storage = static_cast<u8 *>(std::malloc(new_size));
+            }
+
+            if(new_storage == nullptr) {
+                return false;
+            }
+
+            if(storage != nullptr) {
+                std::memcpy(new_storage, storage, front_size);
+                std::memcpy(new_storage + new_size - back_size, storage + storage_size - back_size, back_size);
+                deallocate(storage, storage_size, mapped);
+            }
+        }
+
+        storage = new_storage;
+        storage_size = new_size;
+        mapped = new_mapped;
+        return true;
+    }
+};
+
+}
@@ -0,0 +1,266 @@
+#pragma once
+
+#include "helpers/copy.h"
+#include "helpers/cpu.h"
+#include "helpers/types.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace sedfer {
+
+namespace kernels {
+
+/// \brief Longest pattern accepted by fill_pattern.
+inline constexpr usize MAX_FILL_PATTERN_SIZE = 64;
+
+/**
+ * \brief Pattern repeated into a block of unit + 128 bytes, unit is the smallest pattern multiple >= 128.
+ *
+ * Bytes [offset, offset + 128) of the block continue the pattern from any position offset < unit,
+ * so a fill stores up to 128 block bytes per step and advances offset by the step size modulo unit.
+ */
+struct FillBlock {
+    static constexpr usize STEP = 128;
+
+    alignas(32) u8 bytes[STEP + MAX_FILL_PATTERN_SIZE + STEP] = {};
+    usize unit = 0;
+
+    [[gnu::always_inline]] inline FillBlock(const u8 * pattern, usize pattern_size)
+        : unit((STEP + pattern_size - 1) / pattern_size * pattern_size)
+    {
+        // Doubling copies: a handful of memcpy calls instead of a division per byte.
+        std::memcpy(bytes, pattern, pattern_size);
+        for(usize filled = pattern_size; filled < unit + STEP; filled *= 2) {
+            std::memcpy(bytes + filled, bytes, std::min(filled, unit + STEP - filled));
+        }
+    }
+
+    /// \brief Advance offset by step (<= STEP) bytes, modulo unit.
+    [[nodiscard, gnu::always_inline]] inline usize next(usize offset, usize step) const {
+        offset += step;
+        return (offset >= unit) ? offset - unit : offset;
+    }
+};
+
+namespace scalar {
+
+/// \brief Repeat pattern (1 - MAX_FILL_PATTERN_SIZE bytes) over size bytes at data.
+inline void fill_pattern(u8 * data, usize size, const u8 * pattern, usize pattern_size) {
+    for(usize i = 0, j = 0; i < size; ++i) {
+        data[i] = pattern[j];
+        j = (j + 1 == pattern_size) ? 0 : j + 1;
+    }
+}
+
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+namespace sse2 {
+
+[[gnu::target("sse2"), gnu::always_inline]] inline __m128i load_block(const FillBlock & block, usize offset) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i *>(block.bytes + offset));
+}
+
+template<bool streaming>
+[[gnu::target("sse2"), gnu::always_inline]] inline void store_block(u8 * data, __m128i value) {
+    if constexpr(streaming) {
+        _mm_stream_si128(reinterpret_cast<__m128i *>(data), value);
+    } else {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(data), value);
+    }
+}
+
+/**
+ * \brief Repeat pattern over size bytes with 16-byte stores (64 bytes per iteration), streaming (non-temporal) stores if requested.
+ * \note Streaming stores need 16-byte aligned addresses: the head up to the first aligned address is stored normally.
+ */
+template<bool streaming>
+[[gnu::target("sse2")]] inline void fill_pattern(u8 * data, usize size, const u8 * pattern, usize pattern_size) {
+    if(size < 16) {
+        scalar::fill_pattern(data, size, pattern, pattern_size);
+        return;
+    }
+    const FillBlock block(pattern, pattern_size);
+
+    usize i = 0;
+    if constexpr(streaming) {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(data), load_block(block, 0));
+        i = 16 - (reinterpret_cast<uintptr_t>(data) & 15);
+    }
+    // i <= 16 < unit, so offset == i.
+    usize offset = i;
+    for(; i + 64 <= size; i += 64) {
+        const __m128i a = load_block(block, offset);
+        const __m128i b = load_block(block, offset + 16);
+        const __m128i c = load_block(block, offset + 32);
+        const __m128i d = load_block(block, offset + 48);
+        store_block<streaming>(data + i, a);
+        store_block<streaming>(data + i + 16, b);
+        store_block<streaming>(data + i + 32, c);
+        store_block<streaming>(data + i + 48, d);
+        offset = block.next(offset, 64);
+    }
+    for(; i + 16 <= size; i += 16) {
+        store_block<streaming>(data + i, load_block(block, offset));
+        offset = block.next(offset, 16);
+    }
+    if constexpr(streaming) {
+        _mm_sfence();
+    }
+    if(i != size) {
+        i = size - 16;
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(data + i), load_block(block, i % block.unit));
+    }
+}
+
+}
+
+namespace avx2 {
+
+[[gnu::target("avx2"), gnu::always_inline]] inline __m256i load_block(const FillBlock & block, usize offset) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block.bytes + offset));
+}
+
+template<bool streaming>
+[[gnu::target("avx2"), gnu::always_inline]] inline void store_block(u8 * data, __m256i value) {
+    if constexpr(streaming) {
+        _mm256_stream_si256(reinterpret_cast<__m256i *>(data), value);
+    } else {
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(data), value);
+    }
+}
+
+/**
+ * \brief Repeat pattern over size bytes with 32-byte stores (128 bytes per iteration), streaming (non-temporal) stores if requested.
+ * \note Streaming stores need 32-byte aligned addresses: the head up to the first aligned address is stored normally.
+ */
+template<bool streaming>
+[[gnu::target("avx2")]] inline void fill_pattern(u8 * data, usize size, const u8 * pattern, usize pattern_size) {
+    if(size < 32) {
+        sse2::fill_pattern<false>(data, size, pattern, pattern_size);
+        return;
+    }
+    const FillBlock block(pattern, pattern_size);
+
+    usize i = 0;
+    if constexpr(streaming) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(data), load_block(block, 0));
+        i = 32 - (reinterpret_cast<uintptr_t>(data) & 31);
+    }
+    // i <= 32 < unit, so offset == i.
+    usize offset = i;
+    for(; i + 128 <= size; i += 128) {
+        const __m256i a = load_block(block, offset);
+        const __m256i b = load_block(block, offset + 32);
+        const __m256i c = load_block(block, offset + 64);
+        const __m256i d = load_block(block, offset + 96);
+        store_block<streaming>(data + i, a);
+        store_block<streaming>(data + i + 32, b);
+        store_block<streaming>(data + i + 64, c);
+        store_block<streaming>(data + i + 96, d);
+        offset = block.next(offset, 128);
+    }
+    for(; i + 32 <= size; i += 32) {
+        store_block<streaming>(data + i, load_block(block, offset));
+        offset = block.next(offset, 32);
+    }
+    if constexpr(streaming) {
+        _mm_sfence();
+    }
+    if(i != size) {
+        i = size - 32;
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(data + i), load_block(block, i % block.unit));
+    }
+}
+
+}
+
+#endif
+
+/**
+ * \brief Repeat pattern (1 - MAX_FILL_PATTERN_SIZE bytes) over size bytes at data.
+ * \note Uses streaming stores (destination is not cached) from streaming_copy_threshold.
+ */
+inline void fill_pattern(u8 * data, usize size, const u8 * pattern, usize pattern_size) {
+    const bool streaming = size >= streaming_copy_threshold;
+#if defined(__x86_64__) || defined(__i386__)
+    switch(cpu_tier()) {
+        case CpuTier::avx512:
+        case CpuTier::avx2: return streaming ? avx2::fill_pattern<true>(data, size, pattern, pattern_size)
+                                             : avx2::fill_pattern<false>(data, size, pattern, pattern_size);
+        case CpuTier::sse42:
+        case CpuTier::sse2: return streaming ? sse2::fill_pattern<true>(data, size, pattern, pattern_size)
+                                             : sse2::fill_pattern<false>(data, size, pattern, pattern_size);
+        case CpuTier::scalar: break;
+    }
+#endif
+    (void)streaming;
+    scalar::fill_pattern(data, size, pattern, pattern_size);
+}
+
+/// \brief Out-of-line part of fill: memset (vectorized by libc), or streaming stores from streaming_copy_threshold.
+[[gnu::noinline]] inline void fill_large(u8 * data, usize size, u8 value) {
+    if(size < streaming_copy_threshold) {
+        std::memset(data, value, size);
+        return;
+    }
+    fill_pattern(data, size, &value, 1);
+}
+
+/**
+ * \brief Set size bytes at data to value.
+ *
+ * Sizes up to SMALL_COPY_SIZE are stored inline with two overlapping broadcast stores (1, 2, 4, 8, 16 or 32 bytes),
+ * larger ones are forwarded to fill_large.
+ */
+[[gnu::always_inline]] inline void fill(u8 * data, usize size, u8 value) {
+    if(size <= 16) {
+        const u64 word = 0x0101010101010101ull * value;
+        if(size >= 8) {
+            std::memcpy(data, &word, 8);
+            std::memcpy(data + size - 8, &word, 8);
+        } else if(size >= 4) {
+            std::memcpy(data, &word, 4);
+            std::memcpy(data + size - 4, &word, 4);
+        } else if(size >= 2) {
+            std::memcpy(data, &word, 2);
+            std::memcpy(data + size - 2, &word, 2);
+        } else if(size == 1) {
+            *data = value;
+        }
+        return;
+    }
+    // Constant-size memsets are emitted as vector stores.
+    if(size <= 32) {
+        std::memset(data, value, 16);
+        std::memset(data + size - 16, value, 16);
+        return;
+    }
+    if(size <= SMALL_COPY_SIZE) {
+        std::memset(data, value, 32);
+        std::memset(data + size - 32, value, 32);
+        return;
+    }
+    fill_large(data, size, value);
+}
+
+/**
+ * \brief Set size bytes at data to zero, the stores are not removed by the optimizer (for keys, passwords etc.).
+ *
+ * A plain memset before free or end of scope is a dead store and may be elided, the empty asm statement
+ * below tells the compiler that memory at data is read afterwards.
+ */
+inline void secure_zero(u8 * data, usize size) {
+    std::memset(data, 0, size);
+    asm volatile("" : : "r"(data) : "memory");
+}
+
+}
+
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "helpers/buffer.h"
+#include "helpers/search.h"
+#include "helpers/types.h"
+
+namespace sedfer {
+
+/**
+ * \brief Finder is a prepared needle: searches for the same bytes in many buffers, preprocessing is done once.
+ *
+ * Short needles (up to kernels::SHORT_NEEDLE_SIZE) need no preprocessing and are searched with the SIMD first/last byte
+ * prefilter. Longer needles are factorized for Two-Way search (in both directions) in the constructor.
+ * \code
+ * static const u8 MARKER[] = {0xde, 0xad, 0xbe, 0xef, 0x00, 0x01, 0x02, 0x03};
+ * const Finder marker(MARKER);
+ *
+ * for(ConstBuffer block : blocks) {
+ *     ConstBuffer found = marker.find(block);
+ *     if(found.data != nullptr) {
+ *         // found.data points to the marker
+ *     }
+ * }
+ * \endcode
+ * \note Non-owning: needle bytes must outlive the Finder.
+ */
+class Finder {
+public:
+    [[gnu::always_inline]] inline explicit Finder(ConstBuffer _needle)
+        : needle_bytes(_needle)
+    {
+        if(needle_bytes.size > kernels::SHORT_NEEDLE_SIZE) {
+            forward = kernels::TwoWay<false>::factorize(needle_bytes.data, needle_bytes.size);
+            reverse = kernels::TwoWay<true>::factorize(needle_bytes.data, needle_bytes.size);
+        }
+    }
+
+    [[nodiscard, gnu::always_inline]] inline ConstBuffer needle() const {
+        return needle_bytes;
+    }
+
+    /**
+     * \brief Find first occurrence of needle in haystack.
+     * \return Sub-buffer from the found occurrence to the end if OK, {nullptr, 0} if not found.
+     */
+    [[nodiscard, gnu::always_inline]] inline ConstBuffer find(ConstBuffer haystack) const {
+        if(needle_bytes.size <= kernels::SHORT_NEEDLE_SIZE) {
+            return haystack.find(needle_bytes);
+        }
+        return tail_of(haystack, forward.search(haystack.data, haystack.size, needle_bytes.data, needle_bytes.size));
+    }
+
+    /**
+     * \brief Find last occurrence of needle in haystack.
+     * \return Sub-buffer from the found occurrence to the end if OK, {nullptr, 0} if not found.
+     */
+    [[nodiscard, gnu::always_inline]] inline ConstBuffer find_last(ConstBuffer haystack) const {
+        if(needle_bytes.size <= kernels::SHORT_NEEDLE_SIZE) {
+            return haystack.find_last(needle_bytes);
+        }
+        return tail_of(haystack, reverse.search(haystack.data, haystack.size, needle_bytes.data, needle_bytes.size));
+    }
+
+private:
+    ConstBuffer needle_bytes;
+    kernels::TwoWay<false> forward;
+    kernels::TwoWay<true> reverse;
+
+    [[nodiscard, gnu::always_inline]] static inline ConstBuffer tail_of(ConstBuffer haystack, const u8 * found) {
+        if(found == nullptr) {
+            return {};
+        }
+        return {found, usize(haystack.data + haystack.size - found)};
+    }
+};
+
+}
@@ -0,0 +1,510 @@
+#pragma once
+
+#include "helpers/buffer.h"
+#include "helpers/cpu.h"
+#include "helpers/types.h"
+
+#include <array>
+#include <bit>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace sedfer {
+
+/// \brief 128-bit hash value, see hash128().
+struct Hash128 {
+    u64 low = 0;
+    u64 high = 0;
+
+    [[nodiscard, gnu::always_inline]] inline bool operator==(const Hash128 &) const = default;
+};
+
+/**
+ * \brief Internals of hash64 / hash128 / Hasher: one code path per length class, SIMD only for long inputs.
+ *
+ * Length classes:
+ * 1. 0 - 16 bytes: two overlapping 8-byte (or 4-byte, or 1-3 byte) loads, one 64x64->128 multiply.
+ * 2. 17 - 256 bytes: two independent multiply-fold lanes over 32-byte chunks, the last chunk overlaps.
+ * 3. Longer: 8 x 64-bit accumulators over 64-byte stripes (32x32->64 multiplies, SIMD), scrambled every 1 KiB.
+ *
+ * Results are identical on every CPU tier and platform (input words are read as little-endian).
+ */
+namespace kernels {
+
+inline constexpr u64 HASH_SECRET[4] = {0xa0761d6478bd642full, 0xe7037ed1a0b428dbull, 0x8ebc6af09c88c6e3ull, 0x589965cc75374cc3ull};
+
+/// \brief Longest input of the two-lane (medium) length class.
+inline constexpr usize HASH_MEDIUM_SIZE = 256;
+
+inline constexpr usize HASH_STRIPE_SIZE = 64;
+inline constexpr usize HASH_KEY_SIZE = 192;
+
+/// \brief Stripes per block: each stripe of a block uses the key at an 8-byte offset, then accumulators are scrambled.
+inline constexpr usize HASH_BLOCK_STRIPES = (HASH_KEY_SIZE - HASH_STRIPE_SIZE) / 8;
+
+inline constexpr u32 HASH_PRIME32 = 0x9e3779b1;
+
+inline constexpr u64 HASH_INIT_ACC[8] = {
+    0x00000000c2b2ae3dull, 0x9e3779b185ebca87ull, 0xc2b2ae3d27d4eb4full, 0x165667b19e3779f9ull,
+    0x85ebca77c2b2ae63ull, 0x0000000085ebca77ull, 0x27d4eb2f165667c5ull, 0x000000009e3779b1ull,
+};
+
+/// \brief Default long-input key: splitmix64 output, little-endian.
+inline constexpr std::array<u8, HASH_KEY_SIZE> HASH_KEY = [] {
+    std::array<u8, HASH_KEY_SIZE> ret = {};
+    u64 state = 0x5ed7e12b00c0ffeeull;
+    for(usize i = 0; i < HASH_KEY_SIZE; i += 8) {
+        state += 0x9e3779b97f4a7c15ull;
+        u64 word = state;
+        word = (word ^ (word >> 30)) * 0xbf58476d1ce4e5b9ull;
+        word = (word ^ (word >> 27)) * 0x94d049bb133111ebull;
+        word ^= word >> 31;
+        for(usize j = 0; j < 8; ++j) {
+            ret[i + j] = u8(word >> (8 * j));
+        }
+    }
+    return ret;
+}();
+
+[[nodiscard, gnu::always_inline]] inline u64 hash_read64(const u8 * data) {
+    u64 ret;
+    std::memcpy(&ret, data, 8);
+    if constexpr(std::endian::native == std::endian::big) {
+        ret = std::byteswap(ret);
+    }
+    return ret;
+}
+
+[[nodiscard, gnu::always_inline]] inline u64 hash_read32(const u8 * data) {
+    u32 ret;
+    std::memcpy(&ret, data, 4);
+    if constexpr(std::endian::native == std::endian::big) {
+        ret = std::byteswap(ret);
+    }
+    return ret;
+}
+
+[[gnu::always_inline]] inline void hash_write64(u8 * data, u64 value) {
+    if constexpr(std::endian::native == std::endian::big) {
+        value = std::byteswap(value);
+    }
+    std::memcpy(data, &value, 8);
+}
+
+/// \brief 64x64->128 multiply, both halves.
+[[gnu::always_inline]] inline void hash_multiply(u64 & a, u64 & b) {
+    const u128 product = u128(a) * b;
+    a = u64(product);
+    b = u64(product >> 64);
+}
+
+/// \brief 64x64->128 multiply, halves folded with xor.
+[[nodiscard, gnu::always_inline]] inline u64 hash_mix(u64 a, u64 b) {
+    hash_multiply(a, b);
+    return a ^ b;
+}
+
+[[nodiscard, gnu::always_inline]] inline u64 hash_avalanche(u64 value) {
+    value ^= value >> 37;
+    value *= 0x165667919e3779f9ull;
+    return value ^ (value >> 32);
+}
+
+/// \brief Seed as used by the short and medium length classes.
+[[nodiscard, gnu::always_inline]] inline u64 hash_seed(u64 seed) {
+    return seed ^ hash_mix(seed ^ HASH_SECRET[0], HASH_SECRET[1]);
+}
+
+/// \brief Long-input key for seed: words of the default key +/- seed, so accumulator collisions depend on the seed.
+inline void hash_derive_key(u64 seed, u8 * ret) {
+    for(usize i = 0; i < HASH_KEY_SIZE; i += 16) {
+        hash_write64(ret + i, hash_read64(HASH_KEY.data() + i) + seed);
+        hash_write64(ret + i + 8, hash_read64(HASH_KEY.data() + i + 8) - seed);
+    }
+}
+
+/// \brief 128-bit state (a, b) of a short (0 - 16 bytes) input.
+[[gnu::always_inline]] inline void hash_short(const u8 * data, usize size, u64 seed, u64 & a, u64 & b) {
+    if(size >= 4) {
+        // 4-7 bytes: both words hold the same overlapping 4-byte pair, 8-16: first and last 8 bytes.
+        const usize middle = (size >> 3) << 2;
+        a = (hash_read32(data) << 32) | hash_read32(data + middle);
+        b = (hash_read32(data + size - 4) << 32) | hash_read32(data + size - 4 - middle);
+    } else if(size > 0) {
+        a = (u64(data[0]) << 16) | (u64(data[size >> 1]) << 8) | data[size - 1];
+        b = 0;
+    } else {
+        a = 0;
+        b = 0;
+    }
+    a ^= HASH_SECRET[1];
+    b ^= seed;
+    hash_multiply(a, b);
+}
+
+/// \brief 128-bit state (a, b) of a medium (17 - HASH_MEDIUM_SIZE bytes) input.
+[[gnu::always_inline]] inline void hash_medium(const u8 * data, usize size, u64 seed, u64 & a, u64 & b) {
+    a = seed;
+    b = seed;
+    const u8 * const end = data + size;
+    if(size > 32) {
+        for(; end - data > 32; data += 32) {
+            a = hash_mix(hash_read64(data) ^ HASH_SECRET[1], hash_read64(data + 8) ^ a);
+            b = hash_mix(hash_read64(data + 16) ^ HASH_SECRET[2], hash_read64(data + 24) ^ b);
+        }
+        data = end - 32;
+    }
+    // Last 32 bytes, or first and last 16 bytes of 17 - 32.
+    a = hash_mix(hash_read64(data) ^ HASH_SECRET[1], hash_read64(data + 8) ^ a);
+    b = hash_mix(hash_read64(end - 16) ^ HASH_SECRET[2], hash_read64(end - 8) ^ b);
+}
+
+[[nodiscard, gnu::always_inline]] inline u64 hash_final_low(u64 a, u64 b, usize size) {
+    return hash_mix(a ^ HASH_SECRET[0] ^ size, b ^ HASH_SECRET[1]);
+}
+
+[[nodiscard, gnu::always_inline]] inline u64 hash_final_high(u64 a, u64 b, usize size) {
+    return hash_mix(a ^ HASH_SECRET[2], b ^ HASH_SECRET[3] ^ size);
+}
+
+/// \brief Fold the 8 long-input accumulators into 64 bits.
+[[nodiscard]] inline u64 hash_merge(const u64 * acc, const u8 * key, u64 start) {
+    for(usize i = 0; i < 8; i += 2) {
+        start += hash_mix(acc[i] ^ hash_read64(key + 8 * i), acc[i + 1] ^ hash_read64(key + 8 * i + 8));
+    }
+    return hash_avalanche(start);
+}
+
+namespace scalar {
+
+/// \brief acc[i] += low32(d ^ k) * high32(d ^ k), acc[i ^ 1] += d for the 8 words d of a stripe.
+[[gnu::always_inline]] inline void hash_accumulate(u64 * acc, const u8 * data, const u8 * key) {
+    for(usize i = 0; i < 8; ++i) {
+        const u64 word = hash_read64(data + 8 * i);
+        const u64 keyed = word ^ hash_read64(key + 8 * i);
+        acc[i ^ 1] += word;
+        acc[i] += (keyed & 0xffffffff) * (keyed >> 32);
+    }
+}
+
+[[gnu::always_inline]] inline void hash_scramble(u64 * acc, const u8 * key) {
+    for(usize i = 0; i < 8; ++i) {
+        acc[i] = (acc[i] ^ (acc[i] >> 47) ^ hash_read64(key + 8 * i)) * HASH_PRIME32;
+    }
+}
+
+/**
+ * \brief Accumulate stripes 64-byte stripes, position is the index of the first stripe in its block.
+ * Accumulators are scrambled after the last stripe of each block.
+ */
+inline void hash_stripes(u64 * acc, const u8 * data, usize stripes, usize & position, const u8 * key) {
+    for(; stripes != 0; --stripes, data += HASH_STRIPE_SIZE) {
+        hash_accumulate(acc, data, key + 8 * position);
+        if(++position == HASH_BLOCK_STRIPES) {
+            hash_scramble(acc, key + HASH_KEY_SIZE - HASH_STRIPE_SIZE);
+            position = 0;
+        }
+    }
+}
+
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+namespace sse2 {
+
+[[gnu::target("sse2"), gnu::always_inline]] inline __m128i hash_accumulate(__m128i acc, const u8 * data, const u8 * key) {
+    const __m128i word = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+    const __m128i keyed = _mm_xor_si128(word, _mm_loadu_si128(reinterpret_cast<const __m128i *>(key)));
+    const __m128i product = _mm_mul_epu32(keyed, _mm_shuffle_epi32(keyed, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_add_epi64(acc, _mm_add_epi64(product, _mm_shuffle_epi32(word, _MM_SHUFFLE(1, 0, 3, 2))));
+}
+
+[[gnu::target("sse2"), gnu::always_inline]] inline __m128i hash_scramble(__m128i acc, const u8 * key) {
+    acc = _mm_xor_si128(_mm_xor_si128(acc, _mm_srli_epi64(acc, 47)), _mm_loadu_si128(reinterpret_cast<const __m128i *>(key)));
+    const __m128i prime = _mm_set1_epi32(int(HASH_PRIME32));
+    const __m128i low = _mm_mul_epu32(acc, prime);
+    const __m128i high = _mm_mul_epu32(_mm_srli_epi64(acc, 32), prime);
+    return _mm_add_epi64(low, _mm_slli_epi64(high, 32));
+}
+
+/// \brief scalar::hash_stripes with 4 x 2 accumulators in SSE registers.
+[[gnu::target("sse2")]] inline void hash_stripes(u64 * acc, const u8 * data, usize stripes, usize & position, const u8 * key) {
+    __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(acc));
+    __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(acc + 2));
+    __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(acc + 4));
+    __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(acc + 6));
+    for(; stripes != 0; --stripes, data += HASH_STRIPE_SIZE) {
+        const u8 * const stripe_key = key + 8 * position;
+        a = hash_accumulate(a, data, stripe_key);
+        b = hash_accumulate(b, data + 16, stripe_key + 16);
+        c = hash_accumulate(c, data + 32, stripe_key + 32);
+        d = hash_accumulate(d, data + 48, stripe_key + 48);
+        if(++position == HASH_BLOCK_STRIPES) {
+            const u8 * const scramble_key = key + HASH_KEY_SIZE - HASH_STRIPE_SIZE;
+            a = hash_scramble(a, scramble_key);
+            b = hash_scramble(b, scramble_key + 16);
+            c = hash_scramble(c, scramble_key + 32);
+            d = hash_scramble(d, scramble_key + 48);
+            position = 0;
+        }
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(acc), a);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(acc + 2), b);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(acc + 4), c);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(acc + 6), d);
+}
+
+}
+
+namespace avx2 {
+
+[[gnu::target("avx2"), gnu::always_inline]] inline __m256i hash_accumulate(__m256i acc, const u8 * data, const u8 * key) {
+    const __m256i word = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data));
+    const __m256i keyed = _mm256_xor_si256(word, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(key)));
+    const __m256i product = _mm256_mul_epu32(keyed, _mm256_shuffle_epi32(keyed, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm256_add_epi64(acc, _mm256_add_epi64(product, _mm256_shuffle_epi32(word, _MM_SHUFFLE(1, 0, 3, 2))));
+}
+
+[[gnu::target("avx2"), gnu::always_inline]] inline __m256i hash_scramble(__m256i acc, const u8 * key) {
+    acc = _mm256_xor_si256(_mm256_xor_si256(acc, _mm256_srli_epi64(acc, 47)), _mm256_loadu_si256(reinterpret_cast<const __m256i *>(key)));
+    const __m256i prime = _mm256_set1_epi32(int(HASH_PRIME32));
+    const __m256i low = _mm256_mul_epu32(acc, prime);
+    const __m256i high = _mm256_mul_epu32(_mm256_srli_epi64(acc, 32), prime);
+    return _mm256_add_epi64(low, _mm256_slli_epi64(high, 32));
+}
+
+/// \brief scalar::hash_stripes with 2 x 4 accumulators in AVX registers.
+[[gnu::target("avx2")]] inline void hash_stripes(u64 * acc, const u8 * data, usize stripes, usize & position, const u8 * key) {
+    __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(acc));
+    __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(acc + 4));
+    for(; stripes != 0; --stripes, data += HASH_STRIPE_SIZE) {
+        const u8 * const stripe_key = key + 8 * position;
+        a = hash_accumulate(a, data, stripe_key);
+        b = hash_accumulate(b, data + 32, stripe_key + 32);
+        if(++position == HASH_BLOCK_STRIPES) {
+            a = hash_scramble(a, key + HASH_KEY_SIZE - HASH_STRIPE_SIZE);
+            b = hash_scramble(b, key + HASH_KEY_SIZE - HASH_STRIPE_SIZE + 32);
+            position = 0;
+        }
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(acc), a);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(acc + 4), b);
+}
+
+}
+
+namespace avx512 {
+
+/// \brief scalar::hash_stripes with all 8 accumulators in one AVX-512 register.
+[[gnu::target("avx512f,avx512bw")]] inline void hash_stripes(u64 * acc, const u8 * data, usize stripes, usize & position, const u8 * key) {
+    __m512i a = _mm512_loadu_si512(acc);
+    const __m512i prime = _mm512_set1_epi32(int(HASH_PRIME32));
+    for(; stripes != 0; --stripes, data += HASH_STRIPE_SIZE) {
+        const __m512i word = _mm512_loadu_si512(data);
+        const __m512i keyed = _mm512_xor_si512(word, _mm512_loadu_si512(key + 8 * position));
+        const __m512i product = _mm512_mul_epu32(keyed, _mm512_shuffle_epi32(keyed, _MM_PERM_CDAB));
+        a = _mm512_add_epi64(a, _mm512_add_epi64(product, _mm512_shuffle_epi32(word, _MM_PERM_BADC)));
+        if(++position == HASH_BLOCK_STRIPES) {
+            // a ^ (a >> 47) ^ key in one ternary logic instruction.
+            a = _mm512_ternarylogic_epi64(a, _mm512_srli_epi64(a, 47), _mm512_loadu_si512(key + HASH_KEY_SIZE - HASH_STRIPE_SIZE), 0x96);
+            a = _mm512_add_epi64(_mm512_mul_epu32(a, prime), _mm512_slli_epi64(_mm512_mul_epu32(_mm512_srli_epi64(a, 32), prime), 32));
+            position = 0;
+        }
+    }
+    _mm512_storeu_si512(acc, a);
+}
+
+}
+
+#endif
+
+/// \brief Accumulate 64-byte stripes into acc (see scalar::hash_stripes).
+inline void hash_stripes(u64 * acc, const u8 * data, usize stripes, usize & position, const u8 * key) {
+#if defined(__x86_64__) || defined(__i386__)
+    switch(cpu_tier()) {
+        case CpuTier::avx512: return avx512::hash_stripes(acc, data, stripes, position, key);
+        case CpuTier::avx2: return avx2::hash_stripes(acc, data, stripes, position, key);
+        case CpuTier::sse42:
+        case CpuTier::sse2: return sse2::hash_stripes(acc, data, stripes, position, key);
+        case CpuTier::scalar: break;
+    }
+#endif
+    scalar::hash_stripes(acc, data, stripes, position, key);
+}
+
+/// \brief Accumulators of a long (> HASH_MEDIUM_SIZE bytes) input: all stripes before the last, then the last 64 bytes.
+inline void hash_long(const u8 * data, usize size, const u8 * key, u64 * acc) {
+    std::memcpy(acc, HASH_INIT_ACC, sizeof(HASH_INIT_ACC));
+    usize position = 0;
+    hash_stripes(acc, data, (size - 1) / HASH_STRIPE_SIZE, position, key);
+    scalar::hash_accumulate(acc, data + size - HASH_STRIPE_SIZE, key + HASH_KEY_SIZE - HASH_STRIPE_SIZE - 7);
+}
+
+[[nodiscard, gnu::always_inline]] inline u64 hash_long_low(const u64 * acc, const u8 * key, usize size) {
+    return hash_merge(acc, key + 11, u64(size) * 0x9e3779b185ebca87ull);
+}
+
+[[nodiscard, gnu::always_inline]] inline u64 hash_long_high(const u64 * acc, const u8 * key, usize size) {
+    return hash_merge(acc, key + HASH_KEY_SIZE - HASH_STRIPE_SIZE - 11, ~(u64(size) * 0xc2b2ae3d27d4eb4full));
+}
+
+template<bool wide>
+[[nodiscard]] inline Hash128 hash_long(const u8 * data, usize size, u64 seed) {
+    alignas(64) u8 derived[HASH_KEY_SIZE];
+    const u8 * key = HASH_KEY.data();
+    if(seed != 0) {
+        hash_derive_key(seed, derived);
+        key = derived;
+    }
+    u64 acc[8];
+    hash_long(data, size, key, acc);
+    return {hash_long_low(acc, key, size), wide ? hash_long_high(acc, key, size) : 0};
+}
+
+/// \brief hash64 (wide = false, high is 0) or hash128 of size bytes at data.
+template<bool wide>
+[[nodiscard, gnu::always_inline]] inline Hash128 hash(const u8 * data, usize size, u64 seed) {
+    if(size > HASH_MEDIUM_SIZE) {
+        return hash_long<wide>(data, size, seed);
+    }
+    u64 a;
+    u64 b;
+    if(size <= 16) {
+        hash_short(data, size, hash_seed(seed), a, b);
+    } else {
+        hash_medium(data, size, hash_seed(seed), a, b);
+    }
+    return {hash_final_low(a, b, size), wide ? hash_final_high(a, b, size) : 0};
+}
+
+}
+
+/**
+ * \brief 64-bit non-cryptographic hash of buffer (sharding, hash tables, checksums of non-adversarial data).
+ *
+ * Specialized by length: up to 16 bytes it is a few loads and two multiplies without loops,
+ * inputs over 256 bytes use a SIMD accumulator (~15 GB/s with AVX2).
+ * A secret random seed makes collisions unpredictable for callers who don't know it (hash flooding).
+ * \note Values are stable across CPU tiers and platforms, but not guaranteed across versions of this library.
+ */
+[[nodiscard, gnu::always_inline]] inline u64 hash64(ConstBuffer buffer, u64 seed = 0) {
+    return kernels::hash<false>(buffer.data, buffer.size, seed).low;
+}
+
+/// \brief 128-bit variant of hash64 (e.g. content fingerprints), low is not equal to hash64.
+[[nodiscard, gnu::always_inline]] inline Hash128 hash128(ConstBuffer buffer, u64 seed = 0) {
+    return kernels::hash<true>(buffer.data, buffer.size, seed);
+}
+
+/**
+ * \brief Streaming hash64 / hash128: update with consecutive pieces gives the same result as one call on all bytes.
+ * \code
+ * Hasher hasher(seed);
+ * hasher.update(header);
+ * hasher.update(payload);
+ * const u64 hash = hasher.digest64(); // == hash64(header + payload, seed)
+ * \endcode
+ * \note Buffers up to 256 bytes, longer inputs are accumulated stripe by stripe (no allocation).
+ */
+class Hasher {
+public:
+    [[gnu::always_inline]] inline explicit Hasher(u64 _seed = 0)
+        : seed(_seed)
+    {
+        std::memcpy(key, kernels::HASH_KEY.data(), kernels::HASH_KEY_SIZE);
+        if(seed != 0) {
+            kernels::hash_derive_key(seed, key);
+        }
+        std::memcpy(acc, kernels::HASH_INIT_ACC, sizeof(acc));
+    }
+
+    inline void update(ConstBuffer buffer) {
+        total += buffer.size;
+        while(buffer.size != 0) {
+            if(buffered == BUFFER_SIZE) {
+                // More input follows, so no buffered stripe is the last one.
+                kernels::hash_stripes(acc, pending, BUFFER_SIZE / kernels::HASH_STRIPE_SIZE, position, key);
+                buffered = 0;
+                if(buffer.size > BUFFER_SIZE) {
+                    // Whole stripes straight from the input, at least one byte stays for the buffer.
+                    const usize stripes = (buffer.size - 1) / kernels::HASH_STRIPE_SIZE;
+                    const usize size = stripes * kernels::HASH_STRIPE_SIZE;
+                    kernels::hash_stripes(acc, buffer.data, stripes, position, key);
+                    // Keep the last stripe in the buffer tail, digest may need part of it.
+                    std::memcpy(pending + BUFFER_SIZE - kernels::HASH_STRIPE_SIZE, buffer.data + size - kernels::HASH_STRIPE_SIZE,
+                                kernels::HASH_STRIPE_SIZE);
+                    (void)buffer.skip(size);
+                }
+            }
+            const usize size = std::min(buffer.size, BUFFER_SIZE - buffered);
+            std::memcpy(pending + buffered, buffer.data, size);
+            buffered += size;
+            (void)buffer.skip(size);
+        }
+    }
+
+    [[nodiscard, gnu::always_inline]] inline u64 digest64() const {
+        return digest<false>().low;
+    }
+
+    [[nodiscard, gnu::always_inline]] inline Hash128 digest128() const {
+        return digest<true>();
+    }
+
+private:
+    static constexpr usize BUFFER_SIZE = kernels::HASH_MEDIUM_SIZE;
+
+    u64 seed = 0;
+    u64 total = 0;
+    usize buffered = 0;
+    usize position = 0;
+    alignas(64) u64 acc[8];
+    alignas(64) u8 key[kernels::HASH_KEY_SIZE];
+    alignas(64) u8 pending[BUFFER_SIZE];
+
+    template<bool wide>
+    [[nodiscard]] inline Hash128 digest() const {
+        if(total <= kernels::HASH_MEDIUM_SIZE) {
+            return kernels::hash<wide>(pending, buffered, seed);
+        }
+        u64 state[8];
+        std::memcpy(state, acc, sizeof(acc));
+        usize state_position = position;
+        const usize stripes = (buffered - 1) / kernels::HASH_STRIPE_SIZE;
+        kernels::hash_stripes(state, pending, stripes, state_position, key);
+
+        // Last 64 input bytes: buffered bytes, preceded by the tail of the previous stripes if fewer than 64.
+        u8 last[kernels::HASH_STRIPE_SIZE];
+        if(buffered >= kernels::HASH_STRIPE_SIZE) {
+            std::memcpy(last, pending + buffered - kernels::HASH_STRIPE_SIZE, kernels::HASH_STRIPE_SIZE);
+        } else {
+            const usize previous = kernels::HASH_STRIPE_SIZE - buffered;
+            std::memcpy(last, pending + BUFFER_SIZE - previous, previous);
+            std::memcpy(last + previous, pending, buffered);
+        }
+        kernels::scalar::hash_accumulate(state, last, key + kernels::HASH_KEY_SIZE - kernels::HASH_STRIPE_SIZE - 7);
+        return {kernels::hash_long_low(state, key, total), wide ? kernels::hash_long_high(state, key, total) : 0};
+    }
+};
+
+/// \brief Hash functor for unordered containers of buffers (pair with BufferEqual), hash64 with a seed.
+struct BufferHash {
+    u64 seed = 0;
+
+    [[nodiscard, gnu::always_inline]] inline usize operator()(ConstBuffer buffer) const {
+        return usize(hash64(buffer, seed));
+    }
+};
+
+/// \brief Content equality functor for unordered containers of buffers.
+struct BufferEqual {
+    [[nodiscard, gnu::always_inline]] inline bool operator()(ConstBuffer left, ConstBuffer right) const {
+        return equal(left, right);
+    }
+};
+
+}
@@ -0,0 +1,320 @@
+#pragma once
+
+#include "helpers/cpu.h"
+#include "helpers/types.h"
+
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace sedfer {
+
+/// \brief Letter case of hex digits a - f written by hex_encode / push_hex (decoding accepts both).
+enum class HexCase : u8 {
+    lower,
+    upper,
+};
+
+/// \brief Concept for fixed-width integers read / written as hex text by pop_hex / push_hex (u8 - u64).
+template<typename T>
+concept hex_integer = std::unsigned_integral<T> && (not std::same_as<T, bool>) && (sizeof(T) <= 8);
+
+/**
+ * \brief Hex digits for byte arrays (bulk) and for fixed-width integers.
+ *
+ * Bulk kernels split bytes into nibbles and map them to digits with a 16-entry pshufb table (encode),
+ * or classify digits by range and merge nibble pairs with pmaddubsw (decode). Fixed-width integers use SWAR:
+ * 8 digits in one 64-bit word, no table.
+ */
+namespace kernels {
+
+/// \brief Two digits per byte value, for the scalar kernels.
+[[nodiscard]] constexpr inline std::array<u8, 512> hex_pairs(char a) {
+    std::array<u8, 512> ret = {};
+    for(usize i = 0; i < 256; ++i) {
+        ret[2 * i] = u8((i >> 4) < 10 ? '0' + (i >> 4) : a + (i >> 4) - 10);
+        ret[2 * i + 1] = u8((i & 15) < 10 ? '0' + (i & 15) : a + (i & 15) - 10);
+    }
+    return ret;
+}
+
+inline constexpr std::array<u8, 512> HEX_PAIRS_LOWER = hex_pairs('a');
+inline constexpr std::array<u8, 512> HEX_PAIRS_UPPER = hex_pairs('A');
+
+/// \brief Digit -> value, 0xff for non-digits.
+inline constexpr std::array<u8, 256> HEX_VALUES = [] {
+    std::array<u8, 256> ret = {};
+    ret.fill(0xff);
+    for(usize i = 0; i < 10; ++i) {
+        ret['0' + i] = u8(i);
+    }
+    for(usize i = 0; i < 6; ++i) {
+        ret['a' + i] = u8(10 + i);
+        ret['A' + i] = u8(10 + i);
+    }
+    return ret;
+}();
+
+[[nodiscard, gnu::always_inline]] inline u64 hex_load_le(const u8 * data) {
+    u64 ret;
+    std::memcpy(&ret, data, 8);
+    if constexpr(std::endian::native == std::endian::big) {
+        ret = std::byteswap(ret);
+    }
+    return ret;
+}
+
+[[gnu::always_inline]] inline void hex_store_le(u8 * data, u64 value) {
+    if constexpr(std::endian::native == std::endian::big) {
+        value = std::byteswap(value);
+    }
+    std::memcpy(data, &value, 8);
+}
+
+/// \brief 8 hex digits of value, most significant first, as a little-endian word (first digit in the low byte).
+[[nodiscard, gnu::always_inline]] inline u64 hex_digits(u32 value, HexCase letters) {
+    // Spread nibbles to bytes, least significant nibble in the low byte.
+    u64 x = value;
+    x = (x | (x << 16)) & 0x0000ffff0000ffffull;
+    x = (x | (x << 8)) & 0x00ff00ff00ff00ffull;
+    x = (x | (x << 4)) & 0x0f0f0f0f0f0f0f0full;
+    // 1 in bytes >= 10.
+    const u64 letter = ((x + 0x0606060606060606ull) >> 4) & 0x0101010101010101ull;
+    x += 0x3030303030303030ull + letter * ((letters == HexCase::upper) ? 'A' - '0' - 10 : 'a' - '0' - 10);
+    return std::byteswap(x);
+}
+
+/**
+ * \brief Value of 8 hex digits (either case) loaded as a little-endian word.
+ * \return true if OK, false if any byte is not a hex digit.
+ */
+[[nodiscard, gnu::always_inline]] inline bool hex_value(u64 digits, u32 & ret) {
+    constexpr u64 HIGH = 0x8080808080808080ull;
+    // Range checks by carry into bit 7, valid for bytes < 0x80.
+    const u64 lower = digits | 0x2020202020202020ull;
+    const u64 digit = (digits + 0x5050505050505050ull) & ~(digits + 0x4646464646464646ull);
+    const u64 letter = (lower + 0x1f1f1f1f1f1f1f1full) & ~(lower + 0x1919191919191919ull);
+    if((digits & HIGH) != 0 || ((digit | letter) & HIGH) != HIGH) {
+        return false;
+    }
+    // Letters: low nibble of 'a' - 'f' is 1 - 6.
+    u64 x = (digits & 0x0f0f0f0f0f0f0f0full) + ((letter & HIGH) >> 7) * 9;
+    // Merge nibble pairs (first digit is the high nibble), then bytes, first byte most significant.
+    x = ((x & 0x000f000f000f000full) << 4) | ((x >> 8) & 0x000f000f000f000full);
+    x = (x | (x >> 8)) & 0x0000ffff0000ffffull;
+    x = (x | (x >> 16)) & 0x00000000ffffffffull;
+    ret = std::byteswap(u32(x));
+    return true;
+}
+
+/// \brief Write value as 2 * sizeof(T) hex digits at out.
+template<hex_integer T>
+[[gnu::always_inline]] inline void hex_write(u8 * out, T value, HexCase letters) {
+    if constexpr(sizeof(T) == 8) {
+        hex_store_le(out, hex_digits(u32(value >> 32), letters));
+        hex_store_le(out + 8, hex_digits(u32(value), letters));
+    } else if constexpr(sizeof(T) == 4) {
+        hex_store_le(out, hex_digits(value, letters));
+    } else {
+        // Last 2 * sizeof(T) of 8 digits.
+        u8 digits[8];
+        hex_store_le(digits, hex_digits(value, letters));
+        std::memcpy(out, digits + 8 - 2 * sizeof(T), 2 * sizeof(T));
+    }
+}
+
+/**
+ * \brief Read 2 * sizeof(T) hex digits at data into value.
+ * \return true if OK, false if any byte is not a hex digit (value is unchanged).
+ */
+template<hex_integer T>
+[[nodiscard, gnu::always_inline]] inline bool hex_read(const u8 * data, T & value) {
+    u32 high = 0;
+    u32 low = 0;
+    if constexpr(sizeof(T) == 8) {
+        if(not hex_value(hex_load_le(data), high) || not hex_value(hex_load_le(data + 8), low)) {
+            return false;
+        }
+        value = T((u64(high) << 32) | low);
+    } else if constexpr(sizeof(T) == 4) {
+        if(not hex_value(hex_load_le(data), low)) {
+            return false;
+        }
+        value = T(low);
+    } else {
+        // Left-padded with '0' digits to 8.
+        u8 digits[8] = {'0', '0', '0', '0', '0', '0', '0', '0'};
+        std::memcpy(digits + 8 - 2 * sizeof(T), data, 2 * sizeof(T));
+        if(not hex_value(hex_load_le(digits), low)) {
+            return false;
+        }
+        value = T(low);
+    }
+    return true;
+}
+
+namespace scalar {
+
+/// \brief Write 2 * size hex digits of size bytes at out.
+inline void hex_encode(const u8 * data, usize size, u8 * out, HexCase letters) {
+    const u8 * const pairs = (letters == HexCase::upper) ? HEX_PAIRS_UPPER.data() : HEX_PAIRS_LOWER.data();
+    for(usize i = 0; i < size; ++i) {
+        std::memcpy(out + 2 * i, pairs + 2 * data[i], 2);
+    }
+}
+
+/**
+ * \brief Decode 2 * size hex digits (either case) at data into size bytes at out.
+ * \return true if OK, false if any byte is not a hex digit.
+ */
+inline bool hex_decode(const u8 * data, usize size, u8 * out) {
+    for(usize i = 0; i < size; ++i) {
+        const u8 high = HEX_VALUES[data[2 * i]];
+        const u8 low = HEX_VALUES[data[2 * i + 1]];
+        if((high | low) & 0x80) {
+            return false;
+        }
+        out[i] = u8((high << 4) | low);
+    }
+    return true;
+}
+
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+namespace sse42 {
+
+[[gnu::target("sse4.2"), gnu::always_inline]] inline __m128i hex_table(HexCase letters) {
+    return (letters == HexCase::upper) ? _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F')
+                                       : _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+}
+
+/// \brief 16 bytes -> 32 digits per iteration: nibbles through a pshufb table, interleaved high / low.
+[[gnu::target("sse4.2")]] inline void hex_encode(const u8 * data, usize size, u8 * out, HexCase letters) {
+    const __m128i table = hex_table(letters);
+    const __m128i nibble = _mm_set1_epi8(0x0f);
+    usize i = 0;
+    for(; i + 16 <= size; i += 16) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        const __m128i high = _mm_shuffle_epi8(table, _mm_and_si128(_mm_srli_epi16(bytes, 4), nibble));
+        const __m128i low = _mm_shuffle_epi8(table, _mm_and_si128(bytes, nibble));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 2 * i), _mm_unpacklo_epi8(high, low));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 2 * i + 16), _mm_unpackhi_epi8(high, low));
+    }
+    scalar::hex_encode(data + i, size - i, out + 2 * i, letters);
+}
+
+/**
+ * \brief Nibble values of 16 digits (either case), valid is set to 0 if any byte is not a hex digit.
+ * Digits: byte - '0' <= 9, letters: (byte | 0x20) - 'a' <= 5 (unsigned, by min == self).
+ */
+[[gnu::target("sse4.2"), gnu::always_inline]] inline __m128i hex_nibbles(__m128i digits, __m128i & valid) {
+    const __m128i digit = _mm_sub_epi8(digits, _mm_set1_epi8('0'));
+    const __m128i letter = _mm_sub_epi8(_mm_or_si128(digits, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    const __m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+    const __m128i is_letter = _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter);
+    valid = _mm_and_si128(valid, _mm_or_si128(is_digit, is_letter));
+    return _mm_or_si128(_mm_and_si128(is_digit, digit), _mm_and_si128(is_letter, _mm_add_epi8(letter, _mm_set1_epi8(10))));
+}
+
+/// \brief 32 digits -> 16 bytes per iteration: nibble pairs merged with pmaddubsw (high * 16 + low), then packed.
+[[gnu::target("sse4.2")]] inline bool hex_decode(const u8 * data, usize size, u8 * out) {
+    const __m128i weights = _mm_set1_epi16(0x0110);
+    __m128i valid = _mm_set1_epi8(-1);
+    usize i = 0;
+    for(; i + 16 <= size; i += 16) {
+        const __m128i a = hex_nibbles(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 2 * i)), valid);
+        const __m128i b = hex_nibbles(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 2 * i + 16)), valid);
+        const __m128i bytes = _mm_packus_epi16(_mm_maddubs_epi16(a, weights), _mm_maddubs_epi16(b, weights));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), bytes);
+    }
+    return _mm_movemask_epi8(valid) == 0xffff && scalar::hex_decode(data + 2 * i, size - i, out + i);
+}
+
+}
+
+namespace avx2 {
+
+/// \brief 32 bytes -> 64 digits per iteration, see sse42::hex_encode.
+[[gnu::target("avx2")]] inline void hex_encode(const u8 * data, usize size, u8 * out, HexCase letters) {
+    const __m256i table = _mm256_broadcastsi128_si256(sse42::hex_table(letters));
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    usize i = 0;
+    for(; i + 32 <= size; i += 32) {
+        const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+        const __m256i high = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(bytes, 4), nibble));
+        const __m256i low = _mm256_shuffle_epi8(table, _mm256_and_si256(bytes, nibble));
+        // Unpacks work per 128-bit lane: digits of bytes 0-7 and 16-23, then 8-15 and 24-31.
+        const __m256i first = _mm256_unpacklo_epi8(high, low);
+        const __m256i second = _mm256_unpackhi_epi8(high, low);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + 2 * i), _mm256_permute2x128_si256(first, second, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + 2 * i + 32), _mm256_permute2x128_si256(first, second, 0x31));
+    }
+    sse42::hex_encode(data + i, size - i, out + 2 * i, letters);
+}
+
+[[gnu::target("avx2"), gnu::always_inline]] inline __m256i hex_nibbles(__m256i digits, __m256i & valid) {
+    const __m256i digit = _mm256_sub_epi8(digits, _mm256_set1_epi8('0'));
+    const __m256i letter = _mm256_sub_epi8(_mm256_or_si256(digits, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+    const __m256i is_digit = _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+    const __m256i is_letter = _mm256_cmpeq_epi8(_mm256_min_epu8(letter, _mm256_set1_epi8(5)), letter);
+    valid = _mm256_and_si256(valid, _mm256_or_si256(is_digit, is_letter));
+    return _mm256_or_si256(_mm256_and_si256(is_digit, digit), _mm256_and_si256(is_letter, _mm256_add_epi8(letter, _mm256_set1_epi8(10))));
+}
+
+/// \brief 64 digits -> 32 bytes per iteration, see sse42::hex_decode.
+[[gnu::target("avx2")]] inline bool hex_decode(const u8 * data, usize size, u8 * out) {
+    const __m256i weights = _mm256_set1_epi16(0x0110);
+    __m256i valid = _mm256_set1_epi8(-1);
+    usize i = 0;
+    for(; i + 32 <= size; i += 32) {
+        const __m256i a = hex_nibbles(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + 2 * i)), valid);
+        const __m256i b = hex_nibbles(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + 2 * i + 32)), valid);
+        // packus interleaves lanes: a0 b0 a1 b1 -> a0 a1 b0 b1.
+        const __m256i bytes = _mm256_packus_epi16(_mm256_maddubs_epi16(a, weights), _mm256_maddubs_epi16(b, weights));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), _mm256_permute4x64_epi64(bytes, 0xd8));
+    }
+    return _mm256_movemask_epi8(valid) == -1 && sse42::hex_decode(data + 2 * i, size - i, out + i);
+}
+
+}
+
+#endif
+
+/// \brief Write 2 * size hex digits of size bytes at out.
+inline void hex_encode(const u8 * data, usize size, u8 * out, HexCase letters) {
+#if defined(__x86_64__) || defined(__i386__)
+    switch(cpu_tier()) {
+        case CpuTier::avx512:
+        case CpuTier::avx2: return avx2::hex_encode(data, size, out, letters);
+        case CpuTier::sse42: return sse42::hex_encode(data, size, out, letters);
+        case CpuTier::sse2:
+        case CpuTier::scalar: break;
+    }
+#endif
+    scalar::hex_encode(data, size, out, letters);
+}
+
+/// \brief Decode 2 * size hex digits at data into size bytes at out, false if any byte is not a hex digit.
+inline bool hex_decode(const u8 * data, usize size, u8 * out) {
+#if defined(__x86_64__) || defined(__i386__)
+    switch(cpu_tier()) {
+        case CpuTier::avx512:
+        case CpuTier::avx2: return avx2::hex_decode(data, size, out);
+        case CpuTier::sse42: return sse42::hex_decode(data, size, out);
+        case CpuTier::sse2:
+        case CpuTier::scalar: break;
+    }
+#endif
+    return scalar::hex_decode(data, size, out);
+}
+
+}
+
+}
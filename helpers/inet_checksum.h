@@ -0,0 +1,245 @@
+#pragma once
+
+#include "helpers/buffer.h"
+#include "helpers/cpu.h"
+#include "helpers/types.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace sedfer {
+
+/**
+ * \brief Unfolded partial sums of the RFC 1071 checksum, reduced to 16 bits by inet_fold.
+ *
+ * Kernels add native-endian words into a 64-bit sum without folding: the ones' complement sum is the sum modulo
+ * 0xffff, and 2^32 = 2^64 = 1 modulo 0xffff, so 32- and 64-bit words can be added and folded once at the end.
+ * The byte order of the words only swaps the two bytes of the folded result (RFC 1071), fixed by inet_fold.
+ */
+namespace kernels {
+
+/// \brief Fold a partial sum into the 16-bit ones' complement sum, as the big-endian (network) word value.
+[[nodiscard, gnu::always_inline]] inline u16 inet_fold(u64 sum) {
+    sum = (sum & 0xffffffff) + (sum >> 32);
+    sum = (sum & 0xffffffff) + (sum >> 32);
+    sum = (sum & 0xffff) + (sum >> 16);
+    sum = (sum & 0xffff) + (sum >> 16);
+    if constexpr(std::endian::native == std::endian::little) {
+        return std::byteswap(u16(sum));
+    }
+    return u16(sum);
+}
+
+namespace scalar {
+
+/// \brief Partial sum of size bytes, a trailing odd byte is padded with zero.
+inline u64 inet_sum(const u8 * data, usize size) {
+    u64 sum = 0;
+    u64 carry = 0;
+    for(; size >= 8; size -= 8, data += 8) {
+        // 64-bit add with end-around carry collected separately.
+        u64 word;
+        std::memcpy(&word, data, 8);
+        sum += word;
+        carry += (sum < word);
+    }
+    for(; size >= 4; size -= 4, data += 4) {
+        u32 word;
+        std::memcpy(&word, data, 4);
+        carry += word;
+    }
+    if(size & 2) {
+        u16 half;
+        std::memcpy(&half, data, 2);
+        carry += half;
+        data += 2;
+    }
+    if(size & 1) {
+        const u8 last[2] = {*data, 0};
+        u16 half;
+        std::memcpy(&half, last, 2);
+        carry += half;
+    }
+    // sum + carry may overflow: fold sum first.
+    return (sum & 0xffffffff) + (sum >> 32) + carry;
+}
+
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+namespace sse2 {
+
+/// \brief Accumulator lanes are added into the scalar sum every INET_SUM_BLOCK iterations, before they can wrap.
+inline constexpr usize INET_SUM_BLOCK = usize(1) << 20;
+
+/// \brief Add the two 64-bit lanes of v into sum with end-around carry collected separately (like scalar::inet_sum).
+[[gnu::target("sse2")]] inline void inet_add_lanes(__m128i v, u64 & sum, u64 & carry) {
+    u64 lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), v);
+    for(const u64 lane : lanes) {
+        sum += lane;
+        carry += (sum < lane);
+    }
+}
+
+/// \brief 32-bit words widened into two 64-bit accumulator vectors, 64 bytes per iteration.
+[[gnu::target("sse2")]] inline u64 inet_sum(const u8 * data, usize size) {
+    const __m128i zero = _mm_setzero_si128();
+    u64 sum = 0;
+    u64 carry = 0;
+    while(size >= 64) {
+        // Lanes grow by less than 2^34 per iteration: below 2^54 after a block.
+        __m128i a = zero;
+        __m128i b = zero;
+        for(usize n = std::min(size / 64, INET_SUM_BLOCK); n != 0; --n, size -= 64, data += 64) {
+            const __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+            const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 16));
+            const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 32));
+            const __m128i z = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 48));
+            a = _mm_add_epi64(a, _mm_add_epi64(_mm_unpacklo_epi32(w, zero), _mm_unpackhi_epi32(w, zero)));
+            b = _mm_add_epi64(b, _mm_add_epi64(_mm_unpacklo_epi32(x, zero), _mm_unpackhi_epi32(x, zero)));
+            a = _mm_add_epi64(a, _mm_add_epi64(_mm_unpacklo_epi32(y, zero), _mm_unpackhi_epi32(y, zero)));
+            b = _mm_add_epi64(b, _mm_add_epi64(_mm_unpacklo_epi32(z, zero), _mm_unpackhi_epi32(z, zero)));
+        }
+        inet_add_lanes(_mm_add_epi64(a, b), sum, carry);
+    }
+    return (sum & 0xffffffff) + (sum >> 32) + carry + scalar::inet_sum(data, size);
+}
+
+}
+
+namespace avx2 {
+
+/// \brief 32-bit words widened into four 64-bit accumulator vectors, 128 bytes per iteration.
+[[gnu::target("avx2")]] inline u64 inet_sum(const u8 * data, usize size) {
+    const __m256i zero = _mm256_setzero_si256();
+    u64 sum = 0;
+    u64 carry = 0;
+    while(size >= 128) {
+        // Lanes grow by less than 2^33 per iteration: below 2^53 after a block, 2^56 for the 8 lanes added together.
+        __m256i a = zero;
+        __m256i b = zero;
+        __m256i c = zero;
+        __m256i d = zero;
+        for(usize n = std::min(size / 128, sse2::INET_SUM_BLOCK); n != 0; --n, size -= 128, data += 128) {
+            const __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data));
+            const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + 32));
+            const __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + 64));
+            const __m256i z = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + 96));
+            a = _mm256_add_epi64(a, _mm256_add_epi64(_mm256_unpacklo_epi32(w, zero), _mm256_unpackhi_epi32(w, zero)));
+            b = _mm256_add_epi64(b, _mm256_add_epi64(_mm256_unpacklo_epi32(x, zero), _mm256_unpackhi_epi32(x, zero)));
+            c = _mm256_add_epi64(c, _mm256_add_epi64(_mm256_unpacklo_epi32(y, zero), _mm256_unpackhi_epi32(y, zero)));
+            d = _mm256_add_epi64(d, _mm256_add_epi64(_mm256_unpacklo_epi32(z, zero), _mm256_unpackhi_epi32(z, zero)));
+        }
+        const __m256i sums = _mm256_add_epi64(_mm256_add_epi64(a, b), _mm256_add_epi64(c, d));
+        sse2::inet_add_lanes(_mm_add_epi64(_mm256_castsi256_si128(sums), _mm256_extracti128_si256(sums, 1)), sum, carry);
+    }
+    return (sum & 0xffffffff) + (sum >> 32) + carry + sse2::inet_sum(data, size);
+}
+
+}
+
+#endif
+
+/// \brief Partial sum of size bytes (see scalar::inet_sum).
+inline u64 inet_sum(const u8 * data, usize size) {
+#if defined(__x86_64__) || defined(__i386__)
+    // Headers (20 - 60 bytes) are a few scalar words, shorter than one AVX2 iteration.
+    if(size < 128) {
+        return scalar::inet_sum(data, size);
+    }
+    switch(cpu_tier()) {
+        case CpuTier::avx512:
+        case CpuTier::avx2: return avx2::inet_sum(data, size);
+        case CpuTier::sse42:
+        case CpuTier::sse2: return sse2::inet_sum(data, size);
+        case CpuTier::scalar: break;
+    }
+#endif
+    return scalar::inet_sum(data, size);
+}
+
+/// \brief Ones' complement sum of size bytes starting at an even (odd = false) or odd offset of the checksummed data.
+[[nodiscard, gnu::always_inline]] inline u16 inet_add(const u8 * data, usize size, bool odd) {
+    const u16 sum = inet_fold(inet_sum(data, size));
+    return odd ? std::byteswap(sum) : sum;
+}
+
+/// \brief Ones' complement a + b.
+[[nodiscard, gnu::always_inline]] inline u16 inet_add(u16 a, u16 b) {
+    const u32 sum = u32(a) + b;
+    return u16((sum & 0xffff) + (sum >> 16));
+}
+
+}
+
+/**
+ * \brief Internet checksum (RFC 1071: IPv4, ICMP, UDP, TCP headers) of buffer.
+ * \return Checksum as the value of the big-endian 16-bit field, e.g. write it with {u8(ret >> 8), u8(ret)}.
+ * \note Checksum of data that includes its correct checksum field is 0.
+ */
+[[nodiscard, gnu::always_inline]] inline u16 inet_checksum(ConstBuffer buffer) {
+    return u16(~kernels::inet_add(buffer.data, buffer.size, false));
+}
+
+/**
+ * \brief Internet checksum over chained buffers (pseudo-header + header + payload), any buffer may have an odd size.
+ * \code
+ * InetChecksum checksum;
+ * checksum.update(pseudo_header);
+ * checksum.update(udp_header);
+ * checksum.update(payload);
+ * const u16 value = checksum.value();
+ * \endcode
+ */
+class InetChecksum {
+public:
+    inline void update(ConstBuffer buffer) {
+        sum = kernels::inet_add(sum, kernels::inet_add(buffer.data, buffer.size, odd));
+        odd ^= (buffer.size & 1) != 0;
+    }
+
+    /// \brief Append a 16-bit field in network byte order (e.g. pseudo-header protocol or length).
+    inline void update_word(u16 value) {
+        sum = kernels::inet_add(sum, odd ? std::byteswap(value) : value);
+    }
+
+    /// \brief Checksum of all bytes so far (see inet_checksum).
+    [[nodiscard, gnu::always_inline]] inline u16 value() const {
+        return u16(~sum);
+    }
+
+private:
+    u16 sum = 0;
+    bool odd = false;
+};
+
+/**
+ * \brief Patch checksum after bytes at offset of the checksummed data changed from old_bytes to new_bytes (RFC 1624).
+ * \code
+ * const packed<u16> old_id = header->id;
+ * header->id = next_id;
+ * if(not inet_checksum_update(checksum, old_id, header->id, offsetof(Header, id))) ...
+ * \endcode
+ * \return true if OK, false if old_bytes.size != new_bytes.size.
+ */
+[[nodiscard, gnu::always_inline]] inline bool inet_checksum_update(u16 & checksum, ConstBuffer old_bytes, ConstBuffer new_bytes,
+                                                                   usize offset) {
+    if(old_bytes.size != new_bytes.size) {
+        return false;
+    }
+    const bool odd = (offset & 1) != 0;
+    // HC' = ~(~HC + ~m + m')
+    const u16 removed = u16(~kernels::inet_add(old_bytes.data, old_bytes.size, odd));
+    const u16 added = kernels::inet_add(new_bytes.data, new_bytes.size, odd);
+    checksum = u16(~kernels::inet_add(kernels::inet_add(u16(~checksum), removed), added));
+    return true;
+}
+
+}
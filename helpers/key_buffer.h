@@ -0,0 +1,181 @@
+#pragma once
+
+#include "helpers/buffer.h"
+#include "helpers/types.h"
+
+#include <compare>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string_view>
+
+namespace sedfer {
+
+/**
+ * \brief KeyBuffer is a 16-byte key with inline prefix ("German string"), for sorting and joining on byte keys.
+ *
+ * Layout: u32 size | 4 bytes prefix | 8 bytes (rest of the key if size <= 12, pointer to the whole key otherwise).
+ * Most comparisons resolve on the first 8 bytes without dereferencing the key data:
+ * different sizes (for equal) or different prefixes (for ordering).
+ * \code
+ * std::vector<KeyBuffer> keys;
+ * for(ConstBuffer key : parse_keys(input)) {
+ *     keys.emplace_back(key);
+ * }
+ * std::sort(keys.begin(), keys.end());
+ *
+ * ConstBuffer first = keys[0].buffer(); // valid while keys[0] (and input) live
+ * \endcode
+ * \note Long keys are non-owning (like ConstBuffer), short keys are copied inline.
+ *       buffer() of a short key points into the KeyBuffer object itself.
+ */
+struct KeyBuffer {
+    /// \brief Keys up to this size are stored inline.
+    static constexpr usize INLINE_SIZE = 12;
+
+    /// \brief Keys of this size (or larger) can not be represented.
+    static constexpr usize MAX_SIZE = u32(-1);
+
+    [[gnu::always_inline]] inline KeyBuffer() = default;
+
+    /**
+     * \brief Make key from bytes. Short keys are copied, long keys point to const_buffer.data.
+     * \note const_buffer.size must be < MAX_SIZE (aborts otherwise), use from() for untrusted sizes.
+     */
+    [[gnu::always_inline]] inline explicit KeyBuffer(ConstBuffer const_buffer) {
+        if(const_buffer.size >= MAX_SIZE) [[unlikely]] {
+            std::abort();
+        }
+        key_size = u32(const_buffer.size);
+        if(key_size <= INLINE_SIZE) {
+            std::memcpy(bytes, const_buffer.data, key_size);
+        } else {
+            std::memcpy(bytes, const_buffer.data, 4);
+            std::memcpy(bytes + 4, &const_buffer.data, sizeof(const u8 *));
+        }
+    }
+
+    /**
+     * \brief Make key from bytes, see KeyBuffer(ConstBuffer).
+     * \return true if OK, false if const_buffer.size >= MAX_SIZE (ret is unchanged).
+     */
+    [[nodiscard, gnu::always_inline]] static inline bool from(ConstBuffer const_buffer, KeyBuffer & ret) {
+        if(const_buffer.size >= MAX_SIZE) {
+            return false;
+        }
+        ret = KeyBuffer(const_buffer);
+        return true;
+    }
+
+    [[nodiscard, gnu::always_inline]] inline usize size() const {
+        return key_size;
+    }
+
+    [[nodiscard, gnu::always_inline]] inline bool is_inline() const {
+        return key_size <= INLINE_SIZE;
+    }
+
+    /// \brief Pointer to key bytes (into this object for inline keys).
+    [[nodiscard, gnu::always_inline]] inline const u8 * data() const {
+        if(is_inline()) {
+            return bytes;
+        }
+        const u8 * pointer;
+        std::memcpy(&pointer, bytes + 4, sizeof(pointer));
+        return pointer;
+    }
+
+    /// \brief Key bytes as ConstBuffer (into this object for inline keys).
+    [[nodiscard, gnu::always_inline]] inline ConstBuffer buffer() const {
+        return {data(), key_size};
+    }
+
+    // NOLINTNEXTLINE(google-explicit-constructor)
+    [[gnu::always_inline]] inline operator ConstBuffer() const {
+        return buffer();
+    }
+
+    /// \brief Size and prefix as one integer.
+    [[nodiscard, gnu::always_inline]] inline u64 head() const {
+        u64 ret;
+        std::memcpy(&ret, this, sizeof(ret));
+        return ret;
+    }
+
+    /// \brief First 4 bytes in big-endian order (zero padded), compares like the bytes do.
+    [[nodiscard, gnu::always_inline]] inline u32 prefix() const {
+        u32 ret;
+        std::memcpy(&ret, bytes, sizeof(ret));
+        return __builtin_bswap32(ret);
+    }
+
+    /// \brief Byte-wise equality, resolves without dereferencing unless sizes and prefixes are equal.
+    [[nodiscard, gnu::always_inline]] friend inline bool operator==(const KeyBuffer & left, const KeyBuffer & right) {
+        if(left.head() != right.head()) {
+            return false;
+        }
+        if(left.is_inline()) {
+            return left.tail() == right.tail();
+        }
+        return kernels::equal(left.data() + 4, right.data() + 4, left.key_size - 4);
+    }
+
+    /// \brief Lexicographic order (like std::lexicographical_compare on bytes).
+    [[nodiscard, gnu::always_inline]] friend inline std::strong_ordering operator<=>(const KeyBuffer & left, const KeyBuffer & right) {
+        if(left.prefix() != right.prefix()) {
+            return left.prefix() <=> right.prefix();
+        }
+
+        if(left.is_inline() && right.is_inline()) {
+            // Padding is zero: shorter key orders first on a tie.
+            const u64 left_tail = __builtin_bswap64(left.tail());
+            const u64 right_tail = __builtin_bswap64(right.tail());
+            if(left_tail != right_tail) {
+                return left_tail <=> right_tail;
+            }
+            return left.key_size <=> right.key_size;
+        }
+
+        // Keys are short in practice: compare word-by-word inline instead of calling memcmp.
+        const u8 * l = left.data() + 4;
+        const u8 * r = right.data() + 4;
+        usize remaining = std::min(left.key_size, right.key_size);
+        remaining = (remaining > 4) ? remaining - 4 : 0;
+        for(; remaining >= 8; remaining -= 8, l += 8, r += 8) {
+            u64 l_word;
+            u64 r_word;
+            std::memcpy(&l_word, l, 8);
+            std::memcpy(&r_word, r, 8);
+            if(l_word != r_word) {
+                return __builtin_bswap64(l_word) <=> __builtin_bswap64(r_word);
+            }
+        }
+        for(; remaining != 0; remaining -= 1, l += 1, r += 1) {
+            if(*l != *r) {
+                return *l <=> *r;
+            }
+        }
+        return left.key_size <=> right.key_size;
+    }
+
+private:
+    u32 key_size = 0;
+    alignas(4) u8 bytes[12] = {};
+
+    [[nodiscard, gnu::always_inline]] inline u64 tail() const {
+        u64 ret;
+        std::memcpy(&ret, bytes + 4, sizeof(ret));
+        return ret;
+    }
+};
+
+static_assert(sizeof(KeyBuffer) == 16);
+
+}
+
+template<>
+struct std::hash<sedfer::KeyBuffer> {
+    [[nodiscard, gnu::always_inline]] inline sedfer::usize operator()(const sedfer::KeyBuffer & key) const {
+        return std::hash<std::string_view>()({reinterpret_cast<const char *>(key.data()), key.size()});
+    }
+};
@@ -0,0 +1,562 @@
+#pragma once
+
+#include "helpers/buffer.h"
+#include "helpers/compact_buffer.h"
+#include "helpers/cpu.h"
+#include "helpers/types.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <numeric>
+#include <span>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace sedfer {
+
+/// \brief One occurrence of a pattern: offset of its first byte and pattern index (in constructor order).
+struct PatternMatch {
+    usize offset = 0;
+    u32 pattern = 0;
+
+    [[nodiscard]] friend constexpr auto operator<=>(const PatternMatch &, const PatternMatch &) = default;
+};
+
+namespace kernels {
+
+#if defined(__x86_64__) || defined(__i386__)
+
+namespace sse42 {
+
+/**
+ * \brief Teddy candidate scan: on_candidate(position, bucket mask) for every position where the first width bytes match
+ *        the nibble masks of some bucket.
+ * \return Position where the block loop stopped (remaining positions are left to the caller),
+ *         usize(-1) if on_candidate returned false.
+ */
+template<usize width, typename F>
+[[gnu::target("ssse3")]] inline usize teddy(const u8 * data, usize size, const u8 (& low_masks)[3][16], const u8 (& high_masks)[3][16],
+                                           F & on_candidate) {
+    usize i = 0;
+    if(size < 16 + width - 1) {
+        return i;
+    }
+
+    const __m128i nibble = _mm_set1_epi8(0x0f);
+    __m128i low[width];
+    __m128i high[width];
+    for(usize k = 0; k < width; ++k) {
+        low[k] = _mm_load_si128(reinterpret_cast<const __m128i *>(low_masks[k]));
+        high[k] = _mm_load_si128(reinterpret_cast<const __m128i *>(high_masks[k]));
+    }
+
+    for(; i + 16 + width - 1 <= size; i += 16) {
+        __m128i result = _mm_set1_epi8(char(0xff));
+        for(usize k = 0; k < width; ++k) {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i + k));
+            const __m128i l = _mm_shuffle_epi8(low[k], _mm_and_si128(chunk, nibble));
+            const __m128i h = _mm_shuffle_epi8(high[k], _mm_and_si128(_mm_srli_epi16(chunk, 4), nibble));
+            result = _mm_and_si128(result, _mm_and_si128(l, h));
+        }
+
+        u32 candidates = ~u32(_mm_movemask_epi8(_mm_cmpeq_epi8(result, _mm_setzero_si128()))) & 0xffff;
+        if(candidates != 0) [[unlikely]] {
+            alignas(16) u8 masks[16];
+            _mm_store_si128(reinterpret_cast<__m128i *>(masks), result);
+            do {
+                const u32 j = __builtin_ctz(candidates);
+                candidates &= candidates - 1;
+                if(not on_candidate(i + j, masks[j])) {
+                    return usize(-1);
+                }
+            } while(candidates != 0);
+        }
+    }
+    return i;
+}
+
+}
+
+namespace avx2 {
+
+template<usize width, typename F>
+[[gnu::target("avx2,bmi")]] inline usize teddy(const u8 * data, usize size, const u8 (& low_masks)[3][16], const u8 (& high_masks)[3][16],
+                                              F & on_candidate) {
+    usize i = 0;
+    if(size < 32 + width - 1) {
+        return i;
+    }
+
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    __m256i low[width];
+    __m256i high[width];
+    for(usize k = 0; k < width; ++k) {
+        low[k] = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i *>(low_masks[k])));
+        high[k] = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i *>(high_masks[k])));
+    }
+
+    for(; i + 32 + width - 1 <= size; i += 32) {
+        __m256i result = _mm256_set1_epi8(char(0xff));
+        for(usize k = 0; k < width; ++k) {
+            const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i + k));
+            const __m256i l = _mm256_shuffle_epi8(low[k], _mm256_and_si256(chunk, nibble));
+            const __m256i h = _mm256_shuffle_epi8(high[k], _mm256_and_si256(_mm256_srli_epi16(chunk, 4), nibble));
+            result = _mm256_and_si256(result, _mm256_and_si256(l, h));
+        }
+
+        u32 candidates = ~u32(_mm256_movemask_epi8(_mm256_cmpeq_epi8(result, _mm256_setzero_si256())));
+        if(candidates != 0) [[unlikely]] {
+            alignas(32) u8 masks[32];
+            _mm256_store_si256(reinterpret_cast<__m256i *>(masks), result);
+            do {
+                const u32 j = _tzcnt_u32(candidates);
+                candidates &= candidates - 1;
+                if(not on_candidate(i + j, masks[j])) {
+                    return usize(-1);
+                }
+            } while(candidates != 0);
+        }
+    }
+    return i;
+}
+
+}
+
+#endif
+
+}
+
+/**
+ * \brief Engine used by PatternSet::scan().
+ *
+ * 1. teddy: SIMD fingerprint of the first 1-3 pattern bytes (8 buckets of patterns), candidates are verified with memcmp.
+ *    Fast for small sets (up to TEDDY_MAX_PATTERNS), needs CpuTier::sse42.
+ * 2. automaton: Aho-Corasick compiled to a DFA over byte classes, one table lookup per input byte for any set size.
+ */
+enum class PatternEngine : u8 {
+    automatic,
+    teddy,
+    automaton,
+};
+
+/**
+ * \brief PatternSet is a compiled set of byte patterns, scanned for all of them in one pass.
+ *
+ * All occurrences are reported, including overlapping ones and patterns that occur inside other patterns.
+ * \code
+ * const std::vector<ConstBuffer> signatures = load_signatures();
+ * const PatternSet set(signatures);
+ *
+ * set.scan(payload, [&](PatternMatch match) {
+ *     classify(match.pattern, match.offset);
+ *     return true; // continue, false stops the scan
+ * });
+ *
+ * // Payload that arrives in pieces (matches may span pieces, offsets are counted from the stream start).
+ * PatternSet::Stream stream = set.stream();
+ * for(ConstBuffer piece : pieces) {
+ *     stream.scan(piece, on_match);
+ * }
+ * \endcode
+ * \note Pattern bytes are copied. Empty patterns never match.
+ * \note The order of reported matches is unspecified, find_all() sorts them.
+ */
+class PatternSet {
+public:
+    /// \brief Sets up to this many patterns use teddy (if available).
+    static constexpr usize TEDDY_MAX_PATTERNS = 32;
+
+    /// \brief Buffers of this size (or larger) are scanned by the automaton in two interleaved halves.
+    static constexpr usize AUTOMATON_2X_SIZE = 1024;
+
+    class Stream;
+
+    explicit PatternSet(std::span<const ConstBuffer> _patterns, PatternEngine _engine = PatternEngine::automatic) {
+        for(const ConstBuffer pattern : _patterns) {
+            patterns.push_back({u32(pattern_bytes.size()), u32(pattern.size)});
+            pattern_bytes.insert(pattern_bytes.end(), pattern.data, pattern.data + pattern.size);
+        }
+
+        build_automaton();
+
+        const bool teddy_available = (cpu_tier() >= CpuTier::sse42) && (min_size > 0) && (min_size != usize(-1));
+        if(_engine == PatternEngine::automatic) {
+            _engine = (patterns.size() <= TEDDY_MAX_PATTERNS) ? PatternEngine::teddy : PatternEngine::automaton;
+        }
+        selected = (_engine == PatternEngine::teddy && teddy_available) ? PatternEngine::teddy : PatternEngine::automaton;
+        if(selected == PatternEngine::teddy) {
+            build_teddy();
+        }
+    }
+
+    /// \brief Number of patterns (including empty ones).
+    [[nodiscard, gnu::always_inline]] inline usize size() const {
+        return patterns.size();
+    }
+
+    [[nodiscard, gnu::always_inline]] inline ConstBuffer pattern(u32 index) const {
+        return patterns[index].resolve({pattern_bytes.data(), pattern_bytes.size()});
+    }
+
+    /// \brief Engine selected at construction, never PatternEngine::automatic (scan() uses the automaton below CpuTier::sse42).
+    [[nodiscard, gnu::always_inline]] inline PatternEngine engine() const {
+        return selected;
+    }
+
+    /**
+     * \brief Report all matches in buffer to on_match(PatternMatch) -> bool (false stops the scan).
+     * \return false if stopped by on_match, true otherwise.
+     */
+    template<typename F>
+    inline bool scan(ConstBuffer buffer, F && on_match) const {
+        // The automaton is always built: it takes over if the tier was lowered (set_cpu_tier) after construction.
+        if(selected == PatternEngine::teddy && cpu_tier() >= CpuTier::sse42) {
+            return scan_teddy(buffer, on_match);
+        }
+        if(buffer.size >= AUTOMATON_2X_SIZE) {
+            return scan_automaton_2x(buffer, on_match);
+        }
+        u32 state = 0;
+        return scan_automaton(buffer, 0, state, on_match);
+    }
+
+    /// \brief All matches in buffer, sorted by offset, then by pattern.
+    [[nodiscard]] inline std::vector<PatternMatch> find_all(ConstBuffer buffer) const {
+        std::vector<PatternMatch> ret;
+        (void)scan(buffer, [&](PatternMatch match) {
+            ret.push_back(match);
+            return true;
+        });
+        std::sort(ret.begin(), ret.end());
+        return ret;
+    }
+
+    /// \brief true if any pattern occurs in buffer (stops at the first match).
+    [[nodiscard]] inline bool matches_any(ConstBuffer buffer) const {
+        return not scan(buffer, [](PatternMatch) {
+            return false;
+        });
+    }
+
+    /// \brief Streaming scan over successive buffers, see Stream.
+    [[nodiscard, gnu::always_inline]] inline Stream stream() const;
+
+private:
+    std::vector<u8> pattern_bytes;
+    std::vector<CompactBuffer> patterns;
+    usize min_size = usize(-1);
+    usize max_size = 0;
+    PatternEngine selected = PatternEngine::automaton;
+
+    // Automaton: states are premultiplied by class_count, states >= first_match_state have outputs.
+    std::array<u8, 256> byte_class = {};
+    u32 class_count = 1;
+    u32 first_match_state = 0;
+    std::vector<u32> transitions;
+    std::vector<u32> output_offsets;
+    std::vector<u32> outputs;
+
+    // Teddy: bit b of low_masks[i][n] / high_masks[i][n] is set if some pattern in bucket b has low / high nibble n at i.
+    usize teddy_size = 0;
+    alignas(16) u8 low_masks[3][16] = {};
+    alignas(16) u8 high_masks[3][16] = {};
+    std::vector<u32> buckets[8];
+
+    void build_automaton() {
+        // Bytes that occur in no pattern share class 0 (unless all 256 bytes occur).
+        bool used[256] = {};
+        for(const u8 byte : pattern_bytes) {
+            used[byte] = true;
+        }
+        const bool all_used = std::all_of(std::begin(used), std::end(used), [](bool b) { return b; });
+        class_count = all_used ? 0 : 1;
+        for(usize byte = 0; byte < 256; ++byte) {
+            if(used[byte]) {
+                byte_class[byte] = u8(class_count);
+                class_count += 1;
+            }
+        }
+        for(const CompactBuffer pattern : patterns) {
+            if(pattern.size != 0) {
+                min_size = std::min<usize>(min_size, pattern.size);
+                max_size = std::max<usize>(max_size, pattern.size);
+            }
+        }
+
+        static constexpr u32 NONE = u32(-1);
+        const u32 C = class_count;
+
+        // Trie over byte classes.
+        std::vector<u32> trie(C, NONE);
+        std::vector<std::vector<u32>> state_outputs(1);
+        for(u32 index = 0; index < patterns.size(); ++index) {
+            if(patterns[index].size == 0) {
+                continue;
+            }
+            const ConstBuffer bytes = pattern(index);
+            u32 state = 0;
+            for(usize i = 0; i < bytes.size; ++i) {
+                const usize slot = usize(state) * C + byte_class[bytes.data[i]];
+                if(trie[slot] == NONE) {
+                    trie[slot] = u32(state_outputs.size());
+                    state_outputs.emplace_back();
+                    trie.resize(trie.size() + C, NONE);
+                }
+                state = trie[slot];
+            }
+            state_outputs[state].push_back(index);
+        }
+        const u32 state_count = u32(state_outputs.size());
+
+        // Breadth-first: failure links, complete DFA transitions, outputs inherited through failure links.
+        std::vector<u32> dfa(usize(state_count) * C);
+        std::vector<u32> fail(state_count, 0);
+        std::vector<u32> order;
+        order.reserve(state_count);
+        order.push_back(0);
+        for(u32 c = 0; c < C; ++c) {
+            const u32 next = trie[c];
+            dfa[c] = (next == NONE) ? 0 : next;
+            if(next != NONE) {
+                order.push_back(next);
+            }
+        }
+        for(usize head = 1; head < order.size(); ++head) {
+            const u32 state = order[head];
+            const std::vector<u32> & inherited = state_outputs[fail[state]];
+            state_outputs[state].insert(state_outputs[state].end(), inherited.begin(), inherited.end());
+            for(u32 c = 0; c < C; ++c) {
+                const u32 next = trie[state * C + c];
+                if(next == NONE) {
+                    dfa[state * C + c] = dfa[fail[state] * C + c];
+                } else {
+                    fail[next] = dfa[fail[state] * C + c];
+                    dfa[state * C + c] = next;
+                    order.push_back(next);
+                }
+            }
+        }
+
+        // Renumber: states without outputs first, so the scan loop detects matches with one comparison.
+        std::vector<u32> renamed(state_count);
+        u32 next_id = 0;
+        for(const u32 state : order) {
+            if(state_outputs[state].empty()) {
+                renamed[state] = next_id++;
+            }
+        }
+        first_match_state = next_id * C;
+        output_offsets.push_back(0);
+        for(const u32 state : order) {
+            if(not state_outputs[state].empty()) {
+                renamed[state] = next_id++;
+                outputs.insert(outputs.end(), state_outputs[state].begin(), state_outputs[state].end());
+                output_offsets.push_back(u32(outputs.size()));
+            }
+        }
+
+        transitions.resize(dfa.size());
+        for(u32 state = 0; state < state_count; ++state) {
+            for(u32 c = 0; c < C; ++c) {
+                transitions[renamed[state] * C + c] = renamed[dfa[state * C + c]] * C;
+            }
+        }
+    }
+
+    void build_teddy() {
+        teddy_size = std::min<usize>(3, min_size);
+
+        std::vector<u32> order;
+        for(u32 i = 0; i < patterns.size(); ++i) {
+            if(patterns[i].size != 0) {
+                order.push_back(i);
+            }
+        }
+        // Patterns with similar prefixes share a bucket, so bucket fingerprints stay selective.
+        std::sort(order.begin(), order.end(), [&](u32 a, u32 b) {
+            return std::memcmp(pattern_bytes.data() + patterns[a].offset, pattern_bytes.data() + patterns[b].offset, teddy_size) < 0;
+        });
+        for(usize rank = 0; rank < order.size(); ++rank) {
+            const usize bucket = rank * 8 / order.size();
+            const u8 * const bytes = pattern_bytes.data() + patterns[order[rank]].offset;
+            buckets[bucket].push_back(order[rank]);
+            for(usize i = 0; i < teddy_size; ++i) {
+                low_masks[i][bytes[i] & 15] |= u8(1 << bucket);
+                high_masks[i][bytes[i] >> 4] |= u8(1 << bucket);
+            }
+        }
+    }
+
+    [[nodiscard, gnu::always_inline]] inline u8 teddy_fingerprint(const u8 * data) const {
+        u8 mask = 0xff;
+        for(usize i = 0; i < teddy_size; ++i) {
+            mask &= low_masks[i][data[i] & 15] & high_masks[i][data[i] >> 4];
+        }
+        return mask;
+    }
+
+    /// \brief Verify patterns of buckets in mask at position. false if stopped by on_match.
+    template<typename F>
+    inline bool verify(ConstBuffer buffer, usize position, u32 mask, F & on_match) const {
+        while(mask != 0) {
+            const u32 bucket = __builtin_ctz(mask);
+            mask &= mask - 1;
+            for(const u32 index : buckets[bucket]) {
+                const CompactBuffer pattern = patterns[index];
+                if(buffer.size - position >= pattern.size &&
+                   std::memcmp(buffer.data + position, pattern_bytes.data() + pattern.offset, pattern.size) == 0) {
+                    if(not on_match(PatternMatch{position, index})) {
+                        return false;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    template<typename F>
+    inline bool scan_teddy(ConstBuffer buffer, F & on_match) const;
+
+    /// \brief Report outputs of match state that ends at end. false if stopped by on_match.
+    template<typename F>
+    [[gnu::noinline]] bool report(u32 state, usize end, F & on_match) const {
+        const u32 index = (state - first_match_state) / class_count;
+        for(u32 k = output_offsets[index]; k < output_offsets[index + 1]; ++k) {
+            if(not on_match(PatternMatch{end - patterns[outputs[k]].size, outputs[k]})) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template<typename F>
+    inline bool scan_automaton(ConstBuffer buffer, usize base_offset, u32 & state, F & on_match) const {
+        const u32 * const table = transitions.data();
+        u32 s = state;
+        for(usize i = 0; i < buffer.size; ++i) {
+            s = table[s + byte_class[buffer.data[i]]];
+            if(s >= first_match_state) [[unlikely]] {
+                if(not report(s, base_offset + i + 1, on_match)) {
+                    state = s;
+                    return false;
+                }
+            }
+        }
+        state = s;
+        return true;
+    }
+
+    /**
+     * \brief Scan two halves of buffer at once: the DFA is bound by load latency, two independent chains hide it.
+     *
+     * The second chain starts max_size - 1 bytes before the middle, so its state is exact from the middle on
+     * (a state depends only on the last max_size bytes), and reports only matches that end after the middle.
+     */
+    template<typename F>
+    inline bool scan_automaton_2x(ConstBuffer buffer, F & on_match) const {
+        const u32 * const table = transitions.data();
+        const usize middle = buffer.size / 2;
+        u32 a = 0;
+        u32 b = 0;
+        for(usize i = middle - std::min(middle, max_size - 1); i < middle; ++i) {
+            b = table[b + byte_class[buffer.data[i]]];
+        }
+
+        const u8 * const second = buffer.data + middle;
+        for(usize i = 0; i < middle; ++i) {
+            a = table[a + byte_class[buffer.data[i]]];
+            b = table[b + byte_class[second[i]]];
+            if(std::max(a, b) >= first_match_state) [[unlikely]] {
+                if(a >= first_match_state && not report(a, i + 1, on_match)) {
+                    return false;
+                }
+                if(b >= first_match_state && not report(b, middle + i + 1, on_match)) {
+                    return false;
+                }
+            }
+        }
+        return scan_automaton(buffer.peek_buffer_back(buffer.size - 2 * middle), 2 * middle, b, on_match);
+    }
+};
+
+/**
+ * \brief Stream scans successive buffers as one byte stream: matches that span buffer boundaries are found.
+ *
+ * The state is a single automaton state (any PatternSet::engine()), no input bytes are buffered.
+ * PatternMatch::offset is counted from the start of the stream and may point into a previous buffer.
+ * \note Refers to the PatternSet, which must outlive the Stream.
+ */
+class PatternSet::Stream {
+public:
+    [[gnu::always_inline]] inline explicit Stream(const PatternSet & _set)
+        : set(&_set)
+    { }
+
+    /**
+     * \brief Report all matches that end in buffer to on_match(PatternMatch) -> bool (false stops the scan).
+     * \return false if stopped by on_match (the rest of buffer is skipped, the stream stays usable), true otherwise.
+     */
+    template<typename F>
+    inline bool scan(ConstBuffer buffer, F && on_match) {
+        const bool ret = set->scan_automaton(buffer, consumed, state, on_match);
+        consumed += buffer.size;
+        return ret;
+    }
+
+    /// \brief Bytes scanned so far.
+    [[nodiscard, gnu::always_inline]] inline u64 offset() const {
+        return consumed;
+    }
+
+    /// \brief Start a new stream (forget partial matches, offsets start from 0).
+    [[gnu::always_inline]] inline void reset() {
+        state = 0;
+        consumed = 0;
+    }
+
+private:
+    const PatternSet * set;
+    u32 state = 0;
+    u64 consumed = 0;
+};
+
+inline PatternSet::Stream PatternSet::stream() const {
+    return Stream(*this);
+}
+
+template<typename F>
+inline bool PatternSet::scan_teddy(ConstBuffer buffer, F & on_match) const {
+    auto on_candidate = [&](usize position, u32 mask) {
+        return verify(buffer, position, mask, on_match);
+    };
+
+    usize position = 0;
+#if defined(__x86_64__) || defined(__i386__)
+    const bool wide = (cpu_tier() >= CpuTier::avx2);
+    switch(teddy_size) {
+        case 1: position = wide ? kernels::avx2::teddy<1>(buffer.data, buffer.size, low_masks, high_masks, on_candidate)
+                                : kernels::sse42::teddy<1>(buffer.data, buffer.size, low_masks, high_masks, on_candidate); break;
+        case 2: position = wide ? kernels::avx2::teddy<2>(buffer.data, buffer.size, low_masks, high_masks, on_candidate)
+                                : kernels::sse42::teddy<2>(buffer.data, buffer.size, low_masks, high_masks, on_candidate); break;
+        default: position = wide ? kernels::avx2::teddy<3>(buffer.data, buffer.size, low_masks, high_masks, on_candidate)
+                                 : kernels::sse42::teddy<3>(buffer.data, buffer.size, low_masks, high_masks, on_candidate); break;
+    }
+    if(position == usize(-1)) {
+        return false;
+    }
+#endif
+
+    for(; position + teddy_size <= buffer.size; ++position) {
+        const u8 mask = teddy_fingerprint(buffer.data + position);
+        if(mask != 0 && not verify(buffer, position, mask, on_match)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
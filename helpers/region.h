@@ -0,0 +1,234 @@
+#pragma once
+
+#include "helpers/buffer.h"
+#include "helpers/types.h"
+
+#include <bit>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace sedfer {
+
+/// \brief Which memory actually backs a Region.
+enum class RegionBacking : u8 {
+    none,             ///< Allocation failed.
+    normal,           ///< Regular pages.
+    transparent_huge, ///< Regular mapping with madvise(MADV_HUGEPAGE), kernel may use 2 MiB pages.
+    huge_tlb,         ///< Explicit 2 MiB pages (MAP_HUGETLB).
+};
+
+/// \brief Options for Region. Every option falls back gracefully if not available.
+struct RegionOptions {
+    bool huge_pages = true; ///< Try MAP_HUGETLB, then transparent huge pages.
+    bool populate = true;   ///< Pre-fault all pages, no page faults on first touch.
+    bool lock = false;      ///< mlock() the region (requires RLIMIT_MEMLOCK).
+};
+
+/**
+ * \brief Region is an owning memory mapping for latency-critical buffers, carved into MutableBuffers.
+ *
+ * Pages are backed by 2 MiB huge pages when possible (fewer TLB misses) and pre-faulted (no first-touch faults).
+ * \code
+ * Region region(64 << 20, {.lock = true});
+ * if(region.backing() != RegionBacking::huge_tlb) {
+ *     log("receive buffers are not on huge pages");
+ * }
+ *
+ * MutableBuffer receive_buffer = region.allocate(1 << 20);
+ * if(receive_buffer.data == nullptr) return false;
+ * \endcode
+ * \note Region is a bump allocator: allocate() never frees, reset() frees everything at once.
+ */
+class Region {
+public:
+    static constexpr usize HUGE_PAGE_SIZE = usize(2) << 20;
+
+    Region() = default;
+
+    /// \brief Map at least _size bytes. Check backing() for the result.
+    explicit Region(usize _size, RegionOptions options = {}) {
+        map(_size, options);
+    }
+
+    Region(const Region &) = delete;
+    Region & operator=(const Region &) = delete;
+
+    Region(Region && other) noexcept {
+        swap(other);
+    }
+
+    Region & operator=(Region && other) noexcept {
+        Region(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    ~Region() {
+        if(storage != nullptr) {
+            munmap(storage, storage_size);
+        }
+    }
+
+    void swap(Region & other) noexcept {
+        std::swap(storage, other.storage);
+        std::swap(storage_size, other.storage_size);
+        std::swap(used_size, other.used_size);
+        std::swap(region_backing, other.region_backing);
+        std::swap(is_locked, other.is_locked);
+    }
+
+    /// \brief Backing actually obtained, RegionBacking::none if mapping failed.
+    [[nodiscard, gnu::always_inline]] inline RegionBacking backing() const {
+        return region_backing;
+    }
+
+    /// \brief true if the region is mlock()-ed.
+    [[nodiscard, gnu::always_inline]] inline bool locked() const {
+        return is_locked;
+    }
+
+    /// \brief Mapped size (rounded up to page size).
+    [[nodiscard, gnu::always_inline]] inline usize capacity() const {
+        return storage_size;
+    }
+
+    /// \brief Number of bytes handed out by allocate() (including alignment padding).
+    [[nodiscard, gnu::always_inline]] inline usize used() const {
+        return used_size;
+    }
+
+    /// \brief Whole region as one buffer.
+    [[nodiscard, gnu::always_inline]] inline MutableBuffer buffer() const {
+        return {storage, storage_size};
+    }
+
+    /**
+     * \brief Get next _size bytes of the region, aligned to align (power of 2).
+     * \return Valid buffer if OK, {nullptr, 0} if region has not enough space or align is not a power of 2 up to capacity().
+     */
+    [[nodiscard, gnu::always_inline]] inline MutableBuffer allocate(usize _size, usize align = 64) {
+        // Checked first: rounding up to a huge align would wrap around.
+        if(not std::has_single_bit(align) || align > storage_size) {
+            return {};
+        }
+        const usize offset = (used_size + align - 1) & ~(align - 1);
+        if(offset > storage_size || storage_size - offset < _size) {
+            return {};
+        }
+        used_size = offset + _size;
+        return {storage + offset, _size};
+    }
+
+    /// \brief Forget all allocations. Memory stays mapped (and pre-faulted).
+    void reset() {
+        used_size = 0;
+    }
+
+private:
+    u8 * storage = nullptr;
+    usize storage_size = 0;
+    usize used_size = 0;
+    RegionBacking region_backing = RegionBacking::none;
+    bool is_locked = false;
+
+    static bool transparent_huge_pages_enabled() {
+        FILE * const file = std::fopen("/sys/kernel/mm/transparent_hugepage/enabled", "r");
+        if(file == nullptr) {
+            return false;
+        }
+        char mode[128] = {};
+        const bool ok = std::fgets(mode, sizeof(mode), file) != nullptr;
+        std::fclose(file);
+        return ok && std::strstr(mode, "[never]") == nullptr;
+    }
+
+    static void prefault(u8 * ptr, usize _size) {
+#ifdef MADV_POPULATE_WRITE
+        if(madvise(ptr, _size, MADV_POPULATE_WRITE) == 0) {
+            return;
+        }
+#endif
+        const usize page = usize(sysconf(_SC_PAGESIZE));
+        for(usize offset = 0; offset < _size; offset += page) {
+            *static_cast<volatile u8 *>(ptr + offset) = 0;
+        }
+    }
+
+    void map(usize _size, RegionOptions options) {
+        if(_size == 0) {
+            return;
+        }
+
+        if(options.huge_pages) {
+            map_huge(_size, options.populate);
+        }
+
+        if(storage == nullptr) {
+            const usize page = usize(sysconf(_SC_PAGESIZE));
+            const usize rounded = (_size + page - 1) & ~(page - 1);
+            const int flags = MAP_PRIVATE | MAP_ANONYMOUS | (options.populate ? MAP_POPULATE : 0);
+            void * const ptr = mmap(nullptr, rounded, PROT_READ | PROT_WRITE, flags, -1, 0);
+            if(ptr == MAP_FAILED) {
+                return;
+            }
+            storage = static_cast<u8 *>(ptr);
+            storage_size = rounded;
+            region_backing = RegionBacking::normal;
+        }
+
+        if(options.lock) {
+            is_locked = (mlock(storage, storage_size) == 0);
+        }
+    }
+
+    void map_huge(usize _size, bool populate) {
+        const usize rounded = (_size + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+
+        const int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (populate ? MAP_POPULATE : 0);
+        void * ptr = mmap(nullptr, rounded, PROT_READ | PROT_WRITE, flags, -1, 0);
+        if(ptr != MAP_FAILED) {
+            storage = static_cast<u8 *>(ptr);
+            storage_size = rounded;
+            region_backing = RegionBacking::huge_tlb;
+            return;
+        }
+
+        if(not transparent_huge_pages_enabled()) {
+            return;
+        }
+
+        // Over-allocate to get 2 MiB alignment, otherwise the kernel can not use huge pages at the edges.
+        ptr = mmap(nullptr, rounded + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if(ptr == MAP_FAILED) {
+            return;
+        }
+
+        u8 * const raw = static_cast<u8 *>(ptr);
+        u8 * const aligned = reinterpret_cast<u8 *>((reinterpret_cast<uintptr_t>(raw) + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1));
+        if(aligned != raw) {
+            munmap(raw, aligned - raw);
+        }
+        if(aligned + rounded != raw + rounded + HUGE_PAGE_SIZE) {
+            munmap(aligned + rounded, raw + rounded + HUGE_PAGE_SIZE - (aligned + rounded));
+        }
+
+        storage = aligned;
+        storage_size = rounded;
+
+        if(madvise(storage, storage_size, MADV_HUGEPAGE) == 0) {
+            region_backing = RegionBacking::transparent_huge;
+        } else {
+            region_backing = RegionBacking::normal;
+        }
+
+        // Must run after madvise, otherwise pages are faulted in as regular pages.
+        if(populate) {
+            prefault(storage, storage_size);
+        }
+    }
+};
+
+}
@@ -0,0 +1,776 @@
+#pragma once
+
+#include "helpers/cpu.h"
+#include "helpers/types.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace sedfer {
+
+/**
+ * \brief ByteSet is a set of byte values for find_first_of / find_first_not_of.
+ *
+ * Besides the 256-bit bitmap it keeps two nibble tables, so SIMD kernels test 16/32 bytes for membership
+ * with three byte shuffles: row = table[low nibble] (one table per half of the byte range), bit = 1 << (high nibble & 7).
+ * \code
+ * static constexpr ByteSet SPACES(" \t\r\n");
+ * ConstBuffer rest = line.find_first_not_of(SPACES);
+ * \endcode
+ */
+struct ByteSet {
+    u64 bits[4] = {};
+    alignas(16) u8 low_rows[16] = {};  ///< low_rows[b & 15] has bit (b >> 4) set for every b < 0x80 in the set.
+    alignas(16) u8 high_rows[16] = {}; ///< high_rows[b & 15] has bit ((b >> 4) & 7) set for every b >= 0x80 in the set.
+
+    constexpr ByteSet() = default;
+
+    /// \brief Set of all chars in the string.
+    constexpr explicit ByteSet(std::string_view chars) {
+        for(const char c : chars) {
+            insert(u8(c));
+        }
+    }
+
+    constexpr void insert(u8 value) {
+        bits[value >> 6] |= u64(1) << (value & 63);
+        u8 * const rows = (value < 0x80) ? low_rows : high_rows;
+        rows[value & 15] |= u8(1 << ((value >> 4) & 7));
+    }
+
+    [[nodiscard, gnu::always_inline]] constexpr inline bool contains(u8 value) const {
+        return (bits[value >> 6] >> (value & 63)) & 1;
+    }
+
+    /// \brief Set of all bytes NOT in this set.
+    [[nodiscard]] constexpr ByteSet operator~() const {
+        ByteSet ret;
+        for(usize i = 0; i < 256; ++i) {
+            if(not contains(u8(i))) {
+                ret.insert(u8(i));
+            }
+        }
+        return ret;
+    }
+};
+
+/**
+ * \brief Forward and backward search for a byte, a byte pair, a ByteSet or a substring.
+ *
+ * Every kernel has scalar, SSE and AVX2 versions, the best one for cpu_tier() is selected on each call.
+ * Vector loops never read outside [data, data + size): tails are handled with one overlapping load
+ * (bytes already checked are known not to match) or by a narrower version.
+ */
+namespace kernels {
+
+namespace scalar {
+
+inline const u8 * find_byte(const u8 * data, usize size, u8 value) {
+    for(usize i = 0; i < size; ++i) {
+        if(data[i] == value) {
+            return data + i;
+        }
+    }
+    return nullptr;
+}
+
+inline const u8 * find_last_byte(const u8 * data, usize size, u8 value) {
+    for(usize i = size; i != 0; --i) {
+        if(data[i - 1] == value) {
+            return data + i - 1;
+        }
+    }
+    return nullptr;
+}
+
+template<bool in_set>
+inline const u8 * find_in_set(const u8 * data, usize size, const ByteSet & set) {
+    for(usize i = 0; i < size; ++i) {
+        if(set.contains(data[i]) == in_set) {
+            return data + i;
+        }
+    }
+    return nullptr;
+}
+
+inline const u8 * find_pair(const u8 * data, usize size, u8 first, u8 last, usize distance) {
+    for(usize i = 0; i + distance < size; ++i) {
+        if(data[i] == first && data[i + distance] == last) {
+            return data + i;
+        }
+    }
+    return nullptr;
+}
+
+inline const u8 * find_last_pair(const u8 * data, usize size, u8 first, u8 last, usize distance) {
+    for(usize i = size; i > distance; --i) {
+        if(data[i - 1 - distance] == first && data[i - 1] == last) {
+            return data + i - 1 - distance;
+        }
+    }
+    return nullptr;
+}
+
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+namespace sse2 {
+
+[[gnu::target("sse2")]] inline const u8 * find_byte(const u8 * data, usize size, u8 value) {
+    if(size < 16) {
+        return scalar::find_byte(data, size, value);
+    }
+
+    const __m128i needle = _mm_set1_epi8(char(value));
+    const u8 * p = data;
+    const u8 * const end = data + size;
+
+    for(; end - p >= 64; p += 64) {
+        const __m128i a = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)), needle);
+        const __m128i b = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 16)), needle);
+        const __m128i c = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 32)), needle);
+        const __m128i d = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 48)), needle);
+        if(_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d))) != 0) {
+            break;
+        }
+    }
+
+    for(; end - p >= 16; p += 16) {
+        const u32 mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)), needle));
+        if(mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+    }
+
+    if(p != end) {
+        p = end - 16;
+        const u32 mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)), needle));
+        if(mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+    }
+    return nullptr;
+}
+
+[[gnu::target("sse2")]] inline const u8 * find_last_byte(const u8 * data, usize size, u8 value) {
+    if(size < 16) {
+        return scalar::find_last_byte(data, size, value);
+    }
+
+    const __m128i needle = _mm_set1_epi8(char(value));
+    const u8 * p = data + size;
+
+    for(; p - data >= 64; p -= 64) {
+        const __m128i a = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p - 64)), needle);
+        const __m128i b = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p - 48)), needle);
+        const __m128i c = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p - 32)), needle);
+        const __m128i d = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p - 16)), needle);
+        if(_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d))) != 0) {
+            break;
+        }
+    }
+
+    for(; p - data >= 16; p -= 16) {
+        const u32 mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p - 16)), needle));
+        if(mask != 0) {
+            return p - 16 + (31 - __builtin_clz(mask));
+        }
+    }
+
+    if(p != data) {
+        const u32 mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data)), needle));
+        if(mask != 0) {
+            return data + (31 - __builtin_clz(mask));
+        }
+    }
+    return nullptr;
+}
+
+[[gnu::target("sse2")]] inline const u8 * find_pair(const u8 * data, usize size, u8 first, u8 last, usize distance) {
+    if(size < distance + 16) {
+        return scalar::find_pair(data, size, first, last, distance);
+    }
+
+    const __m128i first_needle = _mm_set1_epi8(char(first));
+    const __m128i last_needle = _mm_set1_epi8(char(last));
+    const usize count = size - distance;
+
+    usize i = 0;
+    for(; i + 16 <= count; i += 16) {
+        const __m128i a = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i)), first_needle);
+        const __m128i b = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i + distance)), last_needle);
+        const u32 mask = _mm_movemask_epi8(_mm_and_si128(a, b));
+        if(mask != 0) {
+            return data + i + __builtin_ctz(mask);
+        }
+    }
+
+    if(i != count) {
+        i = count - 16;
+        const __m128i a = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i)), first_needle);
+        const __m128i b = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i + distance)), last_needle);
+        const u32 mask = _mm_movemask_epi8(_mm_and_si128(a, b));
+        if(mask != 0) {
+            return data + i + __builtin_ctz(mask);
+        }
+    }
+    return nullptr;
+}
+
+[[gnu::target("sse2")]] inline const u8 * find_last_pair(const u8 * data, usize size, u8 first, u8 last, usize distance) {
+    if(size < distance + 16) {
+        return scalar::find_last_pair(data, size, first, last, distance);
+    }
+
+    const __m128i first_needle = _mm_set1_epi8(char(first));
+    const __m128i last_needle = _mm_set1_epi8(char(last));
+
+    usize i = size - distance;
+    for(; i >= 16; i -= 16) {
+        const __m128i a = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i - 16)), first_needle);
+        const __m128i b = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i - 16 + distance)), last_needle);
+        const u32 mask = _mm_movemask_epi8(_mm_and_si128(a, b));
+        if(mask != 0) {
+            return data + i - 16 + (31 - __builtin_clz(mask));
+        }
+    }
+
+    if(i != 0) {
+        const __m128i a = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data)), first_needle);
+        const __m128i b = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + distance)), last_needle);
+        const u32 mask = _mm_movemask_epi8(_mm_and_si128(a, b));
+        if(mask != 0) {
+            return data + (31 - __builtin_clz(mask));
+        }
+    }
+    return nullptr;
+}
+
+}
+
+namespace sse42 {
+
+/// \brief 0xFF in every byte of chunk that is in set.
+[[gnu::target("ssse3")]] inline __m128i match_set(__m128i chunk, __m128i low_rows, __m128i high_rows, __m128i bit_table) {
+    const __m128i rows = _mm_or_si128(_mm_shuffle_epi8(low_rows, chunk),
+                                      _mm_shuffle_epi8(high_rows, _mm_xor_si128(chunk, _mm_set1_epi8(char(0x80)))));
+    const __m128i high = _mm_and_si128(_mm_srli_epi16(chunk, 4), _mm_set1_epi8(0x0f));
+    const __m128i bit = _mm_shuffle_epi8(bit_table, high);
+    return _mm_cmpeq_epi8(_mm_and_si128(rows, bit), bit);
+}
+
+template<bool in_set>
+[[gnu::target("ssse3")]] inline const u8 * find_in_set(const u8 * data, usize size, const ByteSet & set) {
+    if(size < 16) {
+        return scalar::find_in_set<in_set>(data, size, set);
+    }
+
+    const __m128i low_rows = _mm_load_si128(reinterpret_cast<const __m128i *>(set.low_rows));
+    const __m128i high_rows = _mm_load_si128(reinterpret_cast<const __m128i *>(set.high_rows));
+    const __m128i bit_table = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+    const u32 flip = in_set ? 0 : 0xffff;
+
+    const u8 * p = data;
+    const u8 * const end = data + size;
+    for(; end - p >= 16; p += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        const u32 mask = u32(_mm_movemask_epi8(match_set(chunk, low_rows, high_rows, bit_table))) ^ flip;
+        if(mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+    }
+
+    if(p != end) {
+        p = end - 16;
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        const u32 mask = u32(_mm_movemask_epi8(match_set(chunk, low_rows, high_rows, bit_table))) ^ flip;
+        if(mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+    }
+    return nullptr;
+}
+
+}
+
+namespace avx2 {
+
+[[gnu::target("avx2,bmi")]] inline const u8 * find_byte(const u8 * data, usize size, u8 value) {
+    if(size < 32) {
+        return sse2::find_byte(data, size, value);
+    }
+
+    const __m256i needle = _mm256_set1_epi8(char(value));
+    const u8 * p = data;
+    const u8 * const end = data + size;
+
+    // Check first 32 bytes unaligned, then continue from the next 32-byte boundary (aligned loads in the hot loop).
+    const u32 first = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)), needle));
+    if(first != 0) {
+        return p + _tzcnt_u32(first);
+    }
+    p = reinterpret_cast<const u8 *>((reinterpret_cast<uintptr_t>(p) + 32) & ~uintptr_t(31));
+
+    for(; end - p >= 128; p += 128) {
+        const __m256i a = _mm256_cmpeq_epi8(_mm256_load_si256(reinterpret_cast<const __m256i *>(p)), needle);
+        const __m256i b = _mm256_cmpeq_epi8(_mm256_load_si256(reinterpret_cast<const __m256i *>(p + 32)), needle);
+        const __m256i c = _mm256_cmpeq_epi8(_mm256_load_si256(reinterpret_cast<const __m256i *>(p + 64)), needle);
+        const __m256i d = _mm256_cmpeq_epi8(_mm256_load_si256(reinterpret_cast<const __m256i *>(p + 96)), needle);
+        if(_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(a, b), _mm256_or_si256(c, d))) != 0) {
+            break;
+        }
+    }
+
+    for(; end - p >= 32; p += 32) {
+        const u32 mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)), needle));
+        if(mask != 0) {
+            return p + _tzcnt_u32(mask);
+        }
+    }
+
+    if(p != end) {
+        p = end - 32;
+        const u32 mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)), needle));
+        if(mask != 0) {
+            return p + _tzcnt_u32(mask);
+        }
+    }
+    return nullptr;
+}
+
+[[gnu::target("avx2")]] inline const u8 * find_last_byte(const u8 * data, usize size, u8 value) {
+    if(size < 32) {
+        return sse2::find_last_byte(data, size, value);
+    }
+
+    const __m256i needle = _mm256_set1_epi8(char(value));
+    const u8 * p = data + size;
+
+    // Check last 32 bytes unaligned, then continue from the previous 32-byte boundary (aligned loads in the hot loop).
+    const u32 last = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p - 32)), needle));
+    if(last != 0) {
+        return p - 32 + (31 - __builtin_clz(last));
+    }
+    p = reinterpret_cast<const u8 *>((reinterpret_cast<uintptr_t>(p) - 1) & ~uintptr_t(31));
+
+    for(; p - data >= 128; p -= 128) {
+        const __m256i a = _mm256_cmpeq_epi8(_mm256_load_si256(reinterpret_cast<const __m256i *>(p - 128)), needle);
+        const __m256i b = _mm256_cmpeq_epi8(_mm256_load_si256(reinterpret_cast<const __m256i *>(p - 96)), needle);
+        const __m256i c = _mm256_cmpeq_epi8(_mm256_load_si256(reinterpret_cast<const __m256i *>(p - 64)), needle);
+        const __m256i d = _mm256_cmpeq_epi8(_mm256_load_si256(reinterpret_cast<const __m256i *>(p - 32)), needle);
+        if(_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(a, b), _mm256_or_si256(c, d))) != 0) {
+            break;
+        }
+    }
+
+    for(; p - data >= 32; p -= 32) {
+        const u32 mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p - 32)), needle));
+        if(mask != 0) {
+            return p - 32 + (31 - __builtin_clz(mask));
+        }
+    }
+
+    if(p != data) {
+        const u32 mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data)), needle));
+        if(mask != 0) {
+            return data + (31 - __builtin_clz(mask));
+        }
+    }
+    return nullptr;
+}
+
+/// \brief 0xFF in every byte of chunk that is in set (see sse42::match_set).
+[[gnu::target("avx2")]] inline __m256i match_set(__m256i chunk, __m256i low_rows, __m256i high_rows, __m256i bit_table) {
+    const __m256i rows = _mm256_or_si256(_mm256_shuffle_epi8(low_rows, chunk),
+                                         _mm256_shuffle_epi8(high_rows, _mm256_xor_si256(chunk, _mm256_set1_epi8(char(0x80)))));
+    const __m256i high = _mm256_and_si256(_mm256_srli_epi16(chunk, 4), _mm256_set1_epi8(0x0f));
+    const __m256i bit = _mm256_shuffle_epi8(bit_table, high);
+    return _mm256_cmpeq_epi8(_mm256_and_si256(rows, bit), bit);
+}
+
+template<bool in_set>
+[[gnu::target("avx2,bmi")]] inline const u8 * find_in_set(const u8 * data, usize size, const ByteSet & set) {
+    if(size < 32) {
+        return sse42::find_in_set<in_set>(data, size, set);
+    }
+
+    const __m256i low_rows = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i *>(set.low_rows)));
+    const __m256i high_rows = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i *>(set.high_rows)));
+    const __m256i bit_table = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128,
+                                               1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+    const u32 flip = in_set ? 0 : 0xffffffff;
+
+    const u8 * p = data;
+    const u8 * const end = data + size;
+    for(; end - p >= 64; p += 64) {
+        const __m256i a = match_set(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)), low_rows, high_rows, bit_table);
+        const __m256i b = match_set(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + 32)), low_rows, high_rows, bit_table);
+        const u64 mask = (u64(u32(_mm256_movemask_epi8(a)) ^ flip)) | (u64(u32(_mm256_movemask_epi8(b)) ^ flip) << 32);
+        if(mask != 0) {
+            return p + _tzcnt_u64(mask);
+        }
+    }
+
+    for(; end - p >= 32; p += 32) {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+        const u32 mask = u32(_mm256_movemask_epi8(match_set(chunk, low_rows, high_rows, bit_table))) ^ flip;
+        if(mask != 0) {
+            return p + _tzcnt_u32(mask);
+        }
+    }
+
+    if(p != end) {
+        p = end - 32;
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+        const u32 mask = u32(_mm256_movemask_epi8(match_set(chunk, low_rows, high_rows, bit_table))) ^ flip;
+        if(mask != 0) {
+            return p + _tzcnt_u32(mask);
+        }
+    }
+    return nullptr;
+}
+
+[[gnu::target("avx2,bmi")]] inline const u8 * find_pair(const u8 * data, usize size, u8 first, u8 last, usize distance) {
+    if(size < distance + 32) {
+        return sse2::find_pair(data, size, first, last, distance);
+    }
+
+    const __m256i first_needle = _mm256_set1_epi8(char(first));
+    const __m256i last_needle = _mm256_set1_epi8(char(last));
+    const usize count = size - distance;
+
+    usize i = 0;
+    for(; i + 64 <= count; i += 64) {
+        const __m256i a0 = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i)), first_needle);
+        const __m256i b0 = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i + distance)), last_needle);
+        const __m256i a1 = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i + 32)), first_needle);
+        const __m256i b1 = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i + 32 + distance)), last_needle);
+        const u64 mask = u64(u32(_mm256_movemask_epi8(_mm256_and_si256(a0, b0)))) |
+                         (u64(u32(_mm256_movemask_epi8(_mm256_and_si256(a1, b1)))) << 32);
+        if(mask != 0) {
+            return data + i + _tzcnt_u64(mask);
+        }
+    }
+
+    for(; i + 32 <= count; i += 32) {
+        const __m256i a = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i)), first_needle);
+        const __m256i b = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i + distance)), last_needle);
+        const u32 mask = _mm256_movemask_epi8(_mm256_and_si256(a, b));
+        if(mask != 0) {
+            return data + i + _tzcnt_u32(mask);
+        }
+    }
+
+    if(i != count) {
+        i = count - 32;
+        const __m256i a = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i)), first_needle);
+        const __m256i b = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i + distance)), last_needle);
+        const u32 mask = _mm256_movemask_epi8(_mm256_and_si256(a, b));
+        if(mask != 0) {
+            return data + i + _tzcnt_u32(mask);
+        }
+    }
+    return nullptr;
+}
+
+[[gnu::target("avx2")]] inline const u8 * find_last_pair(const u8 * data, usize size, u8 first, u8 last, usize distance) {
+    if(size < distance + 32) {
+        return sse2::find_last_pair(data, size, first, last, distance);
+    }
+
+    const __m256i first_needle = _mm256_set1_epi8(char(first));
+    const __m256i last_needle = _mm256_set1_epi8(char(last));
+
+    usize i = size - distance;
+    for(; i >= 32; i -= 32) {
+        const __m256i a = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i - 32)), first_needle);
+        const __m256i b = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i - 32 + distance)), last_needle);
+        const u32 mask = _mm256_movemask_epi8(_mm256_and_si256(a, b));
+        if(mask != 0) {
+            return data + i - 32 + (31 - __builtin_clz(mask));
+        }
+    }
+
+    if(i != 0) {
+        const __m256i a = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data)), first_needle);
+        const __m256i b = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + distance)), last_needle);
+        const u32 mask = _mm256_movemask_epi8(_mm256_and_si256(a, b));
+        if(mask != 0) {
+            return data + (31 - __builtin_clz(mask));
+        }
+    }
+    return nullptr;
+}
+
+}
+
+#endif
+
+/// \brief First byte == value in [data, data + size), nullptr if not found.
+inline const u8 * find_byte(const u8 * data, usize size, u8 value) {
+#if defined(__x86_64__) || defined(__i386__)
+    switch(cpu_tier()) {
+        case CpuTier::avx512:
+        case CpuTier::avx2: return avx2::find_byte(data, size, value);
+        case CpuTier::sse42:
+        case CpuTier::sse2: return sse2::find_byte(data, size, value);
+        case CpuTier::scalar: break;
+    }
+#endif
+    return scalar::find_byte(data, size, value);
+}
+
+/// \brief Last byte == value in [data, data + size), nullptr if not found.
+inline const u8 * find_last_byte(const u8 * data, usize size, u8 value) {
+#if defined(__x86_64__) || defined(__i386__)
+    switch(cpu_tier()) {
+        case CpuTier::avx512:
+        case CpuTier::avx2: return avx2::find_last_byte(data, size, value);
+        case CpuTier::sse42:
+        case CpuTier::sse2: return sse2::find_last_byte(data, size, value);
+        case CpuTier::scalar: break;
+    }
+#endif
+    return scalar::find_last_byte(data, size, value);
+}
+
+/// \brief First byte in set (in_set = true) or not in set (in_set = false), nullptr if not found.
+template<bool in_set>
+inline const u8 * find_in_set(const u8 * data, usize size, const ByteSet & set) {
+#if defined(__x86_64__) || defined(__i386__)
+    switch(cpu_tier()) {
+        case CpuTier::avx512:
+        case CpuTier::avx2: return avx2::find_in_set<in_set>(data, size, set);
+        case CpuTier::sse42: return sse42::find_in_set<in_set>(data, size, set);
+        case CpuTier::sse2:
+        case CpuTier::scalar: break;
+    }
+#endif
+    return scalar::find_in_set<in_set>(data, size, set);
+}
+
+/// \brief First p in [data, data + size - distance) with p[0] == first and p[distance] == last, nullptr if not found.
+inline const u8 * find_pair(const u8 * data, usize size, u8 first, u8 last, usize distance) {
+#if defined(__x86_64__) || defined(__i386__)
+    switch(cpu_tier()) {
+        case CpuTier::avx512:
+        case CpuTier::avx2: return avx2::find_pair(data, size, first, last, distance);
+        case CpuTier::sse42:
+        case CpuTier::sse2: return sse2::find_pair(data, size, first, last, distance);
+        case CpuTier::scalar: break;
+    }
+#endif
+    return scalar::find_pair(data, size, first, last, distance);
+}
+
+/// \brief Last p in [data, data + size - distance) with p[0] == first and p[distance] == last, nullptr if not found.
+inline const u8 * find_last_pair(const u8 * data, usize size, u8 first, u8 last, usize distance) {
+#if defined(__x86_64__) || defined(__i386__)
+    switch(cpu_tier()) {
+        case CpuTier::avx512:
+        case CpuTier::avx2: return avx2::find_last_pair(data, size, first, last, distance);
+        case CpuTier::sse42:
+        case CpuTier::sse2: return sse2::find_last_pair(data, size, first, last, distance);
+        case CpuTier::scalar: break;
+    }
+#endif
+    return scalar::find_last_pair(data, size, first, last, distance);
+}
+
+/// \brief Needles up to this size are searched with the first/last byte prefilter + memcmp, longer ones with TwoWay.
+static constexpr usize SHORT_NEEDLE_SIZE = 32;
+
+/**
+ * \brief Two-Way string matching (Crochemore-Perrin): linear time, constant space.
+ *
+ * factorize() splits the needle at its critical position once, search() can be run on any number of haystacks.
+ * reverse = true searches for the last occurrence (the algorithm runs on the reversed needle and haystack).
+ * While no partial match is remembered, candidate positions are skipped with the SIMD first/last byte prefilter.
+ */
+template<bool reverse>
+struct TwoWay {
+    isize critical = -1;
+    usize period = 1;
+    bool periodic = false;
+
+    /// \note size must be > 0.
+    static TwoWay factorize(const u8 * needle, usize size) {
+        usize less_period;
+        usize greater_period;
+        const isize less = maximal_suffix<false>(needle, size, less_period);
+        const isize greater = maximal_suffix<true>(needle, size, greater_period);
+
+        TwoWay ret;
+        ret.critical = (less > greater) ? less : greater;
+        ret.period = (less > greater) ? less_period : greater_period;
+
+        ret.periodic = (ret.period + usize(ret.critical + 1) <= size);
+        for(isize i = 0; ret.periodic && i <= ret.critical; ++i) {
+            ret.periodic = (at(needle, size, usize(i)) == at(needle, size, usize(i) + ret.period));
+        }
+        if(not ret.periodic) {
+            ret.period = std::max(usize(ret.critical + 1), size - usize(ret.critical + 1)) + 1;
+        }
+        return ret;
+    }
+
+    /// \brief First (reverse: last) occurrence of needle in [data, data + size), nullptr if not found.
+    const u8 * search(const u8 * data, usize size, const u8 * needle, usize needle_size) const {
+        if(needle_size > size) {
+            return nullptr;
+        }
+
+        const isize n = isize(size);
+        const isize m = isize(needle_size);
+        const u8 first = needle[0];
+        const u8 last = needle[needle_size - 1];
+
+        isize j = 0;
+        isize memory = -1;
+        while(j <= n - m) {
+            if(memory < 0) {
+                // Skip positions that can not match (first/last bytes differ), TwoWay state is empty here.
+                if constexpr(reverse) {
+                    const u8 * const found = find_last_pair(data, usize(n - j), first, last, needle_size - 1);
+                    if(found == nullptr) {
+                        return nullptr;
+                    }
+                    j = n - m - (found - data);
+                } else {
+                    const u8 * const found = find_pair(data + j, usize(n - j), first, last, needle_size - 1);
+                    if(found == nullptr) {
+                        return nullptr;
+                    }
+                    j = found - data;
+                }
+            }
+
+            isize i = std::max(critical, memory) + 1;
+            while(i < m && at(needle, needle_size, usize(i)) == at(data, size, usize(i + j))) {
+                ++i;
+            }
+            if(i < m) {
+                j += i - critical;
+                memory = -1;
+                continue;
+            }
+
+            i = critical;
+            while(i > memory && at(needle, needle_size, usize(i)) == at(data, size, usize(i + j))) {
+                --i;
+            }
+            if(i <= memory) {
+                return reverse ? data + (n - m - j) : data + j;
+            }
+            j += isize(period);
+            memory = periodic ? m - isize(period) - 1 : -1;
+        }
+        return nullptr;
+    }
+
+private:
+    [[gnu::always_inline]] static inline u8 at(const u8 * data, usize size, usize i) {
+        return reverse ? data[size - 1 - i] : data[i];
+    }
+
+    template<bool greater>
+    static isize maximal_suffix(const u8 * needle, usize size, usize & out_period) {
+        isize suffix = -1;
+        usize j = 0;
+        usize k = 1;
+        usize p = 1;
+        while(j + k < size) {
+            const u8 a = at(needle, size, j + k);
+            const u8 b = at(needle, size, usize(suffix + isize(k)));
+            if(greater ? (a > b) : (a < b)) {
+                j += k;
+                k = 1;
+                p = j - usize(suffix);
+            } else if(a == b) {
+                if(k != p) {
+                    k += 1;
+                } else {
+                    j += p;
+                    k = 1;
+                }
+            } else {
+                suffix = isize(j);
+                j = usize(suffix) + 1;
+                k = 1;
+                p = 1;
+            }
+        }
+        out_period = p;
+        return suffix;
+    }
+};
+
+/// \brief First occurrence of short needle (2 <= needle_size <= SHORT_NEEDLE_SIZE): first/last byte prefilter + memcmp.
+inline const u8 * find_short_substring(const u8 * data, usize size, const u8 * needle, usize needle_size) {
+    const u8 * const end = data + size;
+    const u8 * p = data;
+    while((p = find_pair(p, usize(end - p), needle[0], needle[needle_size - 1], needle_size - 1)) != nullptr) {
+        if(std::memcmp(p + 1, needle + 1, needle_size - 2) == 0) {
+            return p;
+        }
+        p += 1;
+    }
+    return nullptr;
+}
+
+/// \brief Last occurrence of short needle (2 <= needle_size <= SHORT_NEEDLE_SIZE): first/last byte prefilter + memcmp.
+inline const u8 * find_last_short_substring(const u8 * data, usize size, const u8 * needle, usize needle_size) {
+    usize limit = size;
+    const u8 * p;
+    while((p = find_last_pair(data, limit, needle[0], needle[needle_size - 1], needle_size - 1)) != nullptr) {
+        if(std::memcmp(p + 1, needle + 1, needle_size - 2) == 0) {
+            return p;
+        }
+        limit = usize(p - data) + needle_size - 1;
+    }
+    return nullptr;
+}
+
+/// \brief First occurrence of needle in [data, data + size), data if needle is empty, nullptr if not found.
+inline const u8 * find_substring(const u8 * data, usize size, const u8 * needle, usize needle_size) {
+    if(needle_size == 0) {
+        return data;
+    }
+    if(needle_size > size) {
+        return nullptr;
+    }
+    if(needle_size == 1) {
+        return find_byte(data, size, needle[0]);
+    }
+    if(needle_size <= SHORT_NEEDLE_SIZE) {
+        return find_short_substring(data, size, needle, needle_size);
+    }
+    return TwoWay<false>::factorize(needle, needle_size).search(data, size, needle, needle_size);
+}
+
+/// \brief Last occurrence of needle in [data, data + size), data + size if needle is empty, nullptr if not found.
+inline const u8 * find_last_substring(const u8 * data, usize size, const u8 * needle, usize needle_size) {
+    if(needle_size == 0) {
+        return data + size;
+    }
+    if(needle_size > size) {
+        return nullptr;
+    }
+    if(needle_size == 1) {
+        return find_last_byte(data, size, needle[0]);
+    }
+    if(needle_size <= SHORT_NEEDLE_SIZE) {
+        return find_last_short_substring(data, size, needle, needle_size);
+    }
+    return TwoWay<true>::factorize(needle, needle_size).search(data, size, needle, needle_size);
+}
+
+}
+
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "helpers/buffer.h"
+#include "helpers/types.h"
+
+#include <memory>
+
+namespace sedfer {
+
+/**
+ * \brief SharedBuffer is a reference-counted owner of immutable bytes.
+ *
+ * Owning buffers (DynamicBuffer etc.) hand their storage over with release().
+ * The storage is freed by the deleter supplied by the owner when the last copy is destroyed.
+ * \code
+ * SharedBuffer make_message() {
+ *     DynamicBuffer buffer;
+ *     ASSERT(buffer.push(VERSION_1));
+ *     // ...
+ *     return buffer.release();
+ * }
+ *
+ * void send(ConstBuffer);
+ *
+ * int main() {
+ *     SharedBuffer message = make_message();
+ *     send(message); // implicitly cast to ConstBuffer
+ * }
+ * \endcode
+ */
+struct SharedBuffer {
+    std::shared_ptr<const u8> owner;
+    usize size = 0;
+
+    SharedBuffer() = default;
+
+    SharedBuffer(std::shared_ptr<const u8> _owner, usize _size)
+        : owner(std::move(_owner)),
+          size(_size)
+    { }
+
+    [[nodiscard, gnu::always_inline]] inline const u8 * data() const {
+        return owner.get();
+    }
+
+    // NOLINTNEXTLINE(google-explicit-constructor)
+    [[gnu::always_inline]] inline operator ConstBuffer() const {
+        return {owner.get(), size};
+    }
+};
+
+}
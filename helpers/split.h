@@ -0,0 +1,357 @@
+#pragma once
+
+#include "helpers/buffer.h"
+#include "helpers/cpu.h"
+#include "helpers/search.h"
+#include "helpers/types.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace sedfer {
+
+/**
+ * \brief Delimiter bitmask kernels used by split ranges: bit i of the result is set if block[i] is a delimiter.
+ *
+ * Blocks are at most 64 bytes, a partial block is read with overlapping loads inside [block, block + size).
+ */
+namespace kernels {
+
+namespace scalar {
+
+inline u64 delimiter_mask(const u8 * block, usize size, u8 value) {
+    u64 ret = 0;
+    for(usize i = 0; i < size; ++i) {
+        ret |= u64(block[i] == value) << i;
+    }
+    return ret;
+}
+
+inline u64 delimiter_set_mask(const u8 * block, usize size, const ByteSet & set) {
+    u64 ret = 0;
+    for(usize i = 0; i < size; ++i) {
+        ret |= u64(set.contains(block[i])) << i;
+    }
+    return ret;
+}
+
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+namespace sse2 {
+
+[[gnu::target("sse2")]] inline u64 delimiter_mask(const u8 * block, usize size, u8 value) {
+    if(size < 16) {
+        return scalar::delimiter_mask(block, size, value);
+    }
+    const __m128i needle = _mm_set1_epi8(char(value));
+    u64 ret = 0;
+    for(usize i = 0; i < size; i += 16) {
+        const usize offset = std::min(i, size - 16);
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + offset));
+        ret |= u64(u32(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle)))) << offset;
+    }
+    return ret;
+}
+
+}
+
+namespace sse42 {
+
+[[gnu::target("ssse3")]] inline u64 delimiter_set_mask(const u8 * block, usize size, const ByteSet & set) {
+    if(size < 16) {
+        return scalar::delimiter_set_mask(block, size, set);
+    }
+    const __m128i low_rows = _mm_load_si128(reinterpret_cast<const __m128i *>(set.low_rows));
+    const __m128i high_rows = _mm_load_si128(reinterpret_cast<const __m128i *>(set.high_rows));
+    const __m128i bit_table = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+    u64 ret = 0;
+    for(usize i = 0; i < size; i += 16) {
+        const usize offset = std::min(i, size - 16);
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + offset));
+        ret |= u64(u32(_mm_movemask_epi8(match_set(chunk, low_rows, high_rows, bit_table)))) << offset;
+    }
+    return ret;
+}
+
+}
+
+namespace avx2 {
+
+[[gnu::target("avx2")]] inline u64 delimiter_mask(const u8 * block, usize size, u8 value) {
+    if(size < 32) {
+        return sse2::delimiter_mask(block, size, value);
+    }
+    const __m256i needle = _mm256_set1_epi8(char(value));
+    const __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block));
+    const __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + size - 32));
+    return u64(u32(_mm256_movemask_epi8(_mm256_cmpeq_epi8(low, needle)))) |
+           (u64(u32(_mm256_movemask_epi8(_mm256_cmpeq_epi8(high, needle)))) << (size - 32));
+}
+
+[[gnu::target("avx2")]] inline u64 delimiter_set_mask(const u8 * block, usize size, const ByteSet & set) {
+    if(size < 32) {
+        return sse42::delimiter_set_mask(block, size, set);
+    }
+    const __m256i low_rows = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i *>(set.low_rows)));
+    const __m256i high_rows = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i *>(set.high_rows)));
+    const __m256i bit_table = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128,
+                                               1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+    const __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block));
+    const __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + size - 32));
+    return u64(u32(_mm256_movemask_epi8(match_set(low, low_rows, high_rows, bit_table)))) |
+           (u64(u32(_mm256_movemask_epi8(match_set(high, low_rows, high_rows, bit_table)))) << (size - 32));
+}
+
+}
+
+#endif
+
+/// \brief Bit i is set if block[i] == value (size <= 64).
+inline u64 delimiter_mask(const u8 * block, usize size, u8 value) {
+#if defined(__x86_64__) || defined(__i386__)
+    switch(cpu_tier()) {
+        case CpuTier::avx512:
+        case CpuTier::avx2: return avx2::delimiter_mask(block, size, value);
+        case CpuTier::sse42:
+        case CpuTier::sse2: return sse2::delimiter_mask(block, size, value);
+        case CpuTier::scalar: break;
+    }
+#endif
+    return scalar::delimiter_mask(block, size, value);
+}
+
+/// \brief Bit i is set if block[i] is in set (size <= 64).
+inline u64 delimiter_set_mask(const u8 * block, usize size, const ByteSet & set) {
+#if defined(__x86_64__) || defined(__i386__)
+    switch(cpu_tier()) {
+        case CpuTier::avx512:
+        case CpuTier::avx2: return avx2::delimiter_set_mask(block, size, set);
+        case CpuTier::sse42: return sse42::delimiter_set_mask(block, size, set);
+        case CpuTier::sse2:
+        case CpuTier::scalar: break;
+    }
+#endif
+    return scalar::delimiter_set_mask(block, size, set);
+}
+
+}
+
+/// \brief Single byte delimiter of split() and lines().
+struct ByteDelimiter {
+    u8 value = 0;
+
+    [[nodiscard, gnu::always_inline]] inline u64 mask(const u8 * block, usize size) const {
+        return kernels::delimiter_mask(block, size, value);
+    }
+
+    [[nodiscard, gnu::always_inline]] inline const u8 * find(const u8 * data, usize size) const {
+        return kernels::find_byte(data, size, value);
+    }
+};
+
+/// \brief Delimiter set of split_any().
+struct ByteSetDelimiter {
+    ByteSet set;
+
+    [[nodiscard, gnu::always_inline]] inline u64 mask(const u8 * block, usize size) const {
+        return kernels::delimiter_set_mask(block, size, set);
+    }
+
+    [[nodiscard, gnu::always_inline]] inline const u8 * find(const u8 * data, usize size) const {
+        return kernels::find_in_set<true>(data, size, set);
+    }
+};
+
+/**
+ * \brief SplitRange is a lazy forward range of the pieces of a buffer between delimiters, see split(), split_any() and lines().
+ *
+ * The iterator keeps a bitmask of delimiters in the current 64-byte block: short pieces cost one bit scan each,
+ * the buffer is scanned once. After a block without delimiters the unrolled find kernels skip long pieces.
+ * Nothing is allocated, pieces point into the original buffer.
+ * \code
+ * for(ConstBuffer line : lines(log)) {
+ *     for(ConstBuffer field : split(line, ',') | std::views::take(3)) {
+ *         // ...
+ *     }
+ * }
+ * \endcode
+ * \note Pieces follow std::views::split: n delimiters give n + 1 pieces, an empty buffer gives none.
+ *       With trim_lines a '\r' before each '\n' is dropped (not at the end of buffer) and a final '\n' does not start an empty line.
+ */
+template<typename Delimiter, bool trim_lines = false>
+class SplitRange : public std::ranges::view_interface<SplitRange<Delimiter, trim_lines>> {
+public:
+    class Iterator {
+    public:
+        using value_type = ConstBuffer;
+        using difference_type = std::ptrdiff_t;
+        using iterator_concept = std::forward_iterator_tag;
+
+        [[gnu::always_inline]] inline Iterator() = default;
+
+        [[gnu::always_inline]] inline Iterator(ConstBuffer buffer, const Delimiter & _delimiter)
+            : delimiter(_delimiter)
+        {
+            if(buffer.size == 0) {
+                return;
+            }
+            next = buffer.data;
+            end = buffer.data + buffer.size;
+            block = buffer.data;
+            mask = delimiter.mask(block, std::min<usize>(buffer.size, 64));
+            advance();
+        }
+
+        [[nodiscard, gnu::always_inline]] inline const ConstBuffer & operator*() const {
+            return piece;
+        }
+
+        [[nodiscard, gnu::always_inline]] inline const ConstBuffer * operator->() const {
+            return &piece;
+        }
+
+        [[gnu::always_inline]] inline Iterator & operator++() {
+            advance();
+            return *this;
+        }
+
+        [[gnu::always_inline]] inline Iterator operator++(int) {
+            Iterator ret = *this;
+            advance();
+            return ret;
+        }
+
+        /// \brief Pieces never start at the same byte, past-the-end iterators have piece.data == nullptr.
+        [[nodiscard, gnu::always_inline]] inline bool operator==(const Iterator & other) const {
+            return piece.data == other.piece.data;
+        }
+
+        [[nodiscard, gnu::always_inline]] inline bool operator==(std::default_sentinel_t) const {
+            return piece.data == nullptr;
+        }
+
+    private:
+        ConstBuffer piece;
+        const u8 * next = nullptr; ///< Start of the piece after this one, nullptr if this is the last piece.
+        const u8 * end = nullptr;
+        const u8 * block = nullptr; ///< Start of the 64-byte block the mask describes.
+        u64 mask = 0;               ///< Delimiters in the block that are not consumed yet.
+        Delimiter delimiter;
+
+        /// \brief Load the mask of the next block with a delimiter (kept out of line, pieces rarely cross blocks).
+        /// \return true if OK, false if there are no more delimiters.
+        [[gnu::noinline]] bool refill() {
+            while(end - block > 64) {
+                block += 64;
+                mask = delimiter.mask(block, std::min<usize>(usize(end - block), 64));
+                if(mask != 0) {
+                    return true;
+                }
+                if(end - block > 64) {
+                    // Long piece: continue from the next delimiter.
+                    const u8 * const found = delimiter.find(block + 64, usize(end - block) - 64);
+                    if(found == nullptr) {
+                        break;
+                    }
+                    block = found;
+                    mask = delimiter.mask(block, std::min<usize>(usize(end - block), 64));
+                    return true;
+                }
+            }
+            block = end;
+            return false;
+        }
+
+        [[gnu::always_inline]] inline const u8 * find_delimiter() {
+            if(mask == 0 && not refill()) {
+                return nullptr;
+            }
+            const u8 * const ret = block + std::countr_zero(mask);
+            mask &= mask - 1;
+            return ret;
+        }
+
+        [[gnu::always_inline]] inline void advance() {
+            if(next == nullptr) {
+                piece = {};
+                return;
+            }
+            const u8 * const found = find_delimiter();
+            if(found != nullptr) {
+                piece = {next, usize(found - next)};
+                next = found + 1;
+                if constexpr(trim_lines) {
+                    // Only pieces ending at a '\n'. Branchless: an empty piece reads its own delimiter, never past the buffer.
+                    const usize not_empty = usize(piece.size != 0);
+                    piece.size -= not_empty & usize(piece.data[piece.size - not_empty] == '\r');
+                }
+            } else if(trim_lines && next == end) {
+                piece = {};
+            } else {
+                piece = {next, usize(end - next)};
+                next = nullptr;
+            }
+        }
+    };
+
+    [[gnu::always_inline]] inline SplitRange() = default;
+
+    [[gnu::always_inline]] inline SplitRange(ConstBuffer _buffer, const Delimiter & _delimiter)
+        : buffer(_buffer),
+          delimiter(_delimiter)
+    { }
+
+    [[nodiscard, gnu::always_inline]] inline Iterator begin() const {
+        return {buffer, delimiter};
+    }
+
+    [[nodiscard, gnu::always_inline]] inline std::default_sentinel_t end() const {
+        return std::default_sentinel;
+    }
+
+private:
+    ConstBuffer buffer;
+    Delimiter delimiter;
+};
+
+/**
+ * \brief Lazy range of pieces of buffer between delimiter bytes.
+ * \code
+ * for(ConstBuffer field : split(record, ',')) {
+ *     // "a,,b," gives "a", "", "b", ""
+ * }
+ * \endcode
+ */
+template<byte_value T>
+[[nodiscard, gnu::always_inline]] inline SplitRange<ByteDelimiter> split(ConstBuffer buffer, T delimiter) {
+    return {buffer, ByteDelimiter{u8(delimiter)}};
+}
+
+/// \brief Lazy range of pieces of buffer between bytes in set (every byte delimits, runs give empty pieces).
+[[nodiscard, gnu::always_inline]] inline SplitRange<ByteSetDelimiter> split_any(ConstBuffer buffer, const ByteSet & set) {
+    return {buffer, ByteSetDelimiter{set}};
+}
+
+/// \brief Lazy range of lines of buffer, each ended by "\n" or "\r\n" (dropped) or by the end of buffer (kept as is).
+[[nodiscard, gnu::always_inline]] inline SplitRange<ByteDelimiter, true> lines(ConstBuffer buffer) {
+    return {buffer, ByteDelimiter{'\n'}};
+}
+
+}
+
+namespace std::ranges {
+
+/// Iterators copy the buffer and delimiter: pieces stay valid after the range is destroyed.
+template<typename Delimiter, bool trim_lines>
+inline constexpr bool enable_borrowed_range<sedfer::SplitRange<Delimiter, trim_lines>> = true;
+
+}
@@ -0,0 +1,263 @@
+#pragma once
+
+#include "helpers/cpu.h"
+#include "helpers/types.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace sedfer {
+
+/// \brief Number of occurrences of each byte value.
+using ByteHistogram = std::array<u32, 256>;
+
+/**
+ * \brief Counting loops: byte histogram, occurrences of one byte value and set bits.
+ *
+ * The histogram is scalar: bytes are spread over 4 interleaved sub-histograms, so runs of equal bytes do not wait
+ * for the previous increment of the same counter (store-to-load forwarding). count and popcount accumulate
+ * per-byte counters in SIMD registers and reduce them with psadbw before they can overflow.
+ */
+namespace kernels {
+
+namespace scalar {
+
+inline void histogram(const u8 * data, usize size, ByteHistogram & ret) {
+    ret = {};
+    // Zeroing and summing the sub-histograms (4 KiB) costs more than the collisions they avoid on short inputs.
+    if(size < 1024) {
+        for(usize i = 0; i < size; ++i) {
+            ++ret[data[i]];
+        }
+        return;
+    }
+    u32 tables[4][256] = {};
+    usize i = 0;
+    for(; i + 16 <= size; i += 16) {
+        u64 a;
+        u64 b;
+        std::memcpy(&a, data + i, 8);
+        std::memcpy(&b, data + i + 8, 8);
+        for(usize shift = 0; shift < 64; shift += 16) {
+            ++tables[0][u8(a >> shift)];
+            ++tables[1][u8(a >> (shift + 8))];
+            ++tables[2][u8(b >> shift)];
+            ++tables[3][u8(b >> (shift + 8))];
+        }
+    }
+    for(; i < size; ++i) {
+        ++tables[0][data[i]];
+    }
+    for(usize value = 0; value < 256; ++value) {
+        ret[value] = tables[0][value] + tables[1][value] + tables[2][value] + tables[3][value];
+    }
+}
+
+inline usize count(const u8 * data, usize size, u8 value) {
+    usize ret = 0;
+    for(usize i = 0; i < size; ++i) {
+        ret += (data[i] == value);
+    }
+    return ret;
+}
+
+inline usize popcount(const u8 * data, usize size) {
+    usize ret = 0;
+    usize i = 0;
+    for(; i + 8 <= size; i += 8) {
+        u64 word;
+        std::memcpy(&word, data + i, 8);
+        ret += std::popcount(word);
+    }
+    for(; i < size; ++i) {
+        ret += std::popcount(data[i]);
+    }
+    return ret;
+}
+
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+namespace sse2 {
+
+/// \brief Per-byte counters are summed every 255 vectors (before they wrap).
+[[gnu::target("sse2")]] inline usize count(const u8 * data, usize size, u8 value) {
+    const __m128i needle = _mm_set1_epi8(char(value));
+    usize ret = 0;
+    usize i = 0;
+    while(i + 16 <= size) {
+        __m128i counters = _mm_setzero_si128();
+        const usize end = std::min(size & ~usize(15), i + 255 * 16);
+        for(; i < end; i += 16) {
+            // Equal bytes are -1: subtracting adds 1.
+            counters = _mm_sub_epi8(counters, _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i)), needle));
+        }
+        // Each 64-bit sum is at most 8 * 255: the low 32 bits hold it, also on i386.
+        const __m128i sums = _mm_sad_epu8(counters, _mm_setzero_si128());
+        ret += usize(u32(_mm_cvtsi128_si32(sums))) + usize(u32(_mm_cvtsi128_si32(_mm_unpackhi_epi64(sums, sums))));
+    }
+    return ret + scalar::count(data + i, size - i, value);
+}
+
+}
+
+namespace sse42 {
+
+/// \brief popcnt on 4 independent words per iteration (std::popcount is one popcnt per word with this target).
+[[gnu::target("popcnt")]] inline usize popcount(const u8 * data, usize size) {
+    u64 a = 0;
+    u64 b = 0;
+    u64 c = 0;
+    u64 d = 0;
+    usize i = 0;
+    for(; i + 32 <= size; i += 32) {
+        u64 words[4];
+        std::memcpy(words, data + i, 32);
+        a += std::popcount(words[0]);
+        b += std::popcount(words[1]);
+        c += std::popcount(words[2]);
+        d += std::popcount(words[3]);
+    }
+    for(; i + 8 <= size; i += 8) {
+        u64 word;
+        std::memcpy(&word, data + i, 8);
+        a += std::popcount(word);
+    }
+    for(; i < size; ++i) {
+        a += _mm_popcnt_u32(data[i]);
+    }
+    return a + b + c + d;
+}
+
+}
+
+namespace avx2 {
+
+[[gnu::target("avx2")]] inline usize sum_bytes(__m256i counters) {
+    const __m256i sums = _mm256_sad_epu8(counters, _mm256_setzero_si256());
+    const __m128i half = _mm_add_epi64(_mm256_castsi256_si128(sums), _mm256_extracti128_si256(sums, 1));
+    // Each 64-bit sum is at most 2 * 8 * 255: the low 32 bits hold it, also on i386.
+    return usize(u32(_mm_cvtsi128_si32(half))) + usize(u32(_mm_cvtsi128_si32(_mm_unpackhi_epi64(half, half))));
+}
+
+/// \brief 4 vectors per iteration, per-byte counters are summed every 63 iterations (at most 252 per byte).
+[[gnu::target("avx2")]] inline usize count(const u8 * data, usize size, u8 value) {
+    const __m256i needle = _mm256_set1_epi8(char(value));
+    usize ret = 0;
+    usize i = 0;
+    while(i + 128 <= size) {
+        __m256i counters = _mm256_setzero_si256();
+        const usize end = std::min(size & ~usize(127), i + 63 * 128);
+        for(; i < end; i += 128) {
+            const __m256i a = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i)), needle);
+            const __m256i b = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i + 32)), needle);
+            const __m256i c = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i + 64)), needle);
+            const __m256i d = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i + 96)), needle);
+            counters = _mm256_sub_epi8(counters, _mm256_add_epi8(_mm256_add_epi8(a, b), _mm256_add_epi8(c, d)));
+        }
+        ret += sum_bytes(counters);
+    }
+    return ret + sse2::count(data + i, size - i, value);
+}
+
+/// \brief Set bits per byte from two 4-bit table lookups (pshufb), per-byte counters are summed every 28 vectors.
+[[gnu::target("avx2")]] inline usize popcount(const u8 * data, usize size) {
+    const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                           0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_nibble = _mm256_set1_epi8(0x0f);
+    usize ret = 0;
+    usize i = 0;
+    while(i + 128 <= size) {
+        __m256i counters = _mm256_setzero_si256();
+        // At most 8 bits per byte and vector: 28 vectors fit in a byte counter.
+        const usize end = std::min(size & ~usize(127), i + 7 * 128);
+        for(; i < end; i += 32) {
+            const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+            const __m256i low = _mm256_shuffle_epi8(table, _mm256_and_si256(bytes, low_nibble));
+            const __m256i high = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(bytes, 4), low_nibble));
+            counters = _mm256_add_epi8(counters, _mm256_add_epi8(low, high));
+        }
+        ret += sum_bytes(counters);
+    }
+    return ret + sse42::popcount(data + i, size - i);
+}
+
+}
+
+#endif
+
+inline void histogram(const u8 * data, usize size, ByteHistogram & ret) {
+    scalar::histogram(data, size, ret);
+}
+
+inline usize count(const u8 * data, usize size, u8 value) {
+#if defined(__x86_64__) || defined(__i386__)
+    switch(cpu_tier()) {
+        case CpuTier::avx512:
+        case CpuTier::avx2: return avx2::count(data, size, value);
+        case CpuTier::sse42:
+        case CpuTier::sse2: return sse2::count(data, size, value);
+        case CpuTier::scalar: break;
+    }
+#endif
+    return scalar::count(data, size, value);
+}
+
+inline usize popcount(const u8 * data, usize size) {
+#if defined(__x86_64__) || defined(__i386__)
+    switch(cpu_tier()) {
+        case CpuTier::avx512:
+        case CpuTier::avx2: return avx2::popcount(data, size);
+        case CpuTier::sse42: return sse42::popcount(data, size);
+        case CpuTier::sse2:
+        case CpuTier::scalar: break;
+    }
+#endif
+    return scalar::popcount(data, size);
+}
+
+}
+
+/// \brief Summary of a payload for choosing a codec, see byte_stats().
+struct ByteStats {
+    usize size = 0;
+    usize zero_bytes = 0;
+    usize ascii_bytes = 0; ///< Bytes < 0x80.
+    usize set_bits = 0;
+    double entropy = 0; ///< Shannon entropy in bits per byte: 0 (constant) to 8 (uniform random).
+
+    [[nodiscard, gnu::always_inline]] inline double zero_ratio() const {
+        return size != 0 ? double(zero_bytes) / double(size) : 0;
+    }
+
+    [[nodiscard, gnu::always_inline]] inline double ascii_ratio() const {
+        return size != 0 ? double(ascii_bytes) / double(size) : 0;
+    }
+
+    /// \brief Derive all statistics from a histogram of size bytes.
+    [[nodiscard]] static inline ByteStats from(const ByteHistogram & histogram, usize size) {
+        ByteStats ret;
+        ret.size = size;
+        ret.zero_bytes = histogram[0];
+        for(usize value = 0; value < 256; ++value) {
+            const usize n = histogram[value];
+            ret.ascii_bytes += (value < 0x80) ? n : 0;
+            ret.set_bits += n * usize(std::popcount(u8(value)));
+            if(n != 0) {
+                const double p = double(n) / double(size);
+                ret.entropy -= p * std::log2(p);
+            }
+        }
+        return ret;
+    }
+};
+
+}
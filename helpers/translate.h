@@ -0,0 +1,357 @@
+#pragma once
+
+#include "helpers/cpu.h"
+#include "helpers/types.h"
+
+#include <cstring>
+#include <string_view>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace sedfer {
+
+/**
+ * \brief ByteMap is a byte -> byte table for MutableBuffer::translate (like tr).
+ *
+ * Besides the table it keeps the rows (16 entries with the same high nibble) as differences from the previous row,
+ * so SIMD kernels look up a byte with one byte shuffle per row: shuffles return 0 for indexes with bit 7 set, so
+ * subtracting 16 per row makes rows 0 - h of the byte's half contribute and their XOR telescopes to row h.
+ * \code
+ * static constexpr ByteMap SLASHES("\\", "/");
+ * path.translate(SLASHES);
+ * \endcode
+ */
+struct ByteMap {
+    alignas(16) u8 values[256] = {};
+    alignas(16) u8 deltas[256] = {}; ///< Row h XOR row h - 1, rows 0 and 8 (the first of each half) as is.
+
+    /// \brief Identity map.
+    constexpr ByteMap() {
+        for(usize i = 0; i < 256; ++i) {
+            values[i] = u8(i);
+            deltas[i] = ((i >> 4) & 7) == 0 ? u8(i) : u8(i ^ (i - 16));
+        }
+    }
+
+    /// \brief Identity map except from[i] -> to[i] (from.size must equal to.size, later duplicates win).
+    constexpr ByteMap(std::string_view from, std::string_view to) : ByteMap() {
+        for(usize i = 0; i < from.size() && i < to.size(); ++i) {
+            set(u8(from[i]), u8(to[i]));
+        }
+    }
+
+    constexpr void set(u8 from, u8 to) {
+        values[from] = to;
+        deltas[from] = ((from >> 4) & 7) == 0 ? to : u8(to ^ values[from - 16]);
+        if(((from >> 4) & 7) != 7) {
+            deltas[from + 16] = u8(values[from + 16] ^ to);
+        }
+    }
+
+    [[nodiscard, gnu::always_inline]] constexpr inline u8 operator[](u8 value) const {
+        return values[value];
+    }
+};
+
+/**
+ * \brief ASCII case conversion, case-insensitive equality and ByteMap translation.
+ *
+ * Case kernels find the letters to flip with one range compare: adding 0x80 - 'A' (or 'a') moves the 26 letters to
+ * the bottom of the signed byte range, so a single signed compare selects them and bit 5 (0x20) is flipped.
+ * The scalar version does the same on 8 bytes per word (SWAR) on 7-bit values, so no carry crosses a byte.
+ * Only ASCII letters change, bytes >= 0x80 (e.g. UTF-8 sequences) are kept.
+ */
+namespace kernels {
+
+namespace scalar {
+
+/// \brief Bit 7 set in each byte of word that is an ASCII letter of the case to flip (upper: 'a' - 'z').
+template<bool upper>
+[[nodiscard, gnu::always_inline]] inline u64 case_mask(u64 word) {
+    constexpr u64 ONES = 0x0101010101010101;
+    constexpr u64 first = upper ? 'a' : 'A';
+    const u64 heptets = word & (0x7f * ONES);
+    const u64 at_least_first = heptets + (0x80 - first) * ONES;
+    const u64 after_last = heptets + (0x80 - first - 26) * ONES;
+    return (at_least_first ^ after_last) & ~word & (0x80 * ONES);
+}
+
+template<bool upper>
+[[nodiscard, gnu::always_inline]] inline u8 change_case(u8 value) {
+    constexpr u8 first = upper ? 'a' : 'A';
+    return u8(value - first) < 26 ? u8(value ^ 0x20) : value;
+}
+
+/// \brief destination = source with ASCII letters changed to lower (upper = false) or upper case.
+template<bool upper>
+inline void change_case(u8 * destination, const u8 * source, usize size) {
+    for(; size >= 8; size -= 8, source += 8, destination += 8) {
+        u64 word;
+        std::memcpy(&word, source, 8);
+        word ^= case_mask<upper>(word) >> 2;
+        std::memcpy(destination, &word, 8);
+    }
+    for(usize i = 0; i < size; ++i) {
+        destination[i] = change_case<upper>(source[i]);
+    }
+}
+
+/// \brief Bytes may only differ in bit 5 (0x20), and only where left is a letter.
+inline bool equal_icase(const u8 * left, const u8 * right, usize size) {
+    for(; size >= 8; size -= 8, left += 8, right += 8) {
+        u64 l;
+        u64 r;
+        std::memcpy(&l, left, 8);
+        std::memcpy(&r, right, 8);
+        const u64 letters = case_mask<true>(l | 0x2020202020202020) >> 2;
+        if(((l ^ r) & ~letters) != 0) {
+            return false;
+        }
+    }
+    for(usize i = 0; i < size; ++i) {
+        if(change_case<false>(left[i]) != change_case<false>(right[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+inline void translate(u8 * destination, const u8 * source, usize size, const ByteMap & map) {
+    for(usize i = 0; i < size; ++i) {
+        destination[i] = map.values[source[i]];
+    }
+}
+
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+namespace sse2 {
+
+template<bool upper>
+[[gnu::target("sse2"), gnu::always_inline]] inline __m128i change_case(__m128i input) {
+    constexpr char first = upper ? 'a' : 'A';
+    const __m128i shifted = _mm_add_epi8(input, _mm_set1_epi8(char(0x80 - first)));
+    const __m128i letters = _mm_cmplt_epi8(shifted, _mm_set1_epi8(char(0x80 + 26)));
+    return _mm_xor_si128(input, _mm_and_si128(letters, _mm_set1_epi8(0x20)));
+}
+
+template<bool upper>
+[[gnu::target("sse2")]] inline void change_case(u8 * destination, const u8 * source, usize size) {
+    for(; size >= 16; size -= 16, source += 16, destination += 16) {
+        const __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(destination), change_case<upper>(input));
+    }
+    scalar::change_case<upper>(destination, source, size);
+}
+
+/// \brief left ^ right without bit 5 where left is a letter, 0 if equal ignoring case (see scalar::equal_icase).
+[[gnu::target("sse2"), gnu::always_inline]] inline __m128i icase_difference(const u8 * left, const u8 * right) {
+    const __m128i l = _mm_loadu_si128(reinterpret_cast<const __m128i *>(left));
+    const __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i *>(right));
+    const __m128i case_bit = _mm_set1_epi8(0x20);
+    const __m128i shifted = _mm_add_epi8(_mm_or_si128(l, case_bit), _mm_set1_epi8(char(0x80 - 'a')));
+    const __m128i letters = _mm_cmplt_epi8(shifted, _mm_set1_epi8(char(0x80 + 26)));
+    return _mm_andnot_si128(_mm_and_si128(letters, case_bit), _mm_xor_si128(l, r));
+}
+
+[[gnu::target("sse2")]] inline bool equal_icase(const u8 * left, const u8 * right, usize size) {
+    for(; size >= 32; size -= 32, left += 32, right += 32) {
+        const __m128i difference = _mm_or_si128(icase_difference(left, right), icase_difference(left + 16, right + 16));
+        if(_mm_movemask_epi8(_mm_cmpeq_epi8(difference, _mm_setzero_si128())) != 0xffff) {
+            return false;
+        }
+    }
+    if(size >= 16) {
+        if(_mm_movemask_epi8(_mm_cmpeq_epi8(icase_difference(left, right), _mm_setzero_si128())) != 0xffff) {
+            return false;
+        }
+        size -= 16;
+        left += 16;
+        right += 16;
+    }
+    return scalar::equal_icase(left, right, size);
+}
+
+}
+
+namespace sse42 {
+
+/// \brief Rows 0 - 7 looked up with input and rows 8 - 15 with input ^ 0x80, blended by bit 7 (see ByteMap).
+[[gnu::target("sse4.2"), gnu::always_inline]] inline __m128i translate_vector(__m128i input, const ByteMap & map) {
+    const __m128i sixteen = _mm_set1_epi8(16);
+    __m128i low_index = input;
+    __m128i high_index = _mm_xor_si128(input, _mm_set1_epi8(char(0x80)));
+    __m128i low = _mm_setzero_si128();
+    __m128i high = _mm_setzero_si128();
+    for(usize i = 0; i < 8; ++i) {
+        const __m128i low_row = _mm_load_si128(reinterpret_cast<const __m128i *>(map.deltas + 16 * i));
+        const __m128i high_row = _mm_load_si128(reinterpret_cast<const __m128i *>(map.deltas + 128 + 16 * i));
+        low = _mm_xor_si128(low, _mm_shuffle_epi8(low_row, low_index));
+        high = _mm_xor_si128(high, _mm_shuffle_epi8(high_row, high_index));
+        low_index = _mm_sub_epi8(low_index, sixteen);
+        high_index = _mm_sub_epi8(high_index, sixteen);
+    }
+    return _mm_blendv_epi8(low, high, input);
+}
+
+[[gnu::target("sse4.2")]] inline void translate(u8 * destination, const u8 * source, usize size, const ByteMap & map) {
+    for(; size >= 16; size -= 16, source += 16, destination += 16) {
+        const __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(destination), translate_vector(input, map));
+    }
+    scalar::translate(destination, source, size, map);
+}
+
+}
+
+namespace avx2 {
+
+template<bool upper>
+[[gnu::target("avx2"), gnu::always_inline]] inline __m256i change_case(__m256i input) {
+    constexpr char first = upper ? 'a' : 'A';
+    const __m256i shifted = _mm256_add_epi8(input, _mm256_set1_epi8(char(0x80 - first)));
+    const __m256i letters = _mm256_cmpgt_epi8(_mm256_set1_epi8(char(0x80 + 26)), shifted);
+    return _mm256_xor_si256(input, _mm256_and_si256(letters, _mm256_set1_epi8(0x20)));
+}
+
+template<bool upper>
+[[gnu::target("avx2")]] inline void change_case(u8 * destination, const u8 * source, usize size) {
+    for(; size >= 64; size -= 64, source += 64, destination += 64) {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(source));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(source + 32));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(destination), change_case<upper>(a));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(destination + 32), change_case<upper>(b));
+    }
+    sse2::change_case<upper>(destination, source, size);
+}
+
+/// \brief See sse2::icase_difference.
+[[gnu::target("avx2"), gnu::always_inline]] inline __m256i icase_difference(const u8 * left, const u8 * right) {
+    const __m256i l = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(left));
+    const __m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(right));
+    const __m256i case_bit = _mm256_set1_epi8(0x20);
+    const __m256i shifted = _mm256_add_epi8(_mm256_or_si256(l, case_bit), _mm256_set1_epi8(char(0x80 - 'a')));
+    const __m256i letters = _mm256_cmpgt_epi8(_mm256_set1_epi8(char(0x80 + 26)), shifted);
+    return _mm256_andnot_si256(_mm256_and_si256(letters, case_bit), _mm256_xor_si256(l, r));
+}
+
+[[gnu::target("avx2")]] inline bool equal_icase(const u8 * left, const u8 * right, usize size) {
+    for(; size >= 64; size -= 64, left += 64, right += 64) {
+        const __m256i difference = _mm256_or_si256(icase_difference(left, right), icase_difference(left + 32, right + 32));
+        if(not _mm256_testz_si256(difference, difference)) {
+            return false;
+        }
+    }
+    if(size >= 32) {
+        const __m256i difference = icase_difference(left, right);
+        if(not _mm256_testz_si256(difference, difference)) {
+            return false;
+        }
+        size -= 32;
+        left += 32;
+        right += 32;
+    }
+    return sse2::equal_icase(left, right, size);
+}
+
+/// \brief See sse42::translate_vector, rows are broadcast to both lanes and shared by count vectors.
+template<usize count>
+[[gnu::target("avx2"), gnu::always_inline]] inline void translate_vectors(u8 * destination, const u8 * source, const ByteMap & map) {
+    const __m256i sixteen = _mm256_set1_epi8(16);
+    __m256i input[count];
+    __m256i low_index[count];
+    __m256i high_index[count];
+    __m256i low[count];
+    __m256i high[count];
+    for(usize j = 0; j < count; ++j) {
+        input[j] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(source + 32 * j));
+        low_index[j] = input[j];
+        high_index[j] = _mm256_xor_si256(input[j], _mm256_set1_epi8(char(0x80)));
+        low[j] = _mm256_setzero_si256();
+        high[j] = _mm256_setzero_si256();
+    }
+    for(usize i = 0; i < 8; ++i) {
+        const __m256i low_row = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i *>(map.deltas + 16 * i)));
+        const __m256i high_row = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i *>(map.deltas + 128 + 16 * i)));
+        for(usize j = 0; j < count; ++j) {
+            low[j] = _mm256_xor_si256(low[j], _mm256_shuffle_epi8(low_row, low_index[j]));
+            high[j] = _mm256_xor_si256(high[j], _mm256_shuffle_epi8(high_row, high_index[j]));
+            low_index[j] = _mm256_sub_epi8(low_index[j], sixteen);
+            high_index[j] = _mm256_sub_epi8(high_index[j], sixteen);
+        }
+    }
+    for(usize j = 0; j < count; ++j) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(destination + 32 * j), _mm256_blendv_epi8(low[j], high[j], input[j]));
+    }
+}
+
+[[gnu::target("avx2")]] inline void translate(u8 * destination, const u8 * source, usize size, const ByteMap & map) {
+    for(; size >= 64; size -= 64, source += 64, destination += 64) {
+        translate_vectors<2>(destination, source, map);
+    }
+    if(size >= 32) {
+        translate_vectors<1>(destination, source, map);
+        size -= 32;
+        source += 32;
+        destination += 32;
+    }
+    sse42::translate(destination, source, size, map);
+}
+
+}
+
+#endif
+
+/// \brief destination = source with ASCII letters in lower (upper = false) or upper case (destination may be source).
+template<bool upper>
+inline void change_case(u8 * destination, const u8 * source, usize size) {
+#if defined(__x86_64__) || defined(__i386__)
+    switch(cpu_tier()) {
+        case CpuTier::avx512:
+        case CpuTier::avx2: return avx2::change_case<upper>(destination, source, size);
+        case CpuTier::sse42:
+        case CpuTier::sse2: return sse2::change_case<upper>(destination, source, size);
+        case CpuTier::scalar: break;
+    }
+#endif
+    scalar::change_case<upper>(destination, source, size);
+}
+
+/// \brief true if size bytes at left and right are equal ignoring ASCII case.
+inline bool equal_icase(const u8 * left, const u8 * right, usize size) {
+#if defined(__x86_64__) || defined(__i386__)
+    switch(cpu_tier()) {
+        case CpuTier::avx512:
+        case CpuTier::avx2: return avx2::equal_icase(left, right, size);
+        case CpuTier::sse42:
+        case CpuTier::sse2: return sse2::equal_icase(left, right, size);
+        case CpuTier::scalar: break;
+    }
+#endif
+    return scalar::equal_icase(left, right, size);
+}
+
+/// \brief destination[i] = map[source[i]] (destination may be source).
+inline void translate(u8 * destination, const u8 * source, usize size, const ByteMap & map) {
+#if defined(__x86_64__) || defined(__i386__)
+    // Short keys: 16 shuffles per vector cost more than the table loads.
+    if(size < 32) {
+        return scalar::translate(destination, source, size, map);
+    }
+    switch(cpu_tier()) {
+        case CpuTier::avx512:
+        case CpuTier::avx2: return avx2::translate(destination, source, size, map);
+        case CpuTier::sse42: return sse42::translate(destination, source, size, map);
+        case CpuTier::sse2:
+        case CpuTier::scalar: break;
+    }
+#endif
+    scalar::translate(destination, source, size, map);
+}
+
+}
+
+}
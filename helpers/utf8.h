@@ -0,0 +1,894 @@
+#pragma once
+
+#include "helpers/buffer.h"
+#include "helpers/cpu.h"
+#include "helpers/types.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace sedfer {
+
+/**
+ * \brief UTF-8 validation, ASCII detection and transcoding to and from UTF-16 / UTF-32.
+ *
+ * The SIMD validators follow Keiser and Lemire ("Validating UTF-8 In Less Than One Instruction Per Byte"): every
+ * error of a 2-byte window is a combination of the high nibble of the first byte, its low nibble and the high nibble
+ * of the second byte, so three 16-entry pshufb lookups AND-ed together flag all of them. What remains is checked
+ * with shifted copies of the input: continuation bytes required by 3- and 4-byte leads 2 and 3 bytes back, and a
+ * sequence cut off at the end of the input. Blocks of ASCII skip the lookups.
+ *
+ * UTF-16 and UTF-32 are native-endian code units (char16_t / char32_t) stored as bytes. Transcoders from UTF-8
+ * expect validated input; SIMD transcoders widen or narrow ASCII blocks and decode other blocks with scalar code.
+ */
+namespace kernels {
+
+/// \brief UTF8_* lookup error bits, the names describe the 2-byte window that sets them.
+inline constexpr u8 UTF8_TOO_SHORT = 1 << 0;  // Lead or ASCII followed by a lead, lead followed by ASCII.
+inline constexpr u8 UTF8_TOO_LONG = 1 << 1;  // ASCII followed by a continuation.
+inline constexpr u8 UTF8_OVERLONG_3 = 1 << 2;  // 11100000 100_____
+inline constexpr u8 UTF8_TOO_LARGE = 1 << 3;  // 11110100 1001____ and above
+inline constexpr u8 UTF8_SURROGATE = 1 << 4;  // 11101101 101_____
+inline constexpr u8 UTF8_OVERLONG_2 = 1 << 5;  // 1100000_ 10______
+inline constexpr u8 UTF8_TOO_LARGE_1000 = 1 << 6;  // 11110101 1000____ and above
+inline constexpr u8 UTF8_OVERLONG_4 = 1 << 6;  // 11110000 1000____
+inline constexpr u8 UTF8_TWO_CONTINUATIONS = 1 << 7;  // 10______ 10______
+inline constexpr u8 UTF8_CARRY = UTF8_TOO_SHORT | UTF8_TOO_LONG | UTF8_TWO_CONTINUATIONS;
+
+/// \brief Error bits by the high nibble of the first byte.
+alignas(16) inline constexpr u8 UTF8_BYTE_1_HIGH[16] = {
+    UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+    UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+    UTF8_TWO_CONTINUATIONS, UTF8_TWO_CONTINUATIONS, UTF8_TWO_CONTINUATIONS, UTF8_TWO_CONTINUATIONS,
+    UTF8_TOO_SHORT | UTF8_OVERLONG_2,
+    UTF8_TOO_SHORT,
+    UTF8_TOO_SHORT | UTF8_OVERLONG_3 | UTF8_SURROGATE,
+    UTF8_TOO_SHORT | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4,
+};
+
+/// \brief Error bits by the low nibble of the first byte.
+alignas(16) inline constexpr u8 UTF8_BYTE_1_LOW[16] = {
+    UTF8_CARRY | UTF8_OVERLONG_3 | UTF8_OVERLONG_2 | UTF8_OVERLONG_4,
+    UTF8_CARRY | UTF8_OVERLONG_2,
+    UTF8_CARRY,
+    UTF8_CARRY,
+    UTF8_CARRY | UTF8_TOO_LARGE,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_SURROGATE,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+};
+
+/// \brief Error bits by the high nibble of the second byte.
+alignas(16) inline constexpr u8 UTF8_BYTE_2_HIGH[16] = {
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTINUATIONS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4,
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTINUATIONS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE,
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTINUATIONS | UTF8_SURROGATE | UTF8_TOO_LARGE,
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTINUATIONS | UTF8_SURROGATE | UTF8_TOO_LARGE,
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+};
+
+/// \brief Last 3 bytes of a block above these start a sequence longer than the rest of the block.
+alignas(32) inline constexpr u8 UTF8_INCOMPLETE[32] = {
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xf0 - 1, 0xe0 - 1, 0xc0 - 1,
+};
+
+[[nodiscard, gnu::always_inline]] inline bool utf8_ascii_8(const u8 * data) {
+    u64 word;
+    std::memcpy(&word, data, 8);
+    return (word & 0x8080808080808080) == 0;
+}
+
+/// \brief Decode one sequence of valid UTF-8 at data and advance data past it.
+[[nodiscard, gnu::always_inline]] inline u32 utf8_decode(const u8 *& data) {
+    const u32 lead = data[0];
+    if(lead < 0x80) {
+        data += 1;
+        return lead;
+    }
+    if(lead < 0xe0) {
+        const u32 ret = ((lead & 0x1f) << 6) | (data[1] & 0x3f);
+        data += 2;
+        return ret;
+    }
+    if(lead < 0xf0) {
+        const u32 ret = ((lead & 0x0f) << 12) | (u32(data[1] & 0x3f) << 6) | (data[2] & 0x3f);
+        data += 3;
+        return ret;
+    }
+    const u32 ret = ((lead & 0x07) << 18) | (u32(data[1] & 0x3f) << 12) | (u32(data[2] & 0x3f) << 6) | (data[3] & 0x3f);
+    data += 4;
+    return ret;
+}
+
+/// \brief Write code point (U+0000 - U+10FFFF, not a surrogate) as UTF-8 and return the end of the output.
+[[gnu::always_inline]] inline u8 * utf8_encode(u8 * out, u32 code_point) {
+    if(code_point < 0x80) {
+        out[0] = u8(code_point);
+        return out + 1;
+    }
+    if(code_point < 0x800) {
+        out[0] = u8(0xc0 | (code_point >> 6));
+        out[1] = u8(0x80 | (code_point & 0x3f));
+        return out + 2;
+    }
+    if(code_point < 0x10000) {
+        out[0] = u8(0xe0 | (code_point >> 12));
+        out[1] = u8(0x80 | ((code_point >> 6) & 0x3f));
+        out[2] = u8(0x80 | (code_point & 0x3f));
+        return out + 3;
+    }
+    out[0] = u8(0xf0 | (code_point >> 18));
+    out[1] = u8(0x80 | ((code_point >> 12) & 0x3f));
+    out[2] = u8(0x80 | ((code_point >> 6) & 0x3f));
+    out[3] = u8(0x80 | (code_point & 0x3f));
+    return out + 4;
+}
+
+/// \brief Write code point as one UTF-16 unit or a surrogate pair and return the end of the output.
+[[gnu::always_inline]] inline u8 * utf16_encode(u8 * out, u32 code_point) {
+    if(code_point < 0x10000) {
+        const u16 unit = u16(code_point);
+        std::memcpy(out, &unit, 2);
+        return out + 2;
+    }
+    code_point -= 0x10000;
+    const u16 units[2] = {u16(0xd800 | (code_point >> 10)), u16(0xdc00 | (code_point & 0x3ff))};
+    std::memcpy(out, units, 4);
+    return out + 4;
+}
+
+[[gnu::always_inline]] inline u8 * utf32_encode(u8 * out, u32 code_point) {
+    std::memcpy(out, &code_point, 4);
+    return out + 4;
+}
+
+/// \brief Number of UTF-8 bytes of code point, the same 1 - 4 byte classes as utf8_encode.
+[[nodiscard, gnu::always_inline]] constexpr inline usize utf8_length(u32 code_point) {
+    return 1 + (code_point >= 0x80) + (code_point >= 0x800) + (code_point >= 0x10000);
+}
+
+/**
+ * \brief Decode UTF-16 units at data up to end into out as UTF-8.
+ * \return End of the output, nullptr on an unpaired surrogate (a pair may extend past end, up to limit).
+ */
+[[nodiscard, gnu::always_inline]] inline u8 * utf16_to_utf8_scalar(const u8 *& data, const u8 * end, const u8 * limit, u8 * out) {
+    while(data < end) {
+        u16 unit;
+        std::memcpy(&unit, data, 2);
+        data += 2;
+        if(unit < 0xd800 || unit > 0xdfff) {
+            out = utf8_encode(out, unit);
+            continue;
+        }
+        u16 low;
+        if(unit > 0xdbff || data == limit || (std::memcpy(&low, data, 2), low < 0xdc00 || low > 0xdfff)) {
+            return nullptr;
+        }
+        data += 2;
+        out = utf8_encode(out, 0x10000 + ((u32(unit & 0x3ff) << 10) | (low & 0x3ff)));
+    }
+    return out;
+}
+
+/// \brief Encode UTF-32 units at data up to end into out as UTF-8, nullptr on a surrogate or a unit above U+10FFFF.
+[[nodiscard, gnu::always_inline]] inline u8 * utf32_to_utf8_scalar(const u8 *& data, const u8 * end, u8 * out) {
+    for(; data < end; data += 4) {
+        u32 unit;
+        std::memcpy(&unit, data, 4);
+        if(unit > 0x10ffff || (unit >= 0xd800 && unit <= 0xdfff)) {
+            return nullptr;
+        }
+        out = utf8_encode(out, unit);
+    }
+    return out;
+}
+
+namespace scalar {
+
+/// \brief Number of code points of valid UTF-8: bytes that are not continuations (10xxxxxx), 8 bytes per word.
+inline usize utf8_code_points(const u8 * data, usize size) {
+    usize ret = size;
+    for(; size >= 8; size -= 8, data += 8) {
+        u64 word;
+        std::memcpy(&word, data, 8);
+        // Bit 7 of each byte: set and bit 6 clear. The multiply sums the 0 / 1 bytes into the top byte.
+        ret -= usize((((word & ~(word << 1) & 0x8080808080808080) >> 7) * 0x0101010101010101) >> 56);
+    }
+    for(; size > 0; --size, ++data) {
+        ret -= (*data & 0xc0) == 0x80;
+    }
+    return ret;
+}
+
+/// \brief Number of UTF-16 units of valid UTF-8: code points, plus one more for each 4-byte lead (1111xxxx).
+inline usize utf8_utf16_units(const u8 * data, usize size) {
+    usize ret = size;
+    for(; size >= 8; size -= 8, data += 8) {
+        u64 word;
+        std::memcpy(&word, data, 8);
+        const u64 continuations = (word & ~(word << 1) & 0x8080808080808080) >> 7;
+        const u64 fours = (word & (word << 1) & (word << 2) & (word << 3) & 0x8080808080808080) >> 7;
+        ret -= usize((continuations * 0x0101010101010101) >> 56);
+        ret += usize((fours * 0x0101010101010101) >> 56);
+    }
+    for(; size > 0; --size, ++data) {
+        ret -= (*data & 0xc0) == 0x80;
+        ret += *data >= 0xf0;
+    }
+    return ret;
+}
+
+/// \brief Number of UTF-8 bytes of count UTF-16 units, a surrogate counts 2 (a valid pair is 4 bytes).
+inline usize utf16_utf8_length(const u8 * data, usize count) {
+    usize ret = 0;
+    for(usize i = 0; i < count; ++i) {
+        u16 unit;
+        std::memcpy(&unit, data + 2 * i, 2);
+        ret += 1 + (unit >= 0x80) + (unit >= 0x800 && (unit < 0xd800 || unit > 0xdfff));
+    }
+    return ret;
+}
+
+/// \brief Number of UTF-8 bytes of count UTF-32 units.
+inline usize utf32_utf8_length(const u8 * data, usize count) {
+    usize ret = 0;
+    for(usize i = 0; i < count; ++i) {
+        u32 unit;
+        std::memcpy(&unit, data + 4 * i, 4);
+        ret += utf8_length(unit);
+    }
+    return ret;
+}
+
+inline bool is_ascii(const u8 * data, usize size) {
+    u64 mask = 0;
+    for(; size >= 8; size -= 8, data += 8) {
+        u64 word;
+        std::memcpy(&word, data, 8);
+        mask |= word;
+    }
+    for(; size > 0; --size, ++data) {
+        mask |= *data;
+    }
+    return (mask & 0x8080808080808080) == 0;
+}
+
+/// \brief Byte-at-a-time validation with an 8-byte ASCII skip.
+inline bool utf8_validate(const u8 * data, usize size) {
+    const u8 * const end = data + size;
+    while(data != end) {
+        if(end - data >= 8 && utf8_ascii_8(data)) {
+            data += 8;
+            continue;
+        }
+        const u8 lead = *data;
+        if(lead < 0x80) {
+            ++data;
+            continue;
+        }
+        usize length;
+        u32 code_point;
+        u32 min;
+        if((lead & 0xe0) == 0xc0) {
+            length = 2;
+            code_point = lead & 0x1f;
+            min = 0x80;
+        } else if((lead & 0xf0) == 0xe0) {
+            length = 3;
+            code_point = lead & 0x0f;
+            min = 0x800;
+        } else if((lead & 0xf8) == 0xf0) {
+            length = 4;
+            code_point = lead & 0x07;
+            min = 0x10000;
+        } else {
+            return false;
+        }
+        if(usize(end - data) < length) {
+            return false;
+        }
+        for(usize i = 1; i < length; ++i) {
+            if((data[i] & 0xc0) != 0x80) {
+                return false;
+            }
+            code_point = (code_point << 6) | (data[i] & 0x3f);
+        }
+        if(code_point < min || code_point > 0x10ffff || (code_point >= 0xd800 && code_point <= 0xdfff)) {
+            return false;
+        }
+        data += length;
+    }
+    return true;
+}
+
+/// \brief Transcode valid UTF-8, return the end of the output.
+inline u8 * utf8_to_utf16(const u8 * data, usize size, u8 * out) {
+    const u8 * const end = data + size;
+    while(data != end) {
+        if(end - data >= 8 && utf8_ascii_8(data)) {
+            for(usize i = 0; i < 8; ++i) {
+                const u16 unit = data[i];
+                std::memcpy(out + 2 * i, &unit, 2);
+            }
+            data += 8;
+            out += 16;
+            continue;
+        }
+        out = utf16_encode(out, utf8_decode(data));
+    }
+    return out;
+}
+
+/// \brief Transcode valid UTF-8, return the end of the output.
+inline u8 * utf8_to_utf32(const u8 * data, usize size, u8 * out) {
+    const u8 * const end = data + size;
+    while(data != end) {
+        out = utf32_encode(out, utf8_decode(data));
+    }
+    return out;
+}
+
+/// \brief Transcode count UTF-16 units, return the end of the output or nullptr on an unpaired surrogate.
+inline u8 * utf16_to_utf8(const u8 * data, usize count, u8 * out) {
+    const u8 * const end = data + 2 * count;
+    return utf16_to_utf8_scalar(data, end, end, out);
+}
+
+/// \brief Transcode count UTF-32 units, return the end of the output or nullptr on an invalid code point.
+inline u8 * utf32_to_utf8(const u8 * data, usize count, u8 * out) {
+    return utf32_to_utf8_scalar(data, data + 4 * count, out);
+}
+
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+namespace sse2 {
+
+[[gnu::target("sse2")]] inline bool is_ascii(const u8 * data, usize size) {
+    __m128i mask = _mm_setzero_si128();
+    for(; size >= 64; size -= 64, data += 64) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 16));
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 32));
+        const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 48));
+        mask = _mm_or_si128(mask, _mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d)));
+    }
+    return _mm_movemask_epi8(mask) == 0 && scalar::is_ascii(data, size);
+}
+
+}
+
+namespace sse42 {
+
+/// \brief Validation state carried between 16-byte blocks.
+struct Utf8Check {
+    __m128i error;
+    __m128i previous;
+    __m128i incomplete;
+};
+
+[[gnu::target("sse4.2"), gnu::always_inline]] inline void utf8_check(Utf8Check & check, __m128i input) {
+    if(_mm_movemask_epi8(input) == 0) {
+        // ASCII can not continue a sequence of the previous block.
+        check.error = _mm_or_si128(check.error, check.incomplete);
+        check.incomplete = _mm_setzero_si128();
+        check.previous = input;
+        return;
+    }
+    const __m128i nibble = _mm_set1_epi8(0x0f);
+    const __m128i prev1 = _mm_alignr_epi8(input, check.previous, 16 - 1);
+    const __m128i byte_1_high = _mm_shuffle_epi8(_mm_load_si128(reinterpret_cast<const __m128i *>(UTF8_BYTE_1_HIGH)),
+                                                 _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble));
+    const __m128i byte_1_low = _mm_shuffle_epi8(_mm_load_si128(reinterpret_cast<const __m128i *>(UTF8_BYTE_1_LOW)),
+                                                _mm_and_si128(prev1, nibble));
+    const __m128i byte_2_high = _mm_shuffle_epi8(_mm_load_si128(reinterpret_cast<const __m128i *>(UTF8_BYTE_2_HIGH)),
+                                                 _mm_and_si128(_mm_srli_epi16(input, 4), nibble));
+    const __m128i special = _mm_and_si128(_mm_and_si128(byte_1_high, byte_1_low), byte_2_high);
+    // Two continuations in a row are valid exactly 2 bytes after a 3-/4-byte lead or 3 bytes after a 4-byte lead.
+    const __m128i prev2 = _mm_alignr_epi8(input, check.previous, 16 - 2);
+    const __m128i prev3 = _mm_alignr_epi8(input, check.previous, 16 - 3);
+    const __m128i third = _mm_subs_epu8(prev2, _mm_set1_epi8(char(0xe0 - 0x80)));
+    const __m128i fourth = _mm_subs_epu8(prev3, _mm_set1_epi8(char(0xf0 - 0x80)));
+    const __m128i required = _mm_and_si128(_mm_or_si128(third, fourth), _mm_set1_epi8(char(0x80)));
+    check.error = _mm_or_si128(check.error, _mm_xor_si128(required, special));
+    check.incomplete = _mm_subs_epu8(input, _mm_load_si128(reinterpret_cast<const __m128i *>(UTF8_INCOMPLETE + 16)));
+    check.previous = input;
+}
+
+[[gnu::target("sse4.2")]] inline bool utf8_validate(const u8 * data, usize size) {
+    Utf8Check check = {_mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128()};
+    for(; size >= 16; size -= 16, data += 16) {
+        utf8_check(check, _mm_loadu_si128(reinterpret_cast<const __m128i *>(data)));
+    }
+    if(size > 0) {
+        // Zero padding is ASCII: a sequence cut off by the end of the input is reported as too short.
+        alignas(16) u8 tail[16] = {};
+        std::memcpy(tail, data, size);
+        utf8_check(check, _mm_load_si128(reinterpret_cast<const __m128i *>(tail)));
+    }
+    return _mm_testz_si128(_mm_or_si128(check.error, check.incomplete), _mm_set1_epi8(-1)) != 0;
+}
+
+}
+
+namespace avx2 {
+
+/// \brief Non-continuation bytes: signed bytes above -65 (0xbf).
+[[gnu::target("avx2,popcnt")]] inline usize utf8_code_points(const u8 * data, usize size) {
+    const __m256i continuation = _mm256_set1_epi8(char(0xbf));
+    usize ret = 0;
+    for(; size >= 32; size -= 32, data += 32) {
+        const __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data));
+        ret += usize(_mm_popcnt_u32(u32(_mm256_movemask_epi8(_mm256_cmpgt_epi8(input, continuation)))));
+    }
+    return ret + scalar::utf8_code_points(data, size);
+}
+
+/// \brief Non-continuation bytes plus 4-byte leads: negative signed bytes above -17 (0xef).
+[[gnu::target("avx2,popcnt")]] inline usize utf8_utf16_units(const u8 * data, usize size) {
+    const __m256i continuation = _mm256_set1_epi8(char(0xbf));
+    const __m256i three = _mm256_set1_epi8(char(0xef));
+    usize ret = 0;
+    for(; size >= 32; size -= 32, data += 32) {
+        const __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data));
+        const u32 leads = u32(_mm256_movemask_epi8(_mm256_cmpgt_epi8(input, continuation)));
+        const u32 four = u32(_mm256_movemask_epi8(_mm256_cmpgt_epi8(input, three))) & u32(_mm256_movemask_epi8(input));
+        ret += usize(_mm_popcnt_u32(leads)) + usize(_mm_popcnt_u32(four));
+    }
+    return ret + scalar::utf8_utf16_units(data, size);
+}
+
+/// \brief 3 bytes per unit, minus one for units below 0x80, below 0x800 and surrogates. Masks have 2 bits per unit.
+[[gnu::target("avx2,popcnt")]] inline usize utf16_utf8_length(const u8 * data, usize count) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i high_bits = _mm256_set1_epi16(i16(0xf800));
+    const __m256i surrogates = _mm256_set1_epi16(i16(0xd800));
+    usize ret = 0;
+    for(; count >= 16; count -= 16, data += 32) {
+        const __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data));
+        const __m256i high = _mm256_and_si256(input, high_bits);
+        const u32 ascii = u32(_mm256_movemask_epi8(_mm256_cmpeq_epi16(_mm256_and_si256(input, _mm256_set1_epi16(i16(0xff80))), zero)));
+        const u32 small = u32(_mm256_movemask_epi8(_mm256_cmpeq_epi16(high, zero)));
+        const u32 surrogate = u32(_mm256_movemask_epi8(_mm256_cmpeq_epi16(high, surrogates)));
+        ret += 48 - usize(_mm_popcnt_u32(ascii) + _mm_popcnt_u32(small) + _mm_popcnt_u32(surrogate)) / 2;
+    }
+    return ret + scalar::utf16_utf8_length(data, count);
+}
+
+/// \brief Bit mask of units >= bound (unsigned: max(unit, bound) == unit).
+[[gnu::target("avx2,popcnt"), gnu::always_inline]] inline u32 utf32_at_least(__m256i input, u32 bound) {
+    const __m256i limit = _mm256_max_epu32(input, _mm256_set1_epi32(i32(bound)));
+    return u32(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(limit, input))));
+}
+
+/// \brief 1 byte per unit, plus one for units from 0x80, from 0x800 and from 0x10000.
+[[gnu::target("avx2,popcnt")]] inline usize utf32_utf8_length(const u8 * data, usize count) {
+    usize ret = 0;
+    for(; count >= 8; count -= 8, data += 32) {
+        const __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data));
+        ret += 8 + usize(_mm_popcnt_u32(utf32_at_least(input, 0x80)) + _mm_popcnt_u32(utf32_at_least(input, 0x800)) +
+                         _mm_popcnt_u32(utf32_at_least(input, 0x10000)));
+    }
+    return ret + scalar::utf32_utf8_length(data, count);
+}
+
+[[gnu::target("avx2")]] inline bool is_ascii(const u8 * data, usize size) {
+    __m256i mask = _mm256_setzero_si256();
+    for(; size >= 128; size -= 128, data += 128) {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + 32));
+        const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + 64));
+        const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + 96));
+        mask = _mm256_or_si256(mask, _mm256_or_si256(_mm256_or_si256(a, b), _mm256_or_si256(c, d)));
+    }
+    return _mm256_movemask_epi8(mask) == 0 && sse2::is_ascii(data, size);
+}
+
+/// \brief Validation state carried between 32-byte blocks.
+struct Utf8Check {
+    __m256i error;
+    __m256i previous;
+    __m256i incomplete;
+};
+
+[[gnu::target("avx2"), gnu::always_inline]] inline __m256i utf8_table(const u8 (& table)[16]) {
+    return _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i *>(table)));
+}
+
+[[gnu::target("avx2"), gnu::always_inline]] inline void utf8_check(Utf8Check & check, __m256i input) {
+    if(_mm256_movemask_epi8(input) == 0) {
+        // ASCII can not continue a sequence of the previous block.
+        check.error = _mm256_or_si256(check.error, check.incomplete);
+        check.incomplete = _mm256_setzero_si256();
+        check.previous = input;
+        return;
+    }
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    // alignr works per 128-bit lane: pair each lane with the lane before it.
+    const __m256i shifted = _mm256_permute2x128_si256(check.previous, input, 0x21);
+    const __m256i prev1 = _mm256_alignr_epi8(input, shifted, 16 - 1);
+    const __m256i byte_1_high = _mm256_shuffle_epi8(utf8_table(UTF8_BYTE_1_HIGH), _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble));
+    const __m256i byte_1_low = _mm256_shuffle_epi8(utf8_table(UTF8_BYTE_1_LOW), _mm256_and_si256(prev1, nibble));
+    const __m256i byte_2_high = _mm256_shuffle_epi8(utf8_table(UTF8_BYTE_2_HIGH), _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble));
+    const __m256i special = _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+    // Two continuations in a row are valid exactly 2 bytes after a 3-/4-byte lead or 3 bytes after a 4-byte lead.
+    const __m256i prev2 = _mm256_alignr_epi8(input, shifted, 16 - 2);
+    const __m256i prev3 = _mm256_alignr_epi8(input, shifted, 16 - 3);
+    const __m256i third = _mm256_subs_epu8(prev2, _mm256_set1_epi8(char(0xe0 - 0x80)));
+    const __m256i fourth = _mm256_subs_epu8(prev3, _mm256_set1_epi8(char(0xf0 - 0x80)));
+    const __m256i required = _mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8(char(0x80)));
+    check.error = _mm256_or_si256(check.error, _mm256_xor_si256(required, special));
+    check.incomplete = _mm256_subs_epu8(input, _mm256_load_si256(reinterpret_cast<const __m256i *>(UTF8_INCOMPLETE)));
+    check.previous = input;
+}
+
+[[gnu::target("avx2")]] inline bool utf8_validate(const u8 * data, usize size) {
+    Utf8Check check = {_mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256()};
+    for(; size >= 64; size -= 64, data += 64) {
+        utf8_check(check, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data)));
+        utf8_check(check, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + 32)));
+    }
+    if(size >= 32) {
+        utf8_check(check, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data)));
+        size -= 32;
+        data += 32;
+    }
+    if(size > 0) {
+        // Zero padding is ASCII: a sequence cut off by the end of the input is reported as too short.
+        alignas(32) u8 tail[32] = {};
+        std::memcpy(tail, data, size);
+        utf8_check(check, _mm256_load_si256(reinterpret_cast<const __m256i *>(tail)));
+    }
+    return _mm256_testz_si256(_mm256_or_si256(check.error, check.incomplete), _mm256_set1_epi8(-1)) != 0;
+}
+
+/// \brief Transcode valid UTF-8, ASCII blocks of 32 bytes are zero-extended to 32 units.
+[[gnu::target("avx2")]] inline u8 * utf8_to_utf16(const u8 * data, usize size, u8 * out) {
+    const u8 * const end = data + size;
+    while(end - data >= 32) {
+        const __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data));
+        if(_mm256_movemask_epi8(input) == 0) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), _mm256_cvtepu8_epi16(_mm256_castsi256_si128(input)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + 32), _mm256_cvtepu8_epi16(_mm256_extracti128_si256(input, 1)));
+            data += 32;
+            out += 64;
+            continue;
+        }
+        // Whole sequences, the last one may end past the block.
+        for(const u8 * const block = data + 32; data < block;) {
+            if(end - data >= 8 && utf8_ascii_8(data)) {
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_cvtepu8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(data))));
+                data += 8;
+                out += 16;
+                continue;
+            }
+            out = utf16_encode(out, utf8_decode(data));
+        }
+    }
+    return scalar::utf8_to_utf16(data, usize(end - data), out);
+}
+
+/// \brief Transcode valid UTF-8, ASCII blocks of 32 bytes are zero-extended to 32 units.
+[[gnu::target("avx2")]] inline u8 * utf8_to_utf32(const u8 * data, usize size, u8 * out) {
+    const u8 * const end = data + size;
+    while(end - data >= 32) {
+        const __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data));
+        if(_mm256_movemask_epi8(input) == 0) {
+            for(usize i = 0; i < 4; ++i) {
+                const __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(data + 8 * i));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + 32 * i), _mm256_cvtepu8_epi32(bytes));
+            }
+            data += 32;
+            out += 128;
+            continue;
+        }
+        for(const u8 * const block = data + 32; data < block;) {
+            if(end - data >= 8 && utf8_ascii_8(data)) {
+                const __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(data));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), _mm256_cvtepu8_epi32(bytes));
+                data += 8;
+                out += 32;
+                continue;
+            }
+            out = utf32_encode(out, utf8_decode(data));
+        }
+    }
+    return scalar::utf8_to_utf32(data, usize(end - data), out);
+}
+
+/// \brief Transcode count UTF-16 units, ASCII blocks of 16 units are narrowed to 16 bytes.
+[[gnu::target("avx2")]] inline u8 * utf16_to_utf8(const u8 * data, usize count, u8 * out) {
+    const u8 * const end = data + 2 * count;
+    while(end - data >= 32) {
+        const __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data));
+        if(_mm256_testz_si256(input, _mm256_set1_epi16(i16(0xff80)))) {
+            const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(input, input), 0xd8);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm256_castsi256_si128(packed));
+            data += 32;
+            out += 16;
+            continue;
+        }
+        out = utf16_to_utf8_scalar(data, data + 32, end, out);
+        if(out == nullptr) {
+            return nullptr;
+        }
+    }
+    return utf16_to_utf8_scalar(data, end, end, out);
+}
+
+/// \brief Transcode count UTF-32 units, ASCII blocks of 8 units are narrowed to 8 bytes.
+[[gnu::target("avx2")]] inline u8 * utf32_to_utf8(const u8 * data, usize count, u8 * out) {
+    const u8 * const end = data + 4 * count;
+    while(end - data >= 32) {
+        const __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data));
+        if(_mm256_testz_si256(input, _mm256_set1_epi32(i32(0xffffff80)))) {
+            const __m128i words = _mm_packus_epi32(_mm256_castsi256_si128(input), _mm256_extracti128_si256(input, 1));
+            _mm_storel_epi64(reinterpret_cast<__m128i *>(out), _mm_packus_epi16(words, words));
+            data += 32;
+            out += 8;
+            continue;
+        }
+        out = utf32_to_utf8_scalar(data, data + 32, out);
+        if(out == nullptr) {
+            return nullptr;
+        }
+    }
+    return utf32_to_utf8_scalar(data, end, out);
+}
+
+}
+
+#endif
+
+inline usize utf8_code_points(const u8 * data, usize size) {
+#if defined(__x86_64__) || defined(__i386__)
+    switch(cpu_tier()) {
+        case CpuTier::avx512:
+        case CpuTier::avx2: return avx2::utf8_code_points(data, size);
+        case CpuTier::sse42:
+        case CpuTier::sse2:
+        case CpuTier::scalar: break;
+    }
+#endif
+    return scalar::utf8_code_points(data, size);
+}
+
+inline usize utf8_utf16_units(const u8 * data, usize size) {
+#if defined(__x86_64__) || defined(__i386__)
+    switch(cpu_tier()) {
+        case CpuTier::avx512:
+        case CpuTier::avx2: return avx2::utf8_utf16_units(data, size);
+        case CpuTier::sse42:
+        case CpuTier::sse2:
+        case CpuTier::scalar: break;
+    }
+#endif
+    return scalar::utf8_utf16_units(data, size);
+}
+
+inline usize utf16_utf8_length(const u8 * data, usize count) {
+#if defined(__x86_64__) || defined(__i386__)
+    switch(cpu_tier()) {
+        case CpuTier::avx512:
+        case CpuTier::avx2: return avx2::utf16_utf8_length(data, count);
+        case CpuTier::sse42:
+        case CpuTier::sse2:
+        case CpuTier::scalar: break;
+    }
+#endif
+    return scalar::utf16_utf8_length(data, count);
+}
+
+inline usize utf32_utf8_length(const u8 * data, usize count) {
+#if defined(__x86_64__) || defined(__i386__)
+    switch(cpu_tier()) {
+        case CpuTier::avx512:
+        case CpuTier::avx2: return avx2::utf32_utf8_length(data, count);
+        case CpuTier::sse42:
+        case CpuTier::sse2:
+        case CpuTier::scalar: break;
+    }
+#endif
+    return scalar::utf32_utf8_length(data, count);
+}
+
+inline bool is_ascii(const u8 * data, usize size) {
+#if defined(__x86_64__) || defined(__i386__)
+    switch(cpu_tier()) {
+        case CpuTier::avx512:
+        case CpuTier::avx2: return avx2::is_ascii(data, size);
+        case CpuTier::sse42:
+        case CpuTier::sse2: return sse2::is_ascii(data, size);
+        case CpuTier::scalar: break;
+    }
+#endif
+    return scalar::is_ascii(data, size);
+}
+
+inline bool utf8_validate(const u8 * data, usize size) {
+#if defined(__x86_64__) || defined(__i386__)
+    switch(cpu_tier()) {
+        case CpuTier::avx512:
+        case CpuTier::avx2: return avx2::utf8_validate(data, size);
+        case CpuTier::sse42: return sse42::utf8_validate(data, size);
+        case CpuTier::sse2:
+        case CpuTier::scalar: break;
+    }
+#endif
+    return scalar::utf8_validate(data, size);
+}
+
+inline u8 * utf8_to_utf16(const u8 * data, usize size, u8 * out) {
+#if defined(__x86_64__) || defined(__i386__)
+    switch(cpu_tier()) {
+        case CpuTier::avx512:
+        case CpuTier::avx2: return avx2::utf8_to_utf16(data, size, out);
+        case CpuTier::sse42:
+        case CpuTier::sse2:
+        case CpuTier::scalar: break;
+    }
+#endif
+    return scalar::utf8_to_utf16(data, size, out);
+}
+
+inline u8 * utf8_to_utf32(const u8 * data, usize size, u8 * out) {
+#if defined(__x86_64__) || defined(__i386__)
+    switch(cpu_tier()) {
+        case CpuTier::avx512:
+        case CpuTier::avx2: return avx2::utf8_to_utf32(data, size, out);
+        case CpuTier::sse42:
+        case CpuTier::sse2:
+        case CpuTier::scalar: break;
+    }
+#endif
+    return scalar::utf8_to_utf32(data, size, out);
+}
+
+inline u8 * utf16_to_utf8(const u8 * data, usize count, u8 * out) {
+#if defined(__x86_64__) || defined(__i386__)
+    switch(cpu_tier()) {
+        case CpuTier::avx512:
+        case CpuTier::avx2: return avx2::utf16_to_utf8(data, count, out);
+        case CpuTier::sse42:
+        case CpuTier::sse2:
+        case CpuTier::scalar: break;
+    }
+#endif
+    return scalar::utf16_to_utf8(data, count, out);
+}
+
+inline u8 * utf32_to_utf8(const u8 * data, usize count, u8 * out) {
+#if defined(__x86_64__) || defined(__i386__)
+    switch(cpu_tier()) {
+        case CpuTier::avx512:
+        case CpuTier::avx2: return avx2::utf32_to_utf8(data, count, out);
+        case CpuTier::sse42:
+        case CpuTier::sse2:
+        case CpuTier::scalar: break;
+    }
+#endif
+    return scalar::utf32_to_utf8(data, count, out);
+}
+
+}
+
+/// \brief true if every byte of buffer is below 0x80 (ASCII is valid UTF-8 and needs no decoding).
+[[nodiscard, gnu::always_inline]] inline bool is_ascii(ConstBuffer buffer) {
+    return kernels::is_ascii(buffer.data, buffer.size);
+}
+
+/**
+ * \brief true if buffer is valid UTF-8 (RFC 3629).
+ *
+ * Rejects overlong encodings, surrogates (U+D800 - U+DFFF), code points above U+10FFFF, stray continuation bytes
+ * and a sequence cut off by the end of the buffer. An empty buffer is valid.
+ */
+[[nodiscard, gnu::always_inline]] inline bool utf8_validate(ConstBuffer buffer) {
+    return kernels::utf8_validate(buffer.data, buffer.size);
+}
+
+/// \brief Exact number of bytes utf8_to_utf16 writes for valid utf8.
+[[nodiscard, gnu::always_inline]] inline usize utf8_to_utf16_size(ConstBuffer utf8) {
+    return 2 * kernels::utf8_utf16_units(utf8.data, utf8.size);
+}
+
+/// \brief Exact number of bytes utf8_to_utf32 writes for valid utf8.
+[[nodiscard, gnu::always_inline]] inline usize utf8_to_utf32_size(ConstBuffer utf8) {
+    return 4 * kernels::utf8_code_points(utf8.data, utf8.size);
+}
+
+/// \brief Exact number of bytes utf16_to_utf8 writes for valid utf16.
+[[nodiscard, gnu::always_inline]] inline usize utf16_to_utf8_size(ConstBuffer utf16) {
+    return kernels::utf16_utf8_length(utf16.data, utf16.size / 2);
+}
+
+/// \brief Exact number of bytes utf32_to_utf8 writes for valid utf32.
+[[nodiscard, gnu::always_inline]] inline usize utf32_to_utf8_size(ConstBuffer utf32) {
+    return kernels::utf32_utf8_length(utf32.data, utf32.size / 4);
+}
+
+/**
+ * \brief Transcode UTF-8 input into native-endian UTF-16 units in the first utf8_to_utf16_size(input) bytes of
+ *        output, which are consumed.
+ * \code
+ * const ConstBuffer name = frame.pop_buffer(name_size);
+ * if(name.data == nullptr || not utf8_to_utf16(name, output)) {
+ *     // Truncated frame, invalid UTF-8 or not enough space in output
+ * }
+ * \endcode
+ * \return true if OK, false if input is not valid UTF-8 or output is too small (output is unchanged).
+ */
+[[nodiscard, gnu::always_inline]] inline bool utf8_to_utf16(ConstBuffer input, MutableBuffer & output) {
+    if(not utf8_validate(input)) {
+        return false;
+    }
+    const usize size = utf8_to_utf16_size(input);
+    if(output.size < size) {
+        return false;
+    }
+    kernels::utf8_to_utf16(input.data, input.size, output.data);
+    return output.skip(size);
+}
+
+/**
+ * \brief Transcode UTF-8 input into native-endian UTF-32 units in the first utf8_to_utf32_size(input) bytes of
+ *        output, which are consumed.
+ * \return true if OK, false if input is not valid UTF-8 or output is too small (output is unchanged).
+ */
+[[nodiscard, gnu::always_inline]] inline bool utf8_to_utf32(ConstBuffer input, MutableBuffer & output) {
+    if(not utf8_validate(input)) {
+        return false;
+    }
+    const usize size = utf8_to_utf32_size(input);
+    if(output.size < size) {
+        return false;
+    }
+    kernels::utf8_to_utf32(input.data, input.size, output.data);
+    return output.skip(size);
+}
+
+/**
+ * \brief Transcode native-endian UTF-16 units of input into UTF-8 in the first utf16_to_utf8_size(input) bytes of
+ *        output, which are consumed.
+ * \return true if OK, false if input has an odd size or an unpaired surrogate, or output is too small
+ *         (output.data / .size are unchanged, bytes in output may be overwritten).
+ */
+[[nodiscard, gnu::always_inline]] inline bool utf16_to_utf8(ConstBuffer input, MutableBuffer & output) {
+    const usize size = utf16_to_utf8_size(input);
+    if(input.size % 2 != 0 || output.size < size) {
+        return false;
+    }
+    // Writes stay within size: every unit up to an unpaired surrogate is counted with its encoded length.
+    return kernels::utf16_to_utf8(input.data, input.size / 2, output.data) != nullptr && output.skip(size);
+}
+
+/**
+ * \brief Transcode native-endian UTF-32 units of input into UTF-8 in the first utf32_to_utf8_size(input) bytes of
+ *        output, which are consumed.
+ * \return true if OK, false if input size is not a multiple of 4, a unit is a surrogate or above U+10FFFF, or output
+ *         is too small (output.data / .size are unchanged, bytes in output may be overwritten).
+ */
+[[nodiscard, gnu::always_inline]] inline bool utf32_to_utf8(ConstBuffer input, MutableBuffer & output) {
+    const usize size = utf32_to_utf8_size(input);
+    if(input.size % 4 != 0 || output.size < size) {
+        return false;
+    }
+    return kernels::utf32_to_utf8(input.data, input.size / 4, output.data) != nullptr && output.skip(size);
+}
+
+}
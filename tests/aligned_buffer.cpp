@@ -0,0 +1,159 @@
+#include "helpers/all.h"
+
+#include "tests/test.h"
+
+#include "bits/stdc++.h"
+
+namespace sedfer::test {
+
+static void storage() {
+    AlignedStorage<4096> storage(5000);
+    const AlignedBuffer<4096> buffer = storage.buffer();
+    EXPECT(buffer.data != nullptr, "");
+    EXPECT(reinterpret_cast<uintptr_t>(buffer.data) % 4096 == 0, "");
+    EXPECT(buffer.size == 8192, "size " << buffer.size);
+
+    EXPECT(AlignedStorage<64>::round_up(0) == 0, "");
+    EXPECT(AlignedStorage<64>::round_up(1) == 64, "");
+    EXPECT(AlignedStorage<64>::round_up(64) == 64, "");
+    EXPECT(AlignedStorage<64>::round_up(65) == 128, "");
+
+    AlignedStorage<64> empty;
+    EXPECT(empty.buffer().data == nullptr, "");
+    EXPECT(empty.buffer().size == 0, "size " << empty.buffer().size);
+}
+
+static void from() {
+    alignas(64) u8 bytes[256];
+
+    const AlignedBuffer<64> ok = AlignedBuffer<64>::from({bytes, 128});
+    EXPECT(ok.data == bytes, "");
+    EXPECT(ok.size == 128, "size " << ok.size);
+
+    const AlignedBuffer<64> bad_data = AlignedBuffer<64>::from({bytes + 1, 128});
+    EXPECT(bad_data.data == nullptr, "");
+    EXPECT(bad_data.size == 0, "size " << bad_data.size);
+
+    const AlignedBuffer<64> bad_size = AlignedBuffer<64>::from({bytes, 100});
+    EXPECT(bad_size.data == nullptr, "");
+    EXPECT(bad_size.size == 0, "size " << bad_size.size);
+}
+
+static void conversions() {
+    alignas(64) u8 bytes[256];
+    const AlignedBuffer<64> aligned = AlignedBuffer<64>::from(bytes);
+
+    const AlignedBuffer<16> weaker = aligned;
+    EXPECT(weaker.data == bytes, "");
+    EXPECT(weaker.size == 256, "size " << weaker.size);
+
+    const MutableBuffer mutable_buffer = aligned;
+    EXPECT(mutable_buffer.data == bytes, "");
+    EXPECT(mutable_buffer.size == 256, "size " << mutable_buffer.size);
+
+    const ConstBuffer const_buffer = aligned;
+    EXPECT(const_buffer.data == bytes, "");
+    EXPECT(const_buffer.size == 256, "size " << const_buffer.size);
+
+    static_assert(std::is_convertible_v<AlignedBuffer<64>, AlignedBuffer<16>>);
+    static_assert(not std::is_convertible_v<AlignedBuffer<16>, AlignedBuffer<64>>);
+}
+
+static void pop_buffer() {
+    alignas(64) u8 bytes[256];
+    AlignedBuffer<64> buffer = AlignedBuffer<64>::from(bytes);
+
+    const AlignedBuffer<64> bad = buffer.pop_buffer(10);
+    EXPECT(bad.data == nullptr, "");
+    EXPECT(buffer.data == bytes, "");
+    EXPECT(buffer.size == 256, "size " << buffer.size);
+
+    const AlignedBuffer<64> first = buffer.pop_buffer(64);
+    EXPECT(first.data == bytes, "");
+    EXPECT(first.size == 64, "size " << first.size);
+    EXPECT(buffer.data == bytes + 64, "");
+    EXPECT(buffer.size == 192, "size " << buffer.size);
+
+    const AlignedBuffer<64> last = buffer.pop_buffer_back(128);
+    EXPECT(last.data == bytes + 128, "");
+    EXPECT(last.size == 128, "size " << last.size);
+    EXPECT(buffer.data == bytes + 64, "");
+    EXPECT(buffer.size == 64, "size " << buffer.size);
+
+    EXPECT(buffer.pop_buffer_back(65).data == nullptr, "");
+    EXPECT(buffer.pop_buffer(128).data == nullptr, "");
+    EXPECT(buffer.size == 64, "size " << buffer.size);
+}
+
+static void skip() {
+    alignas(64) u8 bytes[256];
+    AlignedBuffer<64> buffer = AlignedBuffer<64>::from(bytes);
+
+    EXPECT(not buffer.skip(1), "");
+    EXPECT(not buffer.skip_back(63), "");
+    EXPECT(not buffer.skip(320), "");
+    EXPECT(buffer.data == bytes, "");
+    EXPECT(buffer.size == 256, "size " << buffer.size);
+
+    EXPECT(buffer.skip(64), "");
+    EXPECT(buffer.skip_back(64), "");
+    EXPECT(buffer.data == bytes + 64, "");
+    EXPECT(buffer.size == 128, "size " << buffer.size);
+}
+
+static void direct_file() {
+    char path[] = "/tmp/sedfer_direct_file_XXXXXX";
+    const int fd = mkstemp(path);
+    ASSERT(fd >= 0);
+    close(fd);
+
+    AlignedStorage<DirectFile::ALIGNMENT> storage(3 * DirectFile::ALIGNMENT);
+    const DirectFile::Buffer buffer = storage.buffer();
+    for(usize i = 0; i < buffer.size; ++i) {
+        buffer.data[i] = u8(i * 31);
+    }
+
+    {
+        DirectFile file(path, O_WRONLY | O_TRUNC);
+        EXPECT(file.is_open(), "errno " << errno);
+        EXPECT(file.write(buffer, 0), "errno " << errno);
+        EXPECT(not file.write(buffer, 100), "");
+        EXPECT(errno == EINVAL, "errno " << errno);
+        EXPECT(file.truncate(2 * DirectFile::ALIGNMENT + 100), "errno " << errno);
+    }
+
+    {
+        DirectFile file(path, O_RDONLY);
+        EXPECT(file.is_open(), "errno " << errno);
+
+        AlignedStorage<DirectFile::ALIGNMENT> read_storage(4 * DirectFile::ALIGNMENT);
+        const DirectFile::Buffer read_buffer = read_storage.buffer();
+
+        const isize read = file.read(read_buffer, 0);
+        EXPECT(read == isize(2 * DirectFile::ALIGNMENT + 100), "read " << read);
+        EXPECT(std::equal(buffer.data, buffer.data + 2 * DirectFile::ALIGNMENT + 100, read_buffer.data), "");
+
+        const isize read_tail = file.read(read_buffer, 2 * DirectFile::ALIGNMENT);
+        EXPECT(read_tail == 100, "read " << read_tail);
+        EXPECT(std::equal(buffer.data + 2 * DirectFile::ALIGNMENT, buffer.data + 2 * DirectFile::ALIGNMENT + 100, read_buffer.data), "");
+
+        EXPECT(file.read(read_buffer, 3 * DirectFile::ALIGNMENT) == 0, "");
+        EXPECT(file.read(read_buffer, 1) == -1, "");
+    }
+
+    DirectFile missing("/nonexistent/sedfer_direct_file", O_RDONLY);
+    EXPECT(not missing.is_open(), "");
+
+    unlink(path);
+}
+
+void test_aligned_buffer() {
+    storage();
+    from();
+    conversions();
+    pop_buffer();
+    skip();
+    direct_file();
+}
+
+}
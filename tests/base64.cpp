@@ -0,0 +1,111 @@
+#include "helpers/all.h"
+
+#include "tests/test.h"
+
+#include "bits/stdc++.h"
+
+namespace sedfer::test {
+
+static std::string encode(std::string_view text, Base64 variant = Base64::standard) {
+    std::string ret(base64_encoded_size(text.size(), variant), '\0');
+    MutableBuffer output(reinterpret_cast<u8 *>(ret.data()), ret.size());
+    if(not base64_encode({reinterpret_cast<const u8 *>(text.data()), text.size()}, output, variant) || output.size != 0) {
+        return "<error>";
+    }
+    return ret;
+}
+
+static std::string decode(std::string_view text, Base64 variant = Base64::standard) {
+    const ConstBuffer input(reinterpret_cast<const u8 *>(text.data()), text.size());
+    std::string ret(base64_decoded_size(input, variant), '\0');
+    MutableBuffer output(reinterpret_cast<u8 *>(ret.data()), ret.size());
+    if(not base64_decode(input, output, variant) || output.size != 0) {
+        return "<error>";
+    }
+    return ret;
+}
+
+static void known_values() {
+    // RFC 4648 test vectors.
+    static const char * const VECTORS[][3] = {
+        {"", "", ""}, {"f", "Zg==", "Zg"}, {"fo", "Zm8=", "Zm8"}, {"foo", "Zm9v", "Zm9v"},
+        {"foob", "Zm9vYg==", "Zm9vYg"}, {"fooba", "Zm9vYmE=", "Zm9vYmE"}, {"foobar", "Zm9vYmFy", "Zm9vYmFy"},
+    };
+    for(const auto & vector : VECTORS) {
+        EXPECT(encode(vector[0]) == vector[1], encode(vector[0]));
+        EXPECT(decode(vector[1]) == vector[0], decode(vector[1]));
+        EXPECT(encode(vector[0], Base64::url) == vector[2], encode(vector[0], Base64::url));
+        EXPECT(decode(vector[2], Base64::url) == vector[0], decode(vector[2], Base64::url));
+    }
+    std::string text(1000, '\0');
+    for(char & c : text) {
+        c = char(rand());
+    }
+    EXPECT(decode(encode(text)) == text, "");
+    EXPECT(decode(encode(text, Base64::url), Base64::url) == text, "");
+    EXPECT(encode("\xfb\xff\xbf") == "+/+/", encode("\xfb\xff\xbf"));
+    EXPECT(encode("\xfb\xff\xbf", Base64::url) == "-_-_", encode("\xfb\xff\xbf", Base64::url));
+}
+
+static void invalid() {
+    for(const char * text : {"Zg=", "Zg", "Z===", "====", "Zg=a", "Z=g=", "Zm9v Zg==", "Zm9v\nZg==", "Zh==", "Zm9=", "Zm-_",
+                             "Zm9vYmFy\x80\x80\x80\x80"}) {
+        EXPECT(decode(text) == "<error>", text);
+    }
+    for(const char * text : {"Zg==", "Z", "Zh", "Zm9", "Zm+/", "Zm9vY"}) {
+        EXPECT(decode(text, Base64::url) == "<error>", text);
+    }
+
+    u8 storage[8];
+    MutableBuffer small(storage, 3);
+    static const u8 FOUR[] = {1, 2, 3, 4};
+    EXPECT(not base64_encode(FOUR, small), "");
+    EXPECT(small.size == 3, small.size);
+    static const char ENCODED[] = "Zm9vYmFy";
+    EXPECT(not base64_decode({reinterpret_cast<const u8 *>(ENCODED), 8}, small), "");
+    EXPECT(small.size == 3, small.size);
+}
+
+/// Round trips of every size up to 300 and long inputs against the scalar kernels, invalid characters at every position.
+static void kernels_match_scalar() {
+    std::vector<u8> bytes(5000);
+    for(u8 & byte : bytes) {
+        byte = u8(rand());
+    }
+    usize failed = 0;
+    for(const kernels::Base64Alphabet * alphabet : {&kernels::BASE64_STANDARD, &kernels::BASE64_URL}) {
+        for(usize size = 0; size <= bytes.size(); size += (size < 300) ? 1 : 1111) {
+            const usize encoded_size = kernels::base64_encoded_size(size, alphabet->padding);
+            std::vector<u8> expected(encoded_size + 1, 0xee);
+            std::vector<u8> actual(encoded_size + 1, 0xee);
+            kernels::scalar::base64_encode(bytes.data(), size, expected.data(), *alphabet);
+            kernels::base64_encode(bytes.data(), size, actual.data(), *alphabet);
+            failed += (expected != actual);
+
+            const usize padding = kernels::base64_padding({actual.data(), encoded_size});
+            std::vector<u8> decoded(size + 32, 0xee);
+            failed += not kernels::base64_decode(actual.data(), encoded_size - padding, decoded.data(), *alphabet);
+            failed += (std::memcmp(decoded.data(), bytes.data(), size) != 0);
+
+            if(size > 0 && size < 100) {
+                for(usize position = 0; position < encoded_size - padding; ++position) {
+                    const u8 original = actual[position];
+                    for(const u8 bad : {u8('='), u8('!'), u8(0x80), u8(0xff), u8(0), u8('.'), u8('{'), u8('@')}) {
+                        actual[position] = bad;
+                        failed += kernels::base64_decode(actual.data(), encoded_size - padding, decoded.data(), *alphabet);
+                    }
+                    actual[position] = original;
+                }
+            }
+        }
+    }
+    EXPECT(failed == 0, "base64 failed " << failed);
+}
+
+void test_base64() {
+    known_values();
+    invalid();
+    kernels_match_scalar();
+}
+
+}
@@ -0,0 +1,141 @@
+#include "helpers/all.h"
+
+#include "tests/test.h"
+
+#include "bits/stdc++.h"
+
+namespace sedfer::test {
+
+using Bitwise = void (*)(u8 *, const u8 *, const u8 *, usize);
+
+static u8 reference(BitOp op, u8 left, u8 right) {
+    switch(op) {
+        case BitOp::xor_: return left ^ right;
+        case BitOp::and_: return left & right;
+        case BitOp::or_: return left | right;
+        case BitOp::andnot: return left & ~right;
+    }
+    return 0;
+}
+
+/// All sizes up to 300, several alignments, into a separate destination and in place (destination == left).
+static void compare_bitwise(const char * name, BitOp op, Bitwise kernel) {
+    std::vector<u8> left(400);
+    std::vector<u8> right(400);
+    std::vector<u8> destination(400);
+    usize failed = 0;
+    for(usize size = 0; size <= 300; ++size) {
+        const usize offset = rand() % 64;
+        for(usize i = 0; i < left.size(); ++i) {
+            left[i] = rand() % 256;
+            right[i] = rand() % 256;
+            destination[i] = rand() % 256;
+        }
+        std::vector<u8> expected = destination;
+        for(usize i = 0; i < size; ++i) {
+            expected[offset + i] = reference(op, left[offset + i], right[i]);
+        }
+        kernel(destination.data() + offset, left.data() + offset, right.data(), size);
+        failed += (destination != expected);
+
+        expected = left;
+        for(usize i = 0; i < size; ++i) {
+            expected[offset + i] = reference(op, left[offset + i], right[i]);
+        }
+        kernel(left.data() + offset, left.data() + offset, right.data(), size);
+        failed += (left != expected);
+    }
+    EXPECT(failed == 0, name << " failed " << failed);
+}
+
+static void kernels_match_reference() {
+    compare_bitwise("bitwise<xor_>", BitOp::xor_, kernels::bitwise<BitOp::xor_>);
+    compare_bitwise("bitwise<and_>", BitOp::and_, kernels::bitwise<BitOp::and_>);
+    compare_bitwise("bitwise<or_>", BitOp::or_, kernels::bitwise<BitOp::or_>);
+    compare_bitwise("bitwise<andnot>", BitOp::andnot, kernels::bitwise<BitOp::andnot>);
+
+    std::vector<u8> bytes(400);
+    usize failed = 0;
+    for(usize size = 0; size <= 300; ++size) {
+        const usize offset = rand() % 64;
+        const u32 pattern = u32(rand()) * 2654435761u;
+        u8 pattern_bytes[4];
+        std::memcpy(pattern_bytes, &pattern, 4);
+        for(u8 & byte : bytes) {
+            byte = rand() % 256;
+        }
+        std::vector<u8> expected = bytes;
+        for(usize i = 0; i < size; ++i) {
+            expected[offset + i] ^= pattern_bytes[i % 4];
+        }
+        kernels::xor_pattern(bytes.data() + offset, bytes.data() + offset, size, pattern);
+        failed += (bytes != expected);
+    }
+    EXPECT(failed == 0, "xor_pattern failed " << failed);
+}
+
+/// Unmasking in chunks with offsets gives the same result as unmasking the whole payload.
+static void xor_mask_chunks() {
+    static const u8 KEY[] = {0x37, 0xfa, 0x21, 0x3d};
+    u32 key;
+    std::memcpy(&key, KEY, 4);
+
+    std::vector<u8> payload(1000);
+    for(usize i = 0; i < payload.size(); ++i) {
+        payload[i] = u8(i * 31);
+    }
+    std::vector<u8> whole = payload;
+    MutableBuffer(whole.data(), whole.size()).xor_mask(key);
+    for(usize i = 0; i < payload.size(); ++i) {
+        EXPECT(whole[i] == (payload[i] ^ KEY[i % 4]), "at " << i);
+    }
+
+    std::vector<u8> chunked = payload;
+    for(usize offset = 0; offset < chunked.size();) {
+        const usize size = std::min<usize>(1 + rand() % 100, chunked.size() - offset);
+        MutableBuffer(chunked.data() + offset, size).xor_mask(key, offset);
+        offset += size;
+    }
+    EXPECT(chunked == whole, "");
+
+    std::vector<u8> copy(payload.size());
+    EXPECT(xor_mask({copy.data(), copy.size()}, {whole.data(), whole.size()}, key), "");
+    EXPECT(copy == payload, "");
+    EXPECT(not xor_mask({copy.data(), 3}, {whole.data(), 4}, key), "");
+}
+
+static void buffer_operations() {
+    u8 left[] = {0b1100, 0b1010, 0xff, 0x00, 0x0f};
+    const u8 right[] = {0b1010, 0b1010, 0x0f, 0xff, 0xf0};
+    u8 destination[5] = {};
+
+    EXPECT(bitwise<BitOp::andnot>(destination, left, right), "");
+    const u8 andnot_expected[] = {0b0100, 0, 0xf0, 0x00, 0x0f};
+    EXPECT(std::equal(destination, destination + 5, andnot_expected), "");
+    EXPECT(not bitwise<BitOp::xor_>(destination, left, ConstBuffer(right, 4)), "");
+
+    EXPECT(invert(destination, left), "");
+    const u8 invert_expected[] = {0xf3, 0xf5, 0x00, 0xff, 0xf0};
+    EXPECT(std::equal(destination, destination + 5, invert_expected), "");
+
+    const MutableBuffer buffer = left;
+    EXPECT(buffer.or_with(right), "");
+    const u8 or_expected[] = {0b1110, 0b1010, 0xff, 0xff, 0xff};
+    EXPECT(std::equal(left, left + 5, or_expected), "");
+    EXPECT(buffer.and_with(right), "");
+    EXPECT(std::equal(left, left + 5, right), "");
+    EXPECT(buffer.xor_with(right), "");
+    EXPECT(std::all_of(left, left + 5, [](u8 byte) { return byte == 0; }), "");
+    EXPECT(buffer.andnot_with(right), "");
+    buffer.invert();
+    EXPECT(std::all_of(left, left + 5, [](u8 byte) { return byte == 0xff; }), "");
+    EXPECT(not buffer.xor_with(ConstBuffer(right, 4)), "");
+}
+
+void test_bitwise() {
+    kernels_match_reference();
+    xor_mask_chunks();
+    buffer_operations();
+}
+
+}
@@ -0,0 +1,92 @@
+#include "helpers/all.h"
+
+#include "tests/test.h"
+
+#include "bits/stdc++.h"
+
+namespace sedfer::test {
+
+static void from_and_resolve() {
+    const u8 bytes[] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09};
+    const ConstBuffer arena = bytes;
+
+    const CompactBuffer middle = CompactBuffer::from(arena, {bytes + 2, 3});
+    EXPECT(middle.valid(), "");
+    EXPECT(middle.offset == 2, "offset " << middle.offset);
+    EXPECT(middle.size == 3, "size " << middle.size);
+    EXPECT(middle.resolve(arena).data == bytes + 2, "");
+    EXPECT(middle.resolve(arena).size == 3, "size " << middle.resolve(arena).size);
+
+    const CompactBuffer whole = CompactBuffer::from(arena, arena);
+    EXPECT(whole.valid(), "");
+    EXPECT(whole.resolve(arena).data == bytes, "");
+    EXPECT(whole.resolve(arena).size == 9, "");
+
+    const CompactBuffer empty_at_end = CompactBuffer::from(arena, {bytes + 9, 0});
+    EXPECT(empty_at_end.valid(), "");
+    EXPECT(empty_at_end.resolve(arena).data == bytes + 9, "");
+    EXPECT(empty_at_end.resolve(arena).size == 0, "");
+
+    EXPECT(not CompactBuffer::from(arena, {bytes + 8, 2}).valid(), "");
+    EXPECT(not CompactBuffer::from(arena, {bytes + 10, 0}).valid(), "");
+    EXPECT(not CompactBuffer::from({bytes + 1, 8}, {bytes, 1}).valid(), "");
+    EXPECT(not CompactBuffer::from(arena, {}).valid(), "");
+
+    EXPECT(middle.resolve({bytes, 4}).data == nullptr, "");
+    EXPECT(CompactBuffer::invalid().resolve(arena).data == nullptr, "");
+}
+
+static void compare_handles() {
+    const CompactBuffer a{1, 5};
+    const CompactBuffer b{1, 6};
+    const CompactBuffer c{2, 0};
+
+    EXPECT(a == a, "");
+    EXPECT(a != b, "");
+    EXPECT(a < b, "");
+    EXPECT(b < c, "");
+    EXPECT(a.as_u64() < b.as_u64(), "");
+    EXPECT(b.as_u64() < c.as_u64(), "");
+
+    EXPECT(std::hash<CompactBuffer>()(a) == std::hash<CompactBuffer>()(CompactBuffer{1, 5}), "");
+    EXPECT(std::hash<CompactBuffer>()(a) != std::hash<CompactBuffer>()(b), "");
+
+    std::unordered_set<CompactBuffer> set = {a, b, c, a};
+    EXPECT(set.size() == 3, "size " << set.size());
+}
+
+static void compare_content() {
+    const char text[] = "banana apple cherry apple";
+    const ConstBuffer arena(reinterpret_cast<const u8 *>(text), sizeof(text) - 1);
+
+    std::vector<CompactBuffer> words = {
+        CompactBuffer::from(arena, {arena.data + 0, 6}),
+        CompactBuffer::from(arena, {arena.data + 7, 5}),
+        CompactBuffer::from(arena, {arena.data + 13, 6}),
+        CompactBuffer::from(arena, {arena.data + 20, 5}),
+    };
+
+    std::sort(words.begin(), words.end(), CompactBuffer::Less{arena});
+    EXPECT(words[0].offset == 7 || words[0].offset == 20, "offset " << words[0].offset);
+    EXPECT(words[1].offset == 7 || words[1].offset == 20, "offset " << words[1].offset);
+    EXPECT(words[2].offset == 0, "offset " << words[2].offset);
+    EXPECT(words[3].offset == 13, "offset " << words[3].offset);
+
+    const CompactBuffer::Equal equal_content{arena};
+    const CompactBuffer::Hash hash_content{arena};
+    EXPECT(equal_content(words[0], words[1]), "");
+    EXPECT(not equal_content(words[0], words[2]), "");
+    EXPECT(hash_content(words[0]) == hash_content(words[1]), "");
+
+    std::unordered_set<CompactBuffer, CompactBuffer::Hash, CompactBuffer::Equal> unique(0, hash_content, equal_content);
+    unique.insert(words.begin(), words.end());
+    EXPECT(unique.size() == 3, "size " << unique.size());
+}
+
+void test_compact_buffer() {
+    from_and_resolve();
+    compare_handles();
+    compare_content();
+}
+
+}
@@ -0,0 +1,56 @@
+#include "helpers/all.h"
+
+#include "tests/test.h"
+
+#include "bits/stdc++.h"
+
+namespace sedfer::test {
+
+static usize reference_mismatch(const u8 * left, const u8 * right, usize size) {
+    return std::mismatch(left, left + size, right).first - left;
+}
+
+static int sign(int value) {
+    return (value > 0) - (value < 0);
+}
+
+/// Buffers are equal except for one random byte (or none), for all sizes up to 300 and several alignments.
+template<typename F>
+static void for_each_case(F f) {
+    std::vector<u8> left(400);
+    std::vector<u8> right(400);
+    for(usize size = 0; size <= 300; ++size) {
+        for(usize offset = 0; offset < 64; offset += 7) {
+            for(usize i = 0; i < left.size(); ++i) {
+                left[i] = right[i] = rand() % 256;
+            }
+            if(size != 0 && rand() % 4 != 0) {
+                right[offset + rand() % size] = rand() % 256;
+            }
+            f(left.data() + offset, right.data() + (offset * 3) % 64, size);
+        }
+    }
+}
+
+static void kernels_match_reference() {
+    usize failed = 0;
+    for_each_case([&](const u8 * left, const u8 * right, usize size) {
+        const int expected = sign(std::memcmp(left, right, size));
+        failed += (expected != sign(kernels::compare(left, right, size)));
+        failed += (expected != sign(-kernels::compare(right, left, size)));
+        failed += ((expected == 0) != kernels::equal(left, right, size));
+    });
+    EXPECT(failed == 0, "compare/equal failed " << failed);
+
+    failed = 0;
+    for_each_case([&](const u8 * left, const u8 * right, usize size) {
+        failed += (reference_mismatch(left, right, size) != kernels::mismatch(left, right, size));
+    });
+    EXPECT(failed == 0, "mismatch failed " << failed);
+}
+
+void test_compare() {
+    kernels_match_reference();
+}
+
+}
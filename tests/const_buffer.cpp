@@ -1664,6 +1664,232 @@ static void skip_back() {
     EXPECT(buffer.size == 9, "size " << buffer.size);
 }
 
+static void find() {
+    const u8 bytes[] = {0x01, 0x02, 0x03, 0x02, 0x05, 0x06, 0x07, 0x08, 0x09};
+    const ConstBuffer buffer = bytes;
+
+    const ConstBuffer found = buffer.find(u8(0x02));
+    EXPECT(found.data == bytes + 1, "");
+    EXPECT(found.size == 8, "size " << found.size);
+
+    const ConstBuffer found_last = buffer.find(u8(0x09));
+    EXPECT(found_last.data == bytes + 8, "");
+    EXPECT(found_last.size == 1, "size " << found_last.size);
+
+    EXPECT(buffer.find(u8(0x04)).data == nullptr, "");
+    EXPECT(buffer.find(u8(0x04)).size == 0, "");
+    EXPECT(ConstBuffer().find(u8(0x00)).data == nullptr, "");
+
+    EXPECT(buffer.data == bytes, "");
+    EXPECT(buffer.size == 9, "size " << buffer.size);
+}
+
+static void find_last() {
+    const u8 bytes[] = {0x01, 0x02, 0x03, 0x02, 0x05, 0x06, 0x07, 0x08, 0x09};
+    const ConstBuffer buffer = bytes;
+
+    const ConstBuffer found = buffer.find_last(u8(0x02));
+    EXPECT(found.data == bytes + 3, "");
+    EXPECT(found.size == 6, "size " << found.size);
+
+    const ConstBuffer found_first = buffer.find_last(u8(0x01));
+    EXPECT(found_first.data == bytes, "");
+    EXPECT(found_first.size == 9, "size " << found_first.size);
+
+    EXPECT(buffer.find_last(u8(0x04)).data == nullptr, "");
+    EXPECT(ConstBuffer().find_last(u8(0x00)).data == nullptr, "");
+}
+
+static void find_first_of() {
+    const char text[] = "key = value; next";
+    const ConstBuffer buffer(reinterpret_cast<const u8 *>(text), sizeof(text) - 1);
+
+    const ConstBuffer found = buffer.find_first_of(ByteSet("=;"));
+    EXPECT(found.data == buffer.data + 4, "");
+    EXPECT(found.size == 13, "size " << found.size);
+
+    const ConstBuffer found_not = buffer.find_first_not_of(ByteSet("aeky "));
+    EXPECT(found_not.data == buffer.data + 4, "");
+
+    EXPECT(buffer.find_first_of(ByteSet("#!")).data == nullptr, "");
+    EXPECT(buffer.find_first_not_of(~ByteSet()).data == nullptr, "");
+    EXPECT(buffer.find_first_of(ByteSet()).data == nullptr, "");
+    EXPECT(buffer.find_first_not_of(ByteSet()).data == buffer.data, "");
+}
+
+static void pop_until() {
+    const char text[] = "a,bc,,d";
+    ConstBuffer buffer(reinterpret_cast<const u8 *>(text), sizeof(text) - 1);
+
+    const ConstBuffer a = buffer.pop_until(',');
+    EXPECT(a.data == buffer.data - 2, "");
+    EXPECT(a.size == 1 && a.data[0] == 'a', "size " << a.size);
+    EXPECT(buffer.size == 5, "size " << buffer.size);
+
+    const ConstBuffer bc = buffer.pop_until(',');
+    EXPECT(bc.size == 2 && bc.data[0] == 'b' && bc.data[1] == 'c', "size " << bc.size);
+
+    const ConstBuffer empty = buffer.pop_until(',');
+    EXPECT(empty.data != nullptr, "");
+    EXPECT(empty.size == 0, "size " << empty.size);
+
+    const u8 * const before = buffer.data;
+    const ConstBuffer none = buffer.pop_until(',');
+    EXPECT(none.data == nullptr, "");
+    EXPECT(buffer.data == before, "");
+    EXPECT(buffer.size == 1 && buffer.data[0] == 'd', "size " << buffer.size);
+}
+
+static void find_substring() {
+    const char text[] = "GET /a HTTP/1.1\r\nHost: x\r\n\r\nbody\r\n";
+    const ConstBuffer buffer(reinterpret_cast<const u8 *>(text), sizeof(text) - 1);
+    const ConstBuffer crlf(reinterpret_cast<const u8 *>("\r\n"), 2);
+    const ConstBuffer end_of_headers(reinterpret_cast<const u8 *>("\r\n\r\n"), 4);
+
+    const ConstBuffer found = buffer.find(crlf);
+    EXPECT(found.data == buffer.data + 15, "");
+    EXPECT(found.size == buffer.size - 15, "size " << found.size);
+
+    EXPECT(buffer.find(end_of_headers).data == buffer.data + 24, "");
+    EXPECT(buffer.find_last(crlf).data == buffer.data + 32, "");
+    EXPECT(buffer.find_last(end_of_headers).data == buffer.data + 24, "");
+
+    const ConstBuffer missing(reinterpret_cast<const u8 *>("\n\n"), 2);
+    EXPECT(buffer.find(missing).data == nullptr, "");
+    EXPECT(buffer.find_last(missing).data == nullptr, "");
+    EXPECT(crlf.find(end_of_headers).data == nullptr, "");
+
+    EXPECT(buffer.find(ConstBuffer(buffer.data, 0)).data == buffer.data, "");
+    EXPECT(buffer.find_last(ConstBuffer(buffer.data, 0)).data == buffer.data + buffer.size, "");
+    EXPECT(buffer.find(buffer).data == buffer.data, "");
+
+    // Long needle (Two-Way).
+    std::vector<u8> long_text(1000, 'a');
+    std::vector<u8> long_needle(100, 'a');
+    long_needle.back() = 'b';
+    EXPECT(ConstBuffer(long_text.data(), long_text.size()).find({long_needle.data(), long_needle.size()}).data == nullptr, "");
+    long_text[500] = 'b';
+    EXPECT(ConstBuffer(long_text.data(), long_text.size()).find({long_needle.data(), long_needle.size()}).data == long_text.data() + 401, "");
+    EXPECT(ConstBuffer(long_text.data(), long_text.size()).find_last({long_needle.data(), long_needle.size()}).data == long_text.data() + 401, "");
+}
+
+static void pop_until_substring() {
+    const char text[] = "a\r\n\r\nb\r\nc";
+    ConstBuffer buffer(reinterpret_cast<const u8 *>(text), sizeof(text) - 1);
+    const ConstBuffer crlf(reinterpret_cast<const u8 *>("\r\n"), 2);
+
+    const ConstBuffer a = buffer.pop_until(crlf);
+    EXPECT(a.size == 1 && a.data[0] == 'a', "size " << a.size);
+
+    const ConstBuffer empty = buffer.pop_until(crlf);
+    EXPECT(empty.data != nullptr, "");
+    EXPECT(empty.size == 0, "size " << empty.size);
+
+    const ConstBuffer b = buffer.pop_until(crlf);
+    EXPECT(b.size == 1 && b.data[0] == 'b', "size " << b.size);
+
+    const ConstBuffer none = buffer.pop_until(crlf);
+    EXPECT(none.data == nullptr, "");
+    EXPECT(buffer.size == 1 && buffer.data[0] == 'c', "size " << buffer.size);
+}
+
+static void pop_back_until() {
+    const char text[] = "dir/sub/file";
+    ConstBuffer buffer(reinterpret_cast<const u8 *>(text), sizeof(text) - 1);
+
+    const ConstBuffer file = buffer.pop_back_until('/');
+    EXPECT(file.data == buffer.data + 8, "");
+    EXPECT(file.size == 4, "size " << file.size);
+    EXPECT(buffer.size == 7, "size " << buffer.size);
+
+    const ConstBuffer sub = buffer.pop_back_until('/');
+    EXPECT(sub.size == 3, "size " << sub.size);
+    EXPECT(buffer.size == 3, "size " << buffer.size);
+
+    const ConstBuffer none = buffer.pop_back_until('/');
+    EXPECT(none.data == nullptr, "");
+    EXPECT(buffer.size == 3, "size " << buffer.size);
+}
+
+static void pop_until_first_of() {
+    const char text[] = "  key=value\n";
+    ConstBuffer buffer(reinterpret_cast<const u8 *>(text), sizeof(text) - 1);
+
+    const ConstBuffer spaces = buffer.pop_until_first_not_of(ByteSet(" \t"));
+    EXPECT(spaces.size == 2, "size " << spaces.size);
+    EXPECT(buffer.size == 10 && buffer.data[0] == 'k', "size " << buffer.size);
+
+    const ConstBuffer key = buffer.pop_until_first_of(ByteSet("=:"));
+    EXPECT(key.size == 3 && key.data[0] == 'k', "size " << key.size);
+    EXPECT(buffer.size == 6 && buffer.data[0] == 'v', "size " << buffer.size);
+
+    const ConstBuffer no_spaces = buffer.pop_until_first_not_of(ByteSet(" \t"));
+    EXPECT(no_spaces.data != nullptr, "");
+    EXPECT(no_spaces.size == 0, "size " << no_spaces.size);
+
+    EXPECT(buffer.pop_until_first_of(ByteSet("=:")).data == nullptr, "");
+    EXPECT(buffer.size == 6, "size " << buffer.size);
+
+    EXPECT(buffer.pop_until_first_not_of(~ByteSet()).data == nullptr, "");
+    EXPECT(buffer.size == 6, "size " << buffer.size);
+}
+
+static void compare_buffers() {
+    static const u8 TEXT[] = {'a', 'b', 'c', 'a', 'b', 'd'};
+    const ConstBuffer abc(TEXT, 3);
+    const ConstBuffer abd(TEXT + 3, 3);
+    const ConstBuffer ab(TEXT, 2);
+    const ConstBuffer empty(TEXT, 0);
+
+    EXPECT(compare(abc, abd) == std::strong_ordering::less, "");
+    EXPECT(compare(abd, abc) == std::strong_ordering::greater, "");
+    EXPECT(compare(abc, ConstBuffer(TEXT + 0, 3)) == std::strong_ordering::equal, "");
+    EXPECT(compare(ab, abc) == std::strong_ordering::less, "");
+    EXPECT(compare(abc, ab) == std::strong_ordering::greater, "");
+    EXPECT(compare(empty, ab) == std::strong_ordering::less, "");
+    EXPECT(compare(empty, empty) == std::strong_ordering::equal, "");
+
+    EXPECT(mismatch(abc, abd) == 2, "mismatch " << mismatch(abc, abd));
+    EXPECT(mismatch(ab, abc) == 2, "mismatch " << mismatch(ab, abc));
+    EXPECT(mismatch(empty, abc) == 0, "mismatch " << mismatch(empty, abc));
+
+    EXPECT(BufferLess()(abc, abd), "");
+    EXPECT(not BufferLess()(abd, abc), "");
+    EXPECT(BufferLess()(ab, abc), "");
+    EXPECT(not BufferLess()(abc, abc), "");
+
+    // Bytes compare unsigned, sizes around the 8/16/32-byte paths.
+    std::vector<u8> left(100, 0x80);
+    std::vector<u8> right(100, 0x80);
+    for(usize size = 1; size < 100; ++size) {
+        for(usize i = 0; i < size; ++i) {
+            right[i] = 0x7f;
+            EXPECT(compare({left.data(), size}, {right.data(), size}) > 0, "size " << size << " at " << i);
+            EXPECT(not BufferLess()({left.data(), size}, {right.data(), size}), "size " << size << " at " << i);
+            EXPECT(mismatch({left.data(), size}, {right.data(), size}) == i, "size " << size << " at " << i);
+            EXPECT(not equal({left.data(), size}, {right.data(), size}), "size " << size << " at " << i);
+            right[i] = 0x80;
+        }
+        EXPECT(equal({left.data(), size}, {right.data(), size}), "size " << size);
+    }
+}
+
+static void starts_ends_with() {
+    static const u8 TEXT[] = {'k', 'e', 'y', '=', 'v', 'a', 'l', 'u', 'e'};
+    const ConstBuffer text(TEXT, 9);
+
+    EXPECT(starts_with(text, ConstBuffer(TEXT, 4)), "");
+    EXPECT(starts_with(text, ConstBuffer(TEXT, 0)), "");
+    EXPECT(starts_with(text, text), "");
+    EXPECT(not starts_with(text, ConstBuffer(TEXT + 4, 5)), "");
+    EXPECT(not starts_with(ConstBuffer(TEXT, 3), ConstBuffer(TEXT, 4)), "");
+
+    EXPECT(ends_with(text, ConstBuffer(TEXT + 4, 5)), "");
+    EXPECT(ends_with(text, ConstBuffer(TEXT, 0)), "");
+    EXPECT(not ends_with(text, ConstBuffer(TEXT, 4)), "");
+    EXPECT(not ends_with(ConstBuffer(TEXT + 5, 4), ConstBuffer(TEXT + 4, 5)), "");
+}
+
 void test_const_buffer() {
     constructor_from_parts();
     default_constructor();
@@ -1710,6 +1936,18 @@ void test_const_buffer() {
 
     skip();
     skip_back();
+
+    find();
+    find_last();
+    find_first_of();
+    pop_until();
+    find_substring();
+    pop_until_substring();
+    pop_back_until();
+    pop_until_first_of();
+
+    compare_buffers();
+    starts_ends_with();
 }
 
 }
@@ -0,0 +1,119 @@
+#include "helpers/all.h"
+
+#include "tests/test.h"
+
+#include "bits/stdc++.h"
+
+namespace sedfer::test {
+
+/// All sizes around the size classes, several alignments: copied bytes match and neighbours are untouched.
+static void kernel_matches_memcpy() {
+    std::vector<u8> source(300);
+    std::vector<u8> destination(300);
+    std::vector<u8> expected(300);
+    usize failed = 0;
+    for(usize size = 0; size <= 200; ++size) {
+        for(usize offset = 0; offset < 64; offset += 5) {
+            for(usize i = 0; i < source.size(); ++i) {
+                source[i] = rand() % 256;
+                destination[i] = expected[i] = rand() % 256;
+            }
+            const usize destination_offset = (offset * 3) % 64;
+            std::memcpy(expected.data() + destination_offset, source.data() + offset, size);
+            kernels::copy(destination.data() + destination_offset, source.data() + offset, size);
+            failed += (destination != expected);
+        }
+    }
+    EXPECT(failed == 0, "copy failed " << failed);
+}
+
+static void streaming_matches_memcpy() {
+    std::vector<u8> source(2000);
+    std::vector<u8> destination(2000);
+    std::vector<u8> expected(2000);
+    usize failed = 0;
+    for(usize size = kernels::SMALL_COPY_SIZE; size <= 1500; size += 7) {
+        for(usize offset = 0; offset < 64; offset += 9) {
+            for(usize i = 0; i < source.size(); ++i) {
+                source[i] = rand() % 256;
+                destination[i] = expected[i] = rand() % 256;
+            }
+            const usize destination_offset = (offset * 5) % 64;
+            std::memcpy(expected.data() + destination_offset, source.data() + offset, size);
+            kernels::copy_streaming(destination.data() + destination_offset, source.data() + offset, size);
+            failed += (destination != expected);
+        }
+    }
+    EXPECT(failed == 0, "copy_streaming failed " << failed);
+
+    // copy goes through copy_large to streaming stores from the threshold.
+    const usize threshold = kernels::streaming_copy_threshold;
+    kernels::streaming_copy_threshold = 100;
+    std::iota(source.begin(), source.end(), 0);
+    kernels::copy(destination.data() + 3, source.data() + 1, 1000);
+    EXPECT(std::equal(source.data() + 1, source.data() + 1001, destination.data() + 3), "");
+    kernels::streaming_copy_threshold = threshold;
+}
+
+/// Source and destination in the same array, shifted both ways: same result as memmove (also from the streaming threshold).
+static void overlapping_matches_memmove() {
+    const usize threshold = kernels::streaming_copy_threshold;
+    std::vector<u8> bytes(600);
+    std::vector<u8> expected(600);
+    usize failed = 0;
+    for(const usize streaming_threshold : {threshold, usize(100)}) {
+        kernels::streaming_copy_threshold = streaming_threshold;
+        for(usize size = 0; size <= 300; size += (size < 140) ? 1 : 37) {
+            for(const usize shift : {1, 7, 16, 31, 33, 64, 65, 150}) {
+                for(const bool forward : {true, false}) {
+                    std::iota(bytes.begin(), bytes.end(), 0);
+                    expected = bytes;
+                    u8 * const low = bytes.data() + 100;
+                    u8 * const high = low + shift;
+                    u8 * const destination = forward ? high : low;
+                    const u8 * const source = forward ? low : high;
+                    std::memmove(expected.data() + (destination - bytes.data()), expected.data() + (source - bytes.data()), size);
+                    kernels::copy(destination, source, size);
+                    failed += (bytes != expected);
+                }
+            }
+        }
+    }
+    kernels::streaming_copy_threshold = threshold;
+    EXPECT(failed == 0, "overlapping copy failed " << failed);
+
+    // Compact the unread tail of a buffer to its front.
+    std::vector<u8> storage(200);
+    std::iota(storage.begin(), storage.end(), 0);
+    MutableBuffer front(storage.data(), storage.size());
+    EXPECT(front.push(ConstBuffer(storage.data() + 50, 150)) && storage[0] == 50 && storage[149] == 199, "");
+}
+
+static void buffer_push_pop() {
+    std::vector<u8> source(100);
+    std::iota(source.begin(), source.end(), 1);
+    for(usize size = 0; size <= 100; ++size) {
+        std::vector<u8> storage(110, 0);
+        MutableBuffer output(storage.data() + 5, 100);
+        EXPECT(output.push({source.data(), size}), "size " << size);
+        EXPECT(output.size == 100 - size, "size " << size);
+        EXPECT(std::equal(source.data(), source.data() + size, storage.data() + 5), "size " << size);
+        EXPECT(storage[4] == 0 && storage[5 + size] == 0, "size " << size);
+
+        std::vector<u8> target(size + 2, 0);
+        ConstBuffer input(storage.data() + 5, size);
+        EXPECT(input.pop(MutableBuffer(target.data() + 1, size)), "size " << size);
+        EXPECT(input.size == 0, "size " << size);
+        EXPECT(std::equal(source.data(), source.data() + size, target.data() + 1), "size " << size);
+        EXPECT(target[0] == 0 && target[size + 1] == 0, "size " << size);
+    }
+}
+
+void test_copy() {
+    kernel_matches_memcpy();
+    streaming_matches_memcpy();
+    overlapping_matches_memmove();
+    buffer_push_pop();
+}
+
+}
@@ -0,0 +1,74 @@
+#include "helpers/all.h"
+
+#include "tests/test.h"
+
+#include "bits/stdc++.h"
+
+namespace sedfer::test {
+
+static void parallel_copy() {
+    static constexpr usize SIZE = (usize(5) << 20) + 13;
+    std::vector<u8> source(SIZE);
+    for(usize i = 0; i < SIZE; ++i) {
+        source[i] = u8(i * 7 + i / 4096);
+    }
+
+    CopyPool pool(3, usize(1) << 20);
+    EXPECT(pool.threads() == 3, "threads " << pool.threads());
+
+    // Repeated copies of different sizes reuse the same workers.
+    for(const usize size : {usize(0), usize(100), SIZE / 3, SIZE - 1, SIZE}) {
+        std::vector<u8> destination(SIZE + 2, 0xee);
+        pool.copy(destination.data() + 1, source.data(), size);
+        EXPECT(std::equal(source.data(), source.data() + size, destination.data() + 1), "size " << size);
+        EXPECT(destination[0] == 0xee && destination[size + 1] == 0xee, "size " << size);
+    }
+}
+
+static void push() {
+    std::vector<u8> source(usize(3) << 20, 'x');
+    std::vector<u8> storage(source.size() + 10);
+    CopyPool pool(2, usize(1) << 20);
+
+    MutableBuffer output(storage.data(), storage.size());
+    EXPECT(pool.push(output, {source.data(), source.size()}), "");
+    EXPECT(output.size == 10, "size " << output.size);
+    EXPECT(std::equal(source.begin(), source.end(), storage.begin()), "");
+    EXPECT(not pool.push(output, {source.data(), 11}), "");
+    EXPECT(output.size == 10, "size " << output.size);
+}
+
+/// Back-to-back parallel copies into destinations freed right after: a worker that wakes late must not touch them.
+static void back_to_back() {
+    static constexpr usize MAX_SIZE = usize(3) << 20;
+    std::vector<u8> source(MAX_SIZE);
+    for(usize i = 0; i < MAX_SIZE; ++i) {
+        source[i] = u8(i + i / 251);
+    }
+    CopyPool pool(4, usize(1) << 20);
+    usize failed = 0;
+    for(usize i = 0; i < 200; ++i) {
+        const usize size = (usize(1) << 20) + usize(rand()) % (MAX_SIZE - (usize(1) << 20));
+        const std::unique_ptr<u8[]> destination(new u8[size]);
+        pool.copy(destination.get(), source.data(), size);
+        failed += not std::equal(source.data(), source.data() + size, destination.get());
+    }
+    EXPECT(failed == 0, "failed " << failed);
+}
+
+static void single_thread() {
+    std::vector<u8> source(usize(2) << 20, 'y');
+    std::vector<u8> destination(source.size());
+    CopyPool pool(1, 0);
+    pool.copy(destination.data(), source.data(), source.size());
+    EXPECT(destination == source, "");
+}
+
+void test_copy_pool() {
+    parallel_copy();
+    push();
+    back_to_back();
+    single_thread();
+}
+
+}
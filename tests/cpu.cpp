@@ -0,0 +1,37 @@
+#include "helpers/all.h"
+
+#include "tests/test.h"
+
+namespace sedfer::test {
+
+static void names() {
+    for(const CpuTier tier : {CpuTier::scalar, CpuTier::sse2, CpuTier::sse42, CpuTier::avx2, CpuTier::avx512}) {
+        CpuTier parsed = CpuTier::scalar;
+        EXPECT(parse_cpu_tier(cpu_tier_name(tier), parsed) && parsed == tier, cpu_tier_name(tier));
+    }
+    CpuTier parsed = CpuTier::sse2;
+    EXPECT(not parse_cpu_tier("", parsed), "");
+    EXPECT(not parse_cpu_tier("avx", parsed), "");
+    EXPECT(not parse_cpu_tier("AVX2", parsed), "");
+    EXPECT(parsed == CpuTier::sse2, "unchanged on failure");
+}
+
+static void forced_tier() {
+    const CpuTier initial = cpu_tier();
+    EXPECT(initial <= detected_cpu_tier(), cpu_tier_name(initial));
+
+    EXPECT(set_cpu_tier(CpuTier::scalar) == CpuTier::scalar, "");
+    EXPECT(cpu_tier() == CpuTier::scalar, "");
+    // Kernels of unsupported tiers are never selected.
+    EXPECT(set_cpu_tier(CpuTier::avx512) == detected_cpu_tier(), cpu_tier_name(cpu_tier()));
+
+    set_cpu_tier(initial);
+    EXPECT(cpu_tier() == initial, "");
+}
+
+void test_cpu() {
+    names();
+    forced_tier();
+}
+
+}
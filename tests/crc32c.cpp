@@ -0,0 +1,118 @@
+#include "helpers/all.h"
+
+#include "tests/test.h"
+
+#include "bits/stdc++.h"
+
+namespace sedfer::test {
+
+/// Bit-at-a-time reference.
+static u32 reference(const u8 * data, usize size, u32 seed = 0) {
+    u32 crc = ~seed;
+    for(usize i = 0; i < size; ++i) {
+        crc ^= data[i];
+        for(usize bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0x82f63b78 : crc >> 1;
+        }
+    }
+    return ~crc;
+}
+
+static void known_values() {
+    static const char DIGITS[] = "123456789";
+    EXPECT(crc32c(ConstBuffer(reinterpret_cast<const u8 *>(DIGITS), 9)) == 0xe3069283, std::hex << crc32c(ConstBuffer(reinterpret_cast<const u8 *>(DIGITS), 9)));
+    EXPECT(crc32c(ConstBuffer()) == 0, "");
+
+    // RFC 3720 (iSCSI) B.4 test vectors.
+    std::vector<u8> bytes(32, 0x00);
+    EXPECT(crc32c({bytes.data(), 32}) == 0x8a9136aa, std::hex << crc32c({bytes.data(), 32}));
+    std::fill(bytes.begin(), bytes.end(), 0xff);
+    EXPECT(crc32c({bytes.data(), 32}) == 0x62a8ab43, std::hex << crc32c({bytes.data(), 32}));
+    for(usize i = 0; i < 32; ++i) {
+        bytes[i] = u8(i);
+    }
+    EXPECT(crc32c({bytes.data(), 32}) == 0x46dd794e, std::hex << crc32c({bytes.data(), 32}));
+}
+
+static void kernels_match_reference() {
+    // Sizes around the 3-way block boundaries (3 x 256 and 3 x 4096 bytes).
+    std::vector<u8> bytes(3 * 4096 * 2 + 3 * 256 + 100);
+    for(u8 & byte : bytes) {
+        byte = u8(rand());
+    }
+    usize failed = 0;
+    for(usize size = 0; size < 100; ++size) {
+        const usize offset = rand() % 16;
+        failed += (~kernels::crc32c(~u32(0), bytes.data() + offset, size) != reference(bytes.data() + offset, size));
+    }
+    for(const usize size : {usize(767), usize(768), usize(769), usize(3 * 256 * 2 + 7), usize(3 * 4096 - 1), usize(3 * 4096),
+                            usize(3 * 4096 + 3 * 256 + 13), bytes.size() - 16}) {
+        const usize offset = rand() % 16;
+        failed += (~kernels::crc32c(~u32(0), bytes.data() + offset, size) != reference(bytes.data() + offset, size));
+    }
+    EXPECT(failed == 0, "crc32c failed " << failed);
+}
+
+static void chaining() {
+    std::vector<u8> bytes(20000);
+    for(u8 & byte : bytes) {
+        byte = u8(rand());
+    }
+    const u32 whole = crc32c({bytes.data(), bytes.size()});
+    usize failed = 0;
+    for(const usize split : {usize(0), usize(1), usize(9), usize(1000), usize(12345), bytes.size()}) {
+        const ConstBuffer a(bytes.data(), split);
+        const ConstBuffer b(bytes.data() + split, bytes.size() - split);
+        failed += (crc32c(b, crc32c(a)) != whole);
+        failed += (crc32c_combine(crc32c(a), crc32c(b), b.size) != whole);
+
+        Crc32c incremental;
+        incremental.update(a);
+        incremental.update(b);
+        failed += (incremental.value() != whole);
+
+        Crc32c resumed(crc32c(a));
+        resumed.update(b);
+        failed += (resumed.value() != whole);
+    }
+    EXPECT(failed == 0, "failed " << failed);
+    EXPECT(Crc32c().value() == 0, "");
+    static_assert(crc32c_combine(0, 0, 0) == 0);
+}
+
+static void framing() {
+    static const u8 PAYLOAD[] = {'h', 'e', 'l', 'l', 'o'};
+    u8 storage[16] = {};
+    MutableBuffer output(storage, sizeof(storage));
+    EXPECT(push_with_crc32c(output, PAYLOAD), "");
+    EXPECT(output.size == 16 - 5 - CRC32C_SIZE, output.size);
+    const u32 crc = crc32c(PAYLOAD);
+    EXPECT(storage[5] == u8(crc) && storage[8] == u8(crc >> 24), "little-endian checksum");
+
+    MutableBuffer small(storage, 8);
+    EXPECT(not push_with_crc32c(small, PAYLOAD), "");
+    EXPECT(small.size == 8, small.size);
+
+    ConstBuffer input(storage, sizeof(storage));
+    EXPECT(pop_with_crc32c(input, 6).data == nullptr, "wrong size");
+    EXPECT(input.size == 16, input.size);
+    const ConstBuffer payload = pop_with_crc32c(input, 5);
+    EXPECT(payload.data == storage && payload.size == 5, payload.size);
+    EXPECT(input.size == 16 - 9, input.size);
+
+    storage[2] ^= 1;
+    ConstBuffer corrupted(storage, 9);
+    EXPECT(pop_with_crc32c(corrupted, 5).data == nullptr, "corrupted");
+    EXPECT(corrupted.size == 9, corrupted.size);
+    ConstBuffer truncated(storage, 3);
+    EXPECT(pop_with_crc32c(truncated, 0).data == nullptr, "truncated");
+}
+
+void test_crc32c() {
+    known_values();
+    kernels_match_reference();
+    chaining();
+    framing();
+}
+
+}
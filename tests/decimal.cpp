@@ -0,0 +1,271 @@
+#include "helpers/all.h"
+
+#include "tests/test.h"
+
+#include "bits/stdc++.h"
+
+namespace sedfer::test {
+
+/// pop_decimal / pop_float against std::from_chars: same success, same value bits, same number of consumed bytes.
+template<typename T>
+static bool matches_from_chars(std::string_view text) {
+    T expected = T(7);
+    const std::from_chars_result result = std::from_chars(text.data(), text.data() + text.size(), expected);
+    const bool expected_ok = (result.ec == std::errc());
+
+    // Copy into an exactly sized allocation, so reads past the end are caught by sanitizers.
+    const std::unique_ptr<u8[]> copy(new u8[text.size()]);
+    std::memcpy(copy.get(), text.data(), text.size());
+    ConstBuffer input(copy.get(), text.size());
+    T actual = T(7);
+    bool ok;
+    if constexpr(std::is_floating_point_v<T>) {
+        ok = input.pop_float(actual);
+    } else {
+        ok = input.pop_decimal(actual);
+    }
+    if(ok != expected_ok) {
+        return false;
+    }
+    if(not ok) {
+        return input.size == text.size() && actual == T(7);
+    }
+    return input.size == usize(text.data() + text.size() - result.ptr) && std::memcmp(&actual, &expected, sizeof(T)) == 0;
+}
+
+template<typename T>
+static void integers() {
+    using L = std::numeric_limits<T>;
+    const std::string min = std::to_string(L::min());
+    const std::string max = std::to_string(L::max());
+    for(const std::string & text : {std::string("0"), std::string("-0"), std::string("7"), std::string("-7"), std::string("00012x"),
+                                    std::string("12345678"), std::string("123456789"), std::string("1234567890123456"),
+                                    std::string("18446744073709551615"), std::string("18446744073709551616"),
+                                    std::string("99999999999999999999"), std::string("100000000000000000000"),
+                                    std::string("9223372036854775807"), std::string("-9223372036854775808"),
+                                    std::string("-9223372036854775809"), std::string("000000000000000000000000001"),
+                                    std::string(""), std::string("-"), std::string("+1"), std::string(" 1"), std::string("1 "),
+                                    std::string("12345678a"), std::string("1234567/"), std::string("123:4567890"), min, max,
+                                    min + "0", max + "0", max + "x", min.substr(0, min.size() - 1)}) {
+        EXPECT(matches_from_chars<T>(text), typeid(T).name() << " " << text);
+    }
+    for(usize i = 0; i < 20000; ++i) {
+        std::string text = (rand() % 4 == 0) ? "-" : "";
+        const usize digits = usize(rand() % 24);
+        for(usize j = 0; j < digits; ++j) {
+            text += char('0' + rand() % 10);
+        }
+        if(rand() % 4 == 0) {
+            text += "x9";
+        }
+        EXPECT(matches_from_chars<T>(text), typeid(T).name() << " " << text);
+    }
+}
+
+template<typename T>
+static void floats() {
+    for(const char * text : {"0", "-0", "0.0", "1", "-1", "1.", ".5", "-.5", ".", "-", "+1", "1e", "1e+", "1e-", "1e5", "1E5", "1e+5",
+                             "1e-5", "1.5e3x", "1..5", "1.5.5", "e5", "inf", "-inf", "INF", "infinity", "-Infinity", "infx", "in",
+                             "nan", "-nan", "NaN", "nan(123)", "0e999999999999", "1e999999999999", "1e-999999999999",
+                             "9007199254740993", "9007199254740995", "16777217", "16777219", "4.9406564584124654e-324",
+                             "2.4703282292062327e-324", "2.4703282292062328e-324", "2.2250738585072011e-308",
+                             "2.2250738585072014e-308", "1.7976931348623157e308", "1.7976931348623158e308",
+                             "1.7976931348623159e308", "3.4028234e38", "3.4028236e38", "1.4e-45", "7e-46", "1.17549435e-38",
+                             "0.1", "0.2", "0.3", "123456789012345678901234567890", "0.000000000000000000000000000001",
+                             "00000000000000000000000000000001.5", "1.00000000000000000000000000000001",
+                             "9999999999999999999", "99999999999999999999", "1844674407370955161.5", "7.2057594037927933e16",
+                             "2.2250738585072012e-308", "1e23", "8.98846567431158e307", "4.35e-28", "1090544144181609348835077142190",
+                             "0.0000000000000000000000000000000000000000000000000000000000000000001"}) {
+        EXPECT(matches_from_chars<T>(text), typeid(T).name() << " " << text);
+    }
+    // Random values printed with every precision, random digit strings with random exponents.
+    char text[64];
+    for(usize i = 0; i < 20000; ++i) {
+        u64 bits = (u64(rand()) << 40) ^ (u64(rand()) << 20) ^ u64(rand());
+        T value;
+        if constexpr(std::is_same_v<T, double>) {
+            value = std::bit_cast<double>(bits);
+        } else {
+            value = std::bit_cast<float>(u32(bits));
+        }
+        if(not std::isfinite(value)) {
+            continue;
+        }
+        std::snprintf(text, sizeof(text), "%.*g", int(1 + i % 20), double(value));
+        EXPECT(matches_from_chars<T>(text), typeid(T).name() << " " << text);
+        std::snprintf(text, sizeof(text), "%.17e", double(value));
+        EXPECT(matches_from_chars<T>(text), typeid(T).name() << " " << text);
+
+        std::string digits = (rand() % 2) ? "-" : "";
+        const usize count = usize(1 + rand() % 22);
+        const usize dot = usize(rand() % (count + 1));
+        for(usize j = 0; j < count; ++j) {
+            digits += (j == dot) ? '.' : char('0' + rand() % 10);
+        }
+        if(rand() % 2) {
+            digits += "e" + std::to_string(rand() % 700 - 350);
+        }
+        EXPECT(matches_from_chars<T>(digits), typeid(T).name() << " " << digits);
+    }
+    // Exact halfway points between neighbours (round to even), and just above / below.
+    for(usize i = 0; i < 2000; ++i) {
+        const u64 mantissa = (u64(rand()) << 31 ^ u64(rand())) & ((u64(1) << (std::numeric_limits<T>::digits + 1)) - 1);
+        for(const i64 delta : {-1, 0, 1}) {
+            const std::string halfway = std::to_string(i64(mantissa | 1) + delta);
+            EXPECT(matches_from_chars<T>(halfway), typeid(T).name() << " " << halfway);
+            EXPECT(matches_from_chars<T>(halfway + "e-1"), typeid(T).name() << " " << halfway);
+            EXPECT(matches_from_chars<T>(halfway + "0e3"), typeid(T).name() << " " << halfway);
+        }
+    }
+}
+
+static void consumption() {
+    static const char TEXT[] = "-12,3.5e2;0x";
+    ConstBuffer input(reinterpret_cast<const u8 *>(TEXT), sizeof(TEXT) - 1);
+    i32 integer = 0;
+    double real = 0;
+    EXPECT(input.pop_decimal(integer) && integer == -12 && input.size == 9, integer);
+    EXPECT(not input.pop_decimal(integer) && integer == -12 && input.size == 9, input.size);
+    EXPECT(input.skip(1) && input.pop_float(real) && real == 350.0 && input.size == 3, real);
+    EXPECT(input.skip(1) && input.pop_decimal(integer) && integer == 0 && input.size == 1, integer);
+    u32 positive = 5;
+    ConstBuffer negative(reinterpret_cast<const u8 *>(TEXT), 3);
+    EXPECT(not negative.pop_decimal(positive) && positive == 5 && negative.size == 3, positive);
+}
+
+/// push_decimal / push_float against std::to_chars (u128 / i128 against repeated division).
+template<typename T>
+static std::string reference(T value) {
+    if constexpr(sizeof(T) == 16) {
+        const bool negative = value < 0;
+        u128 magnitude = negative ? u128(0) - u128(value) : u128(value);
+        std::string ret;
+        do {
+            ret.insert(ret.begin(), char('0' + int(magnitude % 10)));
+            magnitude /= 10;
+        } while(magnitude != 0);
+        return negative ? "-" + ret : ret;
+    } else {
+        char text[64];
+        const std::to_chars_result result = std::to_chars(text, text + sizeof(text), value);
+        return std::string(text, result.ptr);
+    }
+}
+
+template<typename T>
+static std::string push(T value) {
+    u8 storage[64];
+    MutableBuffer output(storage, sizeof(storage));
+    bool ok;
+    if constexpr(std::is_floating_point_v<T>) {
+        ok = output.push_float(value);
+    } else {
+        ok = output.push_decimal(value);
+    }
+    const usize length = sizeof(storage) - output.size;
+    if(not ok) {
+        return "<error>";
+    }
+    // Exact capacity is enough, one byte less fails and leaves the buffer unchanged.
+    MutableBuffer exact(storage, length);
+    MutableBuffer short_by_one(storage, length - 1);
+    if constexpr(std::is_floating_point_v<T>) {
+        ok = exact.push_float(value) && exact.size == 0 && not short_by_one.push_float(value);
+    } else {
+        ok = exact.push_decimal(value) && exact.size == 0 && not short_by_one.push_decimal(value);
+    }
+    if(not ok || short_by_one.size != length - 1) {
+        return "<capacity>";
+    }
+    return std::string(reinterpret_cast<const char *>(storage), length);
+}
+
+template<typename T>
+static void push_integers() {
+    using L = std::numeric_limits<T>;
+    std::vector<T> values = {T(0), T(1), T(9), T(10), T(99), T(100), L::max(), T(L::max() - 1), L::min(), T(L::min() + 1)};
+    if constexpr(sizeof(T) == 16) {
+        // std::numeric_limits<__int128> is not specialized in strict modes.
+        values.push_back(T(~u128(0) >> (T(-1) < T(0) ? 1 : 0)));
+    }
+    for(T power = 1; power <= L::max() / 10; power *= 10) {
+        values.push_back(power);
+        values.push_back(T(power - 1));
+        values.push_back(T(power * 10 - 1));
+        if constexpr(T(-1) < T(0)) {
+            values.push_back(T(-power));
+            values.push_back(T(1 - power));
+        }
+    }
+    for(usize i = 0; i < 10000; ++i) {
+        u128 random = 0;
+        for(usize j = 0; j < 5; ++j) {
+            random = (random << 31) ^ u128(rand());
+        }
+        values.push_back(T(random >> (rand() % 128)));
+        values.push_back(T(random));
+    }
+    for(const T value : values) {
+        EXPECT(push(value) == reference(value), typeid(T).name() << " " << reference(value) << " " << push(value));
+    }
+}
+
+template<typename T>
+static void push_floats() {
+    using L = std::numeric_limits<T>;
+    std::vector<T> values = {T(0), -T(0), T(1), T(-1), T(0.1), T(0.2) + T(0.1), T(100), T(1e21), T(1e22), T(1e23), T(1e-4),
+                             T(1e-3), T(123.456), T(1) / T(3), L::max(), L::lowest(), L::min(), L::denorm_min(), -L::denorm_min(),
+                             L::epsilon(), L::infinity(), -L::infinity(), L::quiet_NaN(), -L::quiet_NaN(), T(9007199254740993.0),
+                             T(1152921504606846976.0), T(16777216), T(16777218), T(5e-324), T(1.7976931348623157e308)};
+    for(i32 exponent = L::min_exponent10 - 8; exponent <= L::max_exponent10; ++exponent) {
+        values.push_back(T(std::pow(10.0, exponent)));
+        values.push_back(std::nextafter(T(std::pow(10.0, exponent)), T(0)));
+        values.push_back(T(std::ldexp(1.0, exponent)));
+    }
+    for(usize i = 0; i < 20000; ++i) {
+        const u64 bits = (u64(rand()) << 40) ^ (u64(rand()) << 20) ^ u64(rand());
+        if constexpr(std::is_same_v<T, double>) {
+            values.push_back(std::bit_cast<double>(bits));
+        } else {
+            values.push_back(std::bit_cast<float>(u32(bits)));
+        }
+    }
+    for(const T value : values) {
+        EXPECT(push(value) == reference(value), typeid(T).name() << " " << reference(value) << " " << push(value));
+        if(std::isfinite(value)) {
+            // Round trip through pop_float.
+            const std::string text = push(value);
+            ConstBuffer input(reinterpret_cast<const u8 *>(text.data()), text.size());
+            T parsed = 0;
+            EXPECT(input.pop_float(parsed) && parsed == value && input.size == 0, text);
+        }
+    }
+}
+
+void test_decimal() {
+    integers<u8>();
+    integers<i8>();
+    integers<u16>();
+    integers<i16>();
+    integers<u32>();
+    integers<i32>();
+    integers<u64>();
+    integers<i64>();
+    floats<double>();
+    floats<float>();
+    consumption();
+    push_integers<u8>();
+    push_integers<i8>();
+    push_integers<u16>();
+    push_integers<i16>();
+    push_integers<u32>();
+    push_integers<i32>();
+    push_integers<u64>();
+    push_integers<i64>();
+    push_integers<u128>();
+    push_integers<i128>();
+    push_floats<double>();
+    push_floats<float>();
+}
+
+}
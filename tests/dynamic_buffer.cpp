@@ -0,0 +1,207 @@
+#include "helpers/all.h"
+
+#include "tests/test.h"
+
+#include "bits/stdc++.h"
+
+namespace sedfer::test {
+
+static void default_constructor() {
+    DynamicBuffer buffer;
+    EXPECT(buffer.size() == 0, "size " << buffer.size());
+    EXPECT(buffer.capacity() == 0, "capacity " << buffer.capacity());
+    EXPECT(buffer.written().size == 0, "size " << buffer.written().size);
+    EXPECT(buffer.written_back().size == 0, "size " << buffer.written_back().size);
+    EXPECT(buffer.available().size == 0, "size " << buffer.available().size);
+}
+
+static void push() {
+    DynamicBuffer buffer;
+
+    EXPECT(buffer.push(u8(0x01)), "");
+    EXPECT(buffer.push(u16(0x0302)), "");
+    EXPECT(buffer.push(u32(0x07060504)), "");
+    EXPECT(buffer.push(u64(0x0f0e0d0c0b0a0908)), "");
+    EXPECT(buffer.size() == 15, "size " << buffer.size());
+    EXPECT(buffer.capacity() >= 15, "capacity " << buffer.capacity());
+
+    const ConstBuffer written = buffer.written();
+    EXPECT(written.size == 15, "size " << written.size);
+    for(usize i = 0; i < written.size; ++i) {
+        EXPECT(written.data[i] == i + 1, "i " << i << " byte " << u32(written.data[i]));
+    }
+}
+
+static void push_back() {
+    DynamicBuffer buffer;
+
+    EXPECT(buffer.push_back(u8(0x0f)), "");
+    EXPECT(buffer.push_back(u16(0x0e0d)), "");
+    EXPECT(buffer.push_back(u32(0x0c0b0a09)), "");
+    EXPECT(buffer.push_back(u64(0x0807060504030201)), "");
+    EXPECT(buffer.size() == 15, "size " << buffer.size());
+    EXPECT(buffer.written().size == 0, "size " << buffer.written().size);
+
+    const ConstBuffer written = buffer.written_back();
+    EXPECT(written.size == 15, "size " << written.size);
+    for(usize i = 0; i < written.size; ++i) {
+        EXPECT(written.data[i] == i + 1, "i " << i << " byte " << u32(written.data[i]));
+    }
+}
+
+static void interpret() {
+    DynamicBuffer buffer;
+
+    EXPECT(buffer.push(u8(0xAA)), "");
+    u32packed * const size = buffer.interpret<u32packed>();
+    EXPECT(size != nullptr, "");
+    *size = 0x12345678;
+    u16packed * const tail = buffer.interpret_back<u16packed>();
+    EXPECT(tail != nullptr, "");
+    *tail = 0x9abc;
+
+    EXPECT(buffer.size() == 7, "size " << buffer.size());
+    EXPECT(buffer.at<u32packed>(1) != nullptr, "");
+    EXPECT(*buffer.at<u32packed>(1) == 0x12345678, "");
+    EXPECT(buffer.at<u32packed>(2) == nullptr, "");
+    EXPECT(buffer.at<u32packed>(100) == nullptr, "");
+
+    const SharedBuffer shared = buffer.release();
+    const u8 expected[] = {0xAA, 0x78, 0x56, 0x34, 0x12, 0xbc, 0x9a};
+    EXPECT(equal(shared, expected), "");
+}
+
+static void growth_keeps_content() {
+    std::vector<u8> front(3 * DynamicBuffer::MMAP_THRESHOLD + 17);
+    std::vector<u8> back(DynamicBuffer::MMAP_THRESHOLD / 3 + 5);
+    for(usize i = 0; i < front.size(); ++i) {
+        front[i] = u8(i * 7);
+    }
+    for(usize i = 0; i < back.size(); ++i) {
+        back[i] = u8(i * 13 + 1);
+    }
+
+    DynamicBuffer buffer;
+    usize previous_capacity = 0;
+    usize reallocations = 0;
+
+    for(usize i = 0, j = 0; i < front.size() || j < back.size(); ) {
+        const usize front_step = std::min<usize>(front.size() - i, 1000);
+        EXPECT(buffer.push({front.data() + i, front_step}), "");
+        i += front_step;
+
+        const usize back_step = std::min<usize>(back.size() - j, 100);
+        EXPECT(buffer.push_back({back.data() + back.size() - j - back_step, back_step}), "");
+        j += back_step;
+
+        if(buffer.capacity() != previous_capacity) {
+            previous_capacity = buffer.capacity();
+            reallocations += 1;
+        }
+    }
+
+    EXPECT(reallocations < 40, "reallocations " << reallocations);
+    EXPECT(equal(buffer.written(), {front.data(), front.size()}), "");
+    EXPECT(equal(buffer.written_back(), {back.data(), back.size()}), "");
+
+    EXPECT(buffer.shrink_to_fit(), "");
+    EXPECT(buffer.capacity() < buffer.size() + 4096, "capacity " << buffer.capacity());
+    EXPECT(equal(buffer.written(), {front.data(), front.size()}), "");
+    EXPECT(equal(buffer.written_back(), {back.data(), back.size()}), "");
+
+    const SharedBuffer shared = buffer.release();
+    EXPECT(shared.size == front.size() + back.size(), "size " << shared.size);
+    EXPECT(equal(ConstBuffer(shared).pop_buffer(front.size()), {front.data(), front.size()}), "");
+    EXPECT(equal(ConstBuffer(shared).pop_buffer_back(back.size()), {back.data(), back.size()}), "");
+
+    EXPECT(buffer.size() == 0, "size " << buffer.size());
+    EXPECT(buffer.capacity() == 0, "capacity " << buffer.capacity());
+}
+
+/// Pushing the buffer's own bytes, with growth (malloc and mmap storage) between reading and writing them.
+static void push_own_bytes() {
+    DynamicBuffer buffer;
+    EXPECT(buffer.push(u32(0x04030201)), "");
+    EXPECT(buffer.push_back(u16(0x0605)), "");
+    std::vector<u8> front = {1, 2, 3, 4};
+    std::vector<u8> back = {5, 6};
+
+    while(buffer.capacity() < 2 * DynamicBuffer::MMAP_THRESHOLD) {
+        EXPECT(buffer.push(buffer.written()), "");
+        const std::vector<u8> front_copy = front;
+        front.insert(front.end(), front_copy.begin(), front_copy.end());
+        EXPECT(buffer.push_back(buffer.written_back()), "");
+        const std::vector<u8> back_copy = back;
+        back.insert(back.begin(), back_copy.begin(), back_copy.end());
+        EXPECT(buffer.push(buffer.written_back().pop_buffer(3)), "");
+        front.insert(front.end(), back.begin(), back.begin() + 3);
+    }
+    EXPECT(equal(buffer.written(), {front.data(), front.size()}), "");
+    EXPECT(equal(buffer.written_back(), {back.data(), back.size()}), "");
+}
+
+static void reserve_and_shrink() {
+    DynamicBuffer buffer;
+
+    EXPECT(buffer.reserve(100), "");
+    EXPECT(buffer.capacity() >= 100, "capacity " << buffer.capacity());
+
+    EXPECT(buffer.push(u64(1)), "");
+    EXPECT(buffer.push_back(u64(2)), "");
+
+    EXPECT(buffer.reserve(2 * DynamicBuffer::MMAP_THRESHOLD), "");
+    EXPECT(buffer.capacity() >= 2 * DynamicBuffer::MMAP_THRESHOLD, "capacity " << buffer.capacity());
+    EXPECT(buffer.written().size == 8 && *reinterpret_cast<const u64 *>(buffer.written().data) == 1, "");
+    EXPECT(buffer.written_back().size == 8 && *reinterpret_cast<const u64 *>(buffer.written_back().data) == 2, "");
+
+    EXPECT(buffer.shrink_to_fit(), "");
+    EXPECT(buffer.capacity() == DynamicBuffer::MIN_CAPACITY, "capacity " << buffer.capacity());
+    EXPECT(buffer.written().size == 8 && *reinterpret_cast<const u64 *>(buffer.written().data) == 1, "");
+    EXPECT(buffer.written_back().size == 8 && *reinterpret_cast<const u64 *>(buffer.written_back().data) == 2, "");
+
+    buffer.clear();
+    EXPECT(buffer.size() == 0, "size " << buffer.size());
+    EXPECT(buffer.shrink_to_fit(), "");
+    EXPECT(buffer.capacity() == 0, "capacity " << buffer.capacity());
+}
+
+static void prepare_and_commit() {
+    DynamicBuffer buffer;
+
+    MutableBuffer space = buffer.prepare(10);
+    EXPECT(space.size >= 10, "size " << space.size);
+    EXPECT(space.push(u32(0x04030201)), "");
+    EXPECT(buffer.commit(4), "");
+    EXPECT(not buffer.commit(buffer.available().size + 1), "");
+    EXPECT(buffer.size() == 4, "size " << buffer.size());
+    EXPECT(equal(buffer.written(), u32(0x04030201)), "");
+}
+
+static void move() {
+    DynamicBuffer buffer;
+    EXPECT(buffer.push(u32(0x04030201)), "");
+
+    DynamicBuffer moved = std::move(buffer);
+    EXPECT(moved.size() == 4, "size " << moved.size());
+    EXPECT(equal(moved.written(), u32(0x04030201)), "");
+
+    buffer = std::move(moved);
+    EXPECT(buffer.size() == 4, "size " << buffer.size());
+    EXPECT(equal(buffer.written(), u32(0x04030201)), "");
+}
+
+void test_dynamic_buffer() {
+    default_constructor();
+
+    push();
+    push_back();
+    interpret();
+
+    growth_keeps_content();
+    push_own_bytes();
+    reserve_and_shrink();
+    prepare_and_commit();
+    move();
+}
+
+}
@@ -0,0 +1,67 @@
+#include "helpers/all.h"
+
+#include "tests/test.h"
+
+#include "bits/stdc++.h"
+
+namespace sedfer::test {
+
+using FillPattern = void (*)(u8 *, usize, const u8 *, usize);
+
+/// All pattern sizes, sizes up to 300 and several alignments: filled bytes match, neighbours are untouched.
+static void compare_fill_pattern(const char * name, FillPattern kernel) {
+    std::vector<u8> bytes(400);
+    std::vector<u8> expected(400);
+    u8 pattern[kernels::MAX_FILL_PATTERN_SIZE];
+    usize failed = 0;
+    for(usize pattern_size = 1; pattern_size <= kernels::MAX_FILL_PATTERN_SIZE; ++pattern_size) {
+        for(usize size = 0; size <= 300; size += 1 + rand() % 5) {
+            const usize offset = rand() % 64;
+            for(usize i = 0; i < bytes.size(); ++i) {
+                bytes[i] = expected[i] = rand() % 256;
+            }
+            for(usize i = 0; i < pattern_size; ++i) {
+                pattern[i] = rand() % 256;
+            }
+            kernels::scalar::fill_pattern(expected.data() + offset, size, pattern, pattern_size);
+            kernel(bytes.data() + offset, size, pattern, pattern_size);
+            failed += (bytes != expected);
+        }
+    }
+    EXPECT(failed == 0, name << " failed " << failed);
+}
+
+static void kernels_match_reference() {
+    compare_fill_pattern("fill_pattern", kernels::fill_pattern);
+
+    // Streaming stores from the threshold.
+    const usize threshold = kernels::streaming_copy_threshold;
+    kernels::streaming_copy_threshold = 0;
+    compare_fill_pattern("fill_pattern streaming", kernels::fill_pattern);
+    kernels::streaming_copy_threshold = threshold;
+}
+
+static void fill_sizes() {
+    std::vector<u8> bytes(300);
+    for(usize size = 0; size <= 200; ++size) {
+        std::fill(bytes.begin(), bytes.end(), 0);
+        kernels::fill(bytes.data() + 7, size, 0xab);
+        EXPECT(std::count(bytes.begin(), bytes.end(), 0xab) == isize(size), "size " << size);
+        EXPECT(std::all_of(bytes.begin() + 7, bytes.begin() + 7 + size, [](u8 byte) { return byte == 0xab; }), "size " << size);
+    }
+
+    // Streaming path from the threshold.
+    const usize threshold = kernels::streaming_copy_threshold;
+    kernels::streaming_copy_threshold = 100;
+    std::fill(bytes.begin(), bytes.end(), 0);
+    kernels::fill(bytes.data() + 3, 250, 0x5a);
+    EXPECT(std::count(bytes.begin(), bytes.end(), 0x5a) == 250 && bytes[3] == 0x5a && bytes[252] == 0x5a, "");
+    kernels::streaming_copy_threshold = threshold;
+}
+
+void test_fill() {
+    kernels_match_reference();
+    fill_sizes();
+}
+
+}
@@ -0,0 +1,70 @@
+#include "helpers/all.h"
+
+#include "tests/test.h"
+
+#include "bits/stdc++.h"
+
+namespace sedfer::test {
+
+static void short_needle() {
+    const char text[] = "one\r\ntwo\r\n";
+    const ConstBuffer buffer(reinterpret_cast<const u8 *>(text), sizeof(text) - 1);
+    const Finder crlf({reinterpret_cast<const u8 *>("\r\n"), 2});
+
+    EXPECT(crlf.needle().size == 2, "size " << crlf.needle().size);
+    EXPECT(crlf.find(buffer).data == buffer.data + 3, "");
+    EXPECT(crlf.find(buffer).size == 7, "size " << crlf.find(buffer).size);
+    EXPECT(crlf.find_last(buffer).data == buffer.data + 8, "");
+    EXPECT(crlf.find({buffer.data, 4}).data == nullptr, "");
+    EXPECT(crlf.find(ConstBuffer()).data == nullptr, "");
+}
+
+static void long_needle() {
+    std::string needle;
+    for(usize i = 0; i < 10; ++i) {
+        needle += "abcab";
+    }
+    needle += "x";
+
+    std::string text = "abcab" + needle + "abcab" + needle + "abcab";
+    const ConstBuffer buffer(reinterpret_cast<const u8 *>(text.data()), text.size());
+    const Finder finder({reinterpret_cast<const u8 *>(needle.data()), needle.size()});
+
+    EXPECT(finder.find(buffer).data == buffer.data + 5, "");
+    EXPECT(finder.find_last(buffer).data == buffer.data + 10 + needle.size(), "");
+    EXPECT(finder.find({buffer.data, needle.size() + 4}).data == nullptr, "");
+
+    text[5 + needle.size() - 1] = 'y';
+    EXPECT(finder.find(buffer).data == buffer.data + 10 + needle.size(), "");
+}
+
+static void matches_const_buffer_find() {
+    std::vector<u8> bytes(3000);
+    std::vector<u8> needle(300);
+    usize failed = 0;
+    for(usize iteration = 0; iteration < 2000; ++iteration) {
+        for(u8 & byte : bytes) {
+            byte = 'a' + rand() % 2;
+        }
+        const usize needle_size = rand() % needle.size();
+        const usize offset = rand() % (bytes.size() - needle_size);
+        std::memcpy(needle.data(), bytes.data() + offset, needle_size);
+        needle[rand() % (needle_size + 1)] ^= (rand() % 4 == 0);
+
+        const Finder finder({needle.data(), needle_size});
+        for(usize i = 0; i < 4; ++i) {
+            const ConstBuffer haystack(bytes.data() + rand() % 100, rand() % 2900);
+            failed += (finder.find(haystack).data != haystack.find(finder.needle()).data);
+            failed += (finder.find_last(haystack).data != haystack.find_last(finder.needle()).data);
+        }
+    }
+    EXPECT(failed == 0, "failed " << failed);
+}
+
+void test_finder() {
+    short_needle();
+    long_needle();
+    matches_const_buffer_find();
+}
+
+}
@@ -0,0 +1,142 @@
+#include "helpers/all.h"
+
+#include "tests/test.h"
+
+#include "bits/stdc++.h"
+
+namespace sedfer::test {
+
+static void kernels_match_scalar() {
+    std::vector<u8> bytes(64 * 40);
+    for(u8 & byte : bytes) {
+        byte = u8(rand());
+    }
+    usize failed = 0;
+    for(const usize stripes : {usize(0), usize(1), usize(15), usize(16), usize(17), usize(40)}) {
+        for(usize position = 0; position < kernels::HASH_BLOCK_STRIPES; position += 5) {
+            u64 expected[8];
+            u64 actual[8];
+            for(usize i = 0; i < 8; ++i) {
+                expected[i] = actual[i] = (u64(rand()) << 32) | u64(rand());
+            }
+            usize expected_position = position;
+            usize actual_position = position;
+            kernels::scalar::hash_stripes(expected, bytes.data(), stripes, expected_position, kernels::HASH_KEY.data());
+            kernels::hash_stripes(actual, bytes.data(), stripes, actual_position, kernels::HASH_KEY.data());
+            failed += (std::memcmp(expected, actual, sizeof(expected)) != 0) || (expected_position != actual_position);
+        }
+    }
+    EXPECT(failed == 0, "hash_stripes failed " << failed);
+}
+
+static void distinct() {
+    // All inputs of 0 - 3 bytes.
+    std::unordered_set<u64> hashes;
+    u8 bytes[3];
+    hashes.insert(hash64(ConstBuffer()));
+    for(u32 value = 0; value < (1u << 24); value += (value < 0x10000) ? 1 : 251) {
+        bytes[0] = u8(value);
+        bytes[1] = u8(value >> 8);
+        bytes[2] = u8(value >> 16);
+        hashes.insert(hash64({bytes, value < 0x100 ? usize(1) : value < 0x10000 ? usize(2) : usize(3)}));
+    }
+    const usize expected = 1 + 0x10000 + (0x1000000 - 0x10000 + 250) / 251;
+    EXPECT(hashes.size() == expected, hashes.size() << " != " << expected);
+
+    // Zero-filled inputs of every length in all length classes, and their 128-bit hashes.
+    std::vector<u8> zeros(2000, 0);
+    std::set<u64> lengths;
+    std::set<std::pair<u64, u64>> wide;
+    for(usize size = 0; size <= zeros.size(); ++size) {
+        lengths.insert(hash64({zeros.data(), size}));
+        const Hash128 hash = hash128({zeros.data(), size});
+        wide.insert({hash.low, hash.high});
+        EXPECT(hash.low != hash.high, size);
+    }
+    EXPECT(lengths.size() == zeros.size() + 1, lengths.size());
+    EXPECT(wide.size() == zeros.size() + 1, wide.size());
+}
+
+/// Flipping one input bit flips about half of the output bits, for every length class.
+static void avalanche() {
+    for(const usize size : {usize(3), usize(8), usize(16), usize(31), usize(100), usize(256), usize(257), usize(5000)}) {
+        std::vector<u8> bytes(size);
+        usize flipped = 0;
+        usize trials = 0;
+        for(usize round = 0; round < 20; ++round) {
+            for(u8 & byte : bytes) {
+                byte = u8(rand());
+            }
+            for(usize bit = 0; bit < size * 8; bit += std::max(usize(1), size / 8)) {
+                const u64 before = hash64({bytes.data(), size}, round);
+                bytes[bit / 8] ^= u8(1 << (bit % 8));
+                flipped += std::popcount(before ^ hash64({bytes.data(), size}, round));
+                bytes[bit / 8] ^= u8(1 << (bit % 8));
+                ++trials;
+            }
+        }
+        const double average = double(flipped) / double(trials);
+        EXPECT(average > 30 && average < 34, size << ": " << average);
+    }
+}
+
+static void seeds() {
+    static const u8 KEY[] = {'k', 'e', 'y'};
+    std::vector<u8> bytes(1000, 0x42);
+    for(const ConstBuffer buffer : {ConstBuffer(KEY), ConstBuffer(bytes.data(), 100), ConstBuffer(bytes.data(), 1000)}) {
+        EXPECT(hash64(buffer) == hash64(buffer, 0), "");
+        EXPECT(hash64(buffer, 1) != hash64(buffer, 0), buffer.size);
+        EXPECT(hash64(buffer, 1) != hash64(buffer, 2), buffer.size);
+        EXPECT(hash128(buffer, 1) != hash128(buffer, 2), buffer.size);
+        EXPECT(hash64(buffer, 7) == hash64(buffer, 7), "deterministic");
+    }
+}
+
+static void streaming() {
+    std::vector<u8> bytes(5000);
+    for(u8 & byte : bytes) {
+        byte = u8(rand());
+    }
+    usize failed = 0;
+    for(const usize size : {usize(0), usize(1), usize(16), usize(17), usize(255), usize(256), usize(257), usize(300), usize(320),
+                            usize(321), usize(512), usize(513), usize(1024), usize(1087), usize(4999)}) {
+        for(const u64 seed : {u64(0), u64(12345)}) {
+            const ConstBuffer whole(bytes.data(), size);
+            // One piece, byte by byte, random pieces (some longer than the internal buffer).
+            for(usize mode = 0; mode < 3; ++mode) {
+                Hasher hasher(seed);
+                ConstBuffer rest = whole;
+                while(rest.size != 0) {
+                    const usize piece = std::min(rest.size, mode == 0 ? rest.size : mode == 1 ? usize(1) : usize(rand() % 700));
+                    hasher.update(rest.pop_buffer(piece));
+                }
+                failed += (hasher.digest64() != hash64(whole, seed));
+                failed += (hasher.digest128() != hash128(whole, seed));
+            }
+        }
+    }
+    EXPECT(failed == 0, "failed " << failed);
+}
+
+static void containers() {
+    static const u8 A[] = {'a'};
+    static const u8 B[] = {'b'};
+    u8 copy[] = {'a'};
+    std::unordered_set<ConstBuffer, BufferHash, BufferEqual> set(8, BufferHash{42});
+    set.insert(A);
+    set.insert(B);
+    set.insert(ConstBuffer(copy, 1));
+    EXPECT(set.size() == 2, set.size());
+    EXPECT(set.contains(ConstBuffer(copy, 1)), "");
+}
+
+void test_hash() {
+    kernels_match_scalar();
+    distinct();
+    avalanche();
+    seeds();
+    streaming();
+    containers();
+}
+
+}
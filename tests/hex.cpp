@@ -0,0 +1,172 @@
+#include "helpers/all.h"
+
+#include "tests/test.h"
+
+#include "bits/stdc++.h"
+
+namespace sedfer::test {
+
+static std::string encode(std::string_view text, HexCase letters = HexCase::lower) {
+    std::string ret(2 * text.size(), '\0');
+    MutableBuffer output(reinterpret_cast<u8 *>(ret.data()), ret.size());
+    if(not hex_encode({reinterpret_cast<const u8 *>(text.data()), text.size()}, output, letters) || output.size != 0) {
+        return "<error>";
+    }
+    return ret;
+}
+
+static std::string decode(std::string_view text) {
+    std::string ret(text.size() / 2, '\0');
+    MutableBuffer output(reinterpret_cast<u8 *>(ret.data()), ret.size());
+    if(not hex_decode({reinterpret_cast<const u8 *>(text.data()), text.size()}, output) || output.size != 0) {
+        return "<error>";
+    }
+    return ret;
+}
+
+static void known_values() {
+    EXPECT(encode("") == "", encode(""));
+    EXPECT(encode("\x01\xab\xff\x7f") == "01abff7f", encode("\x01\xab\xff\x7f"));
+    EXPECT(encode("\x01\xab\xff\x7f", HexCase::upper) == "01ABFF7F", encode("\x01\xab\xff\x7f", HexCase::upper));
+    EXPECT(decode("01abff7f") == "\x01\xab\xff\x7f", decode("01abff7f"));
+    EXPECT(decode("01ABfF7f") == "\x01\xab\xff\x7f", decode("01ABfF7f"));
+    std::string text(1000, '\0');
+    for(char & c : text) {
+        c = char(rand());
+    }
+    EXPECT(decode(encode(text)) == text, "");
+    EXPECT(decode(encode(text, HexCase::upper)) == text, "");
+}
+
+static void invalid() {
+    for(const char * text : {"0", "abc", "0g", "g0", "0x12", " 1", "1 ", "@0", "0`", "0G", "/0", ":0", "\xb0\xb0",
+                             "0123456789abcdef0123456789abcdef0123456789abcdef012345678-"}) {
+        EXPECT(decode(text) == "<error>", text);
+    }
+
+    u8 storage[8];
+    MutableBuffer small(storage, 3);
+    static const u8 TWO[] = {1, 2};
+    EXPECT(not hex_encode(TWO, small), "");
+    EXPECT(small.size == 3, small.size);
+    static const char ENCODED[] = "01020304";
+    EXPECT(not hex_decode({reinterpret_cast<const u8 *>(ENCODED), 8}, small), "");
+    EXPECT(small.size == 3, small.size);
+}
+
+template<typename T>
+static void integer(T value, std::string_view lower, std::string_view upper) {
+    char storage[17] = {};
+    MutableBuffer output(reinterpret_cast<u8 *>(storage), 2 * sizeof(T) + 1);
+    EXPECT(output.push_hex(value), "");
+    EXPECT(output.size == 1, output.size);
+    EXPECT(std::string_view(storage, 2 * sizeof(T)) == lower, storage);
+    output = MutableBuffer(reinterpret_cast<u8 *>(storage), 2 * sizeof(T));
+    EXPECT(output.push_hex(value, HexCase::upper), "");
+    EXPECT(std::string_view(storage, 2 * sizeof(T)) == upper, storage);
+
+    for(std::string_view text : {lower, upper}) {
+        ConstBuffer input(reinterpret_cast<const u8 *>(text.data()), text.size());
+        T parsed = 0;
+        EXPECT(input.pop_hex(parsed), text);
+        EXPECT(parsed == value, text);
+        EXPECT(input.size == 0, input.size);
+    }
+}
+
+static void integers() {
+    integer<u8>(0x00, "00", "00");
+    integer<u8>(0xa5, "a5", "A5");
+    integer<u16>(0x0f1e, "0f1e", "0F1E");
+    integer<u32>(0xdeadbeef, "deadbeef", "DEADBEEF");
+    integer<u32>(0x00000001, "00000001", "00000001");
+    integer<u64>(0x0123456789abcdef, "0123456789abcdef", "0123456789ABCDEF");
+    integer<u64>(u64(-1), "ffffffffffffffff", "FFFFFFFFFFFFFFFF");
+
+    // Every u16 round trip, random u64.
+    for(u32 i = 0; i <= 0xffff; ++i) {
+        u8 storage[4];
+        MutableBuffer output(storage, 4);
+        (void)output.push_hex(u16(i), (i & 1) ? HexCase::upper : HexCase::lower);
+        ConstBuffer input(storage, 4);
+        u16 parsed = 0;
+        EXPECT(input.pop_hex(parsed) && parsed == i, i);
+    }
+    for(usize i = 0; i < 10000; ++i) {
+        const u64 value = (u64(rand()) << 40) ^ (u64(rand()) << 20) ^ u64(rand());
+        u8 storage[16];
+        MutableBuffer output(storage, 16);
+        (void)output.push_hex(value);
+        char expected[17];
+        std::snprintf(expected, sizeof(expected), "%016llx", static_cast<unsigned long long>(value));
+        EXPECT(std::memcmp(storage, expected, 16) == 0, expected);
+        ConstBuffer input(storage, 16);
+        u64 parsed = 0;
+        EXPECT(input.pop_hex(parsed) && parsed == value, expected);
+    }
+
+    // Invalid digit at every position of every byte value: no value, input unchanged.
+    for(u32 bad = 0; bad < 256; ++bad) {
+        if(kernels::HEX_VALUES[bad] != 0xff) {
+            continue;
+        }
+        for(usize position = 0; position < 8; ++position) {
+            u8 text[8] = {'1', '2', '3', '4', '5', '6', '7', '8'};
+            text[position] = u8(bad);
+            ConstBuffer input(text, 8);
+            u32 parsed = 7;
+            EXPECT(not input.pop_hex(parsed) && parsed == 7 && input.size == 8, bad << " at " << position);
+        }
+    }
+    static const u8 SHORT[] = {'1', '2', '3'};
+    ConstBuffer input(SHORT, 3);
+    u16 parsed = 0;
+    EXPECT(not input.pop_hex(parsed) && input.size == 3, "");
+    u8 storage[3];
+    MutableBuffer output(storage, 3);
+    EXPECT(not output.push_hex(u16(1)) && output.size == 3, "");
+}
+
+/// Round trips of every size up to 300 and long inputs against the scalar kernels, invalid characters at every position.
+static void kernels_match_scalar() {
+    std::vector<u8> bytes(5000);
+    for(u8 & byte : bytes) {
+        byte = u8(rand());
+    }
+    usize failed = 0;
+    for(const HexCase letters : {HexCase::lower, HexCase::upper}) {
+        for(usize size = 0; size <= bytes.size(); size += (size < 300) ? 1 : 1111) {
+            std::vector<u8> expected(2 * size + 1, 0xee);
+            std::vector<u8> actual(2 * size + 1, 0xee);
+            kernels::scalar::hex_encode(bytes.data(), size, expected.data(), letters);
+            kernels::hex_encode(bytes.data(), size, actual.data(), letters);
+            failed += (expected != actual);
+
+            std::vector<u8> decoded(size + 1, 0xee);
+            failed += not kernels::hex_decode(actual.data(), size, decoded.data());
+            failed += (std::memcmp(decoded.data(), bytes.data(), size) != 0);
+            failed += (decoded[size] != 0xee);
+
+            if(size > 0 && size < 100) {
+                for(usize position = 0; position < 2 * size; ++position) {
+                    const u8 original = actual[position];
+                    for(const u8 bad : {u8('/'), u8(':'), u8('@'), u8('G'), u8('`'), u8('g'), u8(0x80), u8(0xb0), u8(0)}) {
+                        actual[position] = bad;
+                        failed += kernels::hex_decode(actual.data(), size, decoded.data());
+                    }
+                    actual[position] = original;
+                }
+            }
+        }
+    }
+    EXPECT(failed == 0, "hex failed " << failed);
+}
+
+void test_hex() {
+    known_values();
+    invalid();
+    integers();
+    kernels_match_scalar();
+}
+
+}
@@ -0,0 +1,126 @@
+#include "helpers/all.h"
+
+#include "tests/test.h"
+
+#include "bits/stdc++.h"
+
+namespace sedfer::test {
+
+/// RFC 1071 reference: sum of big-endian 16-bit words with end-around carry.
+static u16 reference(const u8 * data, usize size) {
+    u32 sum = 0;
+    for(usize i = 0; i < size; i += 2) {
+        sum += (u32(data[i]) << 8) | (i + 1 < size ? data[i + 1] : 0);
+        sum = (sum & 0xffff) + (sum >> 16);
+    }
+    return u16(~sum);
+}
+
+static void known_values() {
+    // IPv4 header with the checksum field zeroed.
+    u8 header[] = {0x45, 0x00, 0x00, 0x73, 0x00, 0x00, 0x40, 0x00, 0x40, 0x11,
+                   0x00, 0x00, 0xc0, 0xa8, 0x00, 0x01, 0xc0, 0xa8, 0x00, 0xc7};
+    const u16 checksum = inet_checksum(header);
+    EXPECT(checksum == 0xb861, std::hex << checksum);
+    header[10] = u8(checksum >> 8);
+    header[11] = u8(checksum);
+    EXPECT(inet_checksum(header) == 0, std::hex << inet_checksum(header));
+    EXPECT(inet_checksum(ConstBuffer()) == 0xffff, "");
+}
+
+static void kernels_match_reference() {
+    std::vector<u8> bytes(100000);
+    usize failed = 0;
+    for(const u8 fill : {u8(0x00), u8(0xff), u8(0x5a)}) {
+        for(usize i = 0; i < bytes.size(); ++i) {
+            bytes[i] = fill == 0x5a ? u8(rand()) : fill;
+        }
+        for(usize size = 0; size < 300; ++size) {
+            const usize offset = rand() % 8;
+            failed += (u16(~kernels::inet_fold(kernels::inet_sum(bytes.data() + offset, size))) != reference(bytes.data() + offset, size));
+        }
+        for(const usize size : {usize(4095), usize(65535), usize(99990)}) {
+            failed += (u16(~kernels::inet_fold(kernels::inet_sum(bytes.data() + 1, size))) != reference(bytes.data() + 1, size));
+        }
+    }
+    EXPECT(failed == 0, "inet_sum failed " << failed);
+}
+
+/// Inputs past one accumulator block (kernels::sse2::INET_SUM_BLOCK iterations) of mostly 0xff words, the fastest growing lanes.
+static void several_blocks() {
+    std::vector<u8> bytes((usize(129) << 20) + 5, 0xff);
+    for(usize i = 0; i < bytes.size(); i += 4093) {
+        bytes[i] = u8(rand());
+    }
+    const u16 checksum = inet_checksum({bytes.data() + 1, bytes.size() - 1});
+    EXPECT(checksum == reference(bytes.data() + 1, bytes.size() - 1), std::hex << checksum);
+}
+
+static void chained() {
+    std::vector<u8> bytes(3000);
+    for(u8 & byte : bytes) {
+        byte = u8(rand());
+    }
+    const u16 whole = inet_checksum({bytes.data(), bytes.size()});
+    usize failed = 0;
+    for(usize round = 0; round < 100; ++round) {
+        InetChecksum checksum;
+        ConstBuffer rest(bytes.data(), bytes.size());
+        while(rest.size != 0) {
+            checksum.update(rest.pop_buffer(std::min(rest.size, usize(rand() % 200))));
+        }
+        failed += (checksum.value() != whole);
+    }
+    EXPECT(failed == 0, "failed " << failed);
+
+    // Words appended after an odd-sized buffer.
+    static const u8 DATA[] = {0x12, 0x34, 0x56, 0x78, 0x9a};
+    InetChecksum checksum;
+    checksum.update({DATA, 3});
+    checksum.update_word(0x789a);
+    EXPECT(checksum.value() == inet_checksum(DATA), std::hex << checksum.value());
+    EXPECT(InetChecksum().value() == 0xffff, "");
+}
+
+static void incremental_update() {
+    std::vector<u8> bytes(64);
+    usize failed = 0;
+    for(usize round = 0; round < 1000; ++round) {
+        for(u8 & byte : bytes) {
+            byte = u8(rand());
+        }
+        u16 checksum = inet_checksum({bytes.data(), bytes.size()});
+        const usize offset = rand() % 60;
+        const usize size = 1 + rand() % 4;
+        u8 old_bytes[4];
+        std::memcpy(old_bytes, bytes.data() + offset, size);
+        for(usize i = 0; i < size; ++i) {
+            bytes[offset + i] = u8(rand());
+        }
+        failed += not inet_checksum_update(checksum, {old_bytes, size}, {bytes.data() + offset, size}, offset);
+        failed += (checksum != inet_checksum({bytes.data(), bytes.size()}));
+    }
+    EXPECT(failed == 0, "failed " << failed);
+
+    // Packed field changed in place.
+    struct [[gnu::packed]] Header {
+        packed<u16> id;
+        packed<u16> ttl;
+    } header = {0x1234, 0x4000};
+    u16 checksum = inet_checksum(header);
+    const packed<u16> old_ttl = header.ttl;
+    header.ttl = 0x3f00;
+    EXPECT(inet_checksum_update(checksum, old_ttl, header.ttl, offsetof(Header, ttl)), "");
+    EXPECT(checksum == inet_checksum(header), std::hex << checksum);
+    EXPECT(not inet_checksum_update(checksum, old_ttl, header, 0), "size mismatch");
+}
+
+void test_inet_checksum() {
+    known_values();
+    kernels_match_reference();
+    several_blocks();
+    chained();
+    incremental_update();
+}
+
+}
@@ -0,0 +1,95 @@
+#include "helpers/all.h"
+
+#include "tests/test.h"
+
+#include "bits/stdc++.h"
+
+namespace sedfer::test {
+
+static ConstBuffer text(const char * string) {
+    return {reinterpret_cast<const u8 *>(string), std::strlen(string)};
+}
+
+static void constructor() {
+    const KeyBuffer empty;
+    EXPECT(empty.size() == 0, "size " << empty.size());
+    EXPECT(empty.is_inline(), "");
+
+    const char * const short_string = "hello world!";
+    const KeyBuffer short_key(text(short_string));
+    EXPECT(short_key.size() == 12, "size " << short_key.size());
+    EXPECT(short_key.is_inline(), "");
+    EXPECT(short_key.data() != reinterpret_cast<const u8 *>(short_string), "");
+    EXPECT(equal(short_key, text(short_string)), "");
+    EXPECT(short_key.prefix() == 0x68656c6c, "prefix " << short_key.prefix());
+
+    const char * const long_string = "hello world, long key";
+    const KeyBuffer long_key(text(long_string));
+    EXPECT(long_key.size() == 21, "size " << long_key.size());
+    EXPECT(not long_key.is_inline(), "");
+    EXPECT(long_key.data() == reinterpret_cast<const u8 *>(long_string), "");
+    EXPECT(equal(long_key.buffer(), text(long_string)), "");
+    EXPECT(long_key.prefix() == 0x68656c6c, "prefix " << long_key.prefix());
+
+    const KeyBuffer copy = long_key;
+    EXPECT(copy.data() == long_key.data(), "");
+
+    KeyBuffer checked;
+    EXPECT(KeyBuffer::from(text(long_string), checked) && checked == long_key, "");
+    // Never dereferenced: the size is rejected first.
+    EXPECT(not KeyBuffer::from({reinterpret_cast<const u8 *>(long_string), KeyBuffer::MAX_SIZE}, checked), "");
+    EXPECT(checked == long_key, "");
+}
+
+static void equality() {
+    const char * const strings[] = {"", "a", "ab", "abc", "abcd", "abcde", "abcdefghijkl", "abcdefghijklm",
+                                    "abcdefghijklmnopqrstuvwxyz", "abcdefghijklmnopqrstuvwxyZ", "b", "abce"};
+    for(const char * left : strings) {
+        for(const char * right : strings) {
+            // Copy right to a different address, long keys must compare content, not pointers.
+            const std::string right_copy = right;
+            const KeyBuffer left_key(text(left));
+            const KeyBuffer right_key(text(right_copy.c_str()));
+            EXPECT((left_key == right_key) == (std::strcmp(left, right) == 0), "'" << left << "' == '" << right << "'");
+        }
+    }
+}
+
+static void ordering() {
+    std::vector<std::string> strings = {"", "a", "ab", "abc", "abcd", "abcde", "abcdefghijkl", "abcdefghijklm",
+                                        "abcdefghijklmnopqrstuvwxyz", "abcdefghijklmnopqrstuvwxyZ", "b", "abce",
+                                        std::string("ab\0", 3), std::string("ab\0\0", 4), std::string("abcdefghijkl\0", 13),
+                                        "\xff", "\xff\xff\xff\xff\x01", "zzzz", "zzzzzzzzzzzzzzzzzz"};
+
+    for(const std::string & left : strings) {
+        for(const std::string & right : strings) {
+            const KeyBuffer left_key({reinterpret_cast<const u8 *>(left.data()), left.size()});
+            const KeyBuffer right_key({reinterpret_cast<const u8 *>(right.data()), right.size()});
+            const bool expected = std::lexicographical_compare(
+                    reinterpret_cast<const u8 *>(left.data()), reinterpret_cast<const u8 *>(left.data()) + left.size(),
+                    reinterpret_cast<const u8 *>(right.data()), reinterpret_cast<const u8 *>(right.data()) + right.size());
+            EXPECT((left_key < right_key) == expected, "'" << left << "' < '" << right << "'");
+            EXPECT((left_key <=> right_key == 0) == (left == right), "'" << left << "' <=> '" << right << "'");
+        }
+    }
+}
+
+static void hash() {
+    const std::string a = "abcdefghijklmnopqrstuvwxyz";
+    const std::string b = a;
+    const KeyBuffer key_a(text(a.c_str()));
+    const KeyBuffer key_b(text(b.c_str()));
+    EXPECT(std::hash<KeyBuffer>()(key_a) == std::hash<KeyBuffer>()(key_b), "");
+
+    std::unordered_set<KeyBuffer> set = {key_a, key_b, KeyBuffer(text("a")), KeyBuffer(text("a"))};
+    EXPECT(set.size() == 2, "size " << set.size());
+}
+
+void test_key_buffer() {
+    constructor();
+    equality();
+    ordering();
+    hash();
+}
+
+}
@@ -8,8 +8,32 @@ namespace sedfer::test {
 usize stats::passed = 0;
 usize stats::failed = 0;
 
+void test_aligned_buffer();
+void test_base64();
+void test_bitwise();
+void test_compact_buffer();
+void test_compare();
 void test_const_buffer();
+void test_copy();
+void test_copy_pool();
+void test_cpu();
+void test_crc32c();
+void test_decimal();
+void test_dynamic_buffer();
+void test_fill();
+void test_finder();
+void test_hash();
+void test_hex();
+void test_inet_checksum();
+void test_key_buffer();
 void test_mutable_buffer();
+void test_pattern_set();
+void test_region();
+void test_search();
+void test_split();
+void test_statistics();
+void test_translate();
+void test_utf8();
 
 static void print_result() {
     if(test::stats::failed) {
@@ -19,9 +43,45 @@ static void print_result() {
     }
 }
 
-static void test_all() {
+static void test_tier() {
+    test_aligned_buffer();
+    test_base64();
+    test_bitwise();
+    test_compact_buffer();
+    test_compare();
     test_const_buffer();
+    test_copy();
+    test_copy_pool();
+    test_cpu();
+    test_crc32c();
+    test_decimal();
+    test_dynamic_buffer();
+    test_fill();
+    test_finder();
+    test_hash();
+    test_hex();
+    test_inet_checksum();
+    test_key_buffer();
     test_mutable_buffer();
+    test_pattern_set();
+    test_region();
+    test_search();
+    test_split();
+    test_statistics();
+    test_translate();
+    test_utf8();
+}
+
+/// \brief Run every test at every tier this CPU supports (dispatchers follow cpu_tier()), highest first.
+static void test_all() {
+    const CpuTier initial = cpu_tier();
+    for(u8 tier = u8(initial) + 1; tier-- > 0;) {
+        const usize failed = stats::failed;
+        set_cpu_tier(CpuTier(tier));
+        test_tier();
+        std::cout << cpu_tier_name(CpuTier(tier)) << (stats::failed == failed ? ": OK" : ": FAILED") << std::endl;
+    }
+    set_cpu_tier(initial);
 
     print_result();
 }
@@ -1759,6 +1759,39 @@ static void skip_back() {
     EXPECT(buffer.size == 9, "size " << buffer.size);
 }
 
+static void fill() {
+    u8 bytes[] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09};
+
+    MutableBuffer buffer(bytes + 1, 7);
+    buffer.fill(0xaa);
+    EXPECT(bytes[0] == 0x01 && bytes[8] == 0x09, "");
+    EXPECT(std::all_of(bytes + 1, bytes + 8, [](u8 byte) { return byte == 0xaa; }), "");
+    EXPECT(buffer.size == 7, "size " << buffer.size);
+}
+
+static void fill_pattern() {
+    u8 bytes[] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09};
+    static const u8 PATTERN[] = {0xa0, 0xb0, 0xc0};
+
+    MutableBuffer buffer(bytes + 1, 7);
+    EXPECT(buffer.fill_pattern(PATTERN), "");
+    const u8 expected[] = {0x01, 0xa0, 0xb0, 0xc0, 0xa0, 0xb0, 0xc0, 0xa0, 0x09};
+    EXPECT(std::equal(bytes, bytes + 9, expected), "");
+
+    EXPECT(not buffer.fill_pattern(ConstBuffer()), "");
+    u8 long_pattern[65] = {};
+    EXPECT(not buffer.fill_pattern(long_pattern), "");
+    EXPECT(std::equal(bytes, bytes + 9, expected), "");
+}
+
+static void secure_zero() {
+    u8 bytes[] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09};
+
+    MutableBuffer(bytes, 8).secure_zero();
+    EXPECT(std::all_of(bytes, bytes + 8, [](u8 byte) { return byte == 0; }), "");
+    EXPECT(bytes[8] == 0x09, "");
+}
+
 void test_mutable_buffer() {
     constructor_from_parts();
     default_constructor();
@@ -1807,6 +1840,10 @@ void test_mutable_buffer() {
 
     skip();
     skip_back();
+
+    fill();
+    fill_pattern();
+    secure_zero();
 }
 
 }
@@ -0,0 +1,156 @@
+#include "helpers/all.h"
+
+#include "tests/test.h"
+
+#include "bits/stdc++.h"
+
+namespace sedfer::test {
+
+static std::vector<PatternMatch> naive_find_all(const std::vector<std::string> & patterns, const std::string & text) {
+    std::vector<PatternMatch> ret;
+    for(u32 index = 0; index < patterns.size(); ++index) {
+        if(patterns[index].empty()) {
+            continue;
+        }
+        for(usize offset = text.find(patterns[index]); offset != std::string::npos; offset = text.find(patterns[index], offset + 1)) {
+            ret.push_back({offset, index});
+        }
+    }
+    std::sort(ret.begin(), ret.end());
+    return ret;
+}
+
+static std::vector<ConstBuffer> as_buffers(const std::vector<std::string> & strings) {
+    std::vector<ConstBuffer> ret;
+    for(const std::string & s : strings) {
+        ret.emplace_back(reinterpret_cast<const u8 *>(s.data()), s.size());
+    }
+    return ret;
+}
+
+static ConstBuffer as_buffer(const std::string & s) {
+    return {reinterpret_cast<const u8 *>(s.data()), s.size()};
+}
+
+static std::string random_string(usize size, u32 range) {
+    std::string ret;
+    for(usize i = 0; i < size; ++i) {
+        ret.push_back(char('a' + rand() % range));
+    }
+    return ret;
+}
+
+static void basic() {
+    const std::vector<std::string> patterns = {"he", "she", "his", "hers", ""};
+    const std::string text = "ushers and his hershey";
+
+    for(const PatternEngine engine : {PatternEngine::automatic, PatternEngine::teddy, PatternEngine::automaton}) {
+        const PatternSet set(as_buffers(patterns), engine);
+        EXPECT(set.size() == 5, "size " << set.size());
+        EXPECT(set.engine() != PatternEngine::automatic, "");
+
+        const std::vector<PatternMatch> matches = set.find_all(as_buffer(text));
+        const std::vector<PatternMatch> expected = {{1, 1}, {2, 0}, {2, 3}, {11, 2}, {15, 0}, {15, 3}, {18, 1}, {19, 0}};
+        EXPECT(matches == expected, "matches " << matches.size());
+
+        EXPECT(set.matches_any(as_buffer(text)), "");
+        EXPECT(not set.matches_any(as_buffer("abc")), "");
+        EXPECT(set.find_all({}).empty(), "");
+
+        usize count = 0;
+        EXPECT(not set.scan(as_buffer(text), [&](PatternMatch) { return ++count < 3; }), "");
+        EXPECT(count == 3, "count " << count);
+    }
+
+    const PatternSet empty(std::vector<ConstBuffer>{});
+    EXPECT(empty.find_all(as_buffer(text)).empty(), "");
+    EXPECT(empty.engine() == PatternEngine::automaton, "");
+}
+
+/// A set built with teddy still matches after the tier is lowered to scalar.
+static void lowered_tier() {
+    const std::vector<std::string> patterns = {"he", "she", "his", "hers"};
+    const std::string text = "ushers and his hershey";
+    const PatternSet set(as_buffers(patterns), PatternEngine::teddy);
+    const std::vector<PatternMatch> expected = set.find_all(as_buffer(text));
+
+    const CpuTier initial = cpu_tier();
+    set_cpu_tier(CpuTier::scalar);
+    EXPECT(set.find_all(as_buffer(text)) == expected, "");
+    set_cpu_tier(initial);
+}
+
+static void binary_patterns() {
+    std::vector<std::string> patterns;
+    for(usize i = 0; i < 256; ++i) {
+        patterns.push_back(std::string(1, char(i)) + char(255 - i));
+    }
+    std::string text;
+    for(usize i = 0; i < 4096; ++i) {
+        text.push_back(char(rand() % 256));
+    }
+
+    for(const PatternEngine engine : {PatternEngine::teddy, PatternEngine::automaton}) {
+        const PatternSet set(as_buffers(patterns), engine);
+        EXPECT(set.find_all(as_buffer(text)) == naive_find_all(patterns, text), "");
+    }
+}
+
+static void matches_naive() {
+    usize failed = 0;
+    for(usize iteration = 0; iteration < 300; ++iteration) {
+        const u32 range = 2 + rand() % 6;
+        std::vector<std::string> patterns(1 + rand() % 100);
+        for(std::string & pattern : patterns) {
+            pattern = random_string(1 + rand() % 8, range);
+        }
+        const std::string text = random_string(rand() % 3000, range);
+        const std::vector<PatternMatch> expected = naive_find_all(patterns, text);
+
+        for(const PatternEngine engine : {PatternEngine::teddy, PatternEngine::automaton}) {
+            const PatternSet set(as_buffers(patterns), engine);
+            failed += (set.find_all(as_buffer(text)) != expected);
+        }
+    }
+    EXPECT(failed == 0, "failed " << failed);
+}
+
+static void stream() {
+    usize failed = 0;
+    for(usize iteration = 0; iteration < 300; ++iteration) {
+        std::vector<std::string> patterns(1 + rand() % 50);
+        for(std::string & pattern : patterns) {
+            pattern = random_string(1 + rand() % 12, 3);
+        }
+        const std::string text = random_string(rand() % 1000, 3);
+        const PatternSet set(as_buffers(patterns));
+
+        std::vector<PatternMatch> matches;
+        PatternSet::Stream stream = set.stream();
+        for(usize position = 0; position < text.size();) {
+            const usize piece = std::min<usize>(text.size() - position, rand() % 20);
+            (void)stream.scan({reinterpret_cast<const u8 *>(text.data()) + position, piece}, [&](PatternMatch match) {
+                matches.push_back(match);
+                return true;
+            });
+            position += piece;
+        }
+        failed += (stream.offset() != text.size());
+        std::sort(matches.begin(), matches.end());
+        failed += (matches != naive_find_all(patterns, text));
+
+        stream.reset();
+        failed += (stream.offset() != 0);
+    }
+    EXPECT(failed == 0, "failed " << failed);
+}
+
+void test_pattern_set() {
+    basic();
+    lowered_tier();
+    binary_patterns();
+    matches_naive();
+    stream();
+}
+
+}
@@ -0,0 +1,96 @@
+#include "helpers/all.h"
+
+#include "tests/test.h"
+
+#include "bits/stdc++.h"
+
+namespace sedfer::test {
+
+static void default_constructor() {
+    Region region;
+    EXPECT(region.backing() == RegionBacking::none, "");
+    EXPECT(not region.locked(), "");
+    EXPECT(region.capacity() == 0, "capacity " << region.capacity());
+    EXPECT(region.buffer().data == nullptr, "");
+    EXPECT(region.allocate(1).data == nullptr, "");
+}
+
+static void backing() {
+    for(const bool huge_pages : {false, true}) {
+        for(const bool populate : {false, true}) {
+            Region region(3 << 20, {.huge_pages = huge_pages, .populate = populate, .lock = false});
+            EXPECT(region.backing() != RegionBacking::none, "huge_pages " << huge_pages << " populate " << populate);
+            EXPECT(region.capacity() >= (3 << 20), "capacity " << region.capacity());
+            if(not huge_pages) {
+                EXPECT(region.backing() == RegionBacking::normal, "");
+            } else {
+                EXPECT(region.capacity() % Region::HUGE_PAGE_SIZE == 0, "capacity " << region.capacity());
+            }
+
+            const MutableBuffer buffer = region.buffer();
+            std::fill_n(buffer.data, buffer.size, 0xAA);
+            EXPECT(buffer.data[buffer.size - 1] == 0xAA, "");
+        }
+    }
+}
+
+static void lock() {
+    // Locking may be forbidden by RLIMIT_MEMLOCK, only check that the region is usable either way.
+    Region region(1 << 16, {.huge_pages = false, .populate = true, .lock = true});
+    EXPECT(region.backing() == RegionBacking::normal, "");
+    EXPECT(region.buffer().size >= (1 << 16), "size " << region.buffer().size);
+}
+
+static void allocate() {
+    Region region(1 << 16, {.huge_pages = false});
+    EXPECT(region.backing() == RegionBacking::normal, "");
+
+    const MutableBuffer a = region.allocate(10);
+    EXPECT(a.data == region.buffer().data, "");
+    EXPECT(a.size == 10, "size " << a.size);
+    EXPECT(region.used() == 10, "used " << region.used());
+
+    const MutableBuffer b = region.allocate(100, 64);
+    EXPECT(b.data == region.buffer().data + 64, "");
+    EXPECT(b.size == 100, "size " << b.size);
+    EXPECT(region.used() == 164, "used " << region.used());
+
+    const MutableBuffer c = region.allocate(3, 1);
+    EXPECT(c.data == region.buffer().data + 164, "");
+
+    EXPECT(region.allocate(region.capacity()).data == nullptr, "");
+    EXPECT(region.used() == 167, "used " << region.used());
+
+    // Invalid alignments fail without touching the region.
+    EXPECT(region.allocate(1, 0).data == nullptr, "");
+    EXPECT(region.allocate(1, 48).data == nullptr, "");
+    EXPECT(region.allocate(1, usize(1) << 63).data == nullptr, "");
+    EXPECT(region.allocate(0, ~usize(0)).data == nullptr, "");
+    EXPECT(region.used() == 167, "used " << region.used());
+
+    region.reset();
+    EXPECT(region.used() == 0, "used " << region.used());
+    const MutableBuffer all = region.allocate(region.capacity());
+    EXPECT(all.data == region.buffer().data, "");
+    EXPECT(all.size == region.capacity(), "size " << all.size);
+}
+
+static void move() {
+    Region region(1 << 16, {.huge_pages = false});
+    const MutableBuffer buffer = region.buffer();
+
+    Region moved = std::move(region);
+    EXPECT(moved.buffer().data == buffer.data, "");
+    EXPECT(region.buffer().data == nullptr, "");
+    EXPECT(region.backing() == RegionBacking::none, "");
+}
+
+void test_region() {
+    default_constructor();
+    backing();
+    lock();
+    allocate();
+    move();
+}
+
+}
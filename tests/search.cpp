@@ -0,0 +1,152 @@
+#include "helpers/all.h"
+
+#include "tests/test.h"
+
+#include "bits/stdc++.h"
+
+namespace sedfer::test {
+
+template<typename T>
+concept finds = requires(ConstBuffer buffer, T value) { buffer.find(value); buffer.find_last(value); };
+
+template<typename T>
+concept pops_until = requires(ConstBuffer buffer, T value) { buffer.pop_until(value); };
+
+// Bytes and buffers are needles, wider integers are rejected instead of becoming sizeof(T)-byte needles.
+static_assert(finds<char> && finds<u8> && finds<ConstBuffer> && pops_until<char> && pops_until<ConstBuffer>);
+static_assert(not finds<int> && not finds<u32> && not finds<bool> && not pops_until<int> && not pops_until<u16>);
+
+template<typename T>
+static void fill_random(T * data, usize size, u32 range) {
+    for(usize i = 0; i < size; ++i) {
+        data[i] = rand() % range;
+    }
+}
+
+using FindByte = const u8 * (*)(const u8 *, usize, u8);
+using FindInSet = const u8 * (*)(const u8 *, usize, const ByteSet &);
+using FindPair = const u8 * (*)(const u8 *, usize, u8, u8, usize);
+using FindSubstring = const u8 * (*)(const u8 *, usize, const u8 *, usize);
+
+/// Compare kernel against the scalar reference for all sizes up to 300 and all alignments up to 64.
+static void compare_find_byte(const char * name, FindByte kernel, FindByte reference) {
+    std::vector<u8> bytes(400);
+    usize failed = 0;
+    for(usize size = 0; size <= 300; ++size) {
+        for(usize offset = 0; offset < 64; offset += 7) {
+            fill_random(bytes.data(), bytes.size(), 64);
+            const u8 value = rand() % 64;
+            const u8 * const expected = reference(bytes.data() + offset, size, value);
+            const u8 * const actual = kernel(bytes.data() + offset, size, value);
+            failed += (expected != actual);
+        }
+    }
+    EXPECT(failed == 0, name << " failed " << failed);
+}
+
+static void compare_find_in_set(const char * name, FindInSet kernel, FindInSet reference) {
+    std::vector<u8> bytes(400);
+    usize failed = 0;
+    for(usize size = 0; size <= 300; ++size) {
+        for(usize offset = 0; offset < 64; offset += 7) {
+            fill_random(bytes.data(), bytes.size(), 256);
+            ByteSet set;
+            for(usize i = 0; i < usize(1 + rand() % 8); ++i) {
+                set.insert(rand() % 256);
+            }
+            if(rand() % 2) {
+                set = ~set;
+            }
+            failed += (reference(bytes.data() + offset, size, set) != kernel(bytes.data() + offset, size, set));
+        }
+    }
+    EXPECT(failed == 0, name << " failed " << failed);
+}
+
+static void compare_find_pair(const char * name, FindPair kernel, FindPair reference) {
+    std::vector<u8> bytes(400);
+    usize failed = 0;
+    for(usize size = 0; size <= 300; ++size) {
+        for(const usize distance : {1, 2, 7, 31, 33, 80}) {
+            fill_random(bytes.data(), bytes.size(), 4);
+            const usize offset = rand() % 64;
+            const u8 first = rand() % 4;
+            const u8 last = rand() % 4;
+            failed += (reference(bytes.data() + offset, size, first, last, distance) !=
+                       kernel(bytes.data() + offset, size, first, last, distance));
+        }
+    }
+    EXPECT(failed == 0, name << " failed " << failed);
+}
+
+static const u8 * naive_find(const u8 * data, usize size, const u8 * needle, usize needle_size) {
+    for(usize i = 0; i + needle_size <= size; ++i) {
+        if(std::memcmp(data + i, needle, needle_size) == 0) {
+            return data + i;
+        }
+    }
+    return nullptr;
+}
+
+static const u8 * naive_find_last(const u8 * data, usize size, const u8 * needle, usize needle_size) {
+    for(usize i = size + 1; i > needle_size; --i) {
+        if(std::memcmp(data + i - 1 - needle_size, needle, needle_size) == 0) {
+            return data + i - 1 - needle_size;
+        }
+    }
+    return nullptr;
+}
+
+/// Small alphabets and needles cut from the haystack produce many partial matches and periodic needles.
+static void compare_find_substring(const char * name, FindSubstring kernel, FindSubstring reference) {
+    std::vector<u8> bytes(2000);
+    std::vector<u8> needle(200);
+    usize failed = 0;
+    for(usize iteration = 0; iteration < 20000; ++iteration) {
+        const u32 range = 2 + rand() % 3;
+        const usize size = rand() % 1000;
+        const usize needle_size = (rand() % 4 == 0) ? rand() % 200 : rand() % 40;
+        fill_random(bytes.data(), size, range);
+        if(rand() % 2 && needle_size <= size) {
+            std::memcpy(needle.data(), bytes.data() + rand() % (size - needle_size + 1), needle_size);
+        } else {
+            for(usize i = 0; i < needle_size; ++i) {
+                needle[i] = (i < 3) ? rand() % range : needle[rand() % i];
+            }
+        }
+        failed += (reference(bytes.data(), size, needle.data(), needle_size) !=
+                   kernel(bytes.data(), size, needle.data(), needle_size));
+    }
+    EXPECT(failed == 0, name << " failed " << failed);
+}
+
+static void byte_set() {
+    ByteSet set("az\x80\xff");
+    for(usize i = 0; i < 256; ++i) {
+        const bool expected = (i == 'a' || i == 'z' || i == 0x80 || i == 0xff);
+        EXPECT(set.contains(i) == expected, "i " << i);
+        EXPECT((~set).contains(i) != expected, "i " << i);
+    }
+
+    static constexpr ByteSet SPACES(" \t");
+    static_assert(SPACES.contains(' '));
+    static_assert(not SPACES.contains('x'));
+}
+
+static void kernels_match_reference() {
+    compare_find_byte("find_byte", kernels::find_byte, kernels::scalar::find_byte);
+    compare_find_byte("find_last_byte", kernels::find_last_byte, kernels::scalar::find_last_byte);
+    compare_find_in_set("find_in_set<true>", kernels::find_in_set<true>, kernels::scalar::find_in_set<true>);
+    compare_find_in_set("find_in_set<false>", kernels::find_in_set<false>, kernels::scalar::find_in_set<false>);
+    compare_find_pair("find_pair", kernels::find_pair, kernels::scalar::find_pair);
+    compare_find_pair("find_last_pair", kernels::find_last_pair, kernels::scalar::find_last_pair);
+    compare_find_substring("find_substring", kernels::find_substring, naive_find);
+    compare_find_substring("find_last_substring", kernels::find_last_substring, naive_find_last);
+}
+
+void test_search() {
+    byte_set();
+    kernels_match_reference();
+}
+
+}
@@ -0,0 +1,161 @@
+#include "helpers/all.h"
+
+#include "tests/test.h"
+
+#include "bits/stdc++.h"
+
+namespace sedfer::test {
+
+static_assert(std::ranges::forward_range<SplitRange<ByteDelimiter>>);
+static_assert(std::ranges::view<SplitRange<ByteSetDelimiter>>);
+static_assert(std::ranges::borrowed_range<SplitRange<ByteDelimiter, true>>);
+
+static ConstBuffer bytes_of(std::string_view text) {
+    return {reinterpret_cast<const u8 *>(text.data()), text.size()};
+}
+
+static std::string text_of(ConstBuffer buffer) {
+    return {reinterpret_cast<const char *>(buffer.data), buffer.size};
+}
+
+template<typename Range>
+static std::vector<std::string> pieces(Range && range) {
+    std::vector<std::string> ret;
+    for(const ConstBuffer piece : range) {
+        ret.push_back(text_of(piece));
+    }
+    return ret;
+}
+
+/// Reference split: n delimiters give n + 1 pieces, an empty text gives none. trim_lines drops a '\r' before each delimiter.
+static std::vector<std::string> reference_split(std::string_view text, const ByteSet & set, bool trim_lines) {
+    std::vector<std::string> ret;
+    if(text.empty()) {
+        return ret;
+    }
+    usize begin = 0;
+    for(usize i = 0; i <= text.size(); ++i) {
+        if(i == text.size() || set.contains(u8(text[i]))) {
+            std::string piece(text.substr(begin, i - begin));
+            if(trim_lines && i != text.size() && not piece.empty() && piece.back() == '\r') {
+                piece.pop_back();
+            }
+            if(not (trim_lines && i == text.size() && begin == text.size())) {
+                ret.push_back(piece);
+            }
+            begin = i + 1;
+        }
+    }
+    return ret;
+}
+
+using Pieces = std::vector<std::string>;
+
+static void known_values() {
+    EXPECT(pieces(split(bytes_of(""), ',')).empty(), "");
+    EXPECT(pieces(split(bytes_of("a"), ',')) == Pieces({"a"}), "");
+    EXPECT(pieces(split(bytes_of(","), ',')) == Pieces({"", ""}), "");
+    EXPECT(pieces(split(bytes_of("a,,b,"), ',')) == Pieces({"a", "", "b", ""}), "");
+    EXPECT(pieces(split(bytes_of(",a"), ',')) == Pieces({"", "a"}), "");
+
+    static constexpr ByteSet SEPARATORS(",; ");
+    EXPECT(pieces(split_any(bytes_of("a,b;c d"), SEPARATORS)) == Pieces({"a", "b", "c", "d"}), "");
+    EXPECT(pieces(split_any(bytes_of("a, b"), SEPARATORS)) == Pieces({"a", "", "b"}), "");
+
+    EXPECT(pieces(lines(bytes_of(""))).empty(), "");
+    EXPECT(pieces(lines(bytes_of("\n"))) == Pieces({""}), "");
+    EXPECT(pieces(lines(bytes_of("a\nb"))) == Pieces({"a", "b"}), "");
+    EXPECT(pieces(lines(bytes_of("a\r\nb\r\n"))) == Pieces({"a", "b"}), "");
+    EXPECT(pieces(lines(bytes_of("a\n\nb\n"))) == Pieces({"a", "", "b"}), "");
+    EXPECT(pieces(lines(bytes_of("a\rb\r"))) == Pieces({"a\rb\r"}), "");
+    EXPECT(pieces(lines(bytes_of("a\r\nb\r"))) == Pieces({"a", "b\r"}), "");
+    EXPECT(pieces(lines(bytes_of("\r\n\r\n"))) == Pieces({"", ""}), "");
+}
+
+static void ranges() {
+    const std::string text = "GET /index.html HTTP/1.1\r\nHost: example.com\r\nAccept: */*\r\n\r\n";
+    const auto headers = lines(bytes_of(text));
+    EXPECT(std::ranges::distance(headers) == 4, std::ranges::distance(headers));
+
+    // Header names, up to the empty line.
+    Pieces names;
+    for(const ConstBuffer line : headers | std::views::drop(1) | std::views::take_while([](ConstBuffer line) { return line.size != 0; })) {
+        names.push_back(text_of(*split(line, ':').begin()));
+    }
+    EXPECT(names == Pieces({"Host", "Accept"}), names.size());
+
+    auto non_empty = split(bytes_of("a,,b,,,c"), ',') | std::views::filter([](ConstBuffer piece) { return piece.size != 0; });
+    EXPECT(std::ranges::distance(non_empty) == 3, "");
+
+    // Iterators are regular: copies advance independently.
+    auto first = split(bytes_of("x,y,z"), ',').begin();
+    auto second = first;
+    ++second;
+    EXPECT(first != second && text_of(*first) == "x" && text_of(*second) == "y", "");
+    EXPECT(text_of(*std::ranges::next(first, 2)) == "z" && std::ranges::next(first, 3) == std::default_sentinel, "");
+
+    // Borrowed: pieces outlive the range object.
+    const auto found = std::ranges::find_if(split(bytes_of(text), ' '), [](ConstBuffer piece) { return piece.size > 0 && piece.data[0] == '/'; });
+    EXPECT(text_of(*found) == "/index.html", text_of(*found));
+}
+
+/// Random text with delimiters of varying density, every size and alignment against reference_split.
+static void compare_reference() {
+    static constexpr ByteSet NEWLINE("\n");
+    static constexpr ByteSet SEPARATORS(",;\t\xff");
+    usize failed = 0;
+    for(const u32 density : {2u, 10u, 100u, 1000u}) {
+        std::string text(5000, '\0');
+        for(char & c : text) {
+            const u32 r = u32(rand());
+            if(r % density == 0) {
+                c = "\n\r,;\t\xff"[(r / density) % 6];
+            } else {
+                c = char(' ' + (r >> 8) % 95);
+            }
+        }
+        for(usize size = 0; size <= text.size(); size += (size < 300) ? 1 : 97) {
+            for(usize offset = 0; offset < 3 && offset + size <= text.size(); ++offset) {
+                const std::string_view view(text.data() + offset, size);
+                failed += pieces(split(bytes_of(view), '\n')) != reference_split(view, NEWLINE, false);
+                failed += pieces(lines(bytes_of(view))) != reference_split(view, NEWLINE, true);
+                failed += pieces(split_any(bytes_of(view), SEPARATORS)) != reference_split(view, SEPARATORS, false);
+            }
+        }
+    }
+    EXPECT(failed == 0, "failed " << failed);
+}
+
+/// Every block size and every delimiter position against the scalar kernels, nothing past the block is read.
+static void kernels_match_scalar() {
+    static constexpr ByteSet SET(std::string_view("\x00\n,\x7f\x80\xff", 6));
+    usize failed = 0;
+    std::vector<u8> bytes(64);
+    for(usize size = 0; size <= 64; ++size) {
+        for(usize position = 0; position < size; ++position) {
+            for(usize i = 0; i < size; ++i) {
+                bytes[i] = u8('a' + i % 26);
+            }
+            for(const u8 delimiter : {u8('\n'), u8(0x00), u8(0x80), u8(0xff)}) {
+                bytes[position] = delimiter;
+                bytes[size - 1 - (position * 7) % size] = delimiter;
+                // Heap block of exactly size bytes: ASan reports reads past the end.
+                const std::unique_ptr<u8[]> block(new u8[size]);
+                std::copy_n(bytes.begin(), size, block.get());
+                failed += kernels::delimiter_mask(block.get(), size, delimiter) != kernels::scalar::delimiter_mask(block.get(), size, delimiter);
+                failed += kernels::delimiter_set_mask(block.get(), size, SET) != kernels::scalar::delimiter_set_mask(block.get(), size, SET);
+                failed += (kernels::scalar::delimiter_mask(block.get(), size, delimiter) >> position & 1) == 0;
+            }
+        }
+    }
+    EXPECT(failed == 0, "delimiter_mask failed " << failed);
+}
+
+void test_split() {
+    known_values();
+    ranges();
+    compare_reference();
+    kernels_match_scalar();
+}
+
+}
@@ -0,0 +1,94 @@
+#include "helpers/all.h"
+
+#include "tests/test.h"
+
+#include "bits/stdc++.h"
+
+namespace sedfer::test {
+
+/// Sizes up to 300 and long inputs (counter reduction), small alphabets give many matches.
+template<typename F>
+static void for_each_input(F f) {
+    std::vector<u8> bytes(20000);
+    for(usize size : {usize(0), usize(1), usize(15), usize(16), usize(17), usize(127), usize(128), usize(300),
+                      usize(8191), usize(19999)}) {
+        for(const u32 range : {2u, 16u, 256u}) {
+            const usize offset = rand() % 64;
+            size = std::min(size, bytes.size() - offset);
+            for(u8 & byte : bytes) {
+                byte = rand() % range;
+            }
+            f(bytes.data() + offset, size);
+        }
+    }
+    // All bytes equal: every per-byte counter is incremented on every vector.
+    std::fill(bytes.begin(), bytes.end(), 0xff);
+    f(bytes.data(), bytes.size());
+}
+
+static void kernels_match_reference() {
+    usize failed = 0;
+    for_each_input([&](const u8 * data, usize size) {
+        for(const u8 value : {u8(0), u8(1), u8(0xff)}) {
+            failed += (kernels::count(data, size, value) != usize(std::count(data, data + size, value)));
+        }
+    });
+    EXPECT(failed == 0, "count failed " << failed);
+
+    failed = 0;
+    for_each_input([&](const u8 * data, usize size) {
+        usize expected = 0;
+        for(usize i = 0; i < size; ++i) {
+            expected += std::popcount(data[i]);
+        }
+        failed += (kernels::popcount(data, size) != expected);
+    });
+    EXPECT(failed == 0, "popcount failed " << failed);
+
+    failed = 0;
+    for_each_input([&](const u8 * data, usize size) {
+        ByteHistogram expected = {};
+        for(usize i = 0; i < size; ++i) {
+            ++expected[data[i]];
+        }
+        failed += (histogram({data, size}) != expected);
+    });
+    EXPECT(failed == 0, "histogram failed " << failed);
+}
+
+static void buffer_statistics() {
+    static const u8 BYTES[] = {0x00, 0x00, 'a', 'b', 0xff, 0x80, 0x01, 0x00};
+    const ConstBuffer buffer(BYTES, 8);
+
+    EXPECT(buffer.count(u8(0x00)) == 3, "count " << buffer.count(u8(0x00)));
+    EXPECT(buffer.count('a') == 1, "count " << buffer.count('a'));
+    EXPECT(buffer.count(u8(0x7f)) == 0, "count " << buffer.count(u8(0x7f)));
+    EXPECT(popcount(buffer) == 3 + 3 + 8 + 1 + 1, "popcount " << popcount(buffer));
+
+    const ByteStats stats = byte_stats(buffer);
+    EXPECT(stats.size == 8, "size " << stats.size);
+    EXPECT(stats.zero_bytes == 3, "zero_bytes " << stats.zero_bytes);
+    EXPECT(stats.ascii_bytes == 6, "ascii_bytes " << stats.ascii_bytes);
+    EXPECT(stats.set_bits == 16, "set_bits " << stats.set_bits);
+    EXPECT(stats.zero_ratio() == 3.0 / 8, "zero_ratio " << stats.zero_ratio());
+    EXPECT(stats.ascii_ratio() == 6.0 / 8, "ascii_ratio " << stats.ascii_ratio());
+    const double entropy = -(3.0 / 8) * std::log2(3.0 / 8) - 5 * (1.0 / 8) * std::log2(1.0 / 8);
+    EXPECT(std::abs(stats.entropy - entropy) < 1e-9, "entropy " << stats.entropy);
+
+    // Constant input has zero entropy, all 256 values equally often have 8 bits.
+    std::vector<u8> uniform(256 * 16);
+    for(usize i = 0; i < uniform.size(); ++i) {
+        uniform[i] = u8(i);
+    }
+    EXPECT(std::abs(byte_stats({uniform.data(), uniform.size()}).entropy - 8) < 1e-9, "");
+    std::fill(uniform.begin(), uniform.end(), 'x');
+    EXPECT(byte_stats({uniform.data(), uniform.size()}).entropy == 0, "");
+    EXPECT(byte_stats(ConstBuffer()).entropy == 0 && byte_stats(ConstBuffer()).zero_ratio() == 0, "");
+}
+
+void test_statistics() {
+    kernels_match_reference();
+    buffer_statistics();
+}
+
+}
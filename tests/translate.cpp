@@ -0,0 +1,113 @@
+#include "helpers/all.h"
+
+#include "tests/test.h"
+
+#include "bits/stdc++.h"
+
+namespace sedfer::test {
+
+static ConstBuffer bytes_of(std::string_view text) {
+    return {reinterpret_cast<const u8 *>(text.data()), text.size()};
+}
+
+static std::string lower(std::string text) {
+    MutableBuffer(reinterpret_cast<u8 *>(text.data()), text.size()).to_lower();
+    return text;
+}
+
+static std::string upper(std::string text) {
+    MutableBuffer(reinterpret_cast<u8 *>(text.data()), text.size()).to_upper();
+    return text;
+}
+
+static void known_values() {
+    EXPECT(lower("") == "", lower(""));
+    EXPECT(lower("Content-Type: TEXT/html; @[`{ \xc3\x89t\xc3\xa9") == "content-type: text/html; @[`{ \xc3\x89t\xc3\xa9",
+           lower("Content-Type: TEXT/html; @[`{ \xc3\x89t\xc3\xa9"));
+    EXPECT(upper("Content-Type: TEXT/html; @[`{ \xc3\x89t\xc3\xa9") == "CONTENT-TYPE: TEXT/HTML; @[`{ \xc3\x89T\xc3\xa9",
+           upper("Content-Type: TEXT/html; @[`{ \xc3\x89t\xc3\xa9"));
+
+    const std::string_view source = "Mixed Case Header-Name With Some Length 0123456789";
+    std::string destination(source.size(), '\0');
+    const MutableBuffer output(reinterpret_cast<u8 *>(destination.data()), destination.size());
+    EXPECT(to_lower(output, bytes_of(source)) && destination == "mixed case header-name with some length 0123456789", destination);
+    EXPECT(to_upper(output, bytes_of(source)) && destination == "MIXED CASE HEADER-NAME WITH SOME LENGTH 0123456789", destination);
+    EXPECT(not to_lower(output, bytes_of("short")), "");
+    EXPECT(not to_upper(output, bytes_of("short")), "");
+
+    EXPECT(equal_icase(bytes_of("Content-Length"), bytes_of("content-LENGTH")), "");
+    EXPECT(equal_icase(bytes_of(""), bytes_of("")), "");
+    EXPECT(not equal_icase(bytes_of("Content-Length"), bytes_of("Content-Lengt")), "");
+    EXPECT(not equal_icase(bytes_of("Content-Length"), bytes_of("Content_Length")), "");
+    // Letters differ from '@' '[' '`' '{' only in bit 5 or by one: not equal.
+    EXPECT(not equal_icase(bytes_of("@[`{"), bytes_of("`{@[")), "");
+    EXPECT(not equal_icase(bytes_of("\xc3\x89"), bytes_of("\xc3\xa9")), "");
+
+    static constexpr ByteMap SLASHES("\\", "/");
+    std::string path = "C:\\Program Files\\app\\bin\\tool.exe";
+    MutableBuffer(reinterpret_cast<u8 *>(path.data()), path.size()).translate(SLASHES);
+    EXPECT(path == "C:/Program Files/app/bin/tool.exe", path);
+    static constexpr ByteMap ROT13("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz",
+                                   "NOPQRSTUVWXYZABCDEFGHIJKLMnopqrstuvwxyzabcdefghijklm");
+    std::string rot = "Hello, World! Uryyb, Jbeyq!";
+    EXPECT(translate(MutableBuffer(reinterpret_cast<u8 *>(rot.data()), rot.size()), bytes_of(rot), ROT13), "");
+    EXPECT(rot == "Uryyb, Jbeyq! Hello, World!", rot);
+    EXPECT(not translate(MutableBuffer(reinterpret_cast<u8 *>(rot.data()), 3), bytes_of(rot), ROT13), "");
+}
+
+/// Every byte value at every position of every size up to 200 against std::tolower / std::toupper in the C locale.
+static void kernels_match_scalar() {
+    usize failed = 0;
+    std::vector<u8> bytes(1000);
+    for(usize i = 0; i < bytes.size(); ++i) {
+        bytes[i] = u8(i * 7 + i / 256);
+    }
+    ByteMap map;
+    for(usize i = 0; i < 256; ++i) {
+        map.set(u8(i), u8(rand()));
+    }
+    for(usize size = 0; size <= bytes.size(); size += (size < 200) ? 1 : 199) {
+        std::vector<u8> expected_lower(size + 1, 0xee);
+        std::vector<u8> expected_upper(size + 1, 0xee);
+        std::vector<u8> expected_map(size + 1, 0xee);
+        for(usize i = 0; i < size; ++i) {
+            expected_lower[i] = u8(bytes[i] < 0x80 ? std::tolower(bytes[i]) : bytes[i]);
+            expected_upper[i] = u8(bytes[i] < 0x80 ? std::toupper(bytes[i]) : bytes[i]);
+            expected_map[i] = map[bytes[i]];
+        }
+        std::vector<u8> actual(size + 1, 0xee);
+        kernels::change_case<false>(actual.data(), bytes.data(), size);
+        failed += actual != expected_lower;
+        kernels::change_case<true>(actual.data(), bytes.data(), size);
+        failed += actual != expected_upper;
+        kernels::translate(actual.data(), bytes.data(), size, map);
+        failed += actual != expected_map;
+        // In place.
+        std::copy_n(bytes.begin(), size, actual.begin());
+        kernels::change_case<false>(actual.data(), actual.data(), size);
+        failed += actual != expected_lower;
+
+        failed += not kernels::equal_icase(expected_lower.data(), expected_upper.data(), size);
+        failed += not kernels::equal_icase(bytes.data(), expected_upper.data(), size);
+        if(size <= 200) {
+            // Any other byte at any position differs.
+            for(usize position = 0; position < size; ++position) {
+                const u8 original = actual[position];
+                for(const u8 other : {u8(original ^ 0x20), u8(original ^ 0x01), u8(original ^ 0x80)}) {
+                    actual[position] = other;
+                    const bool same_letter = std::tolower(original) == std::tolower(other) && original < 0x80 && other < 0x80;
+                    failed += kernels::equal_icase(actual.data(), expected_upper.data(), size) != same_letter;
+                }
+                actual[position] = original;
+            }
+        }
+    }
+    EXPECT(failed == 0, "translate failed " << failed);
+}
+
+void test_translate() {
+    known_values();
+    kernels_match_scalar();
+}
+
+}
@@ -0,0 +1,335 @@
+#include "helpers/all.h"
+
+#include "tests/test.h"
+
+#include "bits/stdc++.h"
+
+namespace sedfer::test {
+
+/// Well-formed byte sequences table of the Unicode standard (3.9, table 3-7), independent of the kernels.
+static bool reference_valid(const u8 * data, usize size) {
+    usize i = 0;
+    while(i < size) {
+        const u8 lead = data[i];
+        usize length = 1;
+        u8 low = 0x80;
+        u8 high = 0xbf;
+        if(lead < 0x80) {
+            ++i;
+            continue;
+        } else if(lead >= 0xc2 && lead <= 0xdf) {
+            length = 2;
+        } else if(lead >= 0xe0 && lead <= 0xef) {
+            length = 3;
+            low = (lead == 0xe0) ? 0xa0 : 0x80;
+            high = (lead == 0xed) ? 0x9f : 0xbf;
+        } else if(lead >= 0xf0 && lead <= 0xf4) {
+            length = 4;
+            low = (lead == 0xf0) ? 0x90 : 0x80;
+            high = (lead == 0xf4) ? 0x8f : 0xbf;
+        } else {
+            return false;
+        }
+        if(size - i < length || data[i + 1] < low || data[i + 1] > high) {
+            return false;
+        }
+        for(usize j = 2; j < length; ++j) {
+            if(data[i + j] < 0x80 || data[i + j] > 0xbf) {
+                return false;
+            }
+        }
+        i += length;
+    }
+    return true;
+}
+
+static ConstBuffer bytes_of(std::string_view text) {
+    return {reinterpret_cast<const u8 *>(text.data()), text.size()};
+}
+
+template<typename String>
+static ConstBuffer bytes_of(const String & text) {
+    return {reinterpret_cast<const u8 *>(text.data()), text.size() * sizeof(text[0])};
+}
+
+static void known_values() {
+    static const char8_t UTF8[] = u8"ASCII, été, € 100, 日本語, \U0001f600 \U0010ffff.";
+    static const char16_t UTF16[] = u"ASCII, été, € 100, 日本語, \U0001f600 \U0010ffff.";
+    static const char32_t UTF32[] = U"ASCII, été, € 100, 日本語, \U0001f600 \U0010ffff.";
+    const ConstBuffer utf8(reinterpret_cast<const u8 *>(UTF8), sizeof(UTF8) - 1);
+    const ConstBuffer utf16(reinterpret_cast<const u8 *>(UTF16), sizeof(UTF16) - 2);
+    const ConstBuffer utf32(reinterpret_cast<const u8 *>(UTF32), sizeof(UTF32) - 4);
+    EXPECT(utf8_validate(utf8), "");
+    EXPECT(not is_ascii(utf8), "");
+    EXPECT(is_ascii(bytes_of(std::string_view("plain ASCII text"))), "");
+    EXPECT(is_ascii(ConstBuffer()) && utf8_validate(ConstBuffer()), "");
+
+    EXPECT(utf8_to_utf16_size(utf8) == utf16.size, utf8_to_utf16_size(utf8));
+    EXPECT(utf8_to_utf32_size(utf8) == utf32.size, utf8_to_utf32_size(utf8));
+    EXPECT(utf16_to_utf8_size(utf16) == utf8.size, utf16_to_utf8_size(utf16));
+    EXPECT(utf32_to_utf8_size(utf32) == utf8.size, utf32_to_utf8_size(utf32));
+
+    u8 storage[256];
+    MutableBuffer output(storage, sizeof(storage));
+    EXPECT(utf8_to_utf16(utf8, output) && output.size == sizeof(storage) - utf16.size, output.size);
+    EXPECT(std::memcmp(storage, utf16.data, utf16.size) == 0, "");
+    output = MutableBuffer(storage, sizeof(storage));
+    EXPECT(utf8_to_utf32(utf8, output) && output.size == sizeof(storage) - utf32.size, output.size);
+    EXPECT(std::memcmp(storage, utf32.data, utf32.size) == 0, "");
+    output = MutableBuffer(storage, sizeof(storage));
+    EXPECT(utf16_to_utf8(utf16, output) && output.size == sizeof(storage) - utf8.size, output.size);
+    EXPECT(std::memcmp(storage, utf8.data, utf8.size) == 0, "");
+    output = MutableBuffer(storage, sizeof(storage));
+    EXPECT(utf32_to_utf8(utf32, output) && output.size == sizeof(storage) - utf8.size, output.size);
+    EXPECT(std::memcmp(storage, utf8.data, utf8.size) == 0, "");
+
+    // Exact size fits, one byte less fails and leaves output unchanged.
+    output = MutableBuffer(storage, utf16.size);
+    EXPECT(utf8_to_utf16(utf8, output) && output.size == 0, output.size);
+    output = MutableBuffer(storage, utf16.size - 1);
+    EXPECT(not utf8_to_utf16(utf8, output) && output.size == utf16.size - 1, output.size);
+    output = MutableBuffer(storage, utf8.size - 1);
+    EXPECT(not utf16_to_utf8(utf16, output) && output.size == utf8.size - 1, output.size);
+    EXPECT(not utf32_to_utf8(utf32, output) && output.size == utf8.size - 1, output.size);
+}
+
+static void invalid() {
+    for(std::string_view text : {
+            std::string_view("\x80"),                  // Stray continuation
+            std::string_view("a\xbf"),                 //
+            std::string_view("\xc0\x80"),              // Overlong 2-byte (U+0000)
+            std::string_view("\xc1\xbf"),              //
+            std::string_view("\xe0\x80\x80"),          // Overlong 3-byte
+            std::string_view("\xe0\x9f\xbf"),          //
+            std::string_view("\xf0\x80\x80\x80"),      // Overlong 4-byte
+            std::string_view("\xf0\x8f\xbf\xbf"),      //
+            std::string_view("\xed\xa0\x80"),          // Surrogates
+            std::string_view("\xed\xbf\xbf"),          //
+            std::string_view("\xf4\x90\x80\x80"),      // Above U+10FFFF
+            std::string_view("\xf5\x80\x80\x80"),      //
+            std::string_view("\xf8\x88\x80\x80\x80"),  // 5-byte form
+            std::string_view("\xfe"),                  //
+            std::string_view("\xff"),                  //
+            std::string_view("\xc3"),                  // Cut off by the end
+            std::string_view("\xe2\x82"),              //
+            std::string_view("\xf0\x9f\x98"),          //
+            std::string_view("\xc3 "),                 // Lead followed by ASCII
+            std::string_view("\xe2\x82\xac\xac"),      // Too many continuations
+        }) {
+        EXPECT(not reference_valid(bytes_of(text).data, text.size()), "reference");
+        EXPECT(not utf8_validate(bytes_of(text)), text.size());
+        // Same error after a long ASCII prefix, at every position relative to the SIMD blocks.
+        for(usize offset = 0; offset < 70; ++offset) {
+            std::string padded(offset, 'x');
+            padded += text;
+            padded += std::string(offset % 7, 'y');
+            EXPECT(not utf8_validate(bytes_of(std::string_view(padded))), text.size() << " at " << offset);
+        }
+        u8 storage[64];
+        MutableBuffer output(storage, sizeof(storage));
+        EXPECT(not utf8_to_utf16(bytes_of(text), output) && output.size == sizeof(storage), "");
+        EXPECT(not utf8_to_utf32(bytes_of(text), output) && output.size == sizeof(storage), "");
+    }
+
+    u8 storage[64];
+    MutableBuffer output(storage, sizeof(storage));
+    for(const std::u16string & text : {std::u16string(u"a\xd800"), std::u16string(u"\xdc00z"), std::u16string(u"\xd800\xd800"),
+                                       std::u16string(u"\xdbff" u"b")}) {
+        EXPECT(not utf16_to_utf8(bytes_of(text), output) && output.size == sizeof(storage), "");
+    }
+    static const u8 ODD[] = {'a', 0, 'b'};
+    EXPECT(not utf16_to_utf8(ODD, output) && output.size == sizeof(storage), "");
+    for(const char32_t unit : {char32_t(0xd800), char32_t(0xdfff), char32_t(0x110000), char32_t(0xffffffff)}) {
+        const std::u32string text = std::u32string(U"ok") + unit;
+        EXPECT(not utf32_to_utf8(bytes_of(text), output) && output.size == sizeof(storage), u32(unit));
+    }
+}
+
+/// Random text, ascii_percent % ASCII and the rest 2-, 3- and 4-byte code points.
+static std::u32string random_text(usize size, u32 ascii_percent) {
+    std::u32string ret;
+    for(usize i = 0; i < size; ++i) {
+        if(u32(rand()) % 100 < ascii_percent) {
+            ret += char32_t(rand() % 0x80);
+            continue;
+        }
+        char32_t code_point;
+        switch(rand() % 3) {
+            case 0: code_point = char32_t(0x80 + rand() % (0x800 - 0x80)); break;
+            case 1: code_point = char32_t(0x800 + rand() % (0x10000 - 0x800)); break;
+            default: code_point = char32_t(0x10000 + rand() % (0x110000 - 0x10000)); break;
+        }
+        if(code_point >= 0xd800 && code_point <= 0xdfff) {
+            code_point -= 0x800;
+        }
+        ret += code_point;
+    }
+    return ret;
+}
+
+static std::vector<u8> encode_utf8(const std::u32string & text) {
+    std::vector<u8> ret(4 * text.size());
+    u8 * out = ret.data();
+    for(const char32_t code_point : text) {
+        out = kernels::utf8_encode(out, code_point);
+    }
+    ret.resize(usize(out - ret.data()));
+    return ret;
+}
+
+/// Every 1- and 2-byte sequence at every offset around a block boundary, every 3-byte sequence, random 4-byte.
+static void exhaustive() {
+    usize failed = 0;
+    u8 text[80];
+    std::memset(text, 'x', sizeof(text));
+    for(u32 value = 0; value < 0x10000; ++value) {
+        for(usize offset = 10; offset < 70; offset += (value < 0x100) ? 1 : 19) {
+            text[offset] = u8(value);
+            text[offset + 1] = u8(value >> 8);
+            failed += kernels::utf8_validate(text, sizeof(text)) != reference_valid(text, sizeof(text));
+            failed += kernels::utf8_validate(text, offset + 1) != reference_valid(text, offset + 1);
+            failed += kernels::utf8_validate(text, offset + 2) != reference_valid(text, offset + 2);
+            text[offset] = 'x';
+            text[offset + 1] = 'x';
+        }
+    }
+    for(u32 value = 0xe0; value < (1 << 24); value += (value & 0xff) == 0xef ? 0x100 - 0x0f : 1) {
+        const usize offset = 8 + (value >> 8) % 64;
+        std::memcpy(text + offset, &value, 3);
+        failed += kernels::utf8_validate(text, sizeof(text)) != reference_valid(text, sizeof(text));
+        std::memset(text + offset, 'x', 3);
+    }
+    for(u32 i = 0; i < 1000000; ++i) {
+        const u32 value = 0xf0 + (u32(rand()) % 16) + (u32(rand()) << 8);
+        const usize offset = 8 + i % 68;
+        std::memcpy(text + offset, &value, 4);
+        failed += kernels::utf8_validate(text, offset + 4) != reference_valid(text, offset + 4);
+        std::memset(text + offset, 'x', 4);
+    }
+    EXPECT(failed == 0, "utf8_validate failed " << failed);
+}
+
+/// Random valid text of every size up to 300 and long text, with random bytes mutated.
+static void mutations() {
+    usize failed = 0;
+    for(u32 ascii_percent : {0u, 50u, 95u}) {
+        for(usize size = 0; size < 1300; size += (size < 300) ? 1 : 97) {
+            std::vector<u8> text = encode_utf8(random_text(size, ascii_percent));
+            failed += not kernels::utf8_validate(text.data(), text.size());
+            for(usize i = 0; i < 8 && not text.empty(); ++i) {
+                std::vector<u8> mutated = text;
+                for(usize j = 0; j <= i % 3; ++j) {
+                    mutated[usize(rand()) % mutated.size()] = u8(rand());
+                }
+                failed += kernels::utf8_validate(mutated.data(), mutated.size()) != reference_valid(mutated.data(), mutated.size());
+                // Cut off at a random position.
+                const usize cut = usize(rand()) % text.size();
+                failed += kernels::utf8_validate(text.data(), cut) != reference_valid(text.data(), cut);
+            }
+        }
+    }
+    EXPECT(failed == 0, "utf8_validate failed " << failed);
+}
+
+/// Transcoding round trips of random text against the scalar kernels, invalid UTF-16 / UTF-32 units.
+static void transcoding() {
+    usize failed = 0;
+    for(u32 ascii_percent : {0u, 90u, 99u, 100u}) {
+        for(usize size = 0; size < 3000; size += (size < 200) ? 1 : 331) {
+            const std::u32string text = random_text(size, ascii_percent);
+            const std::vector<u8> utf8 = encode_utf8(text);
+            std::vector<u8> utf16(4 * size + 1, 0xee);
+            u8 * end = kernels::utf8_to_utf16(utf8.data(), utf8.size(), utf16.data());
+            failed += usize(end - utf16.data()) != utf8_to_utf16_size(ConstBuffer(utf8.data(), utf8.size()));
+            std::vector<u8> expected(4 * size + 1, 0xee);
+            kernels::scalar::utf8_to_utf16(utf8.data(), utf8.size(), expected.data());
+            failed += utf16 != expected;
+            const usize units = usize(end - utf16.data()) / 2;
+
+            std::vector<u8> utf32(4 * size + 1, 0xee);
+            end = kernels::utf8_to_utf32(utf8.data(), utf8.size(), utf32.data());
+            failed += usize(end - utf32.data()) != 4 * size;
+            failed += std::memcmp(utf32.data(), text.data(), 4 * size) != 0 || utf32[4 * size] != 0xee;
+
+            std::vector<u8> back(utf8.size() + 1, 0xee);
+            end = kernels::utf16_to_utf8(utf16.data(), units, back.data());
+            failed += end == nullptr || usize(end - back.data()) != utf8.size();
+            failed += not std::equal(utf8.begin(), utf8.end(), back.begin()) || back[utf8.size()] != 0xee;
+            std::fill(back.begin(), back.end(), 0xee);
+            end = kernels::utf32_to_utf8(utf32.data(), size, back.data());
+            failed += end == nullptr || usize(end - back.data()) != utf8.size();
+            failed += not std::equal(utf8.begin(), utf8.end(), back.begin()) || back[utf8.size()] != 0xee;
+
+            if(size < 200 && units > 0) {
+                // Lone surrogate or invalid code point at a random position.
+                u16 unit = u16(0xd800 + (rand() % 0x800));
+                std::memcpy(utf16.data() + 2 * (usize(rand()) % units), &unit, 2);
+                failed += kernels::utf16_to_utf8(utf16.data(), units, back.data()) != kernels::scalar::utf16_to_utf8(utf16.data(), units, back.data());
+                u32 code_point = (rand() & 1) ? 0x110000 : 0xdc00;
+                std::memcpy(utf32.data() + 4 * (usize(rand()) % size), &code_point, 4);
+                failed += kernels::utf32_to_utf8(utf32.data(), size, back.data()) != nullptr;
+            }
+        }
+    }
+    EXPECT(failed == 0, "utf8 transcoding failed " << failed);
+}
+
+/// Non-ASCII byte at every position of every size up to 300.
+static void ascii() {
+    usize failed = 0;
+    std::vector<u8> text(300, 'a');
+    for(usize size = 0; size < text.size(); ++size) {
+        for(usize position = 0; position < size; ++position) {
+            text[position] = 0x80;
+            failed += kernels::is_ascii(text.data(), size);
+            text[position] = 'a';
+        }
+        failed += not kernels::is_ascii(text.data(), size);
+    }
+    EXPECT(failed == 0, "is_ascii failed " << failed);
+}
+
+/// Output size counters on random bytes of every size up to 300 against simple per-unit loops.
+static void counts() {
+    usize failed = 0;
+    std::vector<u8> bytes(1200);
+    for(usize size = 0; size <= 300; ++size) {
+        for(u8 & byte : bytes) {
+            // Mostly UTF-16 / UTF-32 units near the class boundaries.
+            byte = (rand() & 1) ? u8(rand()) : u8(rand() % 9);
+        }
+        usize expected_points = 0;
+        usize expected_units = 0;
+        for(usize i = 0; i < size; ++i) {
+            expected_points += (bytes[i] & 0xc0) != 0x80;
+            expected_units += usize((bytes[i] & 0xc0) != 0x80) + (bytes[i] >= 0xf0);
+        }
+        failed += kernels::utf8_code_points(bytes.data(), size) != expected_points;
+        failed += kernels::utf8_utf16_units(bytes.data(), size) != expected_units;
+        usize expected_16 = 0;
+        usize expected_32 = 0;
+        for(usize i = 0; i < size; ++i) {
+            u16 unit16;
+            std::memcpy(&unit16, bytes.data() + 2 * i, 2);
+            expected_16 += (unit16 >= 0xd800 && unit16 <= 0xdfff) ? 2 : kernels::utf8_length(unit16);
+            u32 unit32;
+            std::memcpy(&unit32, bytes.data() + 4 * i, 4);
+            expected_32 += kernels::utf8_length(unit32);
+        }
+        failed += kernels::utf16_utf8_length(bytes.data(), size) != expected_16;
+        failed += kernels::utf32_utf8_length(bytes.data(), size) != expected_32;
+    }
+    EXPECT(failed == 0, "utf8 counts failed " << failed);
+}
+
+void test_utf8() {
+    known_values();
+    invalid();
+    counts();
+    exhaustive();
+    mutations();
+    ascii();
+    transcoding();
+}
+
+}